@@ -479,6 +479,7 @@ bool firstEnsemble = true;
         interface. motdata_Handler	= nullptr;
         interface. tii_data_Handler	= tii_data_Handler;
         interface. timeHandler		= nullptr;
+        interface. ensembleChanged_Handler	= nullptr;
 //
 //	and with a sound device we can create a "backend"
 	theRadio	= dabInit (theDevice,
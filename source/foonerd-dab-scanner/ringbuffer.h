@@ -43,7 +43,8 @@
  *    Jan van Katwijk (J.vanKatwijk@gmail.com)
  *    Lazy Chair Computing
  *
- *    The ringbuffer here is a rewrite of the ringbuffer used in the PA code
+ *    The ringbuffer here is a rewrite of the ringbuffer used in the PA code,
+ *    (2025) rewritten once more, now on C++11 atomics
  *    All rights remain with their owners
  *    This file is part of the SDR-J.
  *    Many of the ideas as implemented in SDR-J are derived from
@@ -72,90 +73,135 @@
 #include	<stdio.h>
 #include	<string.h>
 #include	<stdint.h>
+#include	<atomic>
+#if defined(__linux__)
+#include	<unistd.h>
+#include	<sys/mman.h>
+#include	<sys/syscall.h>
+#endif
 /*
  *	a simple ringbuffer, lockfree, however only for a
  *	single reader and a single writer.
  *	Mostly used for getting samples from or to the soundcard
+ *	and from the devices.
+ *
+ *	The indices are free running 32 bit counters, the writer
+ *	publishes with a "release" store, the reader picks them up with
+ *	an "acquire" load (and vice versa), no further barriers are needed.
+ *	Each side keeps its own index, and a cached copy of the index
+ *	of the other side, on its own cache line.
+ *
+ *	The size is a power of two. Where possible (Linux) the storage
+ *	is mapped twice, back to back, so that any region of the buffer
+ *	is contiguous in memory. The "zero copy" interface uses that:
+ *	    peek    (&amount)	gives a pointer to the readable data,
+ *	    commit  (amount)	releases the data after use,
+ *	    reserve (&amount)	gives a pointer to free space,
+ *	    publish (amount)	makes the data written there visible.
+ *	Without the double mapping, the regions returned stop at the
+ *	end of the buffer and the caller has to ask again.
  */
-#if defined(__APPLE__)
-#   include <libkern/OSAtomic.h>
-    /* Here are the memory barrier functions. Mac OS X only provides
-       full memory barriers, so the three types of barriers are the same,
-       however, these barriers are superior to compiler-based ones. */
-#   define PaUtil_FullMemoryBarrier()  OSMemoryBarrier()
-#   define PaUtil_ReadMemoryBarrier()  OSMemoryBarrier()
-#   define PaUtil_WriteMemoryBarrier() OSMemoryBarrier()
-#elif defined(__GNUC__)
-    /* GCC >= 4.1 has built-in intrinsics. We'll use those */
-#   if (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)
-# define PaUtil_FullMemoryBarrier()  __sync_synchronize()
-# define PaUtil_ReadMemoryBarrier()  __sync_synchronize()
-# define PaUtil_WriteMemoryBarrier() __sync_synchronize()
-    /* as a fallback, GCC understands volatile asm and "memory" to mean it
-     * should not reorder memory read/writes */
-#   elif defined( __PPC__ )
-#      define PaUtil_FullMemoryBarrier()  asm volatile("sync":::"memory")
-#      define PaUtil_ReadMemoryBarrier()  asm volatile("sync":::"memory")
-#      define PaUtil_WriteMemoryBarrier() asm volatile("sync":::"memory")
-#   elif defined( __i386__ ) || defined( __i486__ ) || defined( __i586__ ) || defined( __i686__ ) || defined( __x86_64__ )
-#      define PaUtil_FullMemoryBarrier()  asm volatile("mfence":::"memory")
-#      define PaUtil_ReadMemoryBarrier()  asm volatile("lfence":::"memory")
-#      define PaUtil_WriteMemoryBarrier() asm volatile("sfence":::"memory")
-#   else
-#      ifdef ALLOW_SMP_DANGERS
-#         warning Memory barriers not defined on this system or system unknown
-#         warning For SMP safety, you should fix this.
-#         define PaUtil_FullMemoryBarrier()
-#         define PaUtil_ReadMemoryBarrier()
-#         define PaUtil_WriteMemoryBarrier()
-#      else
-#         error Memory barriers are not defined on this system. You can still compile by defining ALLOW_SMP_DANGERS, but SMP safety will not be guaranteed.
-#      endif
-#   endif
-#else
-#   ifdef ALLOW_SMP_DANGERS
-#      warning Memory barriers not defined on this system or system unknown
-#      warning For SMP safety, you should fix this.
-#      define PaUtil_FullMemoryBarrier()
-#      define PaUtil_ReadMemoryBarrier()
-#      define PaUtil_WriteMemoryBarrier()
-#   else
-#      error Memory barriers are not defined on this system. You can still compile by defining ALLOW_SMP_DANGERS, but SMP safety will not be guaranteed.
-#   endif
-#endif
+#define	RINGBUFFER_CACHE_LINE	64
 
 template <class elementtype>
 class RingBuffer {
 private:
+//	the writer side
+		std::atomic<uint32_t>	writeIndex;
+		uint32_t	cachedReadIndex;
+		char		pad_1 [RINGBUFFER_CACHE_LINE -
+	                               sizeof (std::atomic<uint32_t>) -
+	                               sizeof (uint32_t)];
+//	the reader side
+		std::atomic<uint32_t>	readIndex;
+		uint32_t	cachedWriteIndex;
+		char		pad_2 [RINGBUFFER_CACHE_LINE -
+	                               sizeof (std::atomic<uint32_t>) -
+	                               sizeof (uint32_t)];
+//	read-only after construction
 		uint32_t	bufferSize;
-volatile	uint32_t	writeIndex;
-volatile	uint32_t	readIndex;
-		uint32_t	bigMask;
-	        uint32_t	smallMask;
-		char		*buffer;
+		uint32_t	mask;
+		elementtype	*buffer;
+		size_t		storageSize;
+		bool		mirrored;
+
+static	uint32_t	roundUp		(uint32_t n) {
+	uint32_t p	= 1;
+	while (p < n)
+	   p <<= 1;
+	return p;
+}
+
+	bool	allocateMirrored	() {
+#if defined(__linux__) && defined(SYS_memfd_create)
+	long pageSize	= sysconf (_SC_PAGESIZE);
+	if ((pageSize <= 0) || (storageSize % pageSize) != 0)
+	   return false;
+	int fd	= syscall (SYS_memfd_create, "ringbuffer", 0);
+	if (fd < 0)
+	   return false;
+	if (ftruncate (fd, storageSize) != 0) {
+	   close (fd);
+	   return false;
+	}
+//	reserve the address range, then map the file twice into it
+	char *base	= (char *)mmap (NULL, 2 * storageSize, PROT_NONE,
+	                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == (char *)MAP_FAILED) {
+	   close (fd);
+	   return false;
+	}
+	void *p1	= mmap (base, storageSize,
+	                        PROT_READ | PROT_WRITE,
+	                        MAP_SHARED | MAP_FIXED, fd, 0);
+	void *p2	= mmap (base + storageSize, storageSize,
+	                        PROT_READ | PROT_WRITE,
+	                        MAP_SHARED | MAP_FIXED, fd, 0);
+	close (fd);
+	if ((p1 != (void *)base) || (p2 != (void *)(base + storageSize))) {
+	   munmap (base, 2 * storageSize);
+	   return false;
+	}
+	buffer	= (elementtype *)base;
+	return true;
+#else
+	return false;
+#endif
+}
+
 public:
 	RingBuffer (uint32_t elementCount) {
-	if (((elementCount - 1) & elementCount) != 0)
-	    elementCount = 2 * 16384;	/* default	*/
-
-	bufferSize	= elementCount;
-	buffer		= new char [2 * bufferSize * sizeof (elementtype)];
-	writeIndex	= 0;
-	readIndex	= 0;
-	smallMask	= (elementCount)- 1;
-	bigMask		= (elementCount * 2) - 1;
+	if (elementCount < 2)
+	   elementCount = 2 * 16384;	/* default	*/
+	bufferSize	= roundUp (elementCount);
+	mask		= bufferSize - 1;
+	storageSize	= (size_t)bufferSize * sizeof (elementtype);
+	mirrored	= allocateMirrored ();
+	if (!mirrored)
+	   buffer	= (elementtype *)(new char [storageSize]);
+	writeIndex. store (0);
+	readIndex. store (0);
+	cachedReadIndex		= 0;
+	cachedWriteIndex	= 0;
 }
 
 	~RingBuffer () {
-	   delete[]	 buffer;
+#if defined(__linux__)
+	if (mirrored) {
+	   munmap ((void *)buffer, 2 * storageSize);
+	   return;
+	}
+#endif
+	delete[] (char *)buffer;
 }
 
 /*
  * 	functions for checking available data for reading and space
- * 	for writing
+ * 	for writing, they may be called from either side
  */
 int32_t	GetRingBufferReadAvailable (void) {
-	return (writeIndex - readIndex) & bigMask;
+	return writeIndex. load (std::memory_order_acquire) -
+	               readIndex. load (std::memory_order_acquire);
 }
 
 int32_t	ReadSpace	(void){
@@ -170,149 +216,179 @@ int32_t	WriteSpace	(void) {
 	return GetRingBufferWriteAvailable ();
 }
 
+bool	isMirrored	(void) {
+	return mirrored;
+}
+//
+//	Flushing is done by the reader catching up with the writer,
+//	so it is safe while the writer is active
 void	FlushRingBuffer () {
-	writeIndex	= 0;
-	readIndex	= 0;
+	uint32_t w	= writeIndex. load (std::memory_order_acquire);
+	cachedWriteIndex	= w;
+	readIndex. store (w, std::memory_order_release);
 }
-/* ensure that previous writes are seen before we update the write index 
-   (write after write)
- */
+//
+//	the writer side
+elementtype	*reserve	(int32_t *amount) {
+uint32_t w	= writeIndex. load (std::memory_order_relaxed);
+uint32_t space	= bufferSize - (w - cachedReadIndex);
+
+	if (space < (uint32_t)*amount) {
+	   cachedReadIndex	= readIndex. load (std::memory_order_acquire);
+	   space		= bufferSize - (w - cachedReadIndex);
+	}
+	uint32_t index	= w & mask;
+	if (!mirrored && (index + space > bufferSize))
+	   space	= bufferSize - index;
+	if ((uint32_t)*amount > space)
+	   *amount	= space;
+	return &buffer [index];
+}
+
+void	publish		(int32_t amount) {
+	writeIndex. store (writeIndex. load (std::memory_order_relaxed) +
+	                             amount, std::memory_order_release);
+}
+//
+//	the reader side
+const elementtype	*peek	(int32_t *amount) {
+uint32_t r	= readIndex. load (std::memory_order_relaxed);
+uint32_t available	= cachedWriteIndex - r;
+
+	if (available < (uint32_t)*amount) {
+	   cachedWriteIndex	= writeIndex. load (std::memory_order_acquire);
+	   available		= cachedWriteIndex - r;
+	}
+	uint32_t index	= r & mask;
+	if (!mirrored && (index + available > bufferSize))
+	   available	= bufferSize - index;
+	if ((uint32_t)*amount > available)
+	   *amount	= available;
+	return &buffer [index];
+}
+
+void	commit		(int32_t amount) {
+	readIndex. store (readIndex. load (std::memory_order_relaxed) +
+	                             amount, std::memory_order_release);
+}
+//
+//	The PA style interface, kept for existing users
 int32_t AdvanceRingBufferWriteIndex (int32_t elementCount) {
-	PaUtil_WriteMemoryBarrier();
-	return writeIndex = (writeIndex + elementCount) & bigMask;
+	publish (elementCount);
+	return writeIndex. load (std::memory_order_relaxed) & mask;
 }
 
-/* ensure that previous reads (copies out of the ring buffer) are
- * always completed before updating (writing) the read index. 
- * (write-after-read) => full barrier
- */
 int32_t AdvanceRingBufferReadIndex (int32_t elementCount) {
-    PaUtil_FullMemoryBarrier();
-    return readIndex = (readIndex + elementCount) & bigMask;
+	commit (elementCount);
+	return readIndex. load (std::memory_order_relaxed) & mask;
 }
 
 /***************************************************************************
 ** Get address of region(s) to which we can write data.
-** If the region is contiguous, size2 will be zero.
-** If non-contiguous, size2 will be the size of second region.
+** If the region is contiguous, size2 will be zero (always the case
+** for mirrored storage).
 ** Returns room available to be written or elementCount, whichever is smaller.
 */
 int32_t GetRingBufferWriteRegions (uint32_t elementCount,
                                    void **dataPtr1, int32_t *sizePtr1,
                                    void **dataPtr2, int32_t *sizePtr2 ) {
-uint32_t   index;
-uint32_t   available = GetRingBufferWriteAvailable ();
+uint32_t w	= writeIndex. load (std::memory_order_relaxed);
+uint32_t index	= w & mask;
+uint32_t available;
 
+	cachedReadIndex	= readIndex. load (std::memory_order_acquire);
+	available	= bufferSize - (w - cachedReadIndex);
 	if (elementCount > available)
 	   elementCount = available;
 
 /* Check to see if write is not contiguous. */
-	index = writeIndex & smallMask;
-	if ((index + elementCount) > bufferSize ) {
-        /* Write data in two blocks that wrap the buffer. */
-           int32_t   firstHalf = bufferSize - index;
-           *dataPtr1	= &buffer[index * sizeof(elementtype)];
+	if (!mirrored && ((index + elementCount) > bufferSize)) {
+	   int32_t   firstHalf = bufferSize - index;
+	   *dataPtr1	= &buffer [index];
 	   *sizePtr1	= firstHalf;
 	   *dataPtr2	= &buffer [0];
 	   *sizePtr2	= elementCount - firstHalf;
 	}
 	else {		// fits
-	   *dataPtr1	= &buffer [index * sizeof(elementtype)];
+	   *dataPtr1	= &buffer [index];
 	   *sizePtr1	= elementCount;
 	   *dataPtr2	= NULL;
 	   *sizePtr2	= 0;
 	}
-
-	if (available > 0)
-           PaUtil_FullMemoryBarrier(); /* (write-after-read) => full barrier */
-
 	return elementCount;
 }
 
 /***************************************************************************
 ** Get address of region(s) from which we can read data.
-** If the region is contiguous, size2 will be zero.
-** If non-contiguous, size2 will be the size of second region.
+** If the region is contiguous, size2 will be zero (always the case
+** for mirrored storage).
 ** Returns room available to be read or elementCount, whichever is smaller.
 */
 int32_t GetRingBufferReadRegions (uint32_t elementCount,
 	                          void **dataPtr1, int32_t *sizePtr1,
 	                          void **dataPtr2, int32_t *sizePtr2) {
-uint32_t   index;
-uint32_t   available = GetRingBufferReadAvailable (); /* doesn't use memory barrier */
+uint32_t r	= readIndex. load (std::memory_order_relaxed);
+uint32_t index	= r & mask;
+uint32_t available;
 
+	cachedWriteIndex	= writeIndex. load (std::memory_order_acquire);
+	available	= cachedWriteIndex - r;
 	if (elementCount > available)
 	   elementCount = available;
 
 /* Check to see if read is not contiguous. */
-	index = readIndex & smallMask;
-	if ((index + elementCount) > bufferSize) {
-        /* Write data in two blocks that wrap the buffer. */
-           int32_t firstHalf = bufferSize - index;
-	   *dataPtr1 = &buffer [index * sizeof(elementtype)];
-	   *sizePtr1 = firstHalf;
-	   *dataPtr2 = &buffer [0];
-	   *sizePtr2 = elementCount - firstHalf;
+	if (!mirrored && ((index + elementCount) > bufferSize)) {
+	   int32_t firstHalf = bufferSize - index;
+	   *dataPtr1	= &buffer [index];
+	   *sizePtr1	= firstHalf;
+	   *dataPtr2	= &buffer [0];
+	   *sizePtr2	= elementCount - firstHalf;
 	}
 	else {
-	   *dataPtr1 = &buffer [index * sizeof(elementtype)];
-	   *sizePtr1 = elementCount;
-	   *dataPtr2 = NULL;
-	   *sizePtr2 = 0;
+	   *dataPtr1	= &buffer [index];
+	   *sizePtr1	= elementCount;
+	   *dataPtr2	= NULL;
+	   *sizePtr2	= 0;
 	}
-    
-	if (available)
-           PaUtil_ReadMemoryBarrier(); /* (read-after-read) => read barrier */
-
 	return elementCount;
 }
 
 int32_t	putDataIntoBuffer (const void *data, int32_t elementCount) {
-int32_t size1, size2, numWritten;
+int32_t	size1, size2;
 void	*data1;
 void	*data2;
-
-	numWritten = GetRingBufferWriteRegions (elementCount,
-	                                        &data1, &size1,
-	                                        &data2, &size2 );
-	if (size2 > 0) {
-           memcpy (data1, data, size1 * sizeof(elementtype));
-	   data = ((char *)data) + size1 * sizeof(elementtype);
-	   memcpy (data2, data, size2 * sizeof(elementtype));
-	}
-	else 
-	   memcpy (data1, data, size1 * sizeof(elementtype));
-
-	AdvanceRingBufferWriteIndex (numWritten );
+int32_t	numWritten	= GetRingBufferWriteRegions (elementCount,
+	                                             &data1, &size1,
+	                                             &data2, &size2);
+	memcpy (data1, data, size1 * sizeof (elementtype));
+	if (size2 > 0)
+	   memcpy (data2, ((const char *)data) + size1 * sizeof (elementtype),
+	                                    size2 * sizeof (elementtype));
+	publish (numWritten);
 	return numWritten;
 }
 
-int32_t getDataFromBuffer (void *data, int32_t elementCount ) {
-int32_t	size1, size2, numRead;
+int32_t getDataFromBuffer (void *data, int32_t elementCount) {
+int32_t	size1, size2;
 void	*data1;
 void	*data2;
-
-	numRead = GetRingBufferReadRegions (elementCount,
+int32_t	numRead	= GetRingBufferReadRegions (elementCount,
 	                                    &data1, &size1,
-	                                    &data2, &size2 );
-	if (size2 > 0) {
-	   memcpy (data, data1, size1 * sizeof(elementtype));
-	   data = ((char *)data) + size1 *  sizeof(elementtype);
-	   memcpy (data, data2, size2 * sizeof(elementtype));
-	}
-	else
-           memcpy (data, data1, size1 * sizeof(elementtype));
-
-	AdvanceRingBufferReadIndex (numRead );
+	                                    &data2, &size2);
+	memcpy (data, data1, size1 * sizeof (elementtype));
+	if (size2 > 0)
+	   memcpy (((char *)data) + size1 * sizeof (elementtype),
+	                            data2, size2 * sizeof (elementtype));
+	commit (numRead);
 	return numRead;
 }
 
 int32_t	skipDataInBuffer (uint32_t n_values) {
-//	ensure that we have the correct read and write indices
-	PaUtil_FullMemoryBarrier ();
-	if (n_values > GetRingBufferReadAvailable ())
-	   n_values = GetRingBufferReadAvailable ();
-	AdvanceRingBufferReadIndex (n_values);
+int32_t	available	= GetRingBufferReadAvailable ();
+
+	if ((int32_t)n_values > available)
+	   n_values = available;
+	commit (n_values);
 	return n_values;
 }
 
@@ -0,0 +1,462 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+//
+//	dab-batch makes an inventory of a (large) number of recordings:
+//	the recordings are decoded in parallel, on a pool of workers
+//	(default one per core), each worker with its own instance of
+//	the library and a memory mapped file device, running unthrottled.
+//	For each recording a JSON record (one line) is written with the
+//	ensemble, the services, the transmitters (TII), the SNR and the
+//	FIC quality, at the end a record with the aggregate throughput.
+//	No service is selected, only the FIC is decoded.
+#include	<unistd.h>
+#include	<getopt.h>
+#include	<stdarg.h>
+#include	<cstdio>
+#include	<cstring>
+#include	<string>
+#include	<vector>
+#include	<thread>
+#include	<mutex>
+#include	<atomic>
+#include	<chrono>
+#include	"dab-api.h"
+#include	"mmap-file-handler.h"
+
+//	used by the devices
+bool	debugEnabled	= false;
+//
+//	the state of the decoding of one recording, passed as context
+//	to the callbacks of the library and to the eof handler of the
+//	device. The callbacks come from different threads of the library
+struct	capture {
+	void		*theRadio;
+	std::atomic<bool>	endOfInput;
+	std::atomic<bool>	synced;
+	std::atomic<bool>	ensembleRecognized;
+	std::atomic<int64_t>	snrSum;
+	std::atomic<int64_t>	snrCount;
+	std::atomic<int64_t>	ficSum;
+	std::atomic<int64_t>	ficCount;
+	std::atomic<int32_t>	freqOffset;
+	processingStats	eofStats;
+	std::chrono::steady_clock::time_point	eofTime;
+};
+
+static
+void	inputEnded	(void *userData) {
+capture *c	= (capture *)userData;
+
+	if (c -> endOfInput. load ())
+	   return;
+	dabGetProcessingStats (c -> theRadio, &c -> eofStats);
+	c -> eofTime	= std::chrono::steady_clock::now ();
+	c -> endOfInput. store (true);
+}
+
+static
+void	syncsignal_Handler (bool b, void *ctx) {
+	if (b)
+	   ((capture *)ctx) -> synced. store (true);
+}
+//
+//	the SNR is averaged over the time the decoder is in sync
+static
+void	systemData	(bool flag, int16_t snr, int32_t freqOff, void *ctx) {
+capture *c	= (capture *)ctx;
+
+	if (!flag)
+	   return;
+	c -> snrSum. fetch_add (snr);
+	c -> snrCount. fetch_add (1);
+	c -> freqOffset. store (freqOff);
+}
+//
+//	the percentage of FIB's passing the CRC, per 100 FIB's
+static
+void	fibQuality	(int16_t q, void *ctx) {
+capture *c	= (capture *)ctx;
+
+	c -> ficSum. fetch_add (q);
+	c -> ficCount. fetch_add (1);
+}
+
+static
+void	name_of_ensemble (const std::string &name, int32_t Id, void *ctx) {
+	(void)name; (void)Id;
+	((capture *)ctx) -> ensembleRecognized. store (true);
+}
+
+static
+void	serviceName	(const std::string &s, int32_t SId,
+	                 uint16_t subChId, void *ctx) {
+	(void)s; (void)SId; (void)subChId; (void)ctx;
+}
+
+static
+void	programdata_Handler (audiodata *d, void *ctx) {
+	(void)d; (void)ctx;
+}
+
+static
+void	tii_data_Handler (tiiData *d, void *ctx) {
+	(void)d; (void)ctx;
+}
+//
+//	the records are built as strings, so the workers can write them
+//	as a whole
+static
+void	appendf		(std::string &s, const char *format, ...) {
+char	buffer [256];
+va_list	args;
+
+	va_start (args, format);
+	vsnprintf (buffer, sizeof (buffer), format, args);
+	va_end (args);
+	s	+= buffer;
+}
+
+static
+void	jsonString	(std::string &r, const std::string &s) {
+	r	+= '"';
+	for (char c : s) {
+	   if ((c == '"') || (c == '\\')) {
+	      r	+= '\\';
+	      r	+= c;
+	   }
+	   else
+	   if ((uint8_t)c < 040)
+	      appendf (r, "\\u%04x", c);
+	   else
+	      r	+= c;
+	}
+	r	+= '"';
+}
+
+static
+std::string	errorRecord	(const std::string &fileName,
+	                         const std::string &error) {
+std::string	r	= "{\"file\": ";
+
+	jsonString (r, fileName);
+	r	+= ", \"error\": ";
+	jsonString (r, error);
+	r	+= "}";
+	return r;
+}
+
+static
+void	servicesRecord	(std::string &r, const ensembleSnapshot &ens) {
+	r	+= ", \"services\": [";
+	for (size_t i = 0; i < ens. services. size (); i ++) {
+	   const ensembleService &s	= ens. services [i];
+	   appendf (r, "%s{\"SId\": \"%X\", \"name\": ",
+	                     i == 0 ? "" : ", ", s. SId);
+	   jsonString (r, s. name);
+	   r	+= ", \"shortName\": ";
+	   jsonString (r, s. shortName);
+	   appendf (r, ", \"primary\": %s, \"programType\": %d",
+	                     s. isPrimary ? "true" : "false", s. programType);
+//	type, bit rate and subchannel are those of the first component
+	   if (s. components. size () > 0) {
+	      const ensembleComponent &c = ens. components [s. components [0]];
+	      if (c. serviceType == AUDIO_SERVICE)
+	         appendf (r, ", \"type\": \"%s\", \"bitRate\": %d, \"subChId\": %d",
+	                     c. ad. ASCTy == 077 ? "DAB+" : "DAB",
+	                     c. ad. bitRate, c. ad. subchId);
+	      else
+	         appendf (r, ", \"type\": \"data\", \"bitRate\": %d, \"subChId\": %d",
+	                     c. pd. bitRate, c. pd. subchId);
+	   }
+	   r	+= "}";
+	}
+	r	+= "]";
+}
+
+static
+void	transmittersRecord (std::string &r, const ensembleSnapshot &ens) {
+	r	+= ", \"tii\": [";
+	for (size_t i = 0; i < ens. transmitters. size (); i ++) {
+	   const tiiData &t	= ens. transmitters [i];
+	   appendf (r, "%s{\"mainId\": %d, \"subId\": %d, \"strength\": %.2f}",
+	                     i == 0 ? "" : ", ",
+	                     t. mainId, t. subId, t. strength);
+	}
+	r	+= "]";
+}
+//
+//	decode (at most "limit" seconds of) a recording into a JSON
+//	record, the seconds of signal read are returned in signal.
+//	The result is false if the recording could not be decoded
+static
+bool	decode		(const std::string &fileName, uint8_t theMode,
+	                 double limit, std::string &r, double &signal) {
+capture	c;
+mmapFileHandler	*theDevice;
+
+	signal		= 0;
+	c. theRadio	= nullptr;
+	c. endOfInput. store (false);
+	c. synced. store (false);
+	c. ensembleRecognized. store (false);
+	c. snrSum. store (0);
+	c. snrCount. store (0);
+	c. ficSum. store (0);
+	c. ficCount. store (0);
+	c. freqOffset. store (0);
+	try {
+	   theDevice	= new mmapFileHandler (fileName, false,
+	                                       inputEnded, &c);
+	}
+	catch (std::exception &ex) {
+	   r	= errorRecord (fileName, ex. what ());
+	   return false;
+	}
+	catch (...) {
+	   r	= errorRecord (fileName, "cannot open");
+	   return false;
+	}
+
+	API_struct interface;
+	memset ((void *)&interface, 0, sizeof (interface));
+	interface. dabMode		= theMode;
+	interface. thresholdValue	= 6;
+	interface. syncsignal_Handler	= syncsignal_Handler;
+	interface. systemdata_Handler	= systemData;
+	interface. name_of_ensemble	= name_of_ensemble;
+	interface. serviceName		= serviceName;
+	interface. fib_quality_Handler	= fibQuality;
+	interface. programdata_Handler	= programdata_Handler;
+	interface. tii_data_Handler	= tii_data_Handler;
+
+	c. theRadio	= dabInit (theDevice, &interface,
+	                           nullptr, nullptr, &c);
+	if (c. theRadio == nullptr) {
+	   delete theDevice;
+	   r	= errorRecord (fileName, "initializing the library failed");
+	   return false;
+	}
+	theDevice	-> setUnthrottled (true);
+	std::chrono::steady_clock::time_point startTime =
+	                                 std::chrono::steady_clock::now ();
+	theDevice	-> restartReader (227360000);
+	dabStartProcessing (c. theRadio);
+
+	processingStats	ps;
+	std::chrono::steady_clock::time_point endTime;
+	while (!c. endOfInput. load ()) {
+	   usleep (10000);
+	   if (limit <= 0)
+	      continue;
+	   dabGetProcessingStats (c. theRadio, &ps);
+	   if (ps. samplesRead >= limit * INPUT_RATE)
+	      break;
+	}
+	if (c. endOfInput. load ()) {
+	   ps		= c. eofStats;
+	   endTime	= c. eofTime;
+	}
+	else {
+	   dabGetProcessingStats (c. theRadio, &ps);
+	   endTime	= std::chrono::steady_clock::now ();
+	}
+	theDevice	-> stopReader ();
+	dabStop (c. theRadio);
+
+	double wall	=
+	           std::chrono::duration<double> (endTime - startTime). count ();
+	signal		= ps. samplesRead / (double)INPUT_RATE;
+	std::shared_ptr<const ensembleSnapshot> ens =
+	                                      dabGetEnsemble (c. theRadio);
+	r	= "{\"file\": ";
+	jsonString (r, fileName);
+	appendf (r, ", \"signalSeconds\": %.3f, \"wallSeconds\": %.3f, \"realtime\": %.2f",
+	            signal, wall, wall > 0 ? signal / wall : 0);
+	appendf (r, ", \"synced\": %s, \"frames\": %llu",
+	            c. synced. load () ? "true" : "false",
+	            (unsigned long long)ps. framesDecoded);
+	if (c. snrCount. load () > 0)
+	   appendf (r, ", \"snr\": %.1f, \"freqOffset\": %d",
+	               (double)c. snrSum. load () / c. snrCount. load (),
+	               c. freqOffset. load ());
+	if (c. ficCount. load () > 0)
+	   appendf (r, ", \"ficQuality\": %.1f",
+	               (double)c. ficSum. load () / c. ficCount. load ());
+	appendf (r, ", \"fibs\": {\"parsed\": %llu, \"skipped\": %llu, \"crcErrors\": %llu}",
+	            (unsigned long long)ps. fibsParsed,
+	            (unsigned long long)ps. fibsSkipped,
+	            (unsigned long long)ps. fibsFailed);
+	if (c. ensembleRecognized. load ()) {
+	   r	+= ", \"ensemble\": {\"name\": ";
+	   jsonString (r, ens -> ensembleName);
+	   appendf (r, ", \"EId\": \"%X\", \"ecc\": \"%02X\"}",
+	               ens -> EId, ens -> ecc);
+	}
+	servicesRecord (r, *ens);
+	transmittersRecord (r, *ens);
+	r	+= "}";
+
+	dabExit (c. theRadio);
+	delete theDevice;
+	return true;
+}
+//
+//	the workers take the recordings in order, the records are
+//	written as soon as they are complete
+struct	batch {
+	std::vector<std::string>	files;
+	uint8_t		theMode;
+	double		limit;
+	std::atomic<size_t>	next;
+	std::mutex	outputLock;
+	FILE		*output;
+	int		failed;
+	double		signal;
+};
+
+static
+void	worker	(batch *b) {
+	while (true) {
+	   size_t i	= b -> next. fetch_add (1);
+	   if (i >= b -> files. size ())
+	      return;
+	   std::string r;
+	   double signal;
+	   bool ok = decode (b -> files [i], b -> theMode,
+	                                       b -> limit, r, signal);
+	   std::lock_guard<std::mutex> lock (b -> outputLock);
+	   fprintf (b -> output, "%s\n", r. c_str ());
+	   fflush (b -> output);
+	   if (!ok)
+	      b -> failed ++;
+	   b -> signal	+= signal;
+	   fprintf (stderr, "%d/%d %s: %.1f sec\n",
+	                    (int)(i + 1), (int)b -> files. size (),
+	                    b -> files [i]. c_str (), signal);
+	}
+}
+
+static
+void	printOptions	() {
+	fprintf (stderr,
+"dab-batch [options] file ...\n"
+"	decodes recordings (raw u8 IQ, or xml with 8 or 16 bit IQ at\n"
+"	2048000) in parallel and writes a JSON record per recording\n"
+"	-w workers\tnumber of recordings decoded at the same time,\n"
+"	\tdefault one per core\n"
+"	-l file\ta file with the names of the recordings, one per line\n"
+"	-s seconds\tdecode at most this much of each recording\n"
+"	-M mode\tDAB mode, default 1\n"
+"	-j file\twrite the records to file rather than to stdout\n");
+}
+
+int	main	(int argc, char **argv) {
+batch	theBatch;
+int	workers		= std::thread::hardware_concurrency ();
+std::string	jsonFile	= "";
+int	opt;
+
+	theBatch. theMode	= 1;
+	theBatch. limit		= 0;
+	theBatch. failed	= 0;
+	theBatch. signal	= 0;
+	theBatch. next. store (0);
+	while ((opt = getopt (argc, argv, "w:l:s:M:j:h")) != -1) {
+	   switch (opt) {
+	      case 'w':
+	         workers	= atoi (optarg);
+	         break;
+	      case 'l': {
+	         FILE *f = fopen (optarg, "r");
+	         char line [1024];
+	         if (f == nullptr) {
+	            fprintf (stderr, "cannot open %s\n", optarg);
+	            exit (1);
+	         }
+	         while (fgets (line, sizeof (line), f) != nullptr) {
+	            line [strcspn (line, "\r\n")] = 0;
+	            if ((line [0] != 0) && (line [0] != '#'))
+	               theBatch. files. push_back (line);
+	         }
+	         fclose (f);
+	         break;
+	      }
+	      case 's':
+	         theBatch. limit	= atof (optarg);
+	         break;
+	      case 'M':
+	         theBatch. theMode	= atoi (optarg);
+	         if (!((theBatch. theMode == 1) || (theBatch. theMode == 2) ||
+	               (theBatch. theMode == 4)))
+	            theBatch. theMode = 1;
+	         break;
+	      case 'j':
+	         jsonFile	= optarg;
+	         break;
+	      default:
+	         printOptions ();
+	         exit (1);
+	   }
+	}
+	for (int i = optind; i < argc; i ++)
+	   theBatch. files. push_back (argv [i]);
+	if (theBatch. files. size () == 0) {
+	   printOptions ();
+	   exit (1);
+	}
+	if (workers <= 0)
+	   workers	= 1;
+	if (workers > (int)theBatch. files. size ())
+	   workers	= theBatch. files. size ();
+
+	theBatch. output	= jsonFile == "" ? stdout :
+	                                     fopen (jsonFile. c_str (), "w");
+	if (theBatch. output == nullptr) {
+	   fprintf (stderr, "cannot open %s\n", jsonFile. c_str ());
+	   exit (1);
+	}
+
+	std::chrono::steady_clock::time_point startTime =
+	                                 std::chrono::steady_clock::now ();
+	std::vector<std::thread> pool;
+	for (int i = 0; i < workers; i ++)
+	   pool. push_back (std::thread (worker, &theBatch));
+	for (auto &t : pool)
+	   t. join ();
+	double wall	= std::chrono::duration<double>
+	                    (std::chrono::steady_clock::now () - startTime).
+	                                                          count ();
+
+	fprintf (theBatch. output,
+	         "{\"aggregate\": {\"recordings\": %d, \"failed\": %d, \"workers\": %d, \"signalSeconds\": %.3f, \"wallSeconds\": %.3f, \"realtime\": %.2f}}\n",
+	         (int)theBatch. files. size (), theBatch. failed, workers,
+	         theBatch. signal, wall,
+	         wall > 0 ? theBatch. signal / wall : 0);
+	fprintf (stderr, "%d recordings (%d failed), %.1f sec of signal in %.2f sec, %.2f x realtime on %d workers\n",
+	         (int)theBatch. files. size (), theBatch. failed,
+	         theBatch. signal, wall,
+	         wall > 0 ? theBatch. signal / wall : 0, workers);
+	if (theBatch. output != stdout)
+	   fclose (theBatch. output);
+	return theBatch. failed == 0 ? 0 : 1;
+}
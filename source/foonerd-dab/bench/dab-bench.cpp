@@ -0,0 +1,1333 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+//
+//	dab-bench decodes a recording (raw u8, wav or xml) or a
+//	synthetic signal as fast as possible, and reports the time
+//	spent in the stages of the decoder, the overall speed (relative
+//	to realtime) and the peak memory use. The report can be written
+//	as JSON, to be compared between releases.
+#include	<unistd.h>
+#include	<getopt.h>
+#include	<sys/resource.h>
+#include	<cstdio>
+#include	<cstring>
+#include	<string>
+#include	<vector>
+#include	<atomic>
+#include	<chrono>
+#include	<random>
+#include	"dab-api.h"
+#include	"rawfiles.h"
+#include	"mmap-file-handler.h"
+#include	"wavfiles.h"
+#include	"xml-filereader.h"
+#include	"synthetic-signal.h"
+#include	"viterbi-spiral.h"
+#include	"protection-bench.h"
+#include	"interleave-bench.h"
+#include	"rs-bench.h"
+#include	"mp2-bench.h"
+#include	"frame-bench.h"
+#include	"fft-bench.h"
+#include	"demap-bench.h"
+#include	"rate-bench.h"
+#include	"iq-bench.h"
+#include	"ring-bench.h"
+#include	"instance-bench.h"
+
+//	used by the devices
+bool	debugEnabled	= false;
+
+static
+std::atomic<bool>	ensembleRecognized;
+
+static
+std::atomic<bool>	endOfInput;
+
+static
+std::atomic<uint64_t>	audioSamples;	// per channel
+//
+//	FNV-1a hash over the PCM samples, the audio is only
+//	delivered by the backend of the selected service
+static
+std::atomic<uint64_t>	audioChecksum;
+
+static
+std::atomic<int>	lastQuality [3];
+
+static
+processingStats	eofStats;
+
+static
+std::chrono::steady_clock::time_point	eofTime;
+//
+//	the cpu time and the context switches of the process, taken at
+//	the start and at the end of the input. The voluntary switches
+//	are the wake ups of threads that waited
+struct	cpuUse {
+	double	seconds;
+	long	wakeUps;
+	long	preemptions;
+};
+
+static
+void	getCpuUse	(cpuUse &c) {
+struct rusage	usage;
+	getrusage (RUSAGE_SELF, &usage);
+	c. seconds	= usage. ru_utime. tv_sec + usage. ru_utime. tv_usec / 1e6 +
+	                  usage. ru_stime. tv_sec + usage. ru_stime. tv_usec / 1e6;
+	c. wakeUps	= usage. ru_nvcsw;
+	c. preemptions	= usage. ru_nivcsw;
+}
+
+static
+cpuUse	eofCpu;
+
+static
+void	*theRadio	= nullptr;
+
+static
+std::string	firstService;
+
+static
+std::atomic<int>	servicesSeen;
+//
+//	the number of ensemble snapshots announced by the library
+static
+std::atomic<uint64_t>	ensembleChanges;
+//
+//	with -A all services are decoded, each with its own sink,
+//	passed as context to the callbacks
+struct	serviceSink {
+	uint32_t	SId;
+	std::string	name;
+	bool		isAudio;
+	uint64_t	samples;
+	uint64_t	checksum;
+};
+
+static
+std::vector<serviceSink *>	sinks;
+
+static
+void	*serviceContext	(uint32_t SId, const std::string &name,
+	                 bool isAudio, void *userData) {
+serviceSink *s	= new serviceSink;
+	(void)userData;
+	s -> SId	= SId;
+	s -> name	= name;
+	s -> isAudio	= isAudio;
+	s -> samples	= 0;
+	s -> checksum	= 0xCBF29CE484222325ULL;
+	sinks. push_back (s);
+	return s;
+}
+
+//
+//	At the end of the input the thread signalling it - the device
+//	thread, or the decoder for the synthetic signal and the memory
+//	mapped file - is held until the bench has the audio checksum.
+//	Devices go on with silence after the end, that is not decoded
+static
+std::atomic<bool>	holdInput;
+
+static
+std::atomic<bool>	hashing;
+
+static
+void	inputEnded	(void *userData) {
+	(void)userData;
+	if (endOfInput. load ())
+	   return;
+	if (theRadio != nullptr)
+	   dabGetProcessingStats (theRadio, &eofStats);
+	eofTime	= std::chrono::steady_clock::now ();
+	getCpuUse (eofCpu);
+	endOfInput. store (true);
+	while (holdInput. load ())
+	   usleep (1000);
+}
+
+static
+void	name_of_ensemble (const std::string &name, int32_t Id, void *ctx) {
+	(void)ctx;
+	fprintf (stderr, "ensemble %s (%X)\n", name. c_str (), (uint32_t)Id);
+	ensembleRecognized. store (true);
+}
+
+static
+void	serviceName	(const std::string &s, int32_t SId,
+	                 uint16_t subChId, void *ctx) {
+	(void)subChId; (void)ctx;
+	fprintf (stderr, "\t%s (%X)\n", s. c_str (), (uint32_t)SId);
+	if (firstService == "")
+	   firstService = s;
+	servicesSeen. fetch_add (1);
+}
+
+static
+void	pcmHandler	(int16_t *buffer, int size, int rate,
+	                 bool isStereo, void *ctx) {
+serviceSink *s	= (serviceSink *)ctx;
+uint64_t	hash	= s == nullptr ? audioChecksum. load () :
+	                                 s -> checksum;
+	(void)rate; (void)isStereo;
+	if (!hashing. load ())
+	   return;
+	for (int i = 0; i < size; i ++) {
+	   hash ^= (uint16_t)buffer [i];
+	   hash *= 0x100000001B3ULL;
+	}
+	if (s != nullptr) {
+	   s -> checksum	= hash;
+	   s -> samples		+= size / 2;
+	   return;
+	}
+	audioChecksum. store (hash);
+	audioSamples. fetch_add (size / 2);
+}
+
+static
+void	mscQuality	(int16_t fe, int16_t rsE, int16_t aacE, void *ctx) {
+	(void)ctx;
+	lastQuality [0]. store (fe);
+	lastQuality [1]. store (rsE);
+	lastQuality [2]. store (aacE);
+}
+
+//
+//	the library calls these handlers unconditionally
+static
+void	syncsignal_Handler (bool b, void *ctx) {
+	(void)b; (void)ctx;
+}
+
+//
+//	The service is attached from the decoder thread, in the systemData
+//	callback. That callback is made after a fixed number of samples,
+//	so the audio - and its checksum - starts at the same CIF in each
+//	run. With the pipeline, the symbols before that point are first
+//	delivered to the msc handler
+static
+std::string	wantedService;
+
+static
+int		wantedWorkers;
+
+static
+std::atomic<bool>	serviceSelected;
+
+static
+void	drainPipeline	() {
+pipelineStats	ps;
+	while (dabGetPipelineStats (theRadio, &ps) &&
+	       (ps. waitingForWorker + ps. inProgress +
+	                                ps. waitingForDelivery > 0))
+	   usleep (100);
+}
+
+static
+void	selectService	() {
+	if (!ensembleRecognized. load ())
+	   return;
+//
+//	for the whole ensemble, the handlers are attached again until
+//	all services seen have one
+	if (wantedWorkers >= 0) {
+	   if ((int)sinks. size () >= servicesSeen. load ())
+	      return;
+	   drainPipeline ();
+	   std::vector<serviceSink *> old	= sinks;
+	   sinks. resize (0);
+	   int n = dabDecodeEnsemble (theRadio, wantedWorkers,
+	                                              serviceContext);
+	   for (auto s : old)	// their handlers are gone
+	      delete s;
+	   if (n > 0) {
+	      wantedService	= "all";
+	      serviceSelected. store (true);
+	   }
+	   return;
+	}
+	if (serviceSelected. load ())
+	   return;
+	std::string name = wantedService != "" ? wantedService : firstService;
+	if ((name == "") || !is_audioService (theRadio, name))
+	   return;
+	audiodata ad;
+	dataforAudioService (theRadio, name, ad, 0);
+	if (!ad. defined)
+	   return;
+	drainPipeline ();
+	set_audioChannel (theRadio, ad);
+	wantedService	= name;
+	serviceSelected. store (true);
+}
+
+static
+void	systemData	(bool flag, int16_t snr, int32_t freqOff, void *ctx) {
+	(void)flag; (void)snr; (void)freqOff; (void)ctx;
+	if (theRadio != nullptr)
+	   selectService ();
+}
+//
+//	After the end of the input, the decoder still handles the samples
+//	in the ring, the pipeline its symbols and the backends the queued
+//	CIF's. To get all audio of the input, the bench waits until none
+//	of them makes progress for 200 msec
+static
+void	waitForDecoder	() {
+uint64_t	last	= 0;
+int	quiet	= 0;
+	while (quiet < 20) {
+	   usleep (10000);
+	   processingStats ps;
+	   pipelineStats pl;
+	   serviceStats load [64];
+	   dabGetProcessingStats (theRadio, &ps);
+	   uint64_t now	= ps. samplesRead + audioSamples. load ();
+	   if (dabGetPipelineStats (theRadio, &pl))
+	      now	+= pl. symbolsDelivered;
+	   int n	= dabGetServiceStats (theRadio, load, 64);
+	   for (int i = 0; i < n; i ++)
+	      now	+= load [i]. segments;
+	   quiet	= now == last ? quiet + 1 : 0;
+	   last		= now;
+	}
+}
+
+static
+void	fibQuality	(int16_t q, void *ctx) {
+	(void)q; (void)ctx;
+}
+
+static
+void	programdata_Handler (audiodata *d, void *ctx) {
+	(void)d; (void)ctx;
+}
+
+static
+void	tii_data_Handler (tiiData *d, void *ctx) {
+	(void)d; (void)ctx;
+}
+
+static
+void	ensembleChanged	(uint64_t version, void *ctx) {
+	(void)version; (void)ctx;
+	ensembleChanges ++;
+}
+
+static
+bool	endsWith	(const std::string &s, const char *suffix) {
+size_t	l	= strlen (suffix);
+
+	return (s. size () >= l) &&
+	       (strcasecmp (s. c_str () + s. size () - l, suffix) == 0);
+}
+//
+//	the p-th percentile. Bucket i holds the times in [2^i, 2^(i + 1))
+//	ns, the value is interpolated linearly within the bucket it is
+//	in, and is never above the maximum seen
+static
+double	percentile	(const stageTiming &s, double p) {
+uint64_t target	= (uint64_t)(p / 100 * s. count);
+uint64_t seen	= 0;
+
+	if (s. count == 0)
+	   return 0;
+	for (int i = 0; i < STAGE_BUCKETS; i ++) {
+	   if (seen + s. histogram [i] > target) {
+	      double low	= i == 0 ? 0 : (double)((uint64_t)1 << i);
+	      double high	= (double)((uint64_t)2 << i);
+	      double value	= low + (high - low) *
+	                           (target - seen + 1) / s. histogram [i];
+	      return value < s. maxNs ? value : (double)s. maxNs;
+	   }
+	   seen	+= s. histogram [i];
+	}
+	return (double)s. maxNs;
+}
+
+static
+void	printReport	(FILE *f, const stageTimings &st, double wall) {
+	fprintf (f, "%-18s %10s %10s %10s %10s %10s %10s %6s\n",
+	            "stage", "count", "total ms", "mean us",
+	            "p50 us", "p99 us", "max us", "%wall");
+	for (int i = 0; i < NR_STAGES; i ++) {
+	   const stageTiming &s = st. stage [i];
+	   if (s. count == 0)
+	      continue;
+	   fprintf (f, "%-18s %10llu %10.1f %10.2f %10.2f %10.2f %10.2f %6.1f\n",
+	               s. name,
+	               (unsigned long long)s. count,
+	               s. totalNs / 1e6,
+	               s. totalNs / 1e3 / s. count,
+	               percentile (s, 50) / 1e3,
+	               percentile (s, 99) / 1e3,
+	               s. maxNs / 1e3,
+	               wall > 0 ? 100 * s. totalNs / 1e9 / wall : 0);
+	}
+}
+
+static
+void	jsonString	(FILE *f, const std::string &s) {
+	fputc ('"', f);
+	for (char c : s) {
+	   if ((c == '"') || (c == '\\'))
+	      fprintf (f, "\\%c", c);
+	   else
+	   if ((uint8_t)c < 040)
+	      fprintf (f, "\\u%04x", c);
+	   else
+	      fputc (c, f);
+	}
+	fputc ('"', f);
+}
+
+static
+void	writeJSON	(FILE *f, const std::string &input,
+	                 const std::string &kind,
+	                 const std::string &service,
+	                 double signal, double wall,
+	                 const processingStats &ps,
+	                 double audio, long peakRss,
+	                 const cpuUse &used,
+	                 const stageTimings &st,
+	                 const std::vector<serviceStats> &load,
+	                 const ensembleSnapshot &ens) {
+	fprintf (f, "{\n  \"input\": ");
+	jsonString (f, input);
+	fprintf (f, ",\n  \"kind\": ");
+	jsonString (f, kind);
+	fprintf (f, ",\n  \"service\": ");
+	jsonString (f, service);
+	fprintf (f, ",\n  \"signalSeconds\": %.3f", signal);
+	fprintf (f, ",\n  \"wallSeconds\": %.3f", wall);
+	fprintf (f, ",\n  \"realtime\": %.3f", wall > 0 ? signal / wall : 0);
+	fprintf (f, ",\n  \"frames\": %llu",
+	                        (unsigned long long)ps. framesDecoded);
+	fprintf (f, ",\n  \"audioSeconds\": %.3f", audio);
+	fprintf (f, ",\n  \"audioChecksum\": \"%016llx\"",
+	            (unsigned long long)audioChecksum. load ());
+	fprintf (f, ",\n  \"quality\": [%d, %d, %d]",
+	            lastQuality [0]. load (), lastQuality [1]. load (),
+	            lastQuality [2]. load ());
+	fprintf (f, ",\n  \"fibs\": {\"parsed\": %llu, \"skipped\": %llu, \"crcErrors\": %llu}",
+	            (unsigned long long)ps. fibsParsed,
+	            (unsigned long long)ps. fibsSkipped,
+	            (unsigned long long)ps. fibsFailed);
+	fprintf (f, ",\n  \"ensemble\": {\"services\": %d, \"components\": %d, \"subchannels\": %d, \"version\": %llu, \"changes\": %llu}",
+	            (int)ens. services. size (),
+	            (int)ens. components. size (),
+	            (int)ens. subchannels. size (),
+	            (unsigned long long)ens. version,
+	            (unsigned long long)ensembleChanges. load ());
+	fprintf (f, ",\n  \"peakRssKb\": %ld", peakRss);
+	fprintf (f, ",\n  \"cpuSeconds\": %.3f", used. seconds);
+	fprintf (f, ",\n  \"wakeUpsPerSecond\": %.1f",
+	            wall > 0 ? used. wakeUps / wall : 0);
+	fprintf (f, ",\n  \"preemptionsPerSecond\": %.1f",
+	            wall > 0 ? used. preemptions / wall : 0);
+	fprintf (f, ",\n  \"viterbiKernel\": \"%s\"",
+	            viterbiSpiral::kernelName (viterbiSpiral::currentKernel ()));
+	if (sinks. size () > 0) {
+	   fprintf (f, ",\n  \"services\": [");
+	   for (size_t i = 0; i < sinks. size (); i ++) {
+	      uint64_t cpuNs	= 0;
+	      for (auto &l : load)
+	         if (l. SId == sinks [i] -> SId)
+	            cpuNs += l. cpuNs;
+	      fprintf (f, "%s\n    {\"SId\": \"%X\", \"name\": ",
+	                  i == 0 ? "" : ",", sinks [i] -> SId);
+	      jsonString (f, sinks [i] -> name);
+	      fprintf (f, ", \"audio\": %s, \"audioSeconds\": %.3f, \"audioChecksum\": \"%016llx\", \"cpuSeconds\": %.3f}",
+	                  sinks [i] -> isAudio ? "true" : "false",
+	                  sinks [i] -> samples / 48000.0,
+	                  (unsigned long long)sinks [i] -> checksum,
+	                  cpuNs / 1e9);
+	   }
+	   fprintf (f, "\n  ]");
+	}
+	fprintf (f, ",\n  \"stages\": {");
+	for (int i = 0; i < NR_STAGES; i ++) {
+	   const stageTiming &s = st. stage [i];
+	   int last	= STAGE_BUCKETS - 1;
+	   while ((last > 0) && (s. histogram [last] == 0))
+	      last --;
+	   fprintf (f, "%s\n    \"%s\": {\"count\": %llu, \"totalNs\": %llu, "
+	               "\"minNs\": %llu, \"maxNs\": %llu, \"histogram\": [",
+	               i == 0 ? "" : ",", s. name,
+	               (unsigned long long)s. count,
+	               (unsigned long long)s. totalNs,
+	               (unsigned long long)s. minNs,
+	               (unsigned long long)s. maxNs);
+	   for (int j = 0; j <= last; j ++)
+	      fprintf (f, "%s%llu", j == 0 ? "" : ", ",
+	                  (unsigned long long)s. histogram [j]);
+	   fprintf (f, "]}");
+	}
+	fprintf (f, "\n  }\n}\n");
+}
+
+//
+//	The Viterbi kernels: decoded Mbit/s per kernel, for blocks of
+//	3072 bits (a 128 kbit/s subchannel). The soft bits are random,
+//	the time does not depend on them, and all kernels should give
+//	the output of the first one
+#define	BENCH_BITS	3072
+
+struct	kernelResult {
+	std::string	name;
+	bool		agrees;
+	double		mbps;
+};
+
+static
+void	viterbiBench	(std::vector<kernelResult> &results) {
+viterbiSpiral	decoder (BENCH_BITS);
+std::vector<int16_t> input ((BENCH_BITS + 6) * 4);
+std::vector<uint8_t> reference (BENCH_BITS);
+std::vector<uint8_t> output (BENCH_BITS);
+std::mt19937	generator (1);
+std::uniform_int_distribution<int> softBit (-127, 127);
+int	defaultKernel	= viterbiSpiral::currentKernel ();
+
+	for (auto &x : input)
+	   x = softBit (generator);
+	for (int k = 0; k < viterbiSpiral::nrKernels (); k ++) {
+	   if (!viterbiSpiral::setKernel (k))
+	      continue;
+	   decoder. deconvolve (input. data (), output. data ());
+	   if (results. size () == 0)
+	      reference = output;
+	   kernelResult r;
+	   r. name	= viterbiSpiral::kernelName (k);
+	   r. agrees	= output == reference;
+	   int	rounds	= 0;
+	   std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	   double elapsed;
+	   do {
+	      for (int i = 0; i < 50; i ++)
+	         decoder. deconvolve (input. data (), output. data ());
+	      rounds	+= 50;
+	      elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	   } while (elapsed < 0.5);
+	   r. mbps	= (double)rounds * BENCH_BITS / elapsed / 1e6;
+	   results. push_back (r);
+	}
+	viterbiSpiral::setKernel (defaultKernel);
+}
+
+static
+void	printOptions	() {
+	fprintf (stderr,
+"dab-bench options are\n"
+"	-f file\tdecode a recording (.raw/.iq/.sdr u8 IQ, .wav, .xml/.uff)\n"
+"	\twithout -f a synthetic signal is generated\n"
+"	-m\tread the (raw or xml) recording from a memory mapping\n"
+"	-s seconds\twith -m, start at this time in the recording\n"
+"	-d seconds\tlength of the synthetic signal, default 30\n"
+"	-S snr\tSNR (dB) of the synthetic signal, default 20\n"
+"	-o file\twrite the synthetic signal as u8 IQ file and exit\n"
+"	-P name\tthe service to decode, default the first one found\n"
+"	-A workers\tdecode all services of the ensemble on a pool of\n"
+"	\tworkers (0 is one per core), report the load per service\n"
+"	-W workers\tuse the OFDM worker pipeline\n"
+"	-b\tbatch the FFT's of a frame\n"
+"	-r\tread the recording paced, as from a device, to see the\n"
+"	\tcpu use and the wake ups\n"
+"	-M mode\tDAB mode, default 1\n"
+"	-t seconds\twait at most this long for the ensemble, default 10\n"
+"	-V\tonly compare the speed of the Viterbi kernels\n"
+"	-E\tonly check and time the depuncturing/deconvolution per\n"
+"	\tprotection profile\n"
+"	-I\tonly check and time the time deinterleaver, up to the\n"
+"	\tlargest subchannel\n"
+"	-R\tonly check and time the Reed-Solomon decoding of superframes\n"
+"	-L\tonly check and time the MP2 (layer II) decoder\n"
+"	-F\tonly check and time the packed path from the deconvolution\n"
+"	\tto the audio decoders against the bit per byte one\n"
+"	-T\tonly check and time the batched FFT of a frame against the\n"
+"	\tFFT per block, for modes I - IV\n"
+"	-D\tonly check and time the kernels of the soft bit demapper\n"
+"	-C\tonly check and time the sample rate converter of the devices\n"
+"	-X\tonly check and time the conversion of the device samples\n"
+"	-Q\tonly check and time the RingBuffer against the former one\n"
+"	-N n\tonly decode the input with n concurrent instances, and\n"
+"	\tcheck each against a single instance\n"
+"	-j file\twrite the report as JSON to file (- is stdout)\n");
+}
+
+int	main	(int argc, char **argv) {
+std::string	fileName	= "";
+bool		mapped		= false;
+double		startSeconds	= 0;
+std::string	rawOut		= "";
+std::string	jsonFile	= "";
+std::string	service		= "";
+double		seconds		= 30;
+float		snr		= 20;
+int		workers		= 0;
+bool		batchFFT	= false;
+bool		realtime	= false;
+uint8_t		theMode		= 1;
+int		timeOut		= 10;
+bool		kernelsOnly	= false;
+bool		profilesOnly	= false;
+bool		interleaveOnly	= false;
+bool		rsOnly		= false;
+bool		mp2Only		= false;
+bool		framesOnly	= false;
+bool		fftOnly		= false;
+bool		demapOnly	= false;
+bool		rateOnly	= false;
+bool		iqOnly		= false;
+bool		ringOnly	= false;
+int		instances	= 0;
+int		ensembleWorkers	= -1;	// default, a single service
+deviceHandler	*theDevice;
+std::string	kind;
+int	opt;
+
+	while ((opt = getopt (argc, argv, "f:ms:d:S:o:P:A:W:brM:t:VEIRLFTDCXQN:j:h")) != -1) {
+	   switch (opt) {
+	      case 'f':
+	         fileName	= optarg;
+	         break;
+	      case 'm':
+	         mapped		= true;
+	         break;
+	      case 's':
+	         startSeconds	= atof (optarg);
+	         break;
+	      case 'd':
+	         seconds	= atof (optarg);
+	         break;
+	      case 'S':
+	         snr		= atof (optarg);
+	         break;
+	      case 'o':
+	         rawOut		= optarg;
+	         break;
+	      case 'P':
+	         service	= optarg;
+	         break;
+	      case 'A':
+	         ensembleWorkers	= atoi (optarg);
+	         break;
+	      case 'W':
+	         workers	= atoi (optarg);
+	         break;
+	      case 'b':
+	         batchFFT	= true;
+	         break;
+	      case 'r':
+	         realtime	= true;
+	         break;
+	      case 'M':
+	         theMode	= atoi (optarg);
+	         if (!((theMode == 1) || (theMode == 2) || (theMode == 4)))
+	            theMode = 1;
+	         break;
+	      case 't':
+	         timeOut	= atoi (optarg);
+	         break;
+	      case 'V':
+	         kernelsOnly	= true;
+	         break;
+	      case 'E':
+	         profilesOnly	= true;
+	         break;
+	      case 'I':
+	         interleaveOnly	= true;
+	         break;
+	      case 'R':
+	         rsOnly		= true;
+	         break;
+	      case 'L':
+	         mp2Only	= true;
+	         break;
+	      case 'F':
+	         framesOnly	= true;
+	         break;
+	      case 'T':
+	         fftOnly	= true;
+	         break;
+	      case 'D':
+	         demapOnly	= true;
+	         break;
+	      case 'C':
+	         rateOnly	= true;
+	         break;
+	      case 'X':
+	         iqOnly		= true;
+	         break;
+	      case 'Q':
+	         ringOnly	= true;
+	         break;
+	      case 'N':
+	         instances	= atoi (optarg);
+	         break;
+	      case 'j':
+	         jsonFile	= optarg;
+	         break;
+	      default:
+	         printOptions ();
+	         exit (1);
+	   }
+	}
+
+	if (kernelsOnly) {
+	   std::vector<kernelResult> results;
+	   viterbiBench (results);
+	   for (auto &r : results)
+	      fprintf (stderr, "%-10s %8.1f Mbit/s %6.2f x%s\n",
+	                       r. name. c_str (), r. mbps,
+	                       r. mbps / results [0]. mbps,
+	                       r. agrees ? "" : "  (output differs)");
+	   fprintf (stderr, "default kernel %s\n",
+	            viterbiSpiral::kernelName (viterbiSpiral::currentKernel ()));
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"viterbi\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"kernel\": \"%s\", \"mbps\": %.1f, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. name. c_str (),
+	                     results [i]. mbps,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   for (auto &r : results)
+	      if (!r. agrees)
+	         return 1;
+	   return 0;
+	}
+
+	if (profilesOnly) {
+	   std::vector<protectionResult> results;
+	   int	failures	= 0;
+	   protectionBench (results);
+	   fprintf (stderr, "%-8s %8s %8s %14s %14s\n", "profile",
+	                    "kbit/s", "bits in", "depuncture ns", "deconvolve ns");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-8s %8d %8d %14.0f %14.0f%s\n",
+	                       r. name. c_str (), r. bitRate, r. inputBits,
+	                       r. depunctureNs, r. deconvolveNs,
+	                       r. ok ? "" : "  (decoding fails)");
+	      if (!r. ok)
+	         failures ++;
+	   }
+	   fprintf (stderr, "%d profiles, %d failures\n",
+	                    (int)results. size (), failures);
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"protection\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"profile\": \"%s\", \"bitRate\": %d, \"inputBits\": %d, \"depunctureNs\": %.0f, \"deconvolveNs\": %.0f, \"ok\": %s}",
+	                     i == 0 ? "" : ",", results [i]. name. c_str (),
+	                     results [i]. bitRate, results [i]. inputBits,
+	                     results [i]. depunctureNs,
+	                     results [i]. deconvolveNs,
+	                     results [i]. ok ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (interleaveOnly) {
+	   std::vector<interleaveResult> results;
+	   int	failures	= 0;
+	   interleaveBench (results);
+	   fprintf (stderr, "%6s %10s %14s %14s %8s\n", "CU's",
+	                    "soft bits", "16 rows ns", "new ns", "speedup");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%6d %10d %14.0f %14.0f %8.2f%s\n",
+	                       r. CUs, r. CUs * 64, r. rowsNs, r. newNs,
+	                       r. rowsNs / r. newNs,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"deinterleave\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"CUs\": %d, \"rowsNs\": %.0f, \"newNs\": %.0f, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. CUs,
+	                     results [i]. rowsNs, results [i]. newNs,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (rsOnly) {
+	   std::vector<rsResult> results;
+	   int	failures	= 0;
+	   rsBench (results);
+	   fprintf (stderr, "%-12s %9s %-16s %-7s %11s %11s %8s\n", "code",
+	                    "codewords", "errors", "kernel",
+	                    "dec sf/s", "batch sf/s", "speedup");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-12s %9d %-16s %-7s %11.0f %11.0f %8.2f%s\n",
+	                       r. code. c_str (), r. codewords,
+	                       r. errors. c_str (), r. kernel. c_str (),
+	                       r. loopRate, r. batchRate,
+	                       r. batchRate / r. loopRate,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"reedSolomon\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"code\": \"%s\", \"codewords\": %d, \"errors\": \"%s\", \"kernel\": \"%s\", \"decRate\": %.0f, \"batchRate\": %.0f, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. code. c_str (),
+	                     results [i]. codewords,
+	                     results [i]. errors. c_str (),
+	                     results [i]. kernel. c_str (),
+	                     results [i]. loopRate, results [i]. batchRate,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (mp2Only) {
+	   std::vector<mp2Result> results;
+	   int	failures	= 0;
+	   mp2Bench (results);
+	   fprintf (stderr, "%-24s %-10s %7s %12s %8s\n", "stream",
+	                    "kernel", "frames", "ns/frame", "speedup");
+	   double referenceNs	= 0;
+	   for (auto &r : results) {
+//	the reference kernel comes first for each stream
+	      if (r. kernel == "reference")
+	         referenceNs	= r. frameNs;
+	      fprintf (stderr, "%-24s %-10s %7d %12.0f %8.2f%s\n",
+	                       r. config. c_str (), r. kernel. c_str (),
+	                       r. frames, r. frameNs,
+	                       referenceNs / r. frameNs,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"mp2\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"stream\": \"%s\", \"kernel\": \"%s\", \"frames\": %d, \"frameNs\": %.0f, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. config. c_str (),
+	                     results [i]. kernel. c_str (),
+	                     results [i]. frames, results [i]. frameNs,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (framesOnly) {
+	   std::vector<frameResult> results;
+	   int	failures	= 0;
+	   frameBench (results);
+	   fprintf (stderr, "%-22s %7s %8s %8s %14s %14s %8s\n", "subchannel",
+	                    "frames", "samples", "reports",
+	                    "bits ns/frame", "packed ns/fr", "speedup");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-22s %7d %8d %8d %14.0f %14.0f %8.2f%s\n",
+	                       r. config. c_str (), r. frames, r. samples,
+	                       r. reports, r. bitNs, r. packedNs,
+	                       r. bitNs / r. packedNs,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"framePath\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"subchannel\": \"%s\", \"frames\": %d, \"samples\": %d, \"reports\": %d, \"bitNs\": %.0f, \"packedNs\": %.0f, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. config. c_str (),
+	                     results [i]. frames, results [i]. samples,
+	                     results [i]. reports,
+	                     results [i]. bitNs, results [i]. packedNs,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (fftOnly) {
+	   std::vector<fftResult> results;
+	   int	failures	= 0;
+	   fftBench (results);
+	   fprintf (stderr, "%-5s %-9s %7s %5s %13s %13s %8s %10s\n",
+	                    "mode", "planning", "blocks", "T_u",
+	                    "block ns/fr", "batch ns/fr", "speedup",
+	                    "max error");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-5d %-9s %7d %5d %13.0f %13.0f %8.2f %10.2e%s\n",
+	                       r. mode, r. planning. c_str (), r. symbols,
+	                       r. size, r. symbolNs, r. batchNs,
+	                       r. symbolNs / r. batchNs, r. maxError,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"fft\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"mode\": %d, \"planning\": \"%s\", \"blocks\": %d, \"size\": %d, \"blockNs\": %.0f, \"batchNs\": %.0f, \"maxError\": %.3e, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. mode,
+	                     results [i]. planning. c_str (),
+	                     results [i]. symbols, results [i]. size,
+	                     results [i]. symbolNs, results [i]. batchNs,
+	                     results [i]. maxError,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (demapOnly) {
+	   std::vector<demapResult> results;
+	   int	failures	= 0;
+	   demapBench (results);
+	   fprintf (stderr, "%-5s %-7s %11s %11s %8s %14s\n",
+	                    "mode", "kernel", "ns/symbol", "former ns",
+	                    "speedup", "former differs");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-5d %-7s %11.0f %11.0f %8.2f %8d (<= %d)%s\n",
+	                       r. mode, r. kernel. c_str (), r. symbolNs,
+	                       r. formerNs, r. formerNs / r. symbolNs,
+	                       r. formerDiffers, r. formerMaxDiff,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"demapper\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"mode\": %d, \"kernel\": \"%s\", \"symbolNs\": %.0f, \"formerNs\": %.0f, \"formerDiffers\": %d, \"formerMaxDiff\": %d, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. mode,
+	                     results [i]. kernel. c_str (),
+	                     results [i]. symbolNs, results [i]. formerNs,
+	                     results [i]. formerDiffers,
+	                     results [i]. formerMaxDiff,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (rateOnly) {
+	   std::vector<rateResult> results;
+	   int	failures	= 0;
+	   rateBench (results);
+	   fprintf (stderr, "%-7s %9s %9s %5s %-7s %8s %8s %9s %9s %9s\n",
+	                    "device", "rate", "L/M", "taps", "kernel",
+	                    "MS/s", "linear", "pass dB", "stop dB", "linear");
+	   for (auto &r : results) {
+	      char ratio [32];
+	      snprintf (ratio, sizeof (ratio), "%d/%d", r. L, r. M);
+	      fprintf (stderr, "%-7s %9d %9s %5d %-7s %8.1f %8.1f %9.3f ",
+	                       r. device. c_str (), r. inRate, ratio, r. taps,
+	                       r. kernel. c_str (), r. msps, r. linearMsps,
+	                       r. passbandDb);
+	      if (r. stopbandDb == 0)
+	         fprintf (stderr, "%9s %9s", "-", "-");
+	      else
+	         fprintf (stderr, "%9.1f %9.1f", r. stopbandDb,
+	                                         r. linearStopbandDb);
+	      fprintf (stderr, "%s\n", r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"rateConverter\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"device\": \"%s\", \"rate\": %d, \"L\": %d, \"M\": %d, \"taps\": %d, \"kernel\": \"%s\", \"msps\": %.1f, \"linearMsps\": %.1f, \"passbandDb\": %.3f, \"stopbandDb\": %.1f, \"linearStopbandDb\": %.1f, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. device. c_str (),
+	                     results [i]. inRate, results [i]. L,
+	                     results [i]. M, results [i]. taps,
+	                     results [i]. kernel. c_str (),
+	                     results [i]. msps, results [i]. linearMsps,
+	                     results [i]. passbandDb,
+	                     results [i]. stopbandDb,
+	                     results [i]. linearStopbandDb,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (iqOnly) {
+	   std::vector<iqResult> results;
+	   int	failures	= 0;
+	   iqBench (results);
+	   fprintf (stderr, "%-9s %-7s %9s %9s %8s\n",
+	                    "format", "kernel", "MS/s", "former", "load %");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-9s %-7s %9.1f %9.1f %8.2f%s\n",
+	                       r. format. c_str (), r. kernel. c_str (),
+	                       r. msps, r. formerMsps, r. load,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"iqConverter\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"format\": \"%s\", \"kernel\": \"%s\", \"msps\": %.1f, \"formerMsps\": %.1f, \"loadPercent\": %.3f, \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. format. c_str (),
+	                     results [i]. kernel. c_str (),
+	                     results [i]. msps, results [i]. formerMsps,
+	                     results [i]. load,
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (ringOnly) {
+	   std::vector<ringResult> results;
+	   int	failures	= 0;
+	   ringBench (results);
+	   fprintf (stderr, "%-22s %-10s %12s\n", "test", "ring", "value");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-22s %-10s %12.1f %s%s\n",
+	                       r. test. c_str (), r. ring. c_str (),
+	                       r. value, r. unit. c_str (),
+	                       r. agrees ? "" : "  (data differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"ringBuffer\": [");
+	      for (size_t i = 0; i < results. size (); i ++)
+	         fprintf (f, "%s\n    {\"test\": \"%s\", \"ring\": \"%s\", \"value\": %.1f, \"unit\": \"%s\", \"agrees\": %s}",
+	                     i == 0 ? "" : ",", results [i]. test. c_str (),
+	                     results [i]. ring. c_str (),
+	                     results [i]. value, results [i]. unit. c_str (),
+	                     results [i]. agrees ? "true" : "false");
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	if (instances > 0) {
+	   std::vector<instanceResult> results;
+	   int	failures	= 0;
+	   if (fileName == "") {
+	      theMode	= 1;
+	      if (service == "")
+	         service = SYNTHETIC_DAB_PLUS;
+	   }
+	   if (!instanceBench (fileName, mapped, seconds, snr, service,
+	                       theMode, instances, timeOut, results)) {
+	      fprintf (stderr, "cannot open %s\n", fileName. c_str ());
+	      exit (1);
+	   }
+	   fprintf (stderr, "%-9s %-20s %10s %-16s %8s\n", "instance",
+	                    "service", "audio sec", "checksum", "wall sec");
+	   for (auto &r : results) {
+	      fprintf (stderr, "%-9s %-20s %10.2f %016llx %8.2f%s\n",
+	                       r. instance == 0 ? "single" :
+	                             std::to_string (r. instance). c_str (),
+	                       r. service. c_str (), r. samples / 48000.0,
+	                       (unsigned long long)r. checksum, r. wall,
+	                       r. agrees ? "" : "  (output differs)");
+	      if (!r. agrees)
+	         failures ++;
+	   }
+	   FILE *f = jsonFile == "" ? nullptr :
+	             jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f != nullptr) {
+	      fprintf (f, "{\n  \"instances\": [");
+	      for (size_t i = 0; i < results. size (); i ++) {
+	         fprintf (f, "%s\n    {\"instance\": %d, \"service\": ",
+	                     i == 0 ? "" : ",", results [i]. instance);
+	         jsonString (f, results [i]. service);
+	         fprintf (f, ", \"audioSeconds\": %.3f, \"audioChecksum\": \"%016llx\", \"wallSeconds\": %.3f, \"agrees\": %s}",
+	                     results [i]. samples / 48000.0,
+	                     (unsigned long long)results [i]. checksum,
+	                     results [i]. wall,
+	                     results [i]. agrees ? "true" : "false");
+	      }
+	      fprintf (f, "\n  ]\n}\n");
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	   return failures == 0 ? 0 : 1;
+	}
+
+	endOfInput. store (false);
+	holdInput. store (true);
+	hashing. store (true);
+	ensembleRecognized. store (false);
+	servicesSeen. store (0);
+	audioSamples. store (0);
+	audioChecksum. store (0xCBF29CE484222325ULL);
+	for (int i = 0; i < 3; i ++)
+	   lastQuality [i]. store (-1);
+
+	try {
+	   if (fileName == "") {
+	      kind	= "synthetic";
+	      theMode	= 1;
+	      syntheticSignal *s = new syntheticSignal (seconds, snr,
+	                                                inputEnded, nullptr);
+	      if (rawOut != "") {
+	         bool ok = s -> writeRaw (rawOut);
+	         delete s;
+	         fprintf (stderr, ok ? "%s written\n" : "writing %s failed\n",
+	                                             rawOut. c_str ());
+	         exit (ok ? 0 : 1);
+	      }
+	      if (service == "")
+	         service = SYNTHETIC_DAB_PLUS;
+	      theDevice	= s;
+	   }
+	   else
+	   if (endsWith (fileName, ".wav")) {
+	      kind	= "wav";
+	      theDevice	= new wavFiles (fileName, 0.0, inputEnded, nullptr);
+	   }
+	   else
+	   if (mapped) {
+	      kind	= "mmap";
+	      mmapFileHandler *f = new mmapFileHandler (fileName, false,
+	                                                inputEnded, nullptr);
+	      if (!f -> seekTime (startSeconds)) {
+	         fprintf (stderr, "%s is shorter than %.1f seconds\n",
+	                           fileName. c_str (), startSeconds);
+	         exit (1);
+	      }
+	      theDevice	= f;
+	   }
+	   else
+	   if (endsWith (fileName, ".xml") || endsWith (fileName, ".uff")) {
+	      kind	= "xml";
+	      theDevice	= new xml_fileReader (fileName, false,
+	                                      inputEnded, nullptr);
+	   }
+	   else {
+	      kind	= "raw";
+	      theDevice	= new rawFiles (fileName, 0.0, inputEnded, nullptr);
+	   }
+	}
+	catch (std::exception &ex) {
+	   fprintf (stderr, "Exception : %s\n", ex. what ());
+	   exit (1);
+	}
+	catch (...) {
+	   fprintf (stderr, "cannot open %s\n", fileName. c_str ());
+	   exit (1);
+	}
+
+	API_struct interface;
+	memset ((void *)&interface, 0, sizeof (interface));
+	interface. dabMode		= theMode;
+	interface. thresholdValue	= 6;
+	interface. syncsignal_Handler	= syncsignal_Handler;
+	interface. systemdata_Handler	= systemData;
+	interface. name_of_ensemble	= name_of_ensemble;
+	interface. serviceName		= serviceName;
+	interface. audioOut_Handler	= pcmHandler;
+	interface. fib_quality_Handler	= fibQuality;
+	interface. programdata_Handler	= programdata_Handler;
+	interface. program_quality_Handler	= mscQuality;
+	interface. tii_data_Handler	= tii_data_Handler;
+	interface. ensembleChanged_Handler	= ensembleChanged;
+
+	wantedService	= service;
+	wantedWorkers	= ensembleWorkers;
+	serviceSelected. store (false);
+	theRadio	= dabInit (theDevice, &interface, nullptr, nullptr, nullptr);
+	if (theRadio == nullptr) {
+	   fprintf (stderr, "initializing the library failed\n");
+	   exit (4);
+	}
+	if (workers > 0)
+	   dabSetPipeline (theRadio, workers);
+	if (batchFFT)
+	   dabSetBatchFFT (theRadio, true);
+	theDevice	-> setUnthrottled (!realtime);
+
+	dabStageTimings (true);
+	cpuUse	startCpu;
+	getCpuUse (startCpu);
+	std::chrono::steady_clock::time_point startTime =
+	                                 std::chrono::steady_clock::now ();
+	theDevice	-> restartReader (227360000);
+	dabStartProcessing (theRadio);
+//
+//	the service is selected - by the decoder thread - as soon as it
+//	is known, the decoding of the input goes on meanwhile. The bench
+//	itself wakes up 10 times per second
+	int	ticks		= 0;
+	while (!endOfInput. load ()) {
+	   usleep (100000);
+	   ticks ++;
+	   if (!serviceSelected. load () && (ticks > 10 * timeOut)) {
+	      fprintf (stderr, "no (audio) service found within %d seconds\n",
+	                                                        timeOut);
+	      break;
+	   }
+	}
+	bool	selected	= serviceSelected. load ();
+	if (endOfInput. load ())
+	   waitForDecoder ();
+	hashing. store (false);
+	holdInput. store (false);
+	service	= wantedService;
+
+	processingStats	ps;
+	std::chrono::steady_clock::time_point endTime;
+	cpuUse	used;
+	if (endOfInput. load ()) {
+	   ps		= eofStats;
+	   endTime	= eofTime;
+	   used		= eofCpu;
+	}
+	else {
+	   dabGetProcessingStats (theRadio, &ps);
+	   endTime	= std::chrono::steady_clock::now ();
+	   getCpuUse (used);
+	}
+	used. seconds		-= startCpu. seconds;
+	used. wakeUps		-= startCpu. wakeUps;
+	used. preemptions	-= startCpu. preemptions;
+	std::vector<serviceStats> load (64);
+	load. resize (dabGetServiceStats (theRadio, load. data (),
+	                                                  load. size ()));
+	theDevice	-> stopReader ();
+	dabStop (theRadio);
+	stageTimings	st;
+	dabGetStageTimings (&st);
+	dabStageTimings (false);
+
+	double wall	=
+	           std::chrono::duration<double> (endTime - startTime). count ();
+	double signal	= ps. samplesRead / (double)INPUT_RATE;
+	double audio	= audioSamples. load () / 48000.0;
+	struct rusage usage;
+	getrusage (RUSAGE_SELF, &usage);
+
+	printReport (stderr, st, wall);
+	fprintf (stderr, "%.1f sec of signal in %.2f sec, %.2f x realtime, %llu frames, %.1f sec audio, peak RSS %ld kB\n",
+	                 signal, wall, wall > 0 ? signal / wall : 0,
+	                 (unsigned long long)ps. framesDecoded,
+	                 audio, usage. ru_maxrss);
+	fprintf (stderr, "cpu %.2f sec (%.1f %% of a core), %.0f wake ups/s, %.0f preemptions/s\n",
+	                 used. seconds,
+	                 wall > 0 ? 100 * used. seconds / wall : 0,
+	                 wall > 0 ? used. wakeUps / wall : 0,
+	                 wall > 0 ? used. preemptions / wall : 0);
+	fprintf (stderr, "FIB's: %llu parsed, %llu skipped (repeated), %llu CRC errors\n",
+	                 (unsigned long long)ps. fibsParsed,
+	                 (unsigned long long)ps. fibsSkipped,
+	                 (unsigned long long)ps. fibsFailed);
+	std::shared_ptr<const ensembleSnapshot> ens = dabGetEnsemble (theRadio);
+	fprintf (stderr, "ensemble: %d services, %d components, %d subchannels, snapshot version %llu (%llu changes announced)\n",
+	                 (int)ens -> services. size (),
+	                 (int)ens -> components. size (),
+	                 (int)ens -> subchannels. size (),
+	                 (unsigned long long)ens -> version,
+	                 (unsigned long long)ensembleChanges. load ());
+	if (sinks. size () == 0)
+	   fprintf (stderr, "audio checksum %016llx\n",
+	                 (unsigned long long)audioChecksum. load ());
+	for (auto s : sinks) {
+	   uint64_t cpuNs	= 0;
+	   for (auto &l : load)
+	      if (l. SId == s -> SId)
+	         cpuNs += l. cpuNs;
+	   fprintf (stderr, "%-16s %8X %5s %8.1f sec audio %016llx, cpu %8.1f ms, %5.2f %% of the signal time\n",
+	                    s -> name. c_str (), s -> SId,
+	                    s -> isAudio ? "audio" : "data",
+	                    s -> samples / 48000.0,
+	                    (unsigned long long)s -> checksum,
+	                    cpuNs / 1e6,
+	                    signal > 0 ? 100 * cpuNs / 1e9 / signal : 0);
+	}
+
+	if (jsonFile != "") {
+	   FILE *f = jsonFile == "-" ? stdout : fopen (jsonFile. c_str (), "w");
+	   if (f == nullptr)
+	      fprintf (stderr, "cannot open %s\n", jsonFile. c_str ());
+	   else {
+	      writeJSON (f, fileName == "" ? "synthetic" : fileName,
+	                 kind, service, signal, wall, ps,
+	                 audio, usage. ru_maxrss, used, st, load, *ens);
+	      if (f != stdout)
+	         fclose (f);
+	   }
+	}
+	dabExit (theRadio);
+	delete theDevice;
+	for (auto s : sinks)
+	   delete s;
+	return selected ? 0 : 2;
+}
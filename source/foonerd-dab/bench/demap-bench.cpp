@@ -0,0 +1,193 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"demap-bench.h"
+#include	"ofdm-demapper.h"
+#include	"freq-interleaver.h"
+#include	"dab-params.h"
+#include	<stdlib.h>
+#include	<math.h>
+#include	<chrono>
+#include	<random>
+
+template <typename F>
+static
+double	timeIt	(F f) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   f ();
+	   rounds ++;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.2);
+	return elapsed * 1e9 / rounds;
+}
+
+static
+int	maxDifference	(const std::vector<int16_t> &a,
+	                 const std::vector<int16_t> &b) {
+int	d	= 0;
+	for (size_t i = 0; i < a. size (); i ++)
+	   if (abs (a [i] - b [i]) > d)
+	      d = abs (a [i] - b [i]);
+	return d;
+}
+//
+//	the loop of ofdmDecoder::decode before the demapper
+static
+void	formerDemap	(interLeaver &myMapper, int carriers, int T_u,
+	                 const std::complex<float> *spectrum,
+	                 const std::complex<float> *reference,
+	                 int16_t *ibits) {
+	for (int i = 0; i < carriers; i ++) {
+	   int16_t	index	= myMapper. mapIn (i);
+	   if (index < 0) 
+	      index += T_u;
+	   std::complex<float>	r1 = spectrum [index] * conj (reference [index]);
+	   float ab1		= abs (r1);
+	   ibits [i]		= - (real (r1) * 128) / ab1;
+	   ibits [carriers + i] = - (imag (r1) * 128) / ab1;
+	}
+}
+
+//
+//	the amplitudes vary over a wide range, as they do after the FFT,
+//	one bin in 64 is zero, the former loop gives undefined
+//	bits for a zero product, those bins are not compared
+static
+void	randomSymbol	(std::mt19937 &generator,
+	                 std::vector<std::complex<float>> &spectrum,
+	                 std::vector<std::complex<float>> &reference) {
+std::normal_distribution<float> gauss (0, 1);
+std::uniform_real_distribution<float> level (-3, 3);
+	for (size_t i = 0; i < spectrum. size (); i ++) {
+	   float a	= powf (10, level (generator));
+	   spectrum [i]		= a * std::complex<float> (gauss (generator),
+	                                                   gauss (generator));
+	   reference [i]	= std::complex<float> (gauss (generator),
+	                                               gauss (generator));
+	   if (i % 64 == 17)
+	      spectrum [i]	= 0;
+	}
+}
+//
+//	a difference of 1 shows up in a few carriers in some thousands,
+//	so the kernels are compared over a few hundred symbols
+#define	CHECK_SYMBOLS	500
+
+void	demapBench	(std::vector<demapResult> &results) {
+static const int modes [] = {1, 2, 3, 4};
+static const int kernels [] = {DEMAP_SCALAR, DEMAP_SSE2,
+	                       DEMAP_AVX2, DEMAP_NEON};
+const int nKernels	= sizeof (kernels) / sizeof (kernels [0]);
+std::mt19937	generator (4);
+
+	for (int mode : modes) {
+	   dabParams	params (mode);
+	   int	T_u		= params. get_T_u ();
+	   int	carriers	= params. get_carriers ();
+	   interLeaver	myMapper (mode);
+	   ofdmDemapper	demapper (mode);
+	   std::vector<std::complex<float>> spectrum (T_u);
+	   std::vector<std::complex<float>> reference (T_u);
+	   std::vector<std::complex<float>> products (T_u);
+	   std::vector<int16_t> scalarBits (2 * carriers);
+	   std::vector<int16_t> ibits (2 * carriers);
+	   std::vector<int16_t> formerBits (2 * carriers);
+	   int	formerDiffers	= 0;
+	   int	formerMaxDiff	= 0;
+	   int	maxDiff [nKernels]	= {0};
+	   bool	available [nKernels];
+	   for (int k = 0; k < nKernels; k ++)
+	      available [k] = demapper. setKernel (kernels [k]);
+
+	   for (int n = 0; n < CHECK_SYMBOLS; n ++) {
+	      randomSymbol (generator, spectrum, reference);
+	      demapper. setKernel (DEMAP_SCALAR);
+	      demapper. demap (spectrum. data (), reference. data (),
+	                                              scalarBits. data ());
+	      formerDemap (myMapper, carriers, T_u, spectrum. data (),
+	                           reference. data (), formerBits. data ());
+	      for (int i = 0; i < carriers; i ++) {
+	         int bin	= myMapper. mapIn (i);
+	         if (bin < 0)
+	            bin += T_u;
+	         if (spectrum [bin] == std::complex<float> (0, 0))
+	            continue;
+	         for (int j = i; j < 2 * carriers; j += carriers) {
+	            int d	= abs (formerBits [j] - scalarBits [j]);
+	            if (d > 0)
+	               formerDiffers ++;
+	            if (d > formerMaxDiff)
+	               formerMaxDiff = d;
+	         }
+	      }
+	      for (int k = 0; k < nKernels; k ++) {
+	         if (!available [k])
+	            continue;
+	         demapper. setKernel (kernels [k]);
+//	the path for the constellation, block 2, is checked with the
+//	scalar kernel
+	         if (kernels [k] == DEMAP_SCALAR)
+	            demapper. demap (spectrum. data (), reference. data (),
+	                             ibits. data (), products. data ());
+	         else
+	            demapper. demap (spectrum. data (), reference. data (),
+	                                                   ibits. data ());
+	         int d	= maxDifference (ibits, scalarBits);
+	         if (d > maxDiff [k])
+	            maxDiff [k] = d;
+	      }
+	   }
+
+	   double formerNs	= timeIt ([&] () {
+	                     formerDemap (myMapper, carriers, T_u,
+	                                  spectrum. data (), reference. data (),
+	                                  formerBits. data ()); });
+	   for (int k = 0; k < nKernels; k ++) {
+	      if (!available [k])
+	         continue;
+	      demapper. setKernel (kernels [k]);
+	      demapResult r;
+	      r. mode		= mode;
+	      r. kernel		= demapper. kernelName ();
+	      r. formerNs	= formerNs;
+	      r. formerDiffers	= formerDiffers;
+	      r. formerMaxDiff	= formerMaxDiff;
+//	32 bit ARM has no vector sqrt and division, see the demapper
+#if	defined (__arm__) && !defined (__aarch64__)
+	      r. agrees		= (kernels [k] == DEMAP_NEON) ?
+	                                 maxDiff [k] <= 1 : maxDiff [k] == 0;
+#else
+	      r. agrees		= maxDiff [k] == 0;
+#endif
+	      r. symbolNs	= timeIt ([&] () {
+	                     demapper. demap (spectrum. data (),
+	                                      reference. data (),
+	                                      ibits. data ()); });
+	      results. push_back (r);
+	   }
+	}
+}
@@ -0,0 +1,47 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The differential demodulator and soft bit mapper: per mode and
+//	per kernel of the ofdmDemapper the time per ofdm symbol. Each
+//	kernel should give the soft bits of the scalar kernel, bit for
+//	bit (on 32 bit ARM, the NEON kernel within 1). The soft bits are
+//	also compared with those of the former per carrier loop of
+//	ofdmDecoder::decode (mapIn per carrier, abs and two divisions),
+//	those may differ by 1 in a few carriers. The check runs over
+//	500 random symbols per mode, with some zero bins
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	demapResult {
+	int		mode;
+	std::string	kernel;
+	double		symbolNs;
+	double		formerNs;	// the former per carrier loop
+	int		formerDiffers;	// soft bits, of 2 * carriers * 500
+	int		formerMaxDiff;
+	bool		agrees;		// with the scalar kernel
+};
+
+void	demapBench	(std::vector<demapResult> &);
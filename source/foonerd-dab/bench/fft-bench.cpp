@@ -0,0 +1,125 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"fft-bench.h"
+#include	"fft-handler.h"
+#include	"dab-params.h"
+#include	<string.h>
+#include	<algorithm>
+#include	<chrono>
+#include	<random>
+
+template <typename F>
+static
+double	timeIt	(F f) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   f ();
+	   rounds ++;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.2);
+	return elapsed * 1e9 / rounds;
+}
+
+void	fftBench	(std::vector<fftResult> &results) {
+struct	planning {
+	const char	*name;
+	int		effort;
+};
+static const planning efforts [] = {
+	{"estimate",	FFT_ESTIMATE},
+	{"measure",	FFT_MEASURE}
+};
+static const int modes [] = {1, 2, 3, 4};
+std::mt19937	generator (3);
+std::normal_distribution<float> gauss (0, 1);
+
+	for (auto &e : efforts) {
+	   fft_handler::setPlanning ("", e. effort);
+	   for (int mode : modes) {
+	      dabParams	params (mode);
+	      int	T_u	= params. get_T_u ();
+	      int	T_s	= params. get_T_s ();
+	      int	T_g	= params. get_T_g ();
+	      int	nrSymbols	= params. get_L () - 4;
+	      fft_handler	single (mode);
+	      fft_handler	batch (mode, nrSymbols);
+	      std::complex<float> *vector	= single. getVector ();
+	      std::complex<float> *frame	= batch. getFrameBuffer ();
+	      std::vector<std::complex<float>> input (nrSymbols * T_s);
+	      std::vector<std::complex<float>> spectra (nrSymbols * T_u);
+	      for (auto &x : input)
+	         x = std::complex<float> (gauss (generator),
+	                                  gauss (generator));
+//
+//	the per block path, as in ofdmDecoder::decode
+	      auto perSymbol	= [&] () {
+	         for (int s = 0; s < nrSymbols; s ++) {
+	            memcpy (vector, &input [s * T_s + T_g],
+	                            T_u * sizeof (std::complex<float>));
+	            single. do_FFT ();
+	            memcpy (&spectra [s * T_u], vector,
+	                            T_u * sizeof (std::complex<float>));
+	         }
+	      };
+//	the blocks are read into the frame buffer by the sync thread,
+//	that copy is not part of the batched FFT
+	      memcpy (frame, input. data (),
+	                     nrSymbols * T_s * sizeof (std::complex<float>));
+	      auto batched	= [&] () {
+	         batch. do_frameFFT ();
+	      };
+
+	      perSymbol ();
+	      batched ();
+	      fftResult r;
+	      r. mode		= mode;
+	      r. planning	= e. name;
+	      r. symbols	= nrSymbols;
+	      r. size		= T_u;
+	      float	largest	= 0;
+	      float	error	= 0;
+	      for (int s = 0; s < nrSymbols; s ++) {
+	         std::complex<float> *b = batch. getSpectrum (s);
+	         for (int i = 0; i < T_u; i ++) {
+	            largest	= std::max (largest,
+	                                    std::abs (spectra [s * T_u + i]));
+	            error	= std::max (error,
+	                                    std::abs (spectra [s * T_u + i] -
+	                                                             b [i]));
+	         }
+	      }
+	      r. maxError	= largest > 0 ? error / largest : error;
+//	the same algorithm is not guaranteed for both plans, the spectra
+//	may differ in the last bits of the floats
+	      r. agrees		= r. maxError < 1e-5;
+	      r. symbolNs	= timeIt (perSymbol);
+	      r. batchNs	= timeIt (batched);
+	      results. push_back (r);
+	   }
+	}
+	fft_handler::setPlanning ("", FFT_ESTIMATE);
+}
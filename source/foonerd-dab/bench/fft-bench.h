@@ -0,0 +1,45 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The FFT's of the MSC blocks of a frame (blocks 4 .. L - 1), for
+//	modes I - IV and with the fftw planning efforts estimate and
+//	measure: one block at a time - copied into the plan vector, as
+//	ofdmDecoder::decode does - and batched, a single plan over the
+//	frame buffer. The spectra should be the same
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	fftResult {
+	int		mode;
+	std::string	planning;
+	int		symbols;	// transformed per frame
+	int		size;		// T_u
+	double		symbolNs;	// per frame, one block at a time
+	double		batchNs;	// per frame, batched
+	double		maxError;	// relative to the largest bin
+	bool		agrees;
+};
+
+void	fftBench	(std::vector<fftResult> &);
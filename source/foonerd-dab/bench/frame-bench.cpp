@@ -0,0 +1,225 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"frame-bench.h"
+#include	"synthetic-signal.h"
+#include	"eep-protection.h"
+#include	"energy-dispersal.h"
+#include	"mp2processor.h"
+#include	"mp4processor.h"
+#include	<string.h>
+#include	<chrono>
+#include	<random>
+
+//	what a decoder gives: its samples and its quality reports
+struct	decoderOutput {
+	std::vector<int16_t>	pcm;
+	std::vector<int16_t>	quality;
+};
+
+static
+void	collectAudio	(int16_t *buffer, int size, int rate,
+	                 bool stereo, void *ctx) {
+decoderOutput *out	= static_cast<decoderOutput *>(ctx);
+	(void)rate; (void)stereo;
+	out -> pcm. insert (out -> pcm. end (), buffer, buffer + size);
+}
+
+static
+void	collectQuality	(int16_t fe, int16_t rsE, int16_t aacE, void *ctx) {
+decoderOutput *out	= static_cast<decoderOutput *>(ctx);
+	out -> quality. push_back (fe);
+	out -> quality. push_back (rsE);
+	out -> quality. push_back (aacE);
+}
+
+//
+//	the logical frames, encoded as in the synthetic signal: energy
+//	dispersal, the mother code and EEP 3-A puncturing, as soft bits
+//	(a 0 bit is negative) with gaussian noise
+static
+void	encodeFrames	(const std::vector<std::vector<uint8_t>> &frames,
+	                 int bitRate, float noise, std::mt19937 &generator,
+	                 std::vector<std::vector<int16_t>> &soft) {
+int	nBits	= 24 * bitRate;
+energyDispersal	dispersal (nBits);
+std::vector<uint8_t> packed (nBits / 8);
+std::vector<uint8_t> bits (nBits);
+std::vector<uint8_t> mother;
+std::vector<uint8_t> coded;
+std::vector<bool> table;
+std::normal_distribution<float> gauss (0, noise > 0 ? noise : 1);
+
+	addPuncturing (table, 6 * bitRate / 8 - 3, 8);
+	addPuncturing (table, 3, 7);
+	addTail (table);
+	soft. resize (0);
+	for (auto &f : frames) {
+	   packed	= f;
+	   dispersal. apply (packed. data ());
+	   for (int i = 0; i < nBits; i ++)
+	      bits [i] = (packed [i / 8] >> (7 - i % 8)) & 01;
+	   convEncode (bits. data (), nBits, mother);
+	   puncture (mother, table, coded);
+	   std::vector<int16_t> s (coded. size ());
+	   for (int i = 0; i < (int)coded. size (); i ++) {
+	      float v	= coded [i] == 0 ? -100 : 100;
+	      if (noise > 0)
+	         v	+= gauss (generator);
+	      s [i]	= v > 127 ? 127 : v < -127 ? -127 : (int16_t)v;
+	   }
+	   soft. push_back (s);
+	}
+}
+
+static
+backendBase	*makeDecoder	(bool dabPlus, int bitRate,
+	                         API_struct *api, decoderOutput *out) {
+	if (dabPlus)
+	   return new mp4Processor (bitRate, api, out);
+	return new mp2Processor (bitRate, api, out);
+}
+//
+//	the path of the audioBackend before the packed data path: the
+//	deconvolution gives one bit per byte, the energy dispersal is
+//	a XOR per bit, the decoder packs the bits again
+static
+void	decodeBits	(protection *handler, backendBase *decoder,
+	                 const std::vector<std::vector<int16_t>> &soft,
+	                 int bitRate) {
+int	nBits	= 24 * bitRate;
+std::vector<uint8_t> disperseVector (nBits);
+std::vector<uint8_t> outV (nBits);
+uint8_t	shiftRegister [9];
+
+	memset (shiftRegister, 1, 9);
+	for (int i = 0; i < nBits; i ++) {
+	   uint8_t b = shiftRegister [8] ^ shiftRegister [4];
+	   for (int j = 8; j > 0; j--)
+	      shiftRegister [j] = shiftRegister [j - 1];
+	   shiftRegister [0] = b;
+	   disperseVector [i] = b;
+	}
+	for (auto &s : soft) {
+	   handler -> deconvolve ((int16_t *)s. data (), s. size (),
+	                                                 outV. data ());
+	   for (int i = 0; i < nBits; i ++)
+	      outV [i] ^= disperseVector [i];
+	   decoder -> addtoFrame (outV. data ());
+	}
+}
+//
+//	the path of the audioBackend now
+static
+void	decodePacked	(protection *handler, backendBase *decoder,
+	                 const std::vector<std::vector<int16_t>> &soft,
+	                 int bitRate) {
+int	nBits	= 24 * bitRate;
+energyDispersal	dispersal (nBits);
+std::vector<uint8_t> outV (nBits / 8);
+
+	for (auto &s : soft) {
+	   handler -> deconvolvePacked ((int16_t *)s. data (), s. size (),
+	                                                 outV. data ());
+	   dispersal. apply (outV. data ());
+	   decoder -> addtoFramePacked (outV. data ());
+	}
+}
+
+template <typename F>
+static
+double	timeIt	(F f) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   f ();
+	   rounds ++;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.2);
+	return elapsed * 1e9 / rounds;
+}
+
+void	frameBench	(std::vector<frameResult> &results) {
+struct	config {
+	const char	*name;
+	bool		dabPlus;
+	int		bitRate;
+	float		noise;
+};
+static const config configs [] = {
+	{"DAB+ 96 kbit/s clean",	true,	 96,	0},
+	{"DAB+ 96 kbit/s noisy",	true,	 96,	80},
+	{"DAB 128 kbit/s clean",	false,	128,	0},
+	{"DAB 128 kbit/s noisy",	false,	128,	80}
+};
+const int	nFrames	= 250;
+std::mt19937	generator (24);
+API_struct	api;
+
+	memset ((void *)&api, 0, sizeof (api));
+	api. audioOut_Handler		= collectAudio;
+	api. program_quality_Handler	= collectQuality;
+	for (auto &c : configs) {
+	   std::vector<std::vector<uint8_t>> frames;
+	   std::vector<std::vector<int16_t>> soft;
+	   if (c. dabPlus)
+	      dabPlusFrames (c. bitRate, nFrames, frames);
+	   else
+	      mp2Frames (c. bitRate, nFrames, generator (), frames);
+	   encodeFrames (frames, c. bitRate, c. noise, generator, soft);
+
+	   eep_protection handler (c. bitRate, 2);	// EEP 3-A
+	   decoderOutput bitOutput, packedOutput;
+	   backendBase *bitDecoder	= makeDecoder (c. dabPlus, c. bitRate,
+	                                               &api, &bitOutput);
+	   backendBase *packedDecoder	= makeDecoder (c. dabPlus, c. bitRate,
+	                                               &api, &packedOutput);
+	   decodeBits (&handler, bitDecoder, soft, c. bitRate);
+	   decodePacked (&handler, packedDecoder, soft, c. bitRate);
+
+	   frameResult r;
+	   r. config	= c. name;
+	   r. frames	= nFrames;
+	   r. samples	= packedOutput. pcm. size () / 2;
+	   r. reports	= packedOutput. quality. size () / 3;
+	   r. agrees	= (bitOutput. pcm == packedOutput. pcm) &&
+	                  (bitOutput. quality == packedOutput. quality) &&
+	                  (r. samples > 0);
+//
+//	decoding the frames again, with the state left by the previous
+//	pass, gives the time per logical frame
+	   r. bitNs	= timeIt ([&] () {
+	                     bitOutput. pcm. clear ();
+	                     decodeBits (&handler, bitDecoder,
+	                                         soft, c. bitRate); }) / nFrames;
+	   r. packedNs	= timeIt ([&] () {
+	                     packedOutput. pcm. clear ();
+	                     decodePacked (&handler, packedDecoder,
+	                                         soft, c. bitRate); }) / nFrames;
+	   delete bitDecoder;
+	   delete packedDecoder;
+	   results. push_back (r);
+	}
+}
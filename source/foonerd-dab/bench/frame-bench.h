@@ -0,0 +1,47 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The packed path from the deconvolution to the audio decoders
+//	against the bit per byte path it replaced. Logical frames of a
+//	DAB+ (96 kbit/s) and a DAB (128 kbit/s) subchannel are encoded
+//	(EEP 3-A), clean and with noise added to the soft bits. They are
+//	decoded as before - deconvolve, energy dispersal per bit and
+//	addtoFrame, one bit per byte - and packed - deconvolvePacked,
+//	energyDispersal and addtoFramePacked. The decoders should give
+//	the same samples and report the same quality
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	frameResult {
+	std::string	config;
+	int		frames;		// logical frames
+	int		samples;	// decoded, per channel
+	int		reports;	// quality reports
+	double		bitNs;		// per logical frame, bit per byte
+	double		packedNs;	// per logical frame, packed
+	bool		agrees;
+};
+
+void	frameBench	(std::vector<frameResult> &);
@@ -0,0 +1,332 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"instance-bench.h"
+#include	"dab-api.h"
+#include	"rawfiles.h"
+#include	"mmap-file-handler.h"
+#include	"wavfiles.h"
+#include	"xml-filereader.h"
+#include	"synthetic-signal.h"
+#include	<unistd.h>
+#include	<string.h>
+#include	<atomic>
+#include	<chrono>
+
+//
+//	all state of an instance, passed as context to the callbacks of
+//	the library and to the end of input handler of its device
+struct	benchInstance {
+	void		*radio;
+	deviceHandler	*device;
+	std::string	wanted;
+	std::string	firstService;
+	std::atomic<bool>	ensembleRecognized;
+	std::atomic<bool>	selected;
+	std::atomic<bool>	ended;
+	std::atomic<bool>	holdInput;
+	std::atomic<bool>	hashing;
+	std::atomic<uint64_t>	samples;
+	std::atomic<uint64_t>	checksum;
+	std::chrono::steady_clock::time_point	startTime;
+	std::chrono::steady_clock::time_point	endTime;
+};
+
+//
+//	the thread signalling the end of the input is held until the
+//	instance has its checksum, as in the main bench
+static
+void	instanceEnded	(void *ctx) {
+benchInstance *b	= static_cast<benchInstance *>(ctx);
+	if (b -> ended. load ())
+	   return;
+	b -> endTime	= std::chrono::steady_clock::now ();
+	b -> ended. store (true);
+	while (b -> holdInput. load ())
+	   usleep (1000);
+}
+
+static
+void	ensembleName	(const std::string &name, int32_t Id, void *ctx) {
+benchInstance *b	= static_cast<benchInstance *>(ctx);
+	(void)name; (void)Id;
+	b -> ensembleRecognized. store (true);
+}
+
+static
+void	serviceName	(const std::string &s, int32_t SId,
+	                 uint16_t subChId, void *ctx) {
+benchInstance *b	= static_cast<benchInstance *>(ctx);
+	(void)SId; (void)subChId;
+	if (b -> firstService == "")
+	   b -> firstService = s;
+}
+
+static
+void	pcmHandler	(int16_t *buffer, int size, int rate,
+	                 bool isStereo, void *ctx) {
+benchInstance *b	= static_cast<benchInstance *>(ctx);
+uint64_t	hash	= b -> checksum. load ();
+	(void)rate; (void)isStereo;
+	if (!b -> hashing. load ())
+	   return;
+	for (int i = 0; i < size; i ++) {
+	   hash ^= (uint16_t)buffer [i];
+	   hash *= 0x100000001B3ULL;
+	}
+	b -> checksum. store (hash);
+	b -> samples. fetch_add (size / 2);
+}
+
+//
+//	called by the decoder thread of the instance, after a fixed
+//	number of samples
+static
+void	systemData	(bool flag, int16_t snr, int32_t freqOff, void *ctx) {
+benchInstance *b	= static_cast<benchInstance *>(ctx);
+	(void)flag; (void)snr; (void)freqOff;
+	if ((b -> radio == nullptr) || b -> selected. load () ||
+	                             !b -> ensembleRecognized. load ())
+	   return;
+	std::string name = b -> wanted != "" ? b -> wanted : b -> firstService;
+	if ((name == "") || !is_audioService (b -> radio, name))
+	   return;
+	audiodata ad;
+	dataforAudioService (b -> radio, name, ad, 0);
+	if (!ad. defined)
+	   return;
+	set_audioChannel (b -> radio, ad);
+	b -> wanted	= name;
+	b -> selected. store (true);
+}
+
+static
+void	syncsignal_Handler (bool b, void *ctx) {
+	(void)b; (void)ctx;
+}
+
+static
+void	fibQuality	(int16_t q, void *ctx) {
+	(void)q; (void)ctx;
+}
+
+static
+void	programdata_Handler (audiodata *d, void *ctx) {
+	(void)d; (void)ctx;
+}
+
+static
+void	mscQuality	(int16_t fe, int16_t rsE, int16_t aacE, void *ctx) {
+	(void)fe; (void)rsE; (void)aacE; (void)ctx;
+}
+
+static
+void	tii_data_Handler (tiiData *d, void *ctx) {
+	(void)d; (void)ctx;
+}
+
+static
+bool	endsWith	(const std::string &s, const char *suffix) {
+size_t	l	= strlen (suffix);
+
+	return (s. size () >= l) &&
+	       (strcasecmp (s. c_str () + s. size () - l, suffix) == 0);
+}
+
+static
+deviceHandler	*openInput	(const std::string &fileName, bool mapped,
+	                         double seconds, float snr, void *ctx) {
+	try {
+	   if (fileName == "")
+	      return new syntheticSignal (seconds, snr, instanceEnded, ctx);
+	   if (endsWith (fileName, ".wav"))
+	      return new wavFiles (fileName, 0.0, instanceEnded, ctx);
+	   if (mapped)
+	      return new mmapFileHandler (fileName, false, instanceEnded, ctx);
+	   if (endsWith (fileName, ".xml") || endsWith (fileName, ".uff"))
+	      return new xml_fileReader (fileName, false, instanceEnded, ctx);
+	   return new rawFiles (fileName, 0.0, instanceEnded, ctx);
+	}
+	catch (...) {
+	   return nullptr;
+	}
+}
+
+//
+//	An instance is done when it makes no progress - samples read,
+//	audio delivered - for 200 msec after the end of its input
+static
+void	waitForInstances (std::vector<benchInstance *> &v) {
+std::vector<uint64_t> last (v. size (), 0);
+int	quiet	= 0;
+	while (quiet < 20) {
+	   usleep (10000);
+	   bool progress	= false;
+	   for (size_t i = 0; i < v. size (); i ++) {
+	      processingStats ps;
+	      dabGetProcessingStats (v [i] -> radio, &ps);
+	      uint64_t now	= ps. samplesRead + v [i] -> samples. load ();
+	      if (now != last [i])
+	         progress	= true;
+	      last [i]		= now;
+	   }
+	   quiet	= progress ? 0 : quiet + 1;
+	}
+}
+
+//
+//	n instances decode the input concurrently
+static
+bool	runInstances	(const std::string &fileName, bool mapped,
+	                 double seconds, float snr,
+	                 const std::string &service, uint8_t mode,
+	                 int n, int timeOut,
+	                 std::vector<instanceResult> &results) {
+std::vector<benchInstance *> v;
+bool	ok	= true;
+
+	for (int i = 0; i < n; i ++) {
+	   benchInstance *b	= new benchInstance;
+	   b -> radio		= nullptr;
+	   b -> wanted		= service;
+	   b -> ensembleRecognized. store (false);
+	   b -> selected. store (false);
+	   b -> ended. store (false);
+	   b -> holdInput. store (true);
+	   b -> hashing. store (true);
+	   b -> samples. store (0);
+	   b -> checksum. store (0xCBF29CE484222325ULL);
+	   b -> device	= openInput (fileName, mapped, seconds, snr, b);
+	   if (b -> device == nullptr) {
+	      delete b;
+	      ok	= false;
+	      break;
+	   }
+	   v. push_back (b);
+	}
+
+	API_struct interface;
+	memset ((void *)&interface, 0, sizeof (interface));
+	interface. dabMode		= mode;
+	interface. thresholdValue	= 6;
+	interface. syncsignal_Handler	= syncsignal_Handler;
+	interface. systemdata_Handler	= systemData;
+	interface. name_of_ensemble	= ensembleName;
+	interface. serviceName		= serviceName;
+	interface. audioOut_Handler	= pcmHandler;
+	interface. fib_quality_Handler	= fibQuality;
+	interface. programdata_Handler	= programdata_Handler;
+	interface. program_quality_Handler	= mscQuality;
+	interface. tii_data_Handler	= tii_data_Handler;
+	for (auto b : v) {
+	   b -> radio	= dabInit (b -> device, &interface,
+	                           nullptr, nullptr, b);
+	   if (b -> radio == nullptr)
+	      ok	= false;
+	}
+	if (!ok) {
+	   for (auto b : v) {
+	      if (b -> radio != nullptr)
+	         dabExit (b -> radio);
+	      delete b -> device;
+	      delete b;
+	   }
+	   return false;
+	}
+
+//
+//	the instances are started 200 msec apart, so they are at different
+//	points in the input: state shared between them would mix parts of
+//	the input, even where the input repeats itself
+	for (auto b : v) {
+	   if (b != v [0])
+	      usleep (200000);
+	   b -> startTime	= std::chrono::steady_clock::now ();
+	   b -> device -> setUnthrottled (true);
+	   b -> device -> restartReader (227360000);
+	   dabStartProcessing (b -> radio);
+	}
+	int	ticks	= 0;
+	while (true) {
+	   bool allEnded	= true;
+	   bool allSelected	= true;
+	   for (auto b : v) {
+	      allEnded		&= b -> ended. load ();
+	      allSelected	&= b -> selected. load ();
+	   }
+	   if (allEnded)
+	      break;
+	   usleep (10000);
+	   if (!allSelected && (++ ticks > 100 * timeOut))
+	      break;
+	}
+	waitForInstances (v);
+	for (auto b : v) {
+	   b -> hashing. store (false);
+	   if (!b -> ended. load ())
+	      b -> endTime	= std::chrono::steady_clock::now ();
+	}
+	for (auto b : v) {
+	   b -> holdInput. store (false);
+	   b -> device -> stopReader ();
+	   dabStop (b -> radio);
+	}
+
+	for (size_t i = 0; i < v. size (); i ++) {
+	   benchInstance *b	= v [i];
+	   instanceResult r;
+	   r. instance	= results. size ();
+	   r. service	= b -> selected. load () ? b -> wanted : "";
+	   r. samples	= b -> samples. load ();
+	   r. checksum	= b -> checksum. load ();
+	   r. wall	= std::chrono::duration<double>
+	                            (b -> endTime - b -> startTime). count ();
+	   r. agrees	= b -> ended. load () && (r. samples > 0);
+	   results. push_back (r);
+	   dabExit (b -> radio);
+	   delete b -> device;
+	   delete b;
+	}
+	return true;
+}
+
+bool	instanceBench	(const std::string &fileName, bool mapped,
+	                 double seconds, float snr,
+	                 const std::string &service, uint8_t mode,
+	                 int instances, int timeOut,
+	                 std::vector<instanceResult> &results) {
+	results. resize (0);
+	if (!runInstances (fileName, mapped, seconds, snr, service, mode,
+	                                      1, timeOut, results))
+	   return false;
+	if (!runInstances (fileName, mapped, seconds, snr, service, mode,
+	                              instances, timeOut, results))
+	   return false;
+	const instanceResult &reference = results [0];
+	for (size_t i = 1; i < results. size (); i ++)
+	   results [i]. agrees = results [i]. agrees &&
+	                         reference. agrees &&
+	                         (results [i]. service == reference. service) &&
+	                         (results [i]. samples == reference. samples) &&
+	                         (results [i]. checksum == reference. checksum);
+	return true;
+}
@@ -0,0 +1,53 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	Several decoder instances in one process. The input (a recording,
+//	or the synthetic signal) is decoded first by a single instance,
+//	then by n instances running concurrently, each with its own
+//	device, started 200 msec apart. Each instance should give the
+//	audio - samples and checksum - of the single instance. The
+//	service is selected from the decoder thread, at a fixed sample
+//	position, as in the main bench, so the output does not depend
+//	on the scheduling
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	instanceResult {
+	int		instance;	// 0 is the single instance run
+	std::string	service;
+	uint64_t	samples;	// audio, per channel
+	uint64_t	checksum;	// FNV-1a over the PCM samples
+	double		wall;		// until the end of the input
+	bool		agrees;
+};
+
+//	the input is synthetic if fileName is empty, seconds and snr
+//	are then those of the synthetic signal. Returns false if the
+//	input cannot be opened
+bool	instanceBench	(const std::string &fileName, bool mapped,
+	                 double seconds, float snr,
+	                 const std::string &service, uint8_t mode,
+	                 int instances, int timeOut,
+	                 std::vector<instanceResult> &);
@@ -0,0 +1,122 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"interleave-bench.h"
+#include	"time-deinterleaver.h"
+#include	<string.h>
+#include	<chrono>
+#include	<random>
+
+#define	CUSize	(4 * 16)
+
+static const
+int16_t	interleaveMap [] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
+//
+//	the former deinterleaver of the backends
+class	rowDeinterleaver {
+public:
+		rowDeinterleaver	(int32_t fragmentSize) {
+	   this	-> fragmentSize	= fragmentSize;
+	   for (int i = 0; i < 16; i ++) {
+	      rows [i] = new int16_t [fragmentSize];
+	      memset (rows [i], 0, fragmentSize * sizeof (int16_t));
+	   }
+	   index	= 0;
+	   count	= 0;
+	}
+		~rowDeinterleaver	() {
+	   for (int i = 0; i < 16; i ++)
+	      delete [] rows [i];
+	}
+	bool	process		(const int16_t *in, int16_t *out) {
+	   for (int32_t i = 0; i < fragmentSize; i ++) {
+	      out [i] = rows [(index + interleaveMap [i & 017]) & 017][i];
+	      rows [index][i] = in [i];
+	   }
+	   index = (index + 1) & 017;
+	   if (count <= 15) {
+	      count ++;
+	      return false;
+	   }
+	   return true;
+	}
+private:
+	int32_t		fragmentSize;
+	int16_t		*rows [16];
+	int16_t		index;
+	int16_t		count;
+};
+
+template <typename F>
+static
+double	timeIt	(F f) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   for (int i = 0; i < 16; i ++)
+	      f ();
+	   rounds	+= 16;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.1);
+	return elapsed * 1e9 / rounds;
+}
+
+void	interleaveBench	(std::vector<interleaveResult> &results) {
+static const int sizes [] = {48, 96, 192, 288, 432, 576, 864};
+std::mt19937	generator (3);
+std::uniform_int_distribution<int> softBit (-127, 127);
+
+	for (int CUs : sizes) {
+	   int32_t	fragmentSize	= CUs * CUSize;
+	   rowDeinterleaver	rowVersion (fragmentSize);
+	   timeDeinterleaver	newVersion (fragmentSize);
+	   std::vector<int16_t> cifs (40 * fragmentSize);
+	   std::vector<int16_t> out1 (fragmentSize);
+	   std::vector<int16_t> out2 (fragmentSize);
+	   interleaveResult r;
+
+	   for (auto &x : cifs)
+	      x = softBit (generator);
+	   r. CUs	= CUs;
+	   r. agrees	= true;
+	   for (int c = 0; c < 40; c ++) {
+	      const int16_t *in	= &cifs [c * fragmentSize];
+	      bool b1	= rowVersion.  process (in, out1. data ());
+	      bool b2	= newVersion. process (in, out2. data ());
+	      if ((b1 != b2) || (b1 && (out1 != out2)))
+	         r. agrees = false;
+	   }
+	   int c	= 0;
+	   r. rowsNs	= timeIt ([&] () {
+	                     rowVersion. process (&cifs [c * fragmentSize],
+	                                          out1. data ());
+	                     c = (c + 1) % 40; });
+	   r. newNs	= timeIt ([&] () {
+	                     newVersion. process (&cifs [c * fragmentSize],
+	                                           out2. data ());
+	                     c = (c + 1) % 40; });
+	   results. push_back (r);
+	}
+}
@@ -0,0 +1,39 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The time deinterleaver, for subchannels up to the largest (the
+//	full MSC, 864 CU's): the timeDeinterleaver of the library is
+//	compared - output and time per CIF - with the former
+//	implementation, with 16 separately allocated rows
+#include	<stdint.h>
+#include	<vector>
+
+struct	interleaveResult {
+	int		CUs;
+	double		rowsNs;		// per CIF, 16 rows
+	double		newNs;		// per CIF, timeDeinterleaver
+	bool		agrees;
+};
+
+void	interleaveBench	(std::vector<interleaveResult> &);
@@ -0,0 +1,153 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"iq-bench.h"
+#include	"iq-converter.h"
+#include	<chrono>
+#include	<complex>
+#include	<functional>
+
+//
+//	the conversions as they were done in the handlers, the u8 one
+//	with the table of the rtlsdr handler
+static float convTable [256];
+
+static
+void	formerConvert	(int format, const uint8_t *in,
+	                 const int16_t *I, const int16_t *Q,
+	                 int32_t n, std::complex<float> *out) {
+	switch (format) {
+	   case IQ_U8:
+	      for (int i = 0; i < n; i ++)
+	         out [i] = std::complex<float> (convTable [in [2 * i]],
+	                                        convTable [in [2 * i + 1]]);
+	      break;
+	   case IQ_S8:
+	      for (int i = 0; i < n; i ++)
+	         out [i] = std::complex<float> (((int8_t *)in) [2 * i] / 128.0,
+	                                        ((int8_t *)in) [2 * i + 1] / 128.0);
+	      break;
+	   case IQ_S16:
+	      for (int i = 0; i < n; i ++)
+	         out [i] = std::complex<float> (
+	                         ((int16_t *)in) [2 * i] / (float)2048,
+	                         ((int16_t *)in) [2 * i + 1] / (float)2048);
+	      break;
+	   case IQ_S16_BE:
+	      for (int i = 0; i < n; i ++) {
+	         int16_t re	= (in [4 * i] << 8) | in [4 * i + 1];
+	         int16_t im	= (in [4 * i + 2] << 8) | in [4 * i + 3];
+	         out [i] = std::complex<float> ((float)re / 2048,
+	                                        (float)im / 2048);
+	      }
+	      break;
+	   default:
+	      for (int i = 0; i < n; i ++)
+	         out [i] = std::complex<float> (float (I [i]) / 2048,
+	                                        float (Q [i]) / 2048);
+	      break;
+	}
+}
+
+static
+double	timeIt		(const std::function<void ()> &f, int32_t n) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   for (int i = 0; i < 16; i ++)
+	      f ();
+	   rounds	+= 16;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.1);
+	return (double)rounds * n / elapsed / 1e6;
+}
+
+void	iqBench		(std::vector<iqResult> &results) {
+struct	format {
+	const char	*name;
+	int		format;
+	float		scale;
+};
+static const format formats [] = {
+	{"u8",		IQ_U8,		1.0 / 128},
+	{"s8",		IQ_S8,		1.0 / 128},
+	{"s16",		IQ_S16,		1.0 / 2048},
+	{"s16be",	IQ_S16_BE,	1.0 / 2048},
+	{"s16split",	IQ_S16_SPLIT,	1.0 / 2048}
+};
+static const int kernels [] = {IQ_SCALAR, IQ_SSE2, IQ_AVX2, IQ_NEON};
+//	an odd number, so the tails are exercised as well
+const int32_t	n	= 16 * 1024 + 7;
+std::vector<uint8_t>	raw (4 * n);
+std::vector<int16_t>	I (n);
+std::vector<int16_t>	Q (n);
+std::vector<std::complex<float>>	reference (n);
+std::vector<std::complex<float>>	out (n);
+uint32_t	seed	= 0x12345678;
+
+	for (int i = 0; i < 256; i ++)
+	   convTable [i] = (i - 128) / 128.0;
+	for (auto &b : raw) {
+	   seed	= seed * 1103515245 + 12345;
+	   b	= seed >> 24;
+	}
+	for (int i = 0; i < n; i ++) {
+	   I [i]	= (int16_t)((raw [4 * i] << 8) | raw [4 * i + 1]);
+	   Q [i]	= (int16_t)((raw [4 * i + 2] << 8) | raw [4 * i + 3]);
+	}
+
+	for (auto &f : formats) {
+	   formerConvert (f. format, raw. data (), I. data (), Q. data (),
+	                  n, reference. data ());
+	   double formerMsps = timeIt ([&] () {
+	                          formerConvert (f. format, raw. data (),
+	                                         I. data (), Q. data (),
+	                                         n, out. data ());
+	                       }, n);
+	   for (int kernel : kernels) {
+	      iqConverter converter (f. format, f. scale);
+	      if (!converter. setKernel (kernel))
+	         continue;
+	      auto convert = [&] () {
+	         if (f. format == IQ_S16_SPLIT)
+	            converter. convert (I. data (), Q. data (), n, out. data ());
+	         else
+	            converter. convert (raw. data (), n, out. data ());
+	      };
+	      iqResult r;
+	      r. format		= f. name;
+	      r. kernel		= converter. kernelName ();
+	      r. formerMsps	= formerMsps;
+	      convert ();
+	      r. agrees		= true;
+	      for (int i = 0; r. agrees && (i < n); i ++)
+	         if (out [i] != reference [i])
+	            r. agrees = false;
+	      r. msps		= timeIt (convert, n);
+	      r. load		= 100 * 2.048 / r. msps;
+	      results. push_back (r);
+	   }
+	}
+}
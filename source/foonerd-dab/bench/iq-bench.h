@@ -0,0 +1,43 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The conversion of the raw device samples to std::complex<float>:
+//	per format and kernel the number of IQ samples converted per
+//	second (on one core), and the same for the per sample loops
+//	the handlers used before. The load is the percentage of a core
+//	needed at 2048000 samples/s
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	iqResult {
+	std::string	format;
+	std::string	kernel;
+	double		msps;		// Msamples per second
+	double		formerMsps;	// idem, the former loop
+	double		load;		// percent at 2.048 MS/s
+	bool		agrees;		// with the former loop
+};
+
+void	iqBench		(std::vector<iqResult> &);
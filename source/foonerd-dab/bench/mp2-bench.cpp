@@ -0,0 +1,126 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"mp2-bench.h"
+#include	"mp2processor.h"
+#include	<string.h>
+#include	<chrono>
+#include	<random>
+
+static
+void	collect		(int16_t *buffer, int size, int rate,
+	                 bool stereo, void *ctx) {
+std::vector<int16_t> *pcm	= static_cast<std::vector<int16_t> *>(ctx);
+	(void)rate; (void)stereo;
+	pcm -> insert (pcm -> end (), buffer, buffer + size);
+}
+//
+//	the stream: a few random bytes, then the frames, all shifted
+//	over shift bits, cut into the packed logical frames the
+//	decoder gets from the subchannel
+static
+void	makeStream	(int bitRate, int frameBytes, const uint8_t *header,
+	                 int nFrames, int shift, std::mt19937 &generator,
+	                 std::vector<std::vector<uint8_t>> &chunks) {
+int	chunkBytes	= 3 * bitRate;
+std::vector<uint8_t> bytes;
+
+	for (int i = 0; i < 5; i ++)
+	   bytes. push_back (generator () & 0xFF);
+	for (int f = 0; f < nFrames; f ++) {
+	   for (int i = 0; i < 4; i ++)
+	      bytes. push_back (header [i]);
+	   for (int i = 4; i < frameBytes - 4; i ++)
+	      bytes. push_back (generator () & 0xFF);
+	   for (int i = frameBytes - 4; i < frameBytes; i ++)
+	      bytes. push_back (0);
+	}
+	bytes. push_back (0);
+	if (shift != 0)
+	   for (size_t i = bytes. size () - 1; i > 0; i --)
+	      bytes [i] = (bytes [i] >> shift) | (bytes [i - 1] << (8 - shift));
+	chunks. clear ();
+	for (size_t i = 0; i + chunkBytes <= bytes. size (); i += chunkBytes)
+	   chunks. push_back (std::vector<uint8_t> (bytes. begin () + i,
+	                                  bytes. begin () + i + chunkBytes));
+}
+
+void	mp2Bench	(std::vector<mp2Result> &results) {
+struct	config {
+	const char	*name;
+	int		bitRate;
+	int		frameBytes;
+	uint8_t		header [4];
+};
+static const config configs [] = {
+	{"128 kbit/s stereo",	    128, 384, {0xFF, 0xFD, 0x84, 0x00}},
+	{"192 kbit/s joint stereo", 192, 576, {0xFF, 0xFD, 0xA4, 0x60}},
+	{"64 kbit/s mono",	     64, 192, {0xFF, 0xFD, 0x44, 0xC0}},
+	{"64 kbit/s 24 kHz",	     64, 384, {0xFF, 0xF5, 0x84, 0x00}}
+};
+static const int kernels [] = {MP2_REFERENCE, MP2_SCALAR,
+	                       MP2_SSE41, MP2_AVX2, MP2_NEON};
+const int	nFrames	= 50;
+std::mt19937	generator (1152);
+API_struct	api;
+
+	memset (&api, 0, sizeof (api));
+	api. audioOut_Handler	= collect;
+	for (auto &c : configs) {
+	   std::vector<std::vector<uint8_t>> chunks;
+	   std::vector<int16_t> reference;
+	   makeStream (c. bitRate, c. frameBytes, c. header, nFrames,
+	               generator () % 8, generator, chunks);
+	   for (int kernel : kernels) {
+	      std::vector<int16_t> pcm;
+	      mp2Processor	decoder (c. bitRate, &api, &pcm);
+	      if (!decoder. setKernel (kernel))
+	         continue;
+	      for (auto &chunk : chunks)
+	         decoder. addtoFramePacked (chunk. data ());
+	      if (kernel == MP2_REFERENCE)
+	         reference	= pcm;
+	      mp2Result r;
+	      r. config	= c. name;
+	      r. kernel	= decoder. kernelName ();
+	      r. frames	= pcm. size () / (2 * KJMP2_SAMPLES_PER_FRAME);
+	      r. agrees	= (pcm == reference) && (r. frames > 0);
+//
+//	decoding the stream again, with the state left by the
+//	previous pass, gives the time per frame
+	      int	rounds	= 0;
+	      double	elapsed;
+	      std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	      do {
+	         pcm. clear ();
+	         for (auto &chunk : chunks)
+	            decoder. addtoFramePacked (chunk. data ());
+	         rounds ++;
+	         elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	      } while (elapsed < 0.2);
+	      r. frameNs	= elapsed * 1e9 / ((double)rounds * r. frames);
+	      results. push_back (r);
+	   }
+	}
+}
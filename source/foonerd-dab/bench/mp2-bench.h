@@ -0,0 +1,43 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The MP2 decoder: streams of MP2 frames with random bodies (so
+//	random allocations, scale factors and samples), preceded by
+//	some random bytes and not starting at a byte boundary, are
+//	decoded with the original decoder (reference kernel, bit by bit
+//	header search) and with each of the synthesis kernels. The
+//	decoded samples should be equal
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	mp2Result {
+	std::string	config;
+	std::string	kernel;
+	int		frames;		// frames decoded
+	double		frameNs;	// ns per frame, including the search
+	bool		agrees;
+};
+
+void	mp2Bench	(std::vector<mp2Result> &);
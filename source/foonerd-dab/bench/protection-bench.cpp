@@ -0,0 +1,165 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"protection-bench.h"
+#include	"synthetic-signal.h"
+#include	"eep-protection.h"
+#include	"uep-protection.h"
+#include	<chrono>
+#include	<random>
+
+//
+//	the EEP parameters (EN 300 401, tables 18 and 19), protLevel
+//	as in the library: bit 2 set for the B profiles, the lower
+//	two bits are the level - 1
+static
+void	eepProfile	(int bitRate, int protLevel, int *L, int *PI) {
+int	n;
+
+	if ((protLevel & 04) == 0) {
+	   n	= bitRate / 8;
+	   switch (protLevel & 03) {
+	      case 0:
+	         L [0] = 6 * n - 3; L [1] = 3; PI [0] = 24; PI [1] = 23;
+	         break;
+	      case 1:
+	         if (n == 1) {
+	            L [0] = 5; L [1] = 1; PI [0] = 13; PI [1] = 12;
+	         }
+	         else {
+	            L [0] = 2 * n - 3; L [1] = 4 * n + 3;
+	            PI [0] = 14; PI [1] = 13;
+	         }
+	         break;
+	      case 2:
+	         L [0] = 6 * n - 3; L [1] = 3; PI [0] = 8; PI [1] = 7;
+	         break;
+	      default:
+	         L [0] = 4 * n - 3; L [1] = 2 * n + 3; PI [0] = 3; PI [1] = 2;
+	         break;
+	   }
+	}
+	else {
+	   static const int PIB [4][2] = {{10, 9}, {6, 5}, {4, 3}, {2, 1}};
+	   n	= bitRate / 32;
+	   L [0] = 24 * n - 3; L [1] = 3;
+	   PI [0] = PIB [protLevel & 03][0];
+	   PI [1] = PIB [protLevel & 03][1];
+	}
+}
+
+template <typename F>
+static
+double	timeIt	(F f) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   for (int i = 0; i < 10; i ++)
+	      f ();
+	   rounds	+= 10;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.05);
+	return elapsed * 1e9 / rounds;
+}
+
+static
+void	runProfile	(protection *handler, const std::string &name,
+	                 int bitRate, const std::vector<bool> &table,
+	                 std::mt19937 &generator,
+	                 std::vector<protectionResult> &results) {
+int	nBits	= 24 * bitRate;
+std::vector<uint8_t> data (nBits);
+std::vector<uint8_t> mother;
+std::vector<uint8_t> coded;
+std::vector<int16_t> soft;
+std::vector<uint8_t> out (nBits);
+protectionResult r;
+
+	for (auto &b : data)
+	   b = generator () & 01;
+	convEncode (data. data (), nBits, mother);
+	puncture (mother, table, coded);
+	soft. resize (coded. size ());
+//	a 0 bit is a negative soft bit
+	for (int i = 0; i < (int)coded. size (); i ++)
+	   soft [i] = coded [i] == 0 ? -100 : 100;
+
+	r. name		= name;
+	r. bitRate	= bitRate;
+	r. inputBits	= soft. size ();
+	r. ok		= handler -> inputSize () == (int32_t)soft. size ();
+	if (r. ok) {
+	   handler -> deconvolve (soft. data (), soft. size (), out. data ());
+	   r. ok	= out == data;
+	}
+	r. depunctureNs	= timeIt ([&] () {
+	                     handler -> depuncture (soft. data ()); });
+	r. deconvolveNs	= timeIt ([&] () {
+	                     handler -> deconvolve (soft. data (),
+	                                            soft. size (),
+	                                            out. data ()); });
+	results. push_back (r);
+}
+
+void	protectionBench	(std::vector<protectionResult> &results) {
+std::mt19937	generator (2);
+//	the higher rates have viterbi block positions beyond 65535
+static const int bitRatesA [] = {8, 64, 128, 384, 768, 1024};
+static const int bitRatesB [] = {32, 128, 384, 768, 1024};
+
+	for (int protLevel = 0; protLevel < 8; protLevel ++) {
+	   bool isB	= (protLevel & 04) != 0;
+	   const int *rates	= isB ? bitRatesB : bitRatesA;
+	   int nRates	= isB ? sizeof (bitRatesB) / sizeof (int) :
+	                        sizeof (bitRatesA) / sizeof (int);
+	   for (int k = 0; k < nRates; k ++) {
+	      int L [2], PI [2];
+	      std::vector<bool> table;
+	      eepProfile (rates [k], protLevel, L, PI);
+	      addPuncturing (table, L [0], PI [0]);
+	      addPuncturing (table, L [1], PI [1]);
+	      addTail (table);
+	      eep_protection handler (rates [k], protLevel);
+	      std::string name = "EEP " + std::to_string ((protLevel & 03) + 1) +
+	                                         (isB ? "-B" : "-A");
+	      runProfile (&handler, name, rates [k], table,
+	                                          generator, results);
+	   }
+	}
+
+	int16_t bitRate, protLevel, L [4], PI [4];
+	for (int16_t i = 0;
+	     uep_protection::getProfile (i, &bitRate, &protLevel, L, PI);
+	     i ++) {
+	   std::vector<bool> table;
+	   for (int j = 0; j < 4; j ++)
+	      if (PI [j] > 0)
+	         addPuncturing (table, L [j], PI [j]);
+	   addTail (table);
+	   uep_protection handler (bitRate, protLevel);
+	   runProfile (&handler, "UEP " + std::to_string (protLevel),
+	                                 bitRate, table, generator, results);
+	}
+}
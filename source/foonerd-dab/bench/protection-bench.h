@@ -0,0 +1,44 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The depuncturing and deconvolution per protection profile:
+//	for all EEP profiles (A and B, for a few bitrates) and all
+//	entries of the UEP table a random logical frame is encoded
+//	(mother code and puncturing, see synthetic-signal.h), the
+//	decoder should give the frame back. The time for the
+//	depuncturing and for the complete deconvolution is measured
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	protectionResult {
+	std::string	name;
+	int		bitRate;
+	int		inputBits;
+	double		depunctureNs;	// per logical frame
+	double		deconvolveNs;	// per logical frame
+	bool		ok;
+};
+
+void	protectionBench	(std::vector<protectionResult> &);
@@ -0,0 +1,212 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"rate-bench.h"
+#include	"rate-converter.h"
+#include	<math.h>
+#include	<chrono>
+#include	<complex>
+
+//
+//	the former conversion: per msec linear interpolation between
+//	the two nearest input samples
+class	linearConverter {
+public:
+		linearConverter	(int32_t inRate) {
+	   convBufferSize	= inRate / 1000;
+	   convBuffer. resize (convBufferSize + 1);
+	   mapTable_int. resize (2048);
+	   mapTable_float. resize (2048);
+	   for (int i = 0; i < 2048; i ++) {
+	      float inVal	= float (inRate / 1000);
+	      mapTable_int [i]	= int (floor (i * (inVal / 2048.0)));
+	      mapTable_float [i] = i * (inVal / 2048.0) - mapTable_int [i];
+	   }
+	   convIndex	= 0;
+	}
+	int32_t	convert (const std::complex<float> *in, int32_t n,
+	                 std::complex<float> *out) {
+	int32_t	count	= 0;
+	   for (int i = 0; i < n; i ++) {
+	      convBuffer [convIndex ++] = in [i];
+	      if (convIndex > convBufferSize) {
+	         for (int j = 0; j < 2048; j ++) {
+	            int16_t inpBase	= mapTable_int [j];
+	            float   inpRatio	= mapTable_float [j];
+	            out [count ++]	= convBuffer [inpBase + 1] * inpRatio +
+	                                  convBuffer [inpBase] * (1 - inpRatio);
+	         }
+	         convBuffer [0]	= convBuffer [convBufferSize];
+	         convIndex	= 1;
+	      }
+	   }
+	   return count;
+	}
+private:
+	int32_t		convBufferSize;
+	int32_t		convIndex;
+	std::vector<std::complex<float>>	convBuffer;
+	std::vector<int16_t>	mapTable_int;
+	std::vector<float>	mapTable_float;
+};
+
+//
+//	converts 100 msec of a tone, per msec as the devices do,
+//	and returns the output
+template <typename C>
+static
+std::vector<std::complex<float>>
+	toneResponse	(C &converter, int32_t inRate, double f) {
+int32_t	block	= inRate / 1000;
+std::vector<std::complex<float>> in (block);
+std::vector<std::complex<float>> out;
+std::vector<std::complex<float>> buffer (2 * 2048 + 64);
+
+	for (int b = 0; b < 100; b ++) {
+	   for (int i = 0; i < block; i ++) {
+	      double t	= (double)(b * block + i) / inRate;
+	      in [i]	= std::complex<float> (cos (2 * M_PI * f * t),
+	                                       sin (2 * M_PI * f * t));
+	   }
+	   int n	= converter. convert (in. data (), block, buffer. data ());
+	   out. insert (out. end (), buffer. begin (), buffer. begin () + n);
+	}
+	return out;
+}
+
+//	the gain (in dB) of the output, skipping the first msec
+static
+double	gainDb		(const std::vector<std::complex<float>> &out) {
+double	power	= 0;
+int	n	= 0;
+
+	for (size_t i = 2048; i < out. size (); i ++, n ++)
+	   power	+= std::norm (out [i]);
+	return 10 * log10 (power / n + 1e-30);
+}
+
+template <typename C>
+static
+double	timeIt		(C &converter, int32_t inRate) {
+int32_t	block	= inRate / 1000;
+std::vector<std::complex<float>> in (block);
+std::vector<std::complex<float>> out (2 * 2048 + 64);
+int	rounds	= 0;
+double	elapsed;
+
+	for (int i = 0; i < block; i ++)
+	   in [i] = std::complex<float> (cos (0.01 * i), sin (0.013 * i));
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   for (int i = 0; i < 16; i ++)
+	      converter. convert (in. data (), block, out. data ());
+	   rounds	+= 16;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.1);
+	return (double)rounds * block / elapsed / 1e6;
+}
+
+void	rateBench	(std::vector<rateResult> &results) {
+struct	device {
+	const char	*name;
+	int32_t		rate;
+};
+static const device devices [] = {
+	{"pluto",	 2100000},
+	{"airspy",	 2500000},
+	{"airspy",	 6000000},
+	{"airspy",	10000000},
+	{"xml",		 2000000}
+};
+static const int kernels [] = {RC_SCALAR, RC_SSE2, RC_AVX2, RC_NEON};
+
+	for (auto &d : devices) {
+	   std::vector<double> passTones;
+	   std::vector<double> stopTones;
+	   for (int k = -3; k <= 3; k ++)
+	      passTones. push_back (k * 256000.0);
+	   double nyquist	= d. rate / 2.0 - 15000;
+	   if (nyquist > 4000000)
+	      nyquist = 4000000;
+	   for (int k = 0; (k < 4) && (nyquist > 1220000); k ++) {
+	      double f	= 1220000 + k * (nyquist - 1220000) / 3;
+	      stopTones. push_back (f);
+	      stopTones. push_back (-f);
+	   }
+
+	   double linearStop	= 0;
+	   for (size_t i = 0; i < stopTones. size (); i ++) {
+	      linearConverter lc (d. rate);
+	      double a	= - gainDb (toneResponse (lc, d. rate, stopTones [i]));
+	      if ((i == 0) || (a < linearStop))
+	         linearStop = a;
+	   }
+	   linearConverter lc (d. rate);
+	   double linearMsps	= timeIt (lc, d. rate);
+
+	   std::vector<std::complex<float>> reference;
+	   for (int kernel : kernels) {
+	      rateConverter rc (d. rate);
+	      if (!rc. setKernel (kernel))
+	         continue;
+	      rateResult r;
+	      r. device		= d. name;
+	      r. inRate		= d. rate;
+	      r. L		= rc. L ();
+	      r. M		= rc. M ();
+	      r. taps		= rc. taps ();
+	      r. kernel		= rc. kernelName ();
+	      r. linearMsps	= linearMsps;
+	      r. linearStopbandDb	= linearStop;
+	      r. passbandDb	= 0;
+	      for (double f : passTones) {
+	         rc. reset ();
+	         double g	= fabs (gainDb (toneResponse (rc, d. rate, f)));
+	         if (g > r. passbandDb)
+	            r. passbandDb = g;
+	      }
+	      r. stopbandDb	= 0;
+	      for (size_t i = 0; i < stopTones. size (); i ++) {
+	         rc. reset ();
+	         double a	= - gainDb (toneResponse (rc, d. rate,
+	                                                  stopTones [i]));
+	         if ((i == 0) || (a < r. stopbandDb))
+	            r. stopbandDb = a;
+	      }
+//
+//	the kernels differ in the order of the additions only
+	      rc. reset ();
+	      std::vector<std::complex<float>> out =
+	                        toneResponse (rc, d. rate, 300000);
+	      if (kernel == RC_SCALAR)
+	         reference	= out;
+	      r. agrees	= out. size () == reference. size ();
+	      for (size_t i = 0; r. agrees && (i < out. size ()); i ++)
+	         if (std::abs (out [i] - reference [i]) > 1e-4)
+	            r. agrees = false;
+	      r. msps	= timeIt (rc, d. rate);
+	      results. push_back (r);
+	   }
+	}
+}
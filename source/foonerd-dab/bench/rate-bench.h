@@ -0,0 +1,50 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The sample rate converter, for the rates of the devices using
+//	it: the number of input samples converted per second (on one
+//	core) per inner product kernel, the gain over the DAB band
+//	(|f| <= 768 kHz), and the attenuation of tones above 1.22 MHz,
+//	that would alias into the adjacent channel at 2048000 samples/s.
+//	The former linear interpolation is measured for comparison
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	rateResult {
+	std::string	device;
+	int32_t		inRate;
+	int		L;
+	int		M;
+	int		taps;
+	std::string	kernel;
+	double		msps;		// input Msamples per second
+	double		linearMsps;	// idem, linear interpolation
+	double		passbandDb;	// largest deviation in the DAB band
+	double		stopbandDb;	// smallest attenuation, 0 if no tones
+	double		linearStopbandDb;
+	bool		agrees;		// with the scalar kernel
+};
+
+void	rateBench	(std::vector<rateResult> &);
@@ -0,0 +1,276 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"ring-bench.h"
+#include	"ringbuffer.h"
+#include	"legacy-ringbuffer.h"
+#include	<string.h>
+#include	<algorithm>
+#include	<complex>
+#include	<chrono>
+#include	<thread>
+
+typedef	std::complex<float>	sample;
+
+#define	STREAM_SAMPLES	(1 << 25)
+#define	STREAM_IN	32768
+#define	STREAM_OUT	2552
+#define	ROUND_TRIPS	20000
+
+template <typename F>
+static
+double	timeIt	(F f) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   for (int i = 0; i < 100; i ++)
+	      f ();
+	   rounds += 100;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.2);
+	return elapsed * 1e9 / rounds;
+}
+
+static
+double	seconds	(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>
+	                (std::chrono::steady_clock::now () - start). count ();
+}
+//
+//	the i-th sample of a stream, exact in floats
+static inline
+sample	streamSample	(uint32_t i) {
+	return sample ((float)(i & 0xFFFF), (float)(i >> 16));
+}
+//
+//	the interface both rings have
+template <class R>
+static
+void	putGet		(std::vector<ringResult> &results, R &ring,
+	                 const char *name, int n) {
+std::vector<sample> in (n);
+std::vector<sample> out (n);
+ringResult r;
+
+	for (int i = 0; i < n; i ++)
+	   in [i] = streamSample (i);
+	r. value	= timeIt ([&] () {
+	                    ring. putDataIntoBuffer (in. data (), n);
+	                    ring. getDataFromBuffer (out. data (), n); });
+	r. test		= "put + get " + std::to_string (n);
+	r. ring		= name;
+	r. unit		= "ns";
+	r. agrees	= in == out;
+	results. push_back (r);
+}
+
+static
+void	reservePeek	(std::vector<ringResult> &results,
+	                 RingBuffer<sample> &ring, int n) {
+std::vector<sample> in (n);
+std::vector<sample> out (n);
+ringResult r;
+
+	for (int i = 0; i < n; i ++)
+	   in [i] = streamSample (i);
+//	without the double mapping a region may stop at the end
+	r. value	= timeIt ([&] () {
+	                    for (int done = 0; done < n; ) {
+	                       int32_t amount = n - done;
+	                       sample *w = ring. reserve (&amount);
+	                       memcpy (w, &in [done], amount * sizeof (sample));
+	                       ring. publish (amount);
+	                       done += amount;
+	                    }
+	                    for (int done = 0; done < n; ) {
+	                       int32_t amount = n - done;
+	                       const sample *p = ring. peek (&amount);
+	                       memcpy (&out [done], p, amount * sizeof (sample));
+	                       ring. commit (amount);
+	                       done += amount;
+	                    }});
+	r. test		= "put + get " + std::to_string (n);
+	r. ring		= "zero copy";
+	r. unit		= "ns";
+	r. agrees	= in == out;
+	results. push_back (r);
+}
+//
+//	a writer thread and a reader thread, the reader checks the
+//	stream
+template <class R>
+static
+void	stream		(std::vector<ringResult> &results, R &ring,
+	                 const char *name) {
+bool	ok	= true;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+std::thread writer ([&] () {
+	std::vector<sample> block (STREAM_IN);
+	for (uint32_t next = 0; next < STREAM_SAMPLES; ) {
+	   for (int i = 0; i < STREAM_IN; i ++)
+	      block [i] = streamSample (next + i);
+	   int done	= 0;
+	   while (done < STREAM_IN) {
+	      int n = ring. putDataIntoBuffer (&block [done],
+	                                       STREAM_IN - done);
+	      if (n == 0)
+	         std::this_thread::yield ();
+	      done	+= n;
+	   }
+	   next	+= STREAM_IN;
+	}});
+std::vector<sample> block (STREAM_OUT);
+	for (uint32_t next = 0; next < STREAM_SAMPLES; ) {
+	   int n	= ring. getDataFromBuffer (block. data (),
+	                          std::min<uint32_t> (STREAM_OUT,
+	                                              STREAM_SAMPLES - next));
+	   if (n == 0) {
+	      std::this_thread::yield ();
+	      continue;
+	   }
+	   for (int i = 0; i < n; i ++)
+	      if (block [i] != streamSample (next + i))
+	         ok = false;
+	   next	+= n;
+	}
+	writer. join ();
+	ringResult r;
+	r. value	= STREAM_SAMPLES / seconds (start) / 1e6;
+	r. test		= "2 threads 32768/2552";
+	r. ring		= name;
+	r. unit		= "MS/s";
+	r. agrees	= ok;
+	results. push_back (r);
+}
+//
+//	the same with the zero copy interface: the writer produces into
+//	the ring, the reader checks in place
+static
+void	streamInPlace	(std::vector<ringResult> &results,
+	                 RingBuffer<sample> &ring) {
+bool	ok	= true;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+std::thread writer ([&] () {
+	for (uint32_t next = 0; next < STREAM_SAMPLES; ) {
+	   int32_t amount	= STREAM_IN;
+	   sample *w	= ring. reserve (&amount);
+	   if (amount == 0) {
+	      std::this_thread::yield ();
+	      continue;
+	   }
+	   for (int i = 0; i < amount; i ++)
+	      w [i] = streamSample (next + i);
+	   ring. publish (amount);
+	   next	+= amount;
+	}});
+	for (uint32_t next = 0; next < STREAM_SAMPLES; ) {
+	   int32_t amount	= std::min<uint32_t> (STREAM_OUT,
+	                                              STREAM_SAMPLES - next);
+	   const sample *p	= ring. peek (&amount);
+	   if (amount == 0) {
+	      std::this_thread::yield ();
+	      continue;
+	   }
+	   for (int i = 0; i < amount; i ++)
+	      if (p [i] != streamSample (next + i))
+	         ok = false;
+	   ring. commit (amount);
+	   next	+= amount;
+	}
+	writer. join ();
+	ringResult r;
+	r. value	= STREAM_SAMPLES / seconds (start) / 1e6;
+	r. test		= "2 threads 32768/2552";
+	r. ring		= "zero copy";
+	r. unit		= "MS/s";
+	r. agrees	= ok;
+	results. push_back (r);
+}
+//
+//	a sample goes to the other thread through the first ring, and
+//	comes back through the second one
+template <class R>
+static
+void	pingPong	(std::vector<ringResult> &results,
+	                 R &there, R &back, const char *name) {
+bool	ok	= true;
+std::thread echo ([&] () {
+	for (int i = 0; i < ROUND_TRIPS; i ++) {
+	   sample s;
+	   while (there. getDataFromBuffer (&s, 1) == 0)
+	      std::this_thread::yield ();
+	   back. putDataIntoBuffer (&s, 1);
+	}});
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	for (int i = 0; i < ROUND_TRIPS; i ++) {
+	   sample s	= streamSample (i);
+	   there. putDataIntoBuffer (&s, 1);
+	   while (back. getDataFromBuffer (&s, 1) == 0)
+	      std::this_thread::yield ();
+	   if (s != streamSample (i))
+	      ok = false;
+	}
+	double elapsed	= seconds (start);
+	echo. join ();
+	ringResult r;
+	r. value	= elapsed * 1e9 / ROUND_TRIPS / 2;
+	r. test		= "latency";
+	r. ring		= name;
+	r. unit		= "ns";
+	r. agrees	= ok;
+	results. push_back (r);
+}
+
+void	ringBench	(std::vector<ringResult> &results) {
+static const int sizes [] = {1, 64, 2552};
+
+	for (int n : sizes) {
+	   legacyRingBuffer<sample> legacy (8192);
+	   RingBuffer<sample> ring (8192);
+	   putGet (results, legacy, "legacy", n);
+	   putGet (results, ring, "atomic", n);
+	   reservePeek (results, ring, n);
+	}
+	{  legacyRingBuffer<sample> legacy (1 << 18);
+	   stream (results, legacy, "legacy");
+	}
+	{  RingBuffer<sample> ring (1 << 18);
+	   stream (results, ring, "atomic");
+	}
+	{  RingBuffer<sample> ring (1 << 18);
+	   streamInPlace (results, ring);
+	}
+	{  legacyRingBuffer<sample> there (1024);
+	   legacyRingBuffer<sample> back (1024);
+	   pingPong (results, there, back, "legacy");
+	}
+	{  RingBuffer<sample> there (1024);
+	   RingBuffer<sample> back (1024);
+	   pingPong (results, there, back, "atomic");
+	}
+}
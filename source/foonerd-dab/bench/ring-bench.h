@@ -0,0 +1,47 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The RingBuffer against the one it replaced (legacy-ringbuffer.h):
+//	  - put and get of a block by a single thread, ns per pair,
+//	  - a writer and a reader thread, blocks of 32768 in and
+//	    2552 (a mode I block) out, Msamples per second,
+//	  - the latency, half of the round trip of a sample through two
+//	    rings between two threads.
+//	The new ring is measured with both its interfaces, the PA style
+//	one (copying) and peek/commit - reserve/publish (zero copy).
+//	The data passing through is checked. Note that with a single
+//	core the two thread figures are dominated by the scheduler
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	ringResult {
+	std::string	test;
+	std::string	ring;		// legacy, atomic, zero copy
+	double		value;
+	std::string	unit;
+	bool		agrees;		// the data arrived intact
+};
+
+void	ringBench	(std::vector<ringResult> &);
@@ -0,0 +1,152 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"rs-bench.h"
+#include	"reed-solomon.h"
+#include	<string.h>
+#include	<chrono>
+#include	<random>
+
+template <typename F>
+static
+double	timeIt	(F f) {
+int	rounds	= 0;
+double	elapsed;
+std::chrono::steady_clock::time_point start =
+	                                 std::chrono::steady_clock::now ();
+	do {
+	   for (int i = 0; i < 16; i ++)
+	      f ();
+	   rounds	+= 16;
+	   elapsed	= std::chrono::duration<double>
+	                   (std::chrono::steady_clock::now () - start). count ();
+	} while (elapsed < 0.1);
+	return elapsed * 1e9 / rounds;
+}
+//
+//	the former decoding, codeword by codeword
+static
+int16_t	decodeLoop	(reedSolomon &rs, const uint8_t *in, uint8_t *out,
+	                 int count, int length, int dataLength, int cutlen) {
+uint8_t	rsIn	[255];
+uint8_t	rsOut	[255];
+int16_t	corrected	= 0;
+bool	failed		= false;
+
+	for (int j = 0; j < count; j ++) {
+	   for (int k = 0; k < length; k ++)
+	      rsIn [k] = in [j + k * count];
+	   int16_t res	= rs. dec (rsIn, rsOut, cutlen);
+	   if (res < 0)
+	      failed = true;
+	   else
+	      corrected += res;
+	   for (int k = 0; k < dataLength; k ++)
+	      out [j + k * count] = rsOut [k];
+	}
+	return failed ? -1 : corrected;
+}
+
+void	rsBench		(std::vector<rsResult> &results) {
+struct	code {
+	const char	*name;
+	int		nroots;
+	int		cutlen;
+	int		count;
+};
+static const code codes [] = {
+	{"RS(120,110)", 10, 135,  6},	// 48 kbit/s
+	{"RS(120,110)", 10, 135, 12},	// 96 kbit/s
+	{"RS(120,110)", 10, 135, 24},	// 192 kbit/s
+	{"RS(204,188)", 16,  51, 12}	// packet data
+};
+static const int kernels [] = {RS_SCALAR, RS_SSSE3, RS_AVX2, RS_NEON};
+std::mt19937	generator (5);
+std::uniform_int_distribution<int> byte (0, 255);
+
+	for (auto &c : codes) {
+	   reedSolomon	rs (8, 0435, 0, 1, c. nroots);
+	   int	length		= 255 - c. cutlen;
+	   int	dataLength	= length - c. nroots;
+	   std::vector<uint8_t> data (c. count * dataLength);
+	   std::vector<uint8_t> clean (c. count * length);
+	   uint8_t codeword [255];
+	   uint8_t message  [255];
+
+	   for (auto &x : data)
+	      x = byte (generator);
+	   for (int j = 0; j < c. count; j ++) {
+	      for (int k = 0; k < dataLength; k ++)
+	         message [k] = data [j + k * c. count];
+	      rs. enc (message, codeword, c. cutlen);
+	      for (int k = 0; k < length; k ++)
+	         clean [j + k * c. count] = codeword [k];
+	   }
+//
+//	clean, one error in the superframe, and nroots / 2 errors
+//	(at different positions) in each codeword
+	   for (int variant = 0; variant < 3; variant ++) {
+	      std::vector<uint8_t> superframe	= clean;
+	      std::string errors	= variant == 0 ? "none" :
+	                                  variant == 1 ? "1" :
+	                                  std::to_string (c. nroots / 2) +
+	                                                  " per codeword";
+	      if (variant == 1)
+	         superframe [c. count * length / 2] ^= 0x5A;
+	      if (variant == 2)
+	         for (int j = 0; j < c. count; j ++)
+	            for (int e = 0; e < c. nroots / 2; e ++) {
+	               int k = (e * length) / (c. nroots / 2) + j % 7;
+	               superframe [j + k * c. count] ^= 1 + byte (generator) % 255;
+	            }
+
+	      std::vector<uint8_t> out1 (c. count * dataLength);
+	      std::vector<uint8_t> out2 (c. count * dataLength);
+	      int16_t r1	= decodeLoop (rs, superframe. data (),
+	                                      out1. data (), c. count,
+	                                      length, dataLength, c. cutlen);
+	      double loopNs	= timeIt ([&] () {
+	                        decodeLoop (rs, superframe. data (),
+	                                    out1. data (), c. count,
+	                                    length, dataLength, c. cutlen); });
+	      for (int kernel : kernels) {
+	         if (!rs. setKernel (kernel))
+	            continue;
+	         rsResult r;
+	         int16_t r2	= rs. decBatch (superframe. data (),
+	                                        out2. data (), c. count,
+	                                        c. cutlen);
+	         r. code	= c. name;
+	         r. codewords	= c. count;
+	         r. errors	= errors;
+	         r. kernel	= rs. kernelName ();
+	         r. agrees	= (r1 == r2) && (out1 == out2) && (out2 == data);
+	         r. loopRate	= 1e9 / loopNs;
+	         r. batchRate	= 1e9 / timeIt ([&] () {
+	                           rs. decBatch (superframe. data (),
+	                                         out2. data (), c. count,
+	                                         c. cutlen); });
+	         results. push_back (r);
+	      }
+	   }
+	}
+}
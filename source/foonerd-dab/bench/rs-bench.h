@@ -0,0 +1,46 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The Reed-Solomon decoding of DAB+ superframes (RS(120,110),
+//	RSDims codewords) and of packet data (RS(204,188), 12 codewords):
+//	superframes of encoded random data, clean, with a single
+//	error and with the maximum number of correctable errors in each
+//	codeword, are decoded per codeword with dec - as was done
+//	before - and in one go with decBatch, with each of the syndrome
+//	kernels. The outputs should agree, and equal the data
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+
+struct	rsResult {
+	std::string	code;
+	int		codewords;
+	std::string	errors;
+	std::string	kernel;
+	double		loopRate;	// superframes per second, dec
+	double		batchRate;	// superframes per second, decBatch
+	bool		agrees;
+};
+
+void	rsBench		(std::vector<rsResult> &);
@@ -0,0 +1,600 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"synthetic-signal.h"
+#include	"dab-constants.h"
+#include	"dab-params.h"
+#include	"phasetable.h"
+#include	"freq-interleaver.h"
+#include	"protTables.h"
+#include	"reed-solomon.h"
+#include	<cstring>
+#include	<cmath>
+#include	<random>
+
+//	rms amplitude of the signal (the null symbol excluded)
+#define	SIGNAL_LEVEL	0.2
+#define	NR_CIFS		(4 * SYNTHETIC_FRAMES)
+#define	CU_BITS		64
+#define	CIF_BITS	(864 * CU_BITS)
+#define	FIB_BYTES	32
+#define	ENSEMBLE_ID	0x4FFF
+
+struct	subchannelDescriptor {
+	int		subChId;
+	int		startAddr;	// in CU's
+	int		size;		// in CU's, EEP 3-A
+	int		bitRate;
+	int		ASCTy;
+	uint16_t	SId;
+	const char	*name;
+};
+
+static
+const subchannelDescriptor subchannels [] = {
+	{0,  0, 72,  96, 077, 0x4F01, SYNTHETIC_DAB_PLUS},
+	{1, 72, 96, 128,   0, 0x4F02, SYNTHETIC_DAB}
+};
+#define	NR_SUBCHANNELS	2
+
+//	the energy dispersal sequence, x^9 + x^5 + 1, all ones as start
+static
+std::vector<uint8_t>	prbs	(int n) {
+std::vector<uint8_t> res (n);
+uint8_t	shiftRegister [9];
+
+	memset (shiftRegister, 1, 9);
+	for (int i = 0; i < n; i ++) {
+	   res [i] = shiftRegister [8] ^ shiftRegister [4];
+	   for (int j = 8; j > 0; j --)
+	      shiftRegister [j] = shiftRegister [j - 1];
+	   shiftRegister [0] = res [i];
+	}
+	return res;
+}
+//
+//	the CRC of the FIB's and of the AAC access units: x^16 + x^12 +
+//	x^5 + 1, all ones as start, the inverted remainder is sent
+static
+uint16_t	crc16	(const uint8_t *msg, int len) {
+uint16_t accumulator	= 0xFFFF;
+
+	for (int i = 0; i < len; i ++) {
+	   accumulator ^= msg [i] << 8;
+	   for (int j = 0; j < 8; j ++)
+	      accumulator = (accumulator & 0x8000) ?
+	                       (accumulator << 1) ^ 0x1021 : accumulator << 1;
+	}
+	return ~accumulator;
+}
+//
+//	the fire code of a DAB+ superframe covers bytes 2 .. 10,
+//	g(x) = x^16 + x^14 + x^13 + x^12 + x^11 + x^5 + x^3 + x^2 + x + 1
+static
+uint16_t	firecode	(const uint8_t *frame) {
+uint16_t state	= 0;
+
+	for (int i = 2; i < 11; i ++) {
+	   state ^= frame [i] << 8;
+	   for (int j = 0; j < 8; j ++)
+	      state = (state & 0x8000) ? (state << 1) ^ 0x782F : state << 1;
+	}
+	return state;
+}
+
+static
+void	toBits	(const uint8_t *bytes, int nBytes, uint8_t *bits) {
+	for (int i = 0; i < nBytes * 8; i ++)
+	   bits [i] = (bytes [i / 8] >> (7 - i % 8)) & 01;
+}
+//
+//	the mother code, rate 1/4 with polynomials 133, 171, 145, 133
+//	(octal), 6 tail bits flush the register
+void	convEncode	(const uint8_t *in, int n, std::vector<uint8_t> &out) {
+uint8_t	reg	= 0;	// bit k is a_{i - k}
+
+	out. resize (4 * (n + 6));
+	for (int i = 0; i < n + 6; i ++) {
+	   reg	= (reg << 1) | (i < n ? in [i] : 0);
+	   uint8_t a [7];
+	   for (int k = 0; k < 7; k ++)
+	      a [k] = (reg >> k) & 01;
+	   out [4 * i]		= a [0] ^ a [2] ^ a [3] ^ a [5] ^ a [6];
+	   out [4 * i + 1]	= a [0] ^ a [1] ^ a [2] ^ a [3] ^ a [6];
+	   out [4 * i + 2]	= a [0] ^ a [1] ^ a [4] ^ a [6];
+	   out [4 * i + 3]	= out [4 * i];
+	}
+}
+
+void	addPuncturing	(std::vector<bool> &table, int blocks, int PI) {
+const int8_t *code	= get_PCodes (PI - 1);
+
+	for (int i = 0; i < blocks * 128; i ++)
+	   table. push_back (code [i % 32] != 0);
+}
+//
+//	the tail is punctured with PI_X (the first 24 entries of PI 8)
+void	addTail		(std::vector<bool> &table) {
+const int8_t *code	= get_PCodes (8 - 1);
+
+	for (int i = 0; i < 24; i ++)
+	   table. push_back (code [i] != 0);
+}
+
+void	puncture	(const std::vector<uint8_t> &mother,
+	                 const std::vector<bool> &table,
+	                 std::vector<uint8_t> &out) {
+	out. resize (0);
+	for (int i = 0; i < (int)mother. size (); i ++)
+	   if (table [i])
+	      out. push_back (mother [i]);
+}
+//
+//	an in place radix 2 (inverse) FFT for the modulator
+static
+void	inverseFFT	(std::complex<float> *v, int n) {
+	for (int i = 1, j = 0; i < n; i ++) {
+	   int bit = n >> 1;
+	   for (; j & bit; bit >>= 1)
+	      j ^= bit;
+	   j ^= bit;
+	   if (i < j)
+	      std::swap (v [i], v [j]);
+	}
+	for (int len = 2; len <= n; len <<= 1) {
+	   double angle	= 2 * M_PI / len;
+	   for (int k = 0; k < len / 2; k ++) {
+	      std::complex<float> w ((float)cos (angle * k),
+	                             (float)sin (angle * k));
+	      for (int i = 0; i < n; i += len) {
+	         std::complex<float> a	= v [i + k];
+	         std::complex<float> b	= v [i + k + len / 2] * w;
+	         v [i + k]		= a + b;
+	         v [i + k + len / 2]	= a - b;
+	      }
+	   }
+	}
+}
+
+	syntheticSignal::syntheticSignal	(double seconds, float snr,
+	                                 device_eof_callback_t eofHandler,
+	                                 void *userData) {
+	this	-> total	= (uint64_t)(seconds * INPUT_RATE);
+	this	-> eofHandler	= eofHandler;
+	this	-> userData	= userData;
+	this	-> frameSize	= dabParams (1). get_T_F ();
+	delivered	= 0;
+	eofSignalled	= false;
+	running. store (false);
+	generate (snr);
+}
+
+	syntheticSignal::~syntheticSignal	() {
+	stopReader ();
+}
+
+bool	syntheticSignal::restartReader	(int32_t frequency) {
+	(void)frequency;
+	running. store (true);
+	return true;
+}
+
+void	syntheticSignal::stopReader	() {
+	if (!running. load ())
+	   return;
+	running. store (false);
+	wakeUp ();
+}
+
+bool	syntheticSignal::setUnthrottled	(bool b) {
+	(void)b;
+	return true;
+}
+
+int32_t	syntheticSignal::Samples	() {
+	if (!running. load ())
+	   return 0;
+	uint64_t left	= total - delivered;
+	return left > (1 << 24) ? (1 << 24) : (int32_t)left;
+}
+//
+//	the samples are taken in place, as far as the end of
+//	the generated sequence
+const std::complex<float> *syntheticSignal::peekSamples	(int32_t *amount) {
+uint64_t offset	= delivered % signal. size ();
+uint64_t left	= total - delivered;
+
+	if (!running. load () || (left == 0)) {
+	   *amount = 0;
+	   return nullptr;
+	}
+	if ((uint64_t)*amount > signal. size () - offset)
+	   *amount = signal. size () - offset;
+	if ((uint64_t)*amount > left)
+	   *amount = left;
+	return &signal [offset];
+}
+
+//
+//	the decoder takes its samples per symbol, a remainder shorter
+//	than a frame is never asked for, so the end of the input is
+//	signalled as soon as less than a frame is left
+void	syntheticSignal::commitSamples	(int32_t amount) {
+	delivered	+= amount;
+	if ((delivered + frameSize > total) && !eofSignalled) {
+	   eofSignalled	= true;
+	   if (eofHandler != nullptr)
+	      eofHandler (userData);
+	}
+}
+
+int32_t	syntheticSignal::getSamples	(std::complex<float> *v,
+	                                 int32_t size) {
+int32_t	done	= 0;
+
+	while (done < size) {
+	   int32_t amount	= size - done;
+	   const std::complex<float> *p	= peekSamples (&amount);
+	   if (p == nullptr)
+	      break;
+	   memcpy (&v [done], p, amount * sizeof (std::complex<float>));
+	   commitSamples (amount);
+	   done	+= amount;
+	}
+	return done;
+}
+
+bool	syntheticSignal::writeRaw	(const std::string &fileName) {
+FILE	*f	= fopen (fileName. c_str (), "wb");
+std::vector<uint8_t> buffer (2 * 8192);
+
+	if (f == nullptr)
+	   return false;
+	for (uint64_t i = 0; i < total; i += 8192) {
+	   int n	= total - i < 8192 ? total - i : 8192;
+	   for (int j = 0; j < n; j ++) {
+	      std::complex<float> s	= signal [(i + j) % signal. size ()];
+	      int re	= (int)lrintf (128 + real (s) * 128);
+	      int im	= (int)lrintf (128 + imag (s) * 128);
+	      buffer [2 * j]	 = re < 0 ? 0 : re > 255 ? 255 : re;
+	      buffer [2 * j + 1] = im < 0 ? 0 : im > 255 ? 255 : im;
+	   }
+	   if (fwrite (buffer. data (), 2, n, f) != (size_t)n) {
+	      fclose (f);
+	      return false;
+	   }
+	}
+	fclose (f);
+	return true;
+}
+//
+//	The FIB's of a CIF: the first one carries the ensemble
+//	information and the organization of the subchannels and services
+//	(FIG 0/0, 0/1, 0/2), the second the ensemble label (FIG 1/0)
+//	and the third one of the service labels (FIG 1/1)
+static
+void	putLabel	(std::vector<uint8_t> &fig, const char *label) {
+int	l	= strlen (label);
+
+	for (int i = 0; i < 16; i ++)
+	   fig. push_back (i < l ? label [i] : ' ');
+	fig. push_back (0xFF);		// short label: all characters
+	fig. push_back (0x00);
+}
+
+void	syntheticSignal::buildFIB	(int cif, int fib, uint8_t *out) {
+std::vector<uint8_t> fig;
+
+	if (fib == 0) {
+//	FIG 0/0, ensemble information with the CIF count
+	   fig. push_back ((0 << 5) | 5);
+	   fig. push_back (0);
+	   fig. push_back (ENSEMBLE_ID >> 8);
+	   fig. push_back (ENSEMBLE_ID & 0xFF);
+	   fig. push_back ((cif / 250) & 0x1F);
+	   fig. push_back (cif % 250);
+//	FIG 0/1, subchannels in long form, EEP 3-A
+	   fig. push_back ((0 << 5) | (1 + 4 * NR_SUBCHANNELS));
+	   fig. push_back (1);
+	   for (int i = 0; i < NR_SUBCHANNELS; i ++) {
+	      const subchannelDescriptor &s = subchannels [i];
+	      fig. push_back ((s. subChId << 2) | (s. startAddr >> 8));
+	      fig. push_back (s. startAddr & 0xFF);
+	      fig. push_back (0x80 | (2 << 2) | (s. size >> 8));
+	      fig. push_back (s. size & 0xFF);
+	   }
+//	FIG 0/2, one (primary) component per service
+	   fig. push_back ((0 << 5) | (1 + 5 * NR_SUBCHANNELS));
+	   fig. push_back (2);
+	   for (int i = 0; i < NR_SUBCHANNELS; i ++) {
+	      const subchannelDescriptor &s = subchannels [i];
+	      fig. push_back (s. SId >> 8);
+	      fig. push_back (s. SId & 0xFF);
+	      fig. push_back (1);
+	      fig. push_back (s. ASCTy & 077);
+	      fig. push_back ((s. subChId << 2) | 02);
+	   }
+	}
+	else
+	if (fib == 1) {
+//	FIG 1/0, the ensemble label
+	   fig. push_back ((1 << 5) | 21);
+	   fig. push_back (0);
+	   fig. push_back (ENSEMBLE_ID >> 8);
+	   fig. push_back (ENSEMBLE_ID & 0xFF);
+	   putLabel (fig, SYNTHETIC_ENSEMBLE);
+	}
+	else {
+//	FIG 1/1, a service label, the services take turns
+	   const subchannelDescriptor &s = subchannels [cif % NR_SUBCHANNELS];
+	   fig. push_back ((1 << 5) | 21);
+	   fig. push_back (1);
+	   fig. push_back (s. SId >> 8);
+	   fig. push_back (s. SId & 0xFF);
+	   putLabel (fig, s. name);
+	}
+//	end marker and padding, then the CRC
+	memset (out, 0, FIB_BYTES);
+	memcpy (out, fig. data (), fig. size ());
+	if (fig. size () < 30)
+	   out [fig. size ()] = 0xFF;
+	uint16_t crc	= crc16 (out, 30);
+	out [30]	= crc >> 8;
+	out [31]	= crc & 0xFF;
+}
+//
+//	The FIC of a CIF: three FIB's, energy dispersal, convolutional
+//	coding and puncturing (21 blocks PI 16, 3 blocks PI 15, the tail)
+//	give 2304 bits
+void	syntheticSignal::ficBits	(int cif, std::vector<uint8_t> &out) {
+static std::vector<bool> table;
+uint8_t	fibs [3 * FIB_BYTES];
+uint8_t	bits [3 * FIB_BYTES * 8];
+std::vector<uint8_t> dispersal	= prbs (768);
+std::vector<uint8_t> mother;
+
+	if (table. size () == 0) {
+	   addPuncturing (table, 21, 16);
+	   addPuncturing (table, 3, 15);
+	   addTail (table);
+	}
+	for (int i = 0; i < 3; i ++)
+	   buildFIB (cif, i, &fibs [i * FIB_BYTES]);
+	toBits (fibs, 3 * FIB_BYTES, bits);
+	for (int i = 0; i < 768; i ++)
+	   bits [i] ^= dispersal [i];
+	convEncode (bits, 768, mother);
+	puncture (mother, table, out);
+}
+//
+//	DAB+: each superframe (5 CIF's) holds 6 access units (48 kHz,
+//	no SBR, mono), each with a silent AAC frame. The superframe is
+//	protected by the fire code and the RS (120, 110) code. The result
+//	is a vector of bytes per CIF
+void	dabPlusFrames	(int bitRate, int nCifs,
+	                 std::vector<std::vector<uint8_t>> &cifs) {
+const int RSDims	= bitRate / 8;
+const int auCount	= 6;
+std::vector<uint8_t> frame (RSDims * 110);
+std::vector<uint8_t> coded (RSDims * 120);
+reedSolomon	rsEncoder (8, 0435, 0, 1, 10);
+int	auStart [auCount + 1];
+//	a single channel element without spectral data, followed by ID_END:
+//	id (3) tag (4) global gain (8) ics_info (11), pulse, tns and
+//	gain control absent (3) and id END (3)
+static const uint8_t silence [] = {0x00, 0x32, 0x00, 0x07};
+
+	auStart [0]	= 11;
+	for (int i = 1; i < auCount; i ++)
+	   auStart [i] = 11 + i * ((RSDims * 110 - 11) / auCount);
+	auStart [auCount]	= RSDims * 110;
+
+	cifs. resize (nCifs);
+	for (int sf = 0; sf < nCifs / 5; sf ++) {
+	   std::fill (frame. begin (), frame. end (), 0);
+	   frame [2]	= 0x40;		// dac rate 48 kHz
+	   frame [3]	= auStart [1] >> 4;
+	   frame [4]	= ((auStart [1] & 0xF) << 4) | (auStart [2] >> 8);
+	   frame [5]	= auStart [2] & 0xFF;
+	   frame [6]	= auStart [3] >> 4;
+	   frame [7]	= ((auStart [3] & 0xF) << 4) | (auStart [4] >> 8);
+	   frame [8]	= auStart [4] & 0xFF;
+	   frame [9]	= auStart [5] >> 4;
+	   frame [10]	= (auStart [5] & 0xF) << 4;
+	   for (int i = 0; i < auCount; i ++) {
+	      uint8_t *au	= &frame [auStart [i]];
+	      int length	= auStart [i + 1] - auStart [i] - 2;
+	      memcpy (au, silence, sizeof (silence));
+	      uint16_t crc	= crc16 (au, length);
+	      au [length]	= crc >> 8;
+	      au [length + 1]	= crc & 0xFF;
+	   }
+	   uint16_t fc	= firecode (frame. data ());
+	   frame [0]	= fc >> 8;
+	   frame [1]	= fc & 0xFF;
+	   for (int j = 0; j < RSDims; j ++) {
+	      uint8_t rsIn [120], rsOut [120];	// enc reads 120 bytes
+	      memset (rsIn, 0, sizeof (rsIn));
+	      for (int k = 0; k < 110; k ++)
+	         rsIn [k] = frame [j + k * RSDims];
+	      rsEncoder. enc (rsIn, rsOut, 135);
+	      for (int k = 0; k < 120; k ++)
+	         coded [j + k * RSDims] = rsOut [k];
+	   }
+	   for (int i = 0; i < 5; i ++)
+	      cifs [5 * sf + i]. assign (&coded [i * 3 * bitRate],
+	                                 &coded [(i + 1) * 3 * bitRate]);
+	}
+}
+//
+//	DAB: a 24 msec MP2 frame (48 kHz, stereo, no CRC) per CIF.
+//	The body is pseudo random, so the decoder produces non trivial
+//	audio. The last 4 bytes - where the F-PAD lives - are zero,
+//	i.e. no PAD
+void	mp2Frames	(int bitRate, int nCifs, uint32_t seed,
+	                 std::vector<std::vector<uint8_t>> &cifs) {
+std::mt19937	generator (seed);
+std::vector<uint8_t> frame (3 * bitRate, 0);
+
+	frame [0]	= 0xFF;
+	frame [1]	= 0xFD;		// MPEG 1, layer II, no CRC
+	frame [2]	= 0x84;		// 128 kbit/s, 48 kHz
+	frame [3]	= 0x00;		// stereo
+	cifs. resize (0);
+	for (int i = 0; i < nCifs; i ++) {
+	   for (int j = 4; j < 3 * bitRate - 4; j ++)
+	      frame [j] = generator () & 0xFF;
+	   cifs. push_back (frame);
+	}
+}
+
+//
+//	energy dispersal, convolutional coding, puncturing according
+//	to EEP 3-A and time interleaving, the result is - per CIF - the
+//	bits of the subchannel
+void	syntheticSignal::encodeSubchannel (
+	                        std::vector<std::vector<uint8_t>> &data,
+	                        int bitRate,
+	                        std::vector<std::vector<uint8_t>> &out) {
+static const int16_t interleaveMap [] =
+	                        {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
+int	nBits	= 24 * bitRate;
+std::vector<uint8_t> dispersal	= prbs (nBits);
+std::vector<uint8_t> bits (nBits);
+std::vector<uint8_t> mother;
+std::vector<std::vector<uint8_t>> coded (NR_CIFS);
+std::vector<bool> table;
+
+	addPuncturing (table, 6 * bitRate / 8 - 3, 8);
+	addPuncturing (table, 3, 7);
+	addTail (table);
+	for (int c = 0; c < NR_CIFS; c ++) {
+	   toBits (data [c]. data (), nBits / 8, bits. data ());
+	   for (int i = 0; i < nBits; i ++)
+	      bits [i] ^= dispersal [i];
+	   convEncode (bits. data (), nBits, mother);
+	   puncture (mother, table, coded [c]);
+	}
+//	bit i is delayed by interleaveMap [i % 16] CIF's, the sequence
+//	wraps around, NR_CIFS being a multiple of 16
+	out. resize (NR_CIFS);
+	for (int c = 0; c < NR_CIFS; c ++) {
+	   out [c]. resize (coded [c]. size ());
+	   for (int i = 0; i < (int)coded [c]. size (); i ++)
+	      out [c][i] = coded [(c - interleaveMap [i & 017] + NR_CIFS) %
+	                                                     NR_CIFS][i];
+	}
+}
+//
+//	one frame: the null symbol, the phase reference symbol, the
+//	3 FIC symbols and the 72 MSC symbols (4 CIF's).
+//	The bits of a symbol are mapped on the carriers as
+//	(1 - 2 b [i]) + j (1 - 2 b [K + i]), through the frequency
+//	interleaver, and modulated differentially
+void	syntheticSignal::modulate	(int frame,
+	                                 const std::vector<uint8_t> &fic,
+	                                 const std::vector<uint8_t> &msc,
+	                                 std::complex<float> *out) {
+dabParams	params (1);
+phaseTable	reference (1);
+interLeaver	interleaver (1);
+int	T_u		= params. get_T_u ();
+int	T_g		= params. get_T_g ();
+int	T_null		= params. get_T_null ();
+int	K		= params. get_carriers ();
+int	L		= params. get_L ();
+float	scale		= SIGNAL_LEVEL / sqrt ((float)K);
+std::vector<std::complex<float>> carriers (reference. refTable);
+std::vector<std::complex<float>> buffer (T_u);
+std::vector<int> bins (K);
+
+	(void)frame;
+	for (int i = 0; i < K; i ++) {
+	   int bin	= interleaver. mapIn (i);
+	   bins [i]	= bin < 0 ? bin + T_u : bin;
+	}
+	memset ((void *)out, 0, T_null * sizeof (std::complex<float>));
+	out	+= T_null;
+	for (int symbol = 0; symbol < L; symbol ++) {
+	   if (symbol > 0) {
+	      const uint8_t *b	= symbol < 4 ?
+	                             &fic [(symbol - 1) * 2 * K] :
+	                             &msc [(symbol - 4) * 2 * K];
+	      for (int i = 0; i < K; i ++) {
+	         std::complex<float> y ((1 - 2 * b [i]) * (float)M_SQRT1_2,
+	                                (1 - 2 * b [K + i]) * (float)M_SQRT1_2);
+	         carriers [bins [i]] *= y;
+	      }
+	   }
+	   buffer	= carriers;
+	   inverseFFT (buffer. data (), T_u);
+	   for (int i = 0; i < T_u; i ++)
+	      out [T_g + i] = buffer [i] * scale;
+	   memcpy ((void *)out, &out [T_u],
+	                         T_g * sizeof (std::complex<float>));
+	   out	+= T_u + T_g;
+	}
+}
+
+void	syntheticSignal::generate	(float snr) {
+dabParams	params (1);
+int	T_F	= params. get_T_F ();
+std::vector<std::vector<uint8_t>> dabPlus, dab;
+std::vector<std::vector<uint8_t>> subchannelBits [NR_SUBCHANNELS];
+std::vector<uint8_t> fic (4 * 2304);
+std::vector<uint8_t> msc (4 * CIF_BITS);
+std::vector<uint8_t> ficBlock;
+
+	dabPlusFrames (subchannels [0]. bitRate, NR_CIFS, dabPlus);
+//	all MP2 frames are equal (with a fixed seed), the audio then
+//	does not depend on the CIF the decoding starts with, which makes
+//	the audio checksum of dab-bench meaningful
+	mp2Frames (subchannels [1]. bitRate, 1, 7654321, dab);
+	dab. resize (NR_CIFS, dab [0]);
+	encodeSubchannel (dabPlus, subchannels [0]. bitRate, subchannelBits [0]);
+	encodeSubchannel (dab, subchannels [1]. bitRate, subchannelBits [1]);
+
+	signal. resize ((size_t)SYNTHETIC_FRAMES * T_F);
+	for (int frame = 0; frame < SYNTHETIC_FRAMES; frame ++) {
+	   std::fill (msc. begin (), msc. end (), 0);
+	   for (int c = 0; c < 4; c ++) {
+	      int cif	= 4 * frame + c;
+	      ficBits (cif, ficBlock);
+	      memcpy (&fic [c * 2304], ficBlock. data (), 2304);
+	      for (int s = 0; s < NR_SUBCHANNELS; s ++)
+	         memcpy (&msc [c * CIF_BITS +
+	                          subchannels [s]. startAddr * CU_BITS],
+	                 subchannelBits [s][cif]. data (),
+	                 subchannelBits [s][cif]. size ());
+	   }
+	   modulate (frame, fic, msc, &signal [(size_t)frame * T_F]);
+	}
+//
+//	the noise is relative to the signal level, a fixed seed keeps
+//	the signal the same from run to run
+	std::mt19937	generator (1234567);
+	float	sigma	= SIGNAL_LEVEL * pow (10, - snr / 20) * M_SQRT1_2;
+	std::normal_distribution<float> noise (0, sigma);
+	for (auto &s : signal)
+	   s += std::complex<float> (noise (generator), noise (generator));
+}
+
@@ -0,0 +1,112 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	syntheticSignal is a "device" producing a Mode I DAB signal, so
+//	the decoder can be benchmarked without recordings.
+//	The ensemble has two services, a DAB+ service (96 kbit/s) and
+//	a DAB service (128 kbit/s), both EEP 3-A. The FIC carries the
+//	ensemble and service information, the DAB+ subchannel carries
+//	Reed-Solomon protected superframes with (silent) AAC frames, the
+//	DAB subchannel MP2 frames with a pseudo random body. All is encoded as prescribed:
+//	energy dispersal, convolutional coding, puncturing, time and
+//	frequency interleaving and differential modulation.
+//	A sequence of SYNTHETIC_FRAMES frames (with the time interleaving
+//	and the superframes both wrapping around exactly) is computed
+//	once, with noise added, and repeated until the requested
+//	duration has been delivered.
+//	The device is always unthrottled, the samples are produced as
+//	fast as they are taken
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+#include	<complex>
+#include	<atomic>
+#include	"device-handler.h"
+
+#define	SYNTHETIC_FRAMES	20
+#define	SYNTHETIC_ENSEMBLE	"Synthetic"
+#define	SYNTHETIC_DAB_PLUS	"Synthetic DAB+"
+#define	SYNTHETIC_DAB		"Synthetic DAB"
+
+typedef void (*device_eof_callback_t)(void * userData);
+
+//	the encoder, also used by the protection bench:
+//	convEncode applies the mother code (rate 1/4, with 6 tail bits)
+//	on n bits, addPuncturing appends blocks * 128 entries of
+//	puncturing vector PI to the table, addTail the 24 entries for
+//	the tail, puncture selects the bits marked in the table
+void	convEncode	(const uint8_t *in, int n, std::vector<uint8_t> &out);
+void	addPuncturing	(std::vector<bool> &table, int blocks, int PI);
+void	addTail		(std::vector<bool> &table);
+void	puncture	(const std::vector<uint8_t> &mother,
+	                 const std::vector<bool> &table,
+	                 std::vector<uint8_t> &out);
+//	the content of the subchannels, the logical frames as bytes:
+//	dabPlusFrames gives nCifs (a multiple of 5) logical frames of
+//	DAB+ superframes with silent AAC access units, mp2Frames nCifs
+//	128 kbit/s MP2 frames with pseudo random bodies
+void	dabPlusFrames	(int bitRate, int nCifs,
+	                 std::vector<std::vector<uint8_t>> &);
+void	mp2Frames	(int bitRate, int nCifs, uint32_t seed,
+	                 std::vector<std::vector<uint8_t>> &);
+
+class	syntheticSignal: public deviceHandler {
+public:
+			syntheticSignal	(double seconds, float snr,
+	                                 device_eof_callback_t eofHandler =
+	                                                          nullptr,
+	                                 void *userData = nullptr);
+			~syntheticSignal	();
+	bool		restartReader	(int32_t);
+	void		stopReader	();
+	int32_t		getSamples	(std::complex<float> *, int32_t);
+	int32_t		Samples		();
+	const std::complex<float> *peekSamples	(int32_t *);
+	void		commitSamples	(int32_t);
+	bool		setUnthrottled	(bool);
+//	writeRaw stores the signal as unsigned 8 bit IQ, the format
+//	read by rawFiles
+	bool		writeRaw	(const std::string &);
+private:
+	std::vector<std::complex<float>>	signal;
+	uint64_t	total;
+	uint64_t	delivered;
+	int32_t		frameSize;
+	std::atomic<bool>	running;
+	bool		eofSignalled;
+	device_eof_callback_t	eofHandler;
+	void		*userData;
+
+	void		generate	(float snr);
+	void		ficBits		(int cif, std::vector<uint8_t> &);
+	void		buildFIB	(int cif, int fib, uint8_t *);
+	void		encodeSubchannel (std::vector<std::vector<uint8_t>> &,
+	                                 int bitRate,
+	                                 std::vector<std::vector<uint8_t>> &);
+	void		modulate	(int frame,
+	                                 const std::vector<uint8_t> &fic,
+	                                 const std::vector<uint8_t> &msc,
+	                                 std::complex<float> *);
+};
+
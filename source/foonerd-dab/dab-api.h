@@ -25,6 +25,8 @@
 #include	<stdio.h>
 #include	<stdint.h>
 #include	<string>
+#include	<vector>
+#include	<memory>
 #include	<complex>
 #include	"ringbuffer.h"
 
@@ -178,6 +180,124 @@ typedef	struct {
 //	tii data - if available, the tii data is passed on as a single
 //	integer
 	typedef void (*tii_data_t)(tiiData *, void *);
+//
+//	whenever the ensemble information (see dabGetEnsemble) changes,
+//	the version number of the new snapshot is sent. The callback is
+//	made from the thread handling the FIC, while the library holds
+//	the lock on its FIG database: it should not call the library,
+//	apart from dabGetEnsemble
+	typedef void (*ensembleChanged_t)(uint64_t version, void *);
+
+//
+//	When the MSC symbols are handled by the ofdm pipeline (see
+//	dabSetPipeline), the queue depths per stage can be inspected
+typedef struct {
+	int		workers;
+	int		slots;
+	int		waitingForWorker;	// published, FFT not started
+	int		inProgress;		// in FFT or demapping
+	int		waitingForDelivery;	// demapped, not yet in the msc
+	int		peakWaitingForWorker;
+	uint64_t	producerStalls;		// sync thread found no slot
+	uint64_t	symbolsDelivered;
+} pipelineStats;
+//
+//	Throughput counters, e.g. to see how fast a recording is decoded
+typedef struct {
+	uint64_t	samplesRead;		// taken from the device
+	uint64_t	framesDecoded;		// complete frames, in sync
+//	FIB's: parsed, not parsed (repeated FIB's in steady state, see
+//	fic-handler.h) and with a CRC error
+	uint64_t	fibsParsed;
+	uint64_t	fibsSkipped;
+	uint64_t	fibsFailed;
+} processingStats;
+//
+//	Timing of the decoder stages (STAGE_xxx in dab-constants.h),
+//	all durations in nsec
+typedef struct {
+	const char	*name;
+	uint64_t	count;
+	uint64_t	totalNs;
+	uint64_t	minNs;
+	uint64_t	maxNs;
+	uint64_t	histogram [STAGE_BUCKETS];
+} stageTiming;
+
+typedef struct {
+	stageTiming	stage [NR_STAGES];
+} stageTimings;
+//
+//	When decoding the whole ensemble (see dabDecodeEnsemble) the
+//	output of a service is passed to the callbacks with - as
+//	context - the pointer returned by the serviceContext_t function,
+//	called once per service when its handler is attached
+	typedef void *(*serviceContext_t)(uint32_t SId,
+	                                  const std::string &name,
+	                                  bool isAudio,
+	                                  void *userData);
+//
+//	The load per service, e.g. to size the hardware for decoding
+//	complete ensembles
+typedef struct {
+	uint32_t	SId;
+	int16_t		subchId;
+	bool		isAudio;
+	uint64_t	segments;		// CIF's handled
+	uint64_t	cpuNs;			// thread cpu time for them
+} serviceStats;
+//
+//	The ensemble as known from the FIC. A snapshot is never modified,
+//	when the FIG database changes the library builds a new one with
+//	a higher version number (see dabGetEnsemble)
+typedef struct {
+	uint32_t	SId;
+	std::string	name;
+	std::string	shortName;
+	bool		isPrimary;	// false: a secondary service
+	uint8_t		SCIds;		// of a secondary service
+	int16_t		programType;
+	uint16_t	announcing;
+	std::vector<int>	fmFrequencies;
+	std::vector<int>	components;	// indices in "components"
+} ensembleService;
+
+typedef struct {
+	uint32_t	SId;
+	int16_t		SCIds;
+	int16_t		compNr;
+	uint8_t		serviceType;	// AUDIO_SERVICE or PACKET_SERVICE
+	audiodata	ad;		// filled for audio components
+	packetdata	pd;		// filled for packet components
+} ensembleComponent;
+
+typedef struct {
+	int16_t		subChId;
+	int16_t		startAddr;
+	int16_t		length;
+	bool		shortForm;
+	int16_t		protLevel;
+	int16_t		bitRate;
+	int16_t		FEC_scheme;
+} ensembleSubchannel;
+
+struct ensembleSnapshot {
+	uint64_t	version;
+	std::string	ensembleName;
+	uint32_t	EId;
+	uint8_t		ecc;
+//	primary services, in the order in which they were found,
+//	followed by the secondary services
+	std::vector<ensembleService>	services;
+	std::vector<ensembleComponent>	components;
+	std::vector<ensembleSubchannel>	subchannels;
+//	the local time from FIG0/10: year, month, day, hours, minutes
+	int32_t		localTime [5];
+//	the transmitters found by the TII detector. A new snapshot is
+//	made when the set of transmitters changes, the strengths and
+//	phases are those of that moment
+	std::vector<tiiData>		transmitters;
+};
 
 /////////////////////////////////////////////////////////////////////////
 //
@@ -209,6 +329,7 @@ typedef struct {
 	motdata_t	motdata_Handler;
 	tii_data_t	tii_data_Handler;
 	theTime_t	timeHandler;
+	ensembleChanged_t	ensembleChanged_Handler;
 } API_struct;
 
 void DAB_API	*dabInit   (deviceHandler       *,
@@ -224,6 +345,37 @@ void DAB_API	dabExit		(void *);
 //	note that the input device needs to be started separately
 void DAB_API	dabStartProcessing (void *);
 //
+//	dabSetPipeline, to be called before dabStartProcessing, moves
+//	the FFT and demapping of the MSC symbols off the sync thread
+//	onto a pool of "nrWorkers" threads. nrWorkers == 0 (the default)
+//	means everything is done on the sync thread
+void DAB_API	dabSetPipeline	(void *, int nrWorkers);
+//
+//	dabSetBatchFFT, to be called before dabStartProcessing, collects
+//	the MSC blocks of a frame and transforms them with a single
+//	(batched) FFT plan. Ignored when a pipeline is set
+void DAB_API	dabSetBatchFFT	(void *, bool);
+//
+//	dabFFTPlanning sets - for the whole process - the planning
+//	effort for the FFT's (FFT_ESTIMATE, FFT_MEASURE or FFT_PATIENT)
+//	and a file (may be NULL) from which fftw wisdom is loaded and to
+//	which new wisdom is saved. It applies to instances created
+//	afterwards, so it is best called before the first dabInit
+void DAB_API	dabFFTPlanning	(const char *wisdomFile, int effort);
+//
+//	dabGetPipelineStats returns false if no pipeline is active
+bool DAB_API	dabGetPipelineStats	(void *, pipelineStats *);
+//
+//	dabGetProcessingStats gives the counters since dabInit
+void DAB_API	dabGetProcessingStats	(void *, processingStats *);
+//
+//	dabStageTimings switches - for the whole process - the timing of
+//	the decoder stages on or off (default off), switching it on
+//	clears the collected timings. dabGetStageTimings gives the
+//	timings collected so far
+void DAB_API	dabStageTimings		(bool);
+void DAB_API	dabGetStageTimings	(stageTimings *);
+//
 //	dabReset is as the name suggests for resetting the state of the library
 void DAB_API	dabReset	(void *);
 //
@@ -268,6 +420,23 @@ void DAB_API	set_audioChannel	(void *, audiodata &);
 //	to the list of active handlers
 void DAB_API	set_dataChannel		(void *, packetdata &);
 //
+//	dabDecodeEnsemble terminates the active handlers and attaches
+//	a handler for (the primary component of) each audio and data
+//	service known from the FIC. The handlers do not get a thread
+//	each, they run on a pool of nrWorkers threads (0 means one per
+//	core). serviceContext (may be NULL, then userData is used) gives
+//	the context for the output of each service, so the output can
+//	be routed per SId.
+//	The result is the number of services attached, dabReset_msc
+//	ends the decoding of the ensemble
+int DAB_API	dabDecodeEnsemble	(void *, int nrWorkers,
+	                                 serviceContext_t serviceContext);
+//
+//	dabGetServiceStats fills - at most max - elements, one for each
+//	active handler, with the cpu time spent. The result is the
+//	number of elements filled
+int DAB_API	dabGetServiceStats	(void *, serviceStats *, int max);
+//
 //	mapping from a name to a Service identifier is done 
 int32_t DAB_API dab_getSId		(void *, const std::string &);
 //
@@ -277,4 +446,11 @@ std::string DAB_API	dab_getserviceName	(void *, uint32_t /* SId */);
 //
 //	extract the name of the ensemble
 std::string DAB_API	get_ensembleName	(void *);
+//
+//	dabGetEnsemble returns the current snapshot of the ensemble.
+//	Getting it does not wait for the decoder (the snapshot is
+//	swapped atomically), and the snapshot remains valid - and
+//	unchanged - as long as the caller holds the pointer
+std::shared_ptr<const ensembleSnapshot> DAB_API
+	                dabGetEnsemble		(void *);
 
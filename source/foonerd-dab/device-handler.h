@@ -28,6 +28,10 @@
 #include	<stdint.h>
 #include	<complex>
 #include	<thread>
+#include	<mutex>
+#include	<condition_variable>
+#include	<atomic>
+#include	<functional>
 
 // Runtime debug flag - controlled via -v command line option
 extern bool debugEnabled;
@@ -57,9 +61,55 @@ virtual		void	set_autogain	(bool);
 virtual		void	set_ifgainReduction	(int);
 virtual		void	set_lnaState	(int);
 //
+//	Blocking hand off of the samples. waitForSamples returns as soon
+//	as (at least) n samples are available, the timeout (in msec)
+//	expires or wakeUp is called, the result is the number of
+//	samples available.
+//	Devices signal the arrival of new samples with samplesArrived,
+//	a device that does not is polled (every msec) instead
+		int32_t	waitForSamples	(int32_t n, int32_t timeout);
+		void	wakeUp		();
+		void	samplesArrived	();
+//
+//	Zero copy access, for devices keeping their samples as
+//	std::complex<float> in a RingBuffer: peekSamples gives (at most
+//	*amount) readable samples in place, commitSamples releases them.
+//	The default returns nullptr, use getSamples then
+virtual	const std::complex<float> *peekSamples	(int32_t *amount);
+virtual		void	commitSamples	(int32_t amount);
+//
+//	Devices keeping the samples in their native format (e.g. 8 bit
+//	IQ, 2 rather than 8 bytes per sample) give them in place with
+//	peekNative, convertNative converts n of them (starting at the
+//	pointer given) to std::complex<float>, commitSamples releases
+//	them. The default returns nullptr
+virtual	const void	*peekNative	(int32_t *amount);
+virtual		void	convertNative	(const void *, int32_t n,
+	                                 std::complex<float> *);
+//
+//	File devices may run "unthrottled": the samples are produced as
+//	fast as they are taken rather than at the sample rate, the
+//	ring buffer provides the back pressure. The default (a real
+//	device) returns false
+virtual		bool	setUnthrottled	(bool);
+//	the writer side of the back pressure: the device thread waits
+//	until "ready" holds (or the timeout or a wakeUp), the reader
+//	side calls roomAvailable after taking samples
+		bool	waitForRoom	(std::function<bool ()> ready,
+	                                 int32_t timeout);
+		void	roomAvailable	();
 protected:
 	        int32_t	lastFrequency;
 	        int16_t	theGain;
 	        bool	isOK;
+		std::atomic<bool>	unthrottled;
+private:
+		std::mutex		handOffLock;
+		std::condition_variable	handOff;
+		std::condition_variable	roomOff;
+		std::atomic<bool>	roomWanted;
+		int32_t			waitingFor;
+		int64_t			wakeUps;
+		std::atomic<bool>	signalling;
 };
 #endif
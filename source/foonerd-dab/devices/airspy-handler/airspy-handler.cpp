@@ -29,15 +29,11 @@ const	int	EXTIO_NS	=  8192;
 static
 const	int	EXTIO_BASE_TYPE_SIZE = sizeof (float);
 
-static
-std::complex<float> cmul (std::complex<float> x, float y) {
-	return std::complex<float> (real (x) * y, imag (x) * y);
-}
-
 	airspyHandler::airspyHandler (int32_t	frequency,
 	                              int16_t	ppmCorrection,
 	                              int16_t	theGain,
-	                              bool	biasTee) {
+	                              bool	biasTee):
+	                                 sampleConverter (IQ_S16, 1.0 / 2048) {
 int	result, i;
 int	distance	= 10000000;
 uint32_t myBuffer [20];
@@ -50,6 +46,7 @@ uint32_t samplerate_count;
 	device			= 0;
 	serialNumber		= 0;
 	theBuffer		= NULL;
+	theConverter		= NULL;
 #ifdef	__MINGW32__
 	const char *libraryString = "airspy.dll";
 	Handle		= LoadLibrary ((wchar_t *)L"airspy.dll");
@@ -142,18 +139,8 @@ uint32_t samplerate_count;
 	   throw SampleRateFailed();
 	}
 
-//	The sizes of the mapTable and the convTable are
-//	predefined and follow from the input and output rate
-//	(selectedRate / 1000) vs (2048000 / 1000)
-	convBufferSize		= selectedRate / 1000;
-	for (i = 0; i < 2048; i ++) {
-	   float inVal	= float (selectedRate / 1000);
-	   mapTable_int [i] =  int (floor (i * (inVal / 2048.0)));
-	   mapTable_float [i] = i * (inVal / 2048.0) - mapTable_int [i];
-	}
-
-	convIndex		= 0;
-	convBuffer		= new std::complex<float> [convBufferSize + 1];
+//	the samples are converted from selectedRate to 2048000
+	theConverter		= new rateConverter (selectedRate, 2048000);
 
 	theBuffer		=
 	               new RingBuffer<std::complex<float>> (512 *1024);
@@ -195,6 +182,8 @@ uint32_t samplerate_count;
 err:
 	if (theBuffer != NULL)
 	   delete theBuffer;
+	if (theConverter != NULL)
+	   delete theConverter;
 }
 
 bool	airspyHandler::restartReader	(int32_t frequency) {
@@ -292,33 +281,20 @@ airspyHandler *p;
 //
 //	recoded for the sdr-j framework
 //	2*2 = 4 bytes for sample, as per AirSpy USB data stream format
-//	we do the rate conversion here, read in groups of 2 * 625 samples
-//	and transform them into groups of 2 * 512 samples
+//	we do the rate conversion here, the whole block at once
 int 	airspyHandler::data_available (void *buf, int buf_size) {
 int16_t	*sbuf	= (int16_t *)buf;
 int nSamples	= buf_size / (sizeof (int16_t) * 2);
-std::complex<float> temp [2048];
-int32_t  i, j;
-
-	for (i = 0; i < nSamples; i ++) {
-	   convBuffer [convIndex ++] = std::complex<float> (sbuf [2 * i] / (float)2048,
-	                                           sbuf [2 * i + 1] / (float)2048);
-	   if (convIndex > convBufferSize) {
-	      for (j = 0; j < 2048; j ++) {
-	         int16_t  inpBase	= mapTable_int [j];
-	         float    inpRatio	= mapTable_float [j];
-	         temp [j]	= cmul (convBuffer [inpBase + 1], inpRatio) +
-	                          cmul (convBuffer [inpBase], 1 - inpRatio);
-	      }
-
-	      theBuffer	-> putDataIntoBuffer (temp, 2048);
-//
-//	shift the sample at the end to the beginning, it is needed
-//	as the starting sample for the next time
-	      convBuffer [0] = convBuffer [convBufferSize];
-	      convIndex = 1;
-	   }
+
+	if ((int)convBuffer. size () < nSamples) {
+	   convBuffer. resize (nSamples);
+	   outBuffer. resize (theConverter -> outSize (nSamples));
 	}
+	sampleConverter. convert (sbuf, nSamples, convBuffer. data ());
+	int n	= theConverter -> convert (convBuffer. data (), nSamples,
+	                                   outBuffer. data ());
+	theBuffer	-> putDataIntoBuffer (outBuffer. data (), n);
+	samplesArrived ();
 	return 0;
 }
 //
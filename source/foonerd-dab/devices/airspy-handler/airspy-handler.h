@@ -18,7 +18,10 @@
 
 #include	"ringbuffer.h"
 #include	"device-handler.h"
+#include	"rate-converter.h"
+#include	"iq-converter.h"
 #include	<complex>
+#include	<vector>
 
 #ifdef  __MINGW32__
 #include        "windows.h"
@@ -133,11 +136,10 @@ private:
 	bool		running;
 const	char*		board_id_name (void);
 	int32_t		selectedRate;
-	std::complex<float>	*convBuffer;
-	int16_t		convBufferSize;
-	int16_t		convIndex;
-	int16_t		mapTable_int   [4 * 512];
-	float		mapTable_float [4 * 512];
+	iqConverter	sampleConverter;
+	rateConverter	*theConverter;
+	std::vector<std::complex<float>>	convBuffer;
+	std::vector<std::complex<float>>	outBuffer;
 	RingBuffer<std::complex<float>> *theBuffer;
 	struct airspy_device* device;
 	uint64_t 	serialNumber;
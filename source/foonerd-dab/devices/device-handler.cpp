@@ -24,9 +24,15 @@
  * 	virtual input class
  */
 #include	"device-handler.h"
+#include	<chrono>
 
 	deviceHandler::deviceHandler () {
 	lastFrequency	= 100000;
+	waitingFor	= 0;
+	wakeUps		= 0;
+	signalling. store (false);
+	unthrottled. store (false);
+	roomWanted. store (false);
 }
 
 	deviceHandler::~deviceHandler () {
@@ -53,6 +59,32 @@ int32_t	deviceHandler::Samples		() {
 	return 0;
 }
 
+const std::complex<float> *deviceHandler::peekSamples	(int32_t *amount) {
+	(void)amount;
+	return nullptr;
+}
+
+void	deviceHandler::commitSamples	(int32_t amount) {
+	(void)amount;
+}
+
+const void	*deviceHandler::peekNative	(int32_t *amount) {
+	(void)amount;
+	return nullptr;
+}
+
+void	deviceHandler::convertNative	(const void *in, int32_t n,
+	                                 std::complex<float> *out) {
+	(void)in;
+	(void)n;
+	(void)out;
+}
+
+bool	deviceHandler::setUnthrottled	(bool b) {
+	(void)b;
+	return false;
+}
+
 int32_t	deviceHandler::defaultFrequency	() {
 	return 220000000;
 }
@@ -79,4 +111,74 @@ void	deviceHandler::set_ifgainReduction  (int x) {
 void	deviceHandler::set_lnaState	(int x) {
 	(void)x;
 }
+//
+//	The reader registers the amount it is waiting for, so the
+//	device only notifies when that amount is there, i.e. one wake up
+//	per read rather than one per device buffer.
+//	The lock is taken when signalling, otherwise a signal arriving
+//	between the test and the wait of the reader would be lost
+int32_t	deviceHandler::waitForSamples	(int32_t n, int32_t timeout) {
+std::unique_lock<std::mutex> lck (handOffLock);
+int64_t	wakeUpsSeen	= wakeUps;
+auto	deadline	= std::chrono::steady_clock::now () +
+	                             std::chrono::milliseconds (timeout);
+int32_t	available	= Samples ();
+
+	while ((available < n) && (wakeUps == wakeUpsSeen)) {
+	   auto now	= std::chrono::steady_clock::now ();
+	   if (now >= deadline)
+	      break;
+	   waitingFor	= n;
+	   if (signalling. load ())
+	      handOff. wait_until (lck, deadline);
+	   else
+	      handOff. wait_for (lck, std::chrono::milliseconds (1));
+	   waitingFor	= 0;
+	   available	= Samples ();
+	}
+	return available;
+}
+
+void	deviceHandler::wakeUp		() {
+	std::lock_guard<std::mutex> lck (handOffLock);
+	wakeUps ++;
+	handOff. notify_all ();
+	roomOff. notify_all ();
+}
 
+void	deviceHandler::samplesArrived	() {
+	if (!signalling. load ())
+	   signalling. store (true);
+	std::lock_guard<std::mutex> lck (handOffLock);
+	if ((waitingFor > 0) && (Samples () >= waitingFor))
+	   handOff. notify_all ();
+}
+//
+//	The reader calls roomAvailable for each read, so it should be cheap
+//	when no one is waiting. Both sides store "their" variable (the
+//	flag, resp. the ring buffer index) before loading the other one,
+//	the fences make sure that at least one of them sees the change
+bool	deviceHandler::waitForRoom	(std::function<bool ()> ready,
+	                                 int32_t timeout) {
+std::unique_lock<std::mutex> lck (handOffLock);
+int64_t	wakeUpsSeen	= wakeUps;
+auto	deadline	= std::chrono::steady_clock::now () +
+	                             std::chrono::milliseconds (timeout);
+
+	roomWanted. store (true);
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	while (!ready () && (wakeUps == wakeUpsSeen)) {
+	   if (roomOff. wait_until (lck, deadline) == std::cv_status::timeout)
+	      break;
+	}
+	roomWanted. store (false);
+	return ready ();
+}
+
+void	deviceHandler::roomAvailable	() {
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	if (!roomWanted. load ())
+	   return;
+	std::lock_guard<std::mutex> lck (handOffLock);
+	roomOff. notify_all ();
+}
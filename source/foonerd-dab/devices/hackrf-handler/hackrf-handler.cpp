@@ -30,7 +30,8 @@
 	                               int16_t	ppm,
 	                               int16_t	lnaGain,
 	                               int16_t	vgaGain,
-	                               bool	ampEnable) {
+	                               bool	ampEnable):
+	                                  sampleConverter (IQ_S8, 1.0 / 128) {
 int	res;
 	vfoFrequency			= frequency;
 	this	-> lnaGain		= lnaGain;
@@ -38,7 +39,7 @@ int	res;
 	this	-> ampEnable		= ampEnable;
 
 	this	-> inputRate		= 2048000;
-	_I_Buffer	= new RingBuffer<std::complex<float>>(1024 * 1024);
+	_I_Buffer	= new RingBuffer<uint8_t>(2 * 1024 * 1024);
 //
 	res	= hackrf_init ();
 	if (res != HACKRF_SUCCESS) {
@@ -129,22 +130,16 @@ int	res;
 	}
 }
 //
-//	we use a static large buffer, rather than trying to allocate
-//	a buffer on the stack
-static std::complex<float>buffer [32 * 32768];
+//	the samples are stored as they come, int8_t I/Q pairs, they
+//	are converted when taken
 static
 int	callback (hackrf_transfer *transfer) {
 hackrfHandler *ctx = static_cast <hackrfHandler *>(transfer -> rx_ctx);
-int	i;
 uint8_t *p	= transfer -> buffer;
-RingBuffer<std::complex<float> > * q = ctx -> _I_Buffer;
+RingBuffer<uint8_t> * q = ctx -> _I_Buffer;
 
-	for (i = 0; i < transfer -> valid_length / 2; i ++) {
-	   float re	= (((int8_t *)p) [2 * i]) / 128.0;
-	   float im	= (((int8_t *)p) [2 * i + 1]) / 128.0;
-	   buffer [i]	= std::complex<float> (re, im);
-	}
-	q -> putDataIntoBuffer (buffer, transfer -> valid_length / 2);
+	q -> putDataIntoBuffer (p, transfer -> valid_length);
+	ctx -> samplesArrived ();
 	return 0;
 }
 
@@ -199,11 +194,32 @@ int	res;
 //	The brave old getSamples. For the hackrf, we get
 //	size still in I/Q pairs
 int32_t	hackrfHandler::getSamples (std::complex<float> *V, int32_t size) {
-	return _I_Buffer	-> getDataFromBuffer (V, size);
+uint8_t	tempBuffer [2 * size];
+int32_t	amount	= _I_Buffer	-> getDataFromBuffer (tempBuffer, 2 * size);
+
+	sampleConverter. convert (tempBuffer, amount / 2, V);
+	return amount / 2;
 }
 
 int32_t	hackrfHandler::Samples	(void) {
-	return _I_Buffer	-> GetRingBufferReadAvailable ();
+	return _I_Buffer	-> GetRingBufferReadAvailable () / 2;
+}
+
+const void	*hackrfHandler::peekNative	(int32_t *amount) {
+int32_t	n	= 2 * *amount;
+const uint8_t *p	= _I_Buffer -> peek (&n);
+
+	*amount	= n / 2;
+	return p;
+}
+
+void	hackrfHandler::convertNative	(const void *in, int32_t n,
+	                                 std::complex<float> *out) {
+	sampleConverter. convert (in, n, out);
+}
+
+void	hackrfHandler::commitSamples	(int32_t amount) {
+	_I_Buffer	-> commit (2 * amount);
 }
 
 void	hackrfHandler::resetBuffer	(void) {
@@ -26,6 +26,7 @@
 #include	"ringbuffer.h"
 #include	<atomic>
 #include	"device-handler.h"
+#include	"iq-converter.h"
 #include	"libhackrf/hackrf.h"
 
 typedef int (*hackrf_sample_block_cb_fn)(hackrf_transfer *transfer);
@@ -45,13 +46,18 @@ public:
 	int32_t		getSamples		(std::complex<float> *,
 	                                                          int32_t);
 	int32_t		Samples			(void);
+	const void	*peekNative		(int32_t *);
+	void		convertNative		(const void *, int32_t,
+	                                         std::complex<float> *);
+	void		commitSamples		(int32_t);
 	void		resetBuffer		(void);
 	int16_t		bitDepth		(void);
 //
 //	The buffer should be visible by the callback function
-	RingBuffer<std::complex<float>>	*_I_Buffer;
+	RingBuffer<uint8_t>	*_I_Buffer;
 	hackrf_device	*theDevice;
 private:
+	iqConverter	sampleConverter;
 	int32_t		vfoFrequency;
 	int16_t		lnaGain;
 	int16_t		vgaGain;
@@ -0,0 +1,464 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"iq-converter.h"
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define	X86_KERNELS
+#include	<immintrin.h>
+#endif
+#if defined (__aarch64__)
+#define	NEON_KERNELS
+#include	<arm_neon.h>
+#endif
+
+//
+//	the scalar versions, also used for the tails of the others
+static
+void	u8_scalar	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+	for (int32_t i = 0; i < n; i ++)
+	   out [i] = (float)(in [i] - 128) * scale;
+}
+
+static
+void	s8_scalar	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+	for (int32_t i = 0; i < n; i ++)
+	   out [i] = (float)((int8_t)in [i]) * scale;
+}
+
+static
+void	s16_scalar	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+	for (int32_t i = 0; i < n; i ++)
+	   out [i] = (float)((int16_t)(in [2 * i] |
+	                               (in [2 * i + 1] << 8))) * scale;
+}
+
+static
+void	s16be_scalar	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+	for (int32_t i = 0; i < n; i ++)
+	   out [i] = (float)((int16_t)((in [2 * i] << 8) |
+	                               in [2 * i + 1])) * scale;
+}
+
+static
+void	split_scalar	(const int16_t *I, const int16_t *Q, int32_t n,
+	                 float scale, float *out) {
+	for (int32_t i = 0; i < n; i ++) {
+	   out [2 * i]		= (float)I [i] * scale;
+	   out [2 * i + 1]	= (float)Q [i] * scale;
+	}
+}
+
+#ifdef	X86_KERNELS
+//
+//	SSE2 has no sign extending moves, the values are widened by
+//	unpacking them with themselves and an arithmetic shift
+__attribute__ ((target ("sse2")))
+static inline
+void	store8_sse2	(__m128i v, __m128 s, float *out) {
+__m128i	lo	= _mm_srai_epi32 (_mm_unpacklo_epi16 (v, v), 16);
+__m128i	hi	= _mm_srai_epi32 (_mm_unpackhi_epi16 (v, v), 16);
+	_mm_storeu_ps (out,     _mm_mul_ps (_mm_cvtepi32_ps (lo), s));
+	_mm_storeu_ps (out + 4, _mm_mul_ps (_mm_cvtepi32_ps (hi), s));
+}
+
+__attribute__ ((target ("sse2")))
+static inline
+void	bytes_sse2	(__m128i v, __m128 s, float *out) {
+	store8_sse2 (_mm_srai_epi16 (_mm_unpacklo_epi8 (v, v), 8), s, out);
+	store8_sse2 (_mm_srai_epi16 (_mm_unpackhi_epi8 (v, v), 8), s, out + 8);
+}
+
+__attribute__ ((target ("sse2")))
+static
+void	u8_sse2		(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m128i	bias	= _mm_set1_epi8 ((char)0x80);
+const __m128	s	= _mm_set1_ps (scale);
+int32_t	i;
+
+//	flipping the top bit makes x - 128 of an offset binary byte
+	for (i = 0; i + 16 <= n; i += 16)
+	   bytes_sse2 (_mm_xor_si128 (_mm_loadu_si128 ((const __m128i *)
+	                                                        (in + i)),
+	                              bias), s, out + i);
+	u8_scalar (in + i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("sse2")))
+static
+void	s8_sse2		(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m128	s	= _mm_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 16 <= n; i += 16)
+	   bytes_sse2 (_mm_loadu_si128 ((const __m128i *)(in + i)), s, out + i);
+	s8_scalar (in + i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("sse2")))
+static
+void	s16_sse2	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m128	s	= _mm_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	   store8_sse2 (_mm_loadu_si128 ((const __m128i *)(in + 2 * i)),
+	                s, out + i);
+	s16_scalar (in + 2 * i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("sse2")))
+static
+void	s16be_sse2	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m128	s	= _mm_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+	   __m128i v	= _mm_loadu_si128 ((const __m128i *)(in + 2 * i));
+	   v	= _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+	   store8_sse2 (v, s, out + i);
+	}
+	s16be_scalar (in + 2 * i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("sse2")))
+static
+void	split_sse2	(const int16_t *I, const int16_t *Q, int32_t n,
+	                 float scale, float *out) {
+const __m128	s	= _mm_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+	   __m128i re	= _mm_loadu_si128 ((const __m128i *)(I + i));
+	   __m128i im	= _mm_loadu_si128 ((const __m128i *)(Q + i));
+	   store8_sse2 (_mm_unpacklo_epi16 (re, im), s, out + 2 * i);
+	   store8_sse2 (_mm_unpackhi_epi16 (re, im), s, out + 2 * i + 8);
+	}
+	split_scalar (I + i, Q + i, n - i, scale, out + 2 * i);
+}
+
+__attribute__ ((target ("avx2")))
+static inline
+void	bytes_avx2	(__m128i v, __m256 s, float *out) {
+	_mm256_storeu_ps (out, _mm256_mul_ps (_mm256_cvtepi32_ps (
+	                          _mm256_cvtepi8_epi32 (v)), s));
+	_mm256_storeu_ps (out + 8, _mm256_mul_ps (_mm256_cvtepi32_ps (
+	                          _mm256_cvtepi8_epi32 (
+	                                _mm_srli_si128 (v, 8))), s));
+}
+
+__attribute__ ((target ("avx2")))
+static inline
+void	words_avx2	(__m128i v, __m256 s, float *out) {
+	_mm256_storeu_ps (out, _mm256_mul_ps (_mm256_cvtepi32_ps (
+	                          _mm256_cvtepi16_epi32 (v)), s));
+}
+
+__attribute__ ((target ("avx2")))
+static
+void	u8_avx2		(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m128i	bias	= _mm_set1_epi8 ((char)0x80);
+const __m256	s	= _mm256_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 32 <= n; i += 32) {
+	   __m128i a	= _mm_loadu_si128 ((const __m128i *)(in + i));
+	   __m128i b	= _mm_loadu_si128 ((const __m128i *)(in + i + 16));
+	   bytes_avx2 (_mm_xor_si128 (a, bias), s, out + i);
+	   bytes_avx2 (_mm_xor_si128 (b, bias), s, out + i + 16);
+	}
+	u8_scalar (in + i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("avx2")))
+static
+void	s8_avx2		(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m256	s	= _mm256_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 32 <= n; i += 32) {
+	   bytes_avx2 (_mm_loadu_si128 ((const __m128i *)(in + i)),
+	               s, out + i);
+	   bytes_avx2 (_mm_loadu_si128 ((const __m128i *)(in + i + 16)),
+	               s, out + i + 16);
+	}
+	s8_scalar (in + i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("avx2")))
+static
+void	s16_avx2	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m256	s	= _mm256_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+	   words_avx2 (_mm_loadu_si128 ((const __m128i *)(in + 2 * i)),
+	               s, out + i);
+	   words_avx2 (_mm_loadu_si128 ((const __m128i *)(in + 2 * i + 16)),
+	               s, out + i + 8);
+	}
+	s16_scalar (in + 2 * i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("avx2")))
+static
+void	s16be_avx2	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const __m256	s	= _mm256_set1_ps (scale);
+const __m128i	swap	= _mm_set_epi8 (14, 15, 12, 13, 10, 11, 8, 9,
+	                                6, 7, 4, 5, 2, 3, 0, 1);
+int32_t	i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+	   __m128i a	= _mm_loadu_si128 ((const __m128i *)(in + 2 * i));
+	   __m128i b	= _mm_loadu_si128 ((const __m128i *)(in + 2 * i + 16));
+	   words_avx2 (_mm_shuffle_epi8 (a, swap), s, out + i);
+	   words_avx2 (_mm_shuffle_epi8 (b, swap), s, out + i + 8);
+	}
+	s16be_scalar (in + 2 * i, n - i, scale, out + i);
+}
+
+__attribute__ ((target ("avx2")))
+static
+void	split_avx2	(const int16_t *I, const int16_t *Q, int32_t n,
+	                 float scale, float *out) {
+const __m256	s	= _mm256_set1_ps (scale);
+int32_t	i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+	   __m128i re	= _mm_loadu_si128 ((const __m128i *)(I + i));
+	   __m128i im	= _mm_loadu_si128 ((const __m128i *)(Q + i));
+	   words_avx2 (_mm_unpacklo_epi16 (re, im), s, out + 2 * i);
+	   words_avx2 (_mm_unpackhi_epi16 (re, im), s, out + 2 * i + 8);
+	}
+	split_scalar (I + i, Q + i, n - i, scale, out + 2 * i);
+}
+#endif
+
+#ifdef	NEON_KERNELS
+static inline
+void	store8_neon	(int16x8_t v, float scale, float *out) {
+	vst1q_f32 (out, vmulq_n_f32 (vcvtq_f32_s32 (
+	                       vmovl_s16 (vget_low_s16 (v))), scale));
+	vst1q_f32 (out + 4, vmulq_n_f32 (vcvtq_f32_s32 (
+	                       vmovl_s16 (vget_high_s16 (v))), scale));
+}
+
+static inline
+void	bytes_neon	(int8x16_t v, float scale, float *out) {
+	store8_neon (vmovl_s8 (vget_low_s8 (v)), scale, out);
+	store8_neon (vmovl_s8 (vget_high_s8 (v)), scale, out + 8);
+}
+
+static
+void	u8_neon		(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+const uint8x16_t bias	= vdupq_n_u8 (0x80);
+int32_t	i;
+
+	for (i = 0; i + 16 <= n; i += 16)
+	   bytes_neon (vreinterpretq_s8_u8 (veorq_u8 (vld1q_u8 (in + i),
+	                                              bias)),
+	               scale, out + i);
+	u8_scalar (in + i, n - i, scale, out + i);
+}
+
+static
+void	s8_neon		(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+int32_t	i;
+
+	for (i = 0; i + 16 <= n; i += 16)
+	   bytes_neon (vld1q_s8 ((const int8_t *)(in + i)), scale, out + i);
+	s8_scalar (in + i, n - i, scale, out + i);
+}
+
+static
+void	s16_neon	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+int32_t	i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	   store8_neon (vreinterpretq_s16_u8 (vld1q_u8 (in + 2 * i)),
+	                scale, out + i);
+	s16_scalar (in + 2 * i, n - i, scale, out + i);
+}
+
+static
+void	s16be_neon	(const uint8_t *in, int32_t n,
+	                 float scale, float *out) {
+int32_t	i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	   store8_neon (vreinterpretq_s16_u8 (vrev16q_u8 (vld1q_u8 (in + 2 * i))),
+	                scale, out + i);
+	s16be_scalar (in + 2 * i, n - i, scale, out + i);
+}
+
+static
+void	split_neon	(const int16_t *I, const int16_t *Q, int32_t n,
+	                 float scale, float *out) {
+int32_t	i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+	   int16x8x2_t v = vzipq_s16 (vld1q_s16 (I + i), vld1q_s16 (Q + i));
+	   store8_neon (v. val [0], scale, out + 2 * i);
+	   store8_neon (v. val [1], scale, out + 2 * i + 8);
+	}
+	split_scalar (I + i, Q + i, n - i, scale, out + 2 * i);
+}
+#endif
+
+struct	iqKernels {
+	iqKernel_t	u8;
+	iqKernel_t	s8;
+	iqKernel_t	s16;
+	iqKernel_t	s16be;
+	iqSplitKernel_t	split;
+};
+
+static const iqKernels scalarKernels =
+	{u8_scalar, s8_scalar, s16_scalar, s16be_scalar, split_scalar};
+#ifdef	X86_KERNELS
+static const iqKernels sse2Kernels =
+	{u8_sse2, s8_sse2, s16_sse2, s16be_sse2, split_sse2};
+static const iqKernels avx2Kernels =
+	{u8_avx2, s8_avx2, s16_avx2, s16be_avx2, split_avx2};
+#endif
+#ifdef	NEON_KERNELS
+static const iqKernels neonKernels =
+	{u8_neon, s8_neon, s16_neon, s16be_neon, split_neon};
+#endif
+
+	iqConverter::iqConverter	(int format, float scale) {
+	if ((format < IQ_U8) || (format > IQ_S16_SPLIT))
+	   throw (21);
+	this	-> theFormat	= format;
+	this	-> scale	= scale;
+	setKernel (IQ_AUTO);
+}
+
+	iqConverter::~iqConverter	() {}
+
+void	iqConverter::convert	(const void *in, int32_t n,
+	                         std::complex<float> *out) {
+	kernel ((const uint8_t *)in, 2 * n, scale, (float *)out);
+}
+
+void	iqConverter::convert	(const int16_t *I, const int16_t *Q,
+	                         int32_t n, std::complex<float> *out) {
+	splitKernel (I, Q, n, scale, (float *)out);
+}
+
+void	iqConverter::setScale	(float scale) {
+	this	-> scale	= scale;
+}
+
+int	iqConverter::format	() {
+	return theFormat;
+}
+
+int	iqConverter::bytesPerSample	() {
+	return (theFormat == IQ_U8) || (theFormat == IQ_S8) ? 2 : 4;
+}
+
+bool	iqConverter::setKernel	(int type) {
+const iqKernels *k;
+
+	switch (type) {
+	   case IQ_AUTO:
+#ifdef	X86_KERNELS
+	      if (__builtin_cpu_supports ("avx2"))
+	         return setKernel (IQ_AVX2);
+	      if (__builtin_cpu_supports ("sse2"))
+	         return setKernel (IQ_SSE2);
+#endif
+#ifdef	NEON_KERNELS
+	      return setKernel (IQ_NEON);
+#endif
+	      return setKernel (IQ_SCALAR);
+
+	   case IQ_SCALAR:
+	      k	= &scalarKernels;
+	      break;
+#ifdef	X86_KERNELS
+	   case IQ_SSE2:
+	      if (!__builtin_cpu_supports ("sse2"))
+	         return false;
+	      k	= &sse2Kernels;
+	      break;
+
+	   case IQ_AVX2:
+	      if (!__builtin_cpu_supports ("avx2"))
+	         return false;
+	      k	= &avx2Kernels;
+	      break;
+#endif
+#ifdef	NEON_KERNELS
+	   case IQ_NEON:
+	      k	= &neonKernels;
+	      break;
+#endif
+	   default:
+	      return false;
+	}
+	switch (theFormat) {
+	   case IQ_U8:
+	      kernel	= k -> u8;
+	      break;
+	   case IQ_S8:
+	      kernel	= k -> s8;
+	      break;
+	   case IQ_S16:
+	      kernel	= k -> s16;
+	      break;
+	   case IQ_S16_BE:
+	      kernel	= k -> s16be;
+	      break;
+	   default:		// IQ_S16_SPLIT
+	      kernel	= k -> s16;
+	      break;
+	}
+	splitKernel	= k -> split;
+	kernelType	= type;
+	return true;
+}
+
+const char	*iqConverter::kernelName	() {
+	switch (kernelType) {
+	   case IQ_SSE2:	return "sse2";
+	   case IQ_AVX2:	return "avx2";
+	   case IQ_NEON:	return "neon";
+	   default:		return "scalar";
+	}
+}
+
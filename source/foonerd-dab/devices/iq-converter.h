@@ -0,0 +1,83 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	iqConverter converts the raw IQ samples of a device to
+//	std::complex<float>, each value is scaled (multiplied) by scale.
+//	The formats are
+//	IQ_U8		unsigned 8 bit, offset binary (rtlsdr, rtl_tcp, files),
+//			the value is (x - 128) * scale
+//	IQ_S8		signed 8 bit (hackrf)
+//	IQ_S16		signed 16 bit, little endian (airspy, pluto, with
+//			12 significant bits and a scale of 1 / 2048)
+//	IQ_S16_BE	signed 16 bit, big endian
+//	IQ_S16_SPLIT	signed 16 bit, with I and Q in separate arrays
+//			(sdrplay), converted with the second form of convert
+//	n is the number of IQ samples. The scale can be changed later on,
+//	for devices that only know the width of their samples when opened.
+//	The kernels only differ in speed, the results are identical, and
+//	with a power of two as scale equal to those of dividing by
+//	1 / scale
+#include	<stdint.h>
+#include	<complex>
+
+#define	IQ_U8		0
+#define	IQ_S8		1
+#define	IQ_S16		2
+#define	IQ_S16_BE	3
+#define	IQ_S16_SPLIT	4
+
+#define	IQ_AUTO		0
+#define	IQ_SCALAR	1
+#define	IQ_SSE2		2
+#define	IQ_AVX2		3
+#define	IQ_NEON		4
+
+//	n is here the number of values, i.e. twice the number of samples
+typedef void (*iqKernel_t)(const uint8_t *in, int32_t n,
+	                   float scale, float *out);
+typedef void (*iqSplitKernel_t)(const int16_t *I, const int16_t *Q,
+	                        int32_t n, float scale, float *out);
+
+class	iqConverter {
+public:
+			iqConverter	(int format, float scale);
+			~iqConverter	();
+	void		convert		(const void *in, int32_t n,
+	                                 std::complex<float> *out);
+	void		convert		(const int16_t *I, const int16_t *Q,
+	                                 int32_t n,
+	                                 std::complex<float> *out);
+	void		setScale	(float);
+	int		format		();
+	int		bytesPerSample	();
+	bool		setKernel	(int);
+	const char	*kernelName	();
+private:
+	int		theFormat;
+	float		scale;
+	iqKernel_t	kernel;
+	iqSplitKernel_t	splitKernel;
+	int		kernelType;
+};
+
@@ -186,6 +186,7 @@ int	amountRead	= 0;
 	                                     FIFO_SIZE,  &meta, 1000);
 	   if (res > 0) {
 	      theBuffer -> putDataIntoBuffer (localBuffer, res);
+	      samplesArrived ();
 	      amountRead	+= res;
 	      res	= LMS_GetStreamStatus (&stream, &streamStatus);
 	   }
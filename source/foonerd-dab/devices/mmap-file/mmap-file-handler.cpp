@@ -0,0 +1,308 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	<stdio.h>
+#include	<unistd.h>
+#include	<fcntl.h>
+#include	<errno.h>
+#include	<cstring>
+#include	<sys/mman.h>
+#include	<sys/stat.h>
+#include	"mmap-file-handler.h"
+#include	"device-exceptions.h"
+#include	"xml-descriptor.h"
+
+//	the xml files have a header of 5000 bytes, the data follow
+#define	XML_HEADER_SIZE	5000
+
+static
+bool	endsWith	(const std::string &s, const std::string &suffix) {
+	return (s. size () >= suffix. size ()) &&
+	        (s. compare (s. size () - suffix. size (),
+	                     suffix. size (), suffix) == 0);
+}
+
+	mmapFileHandler::mmapFileHandler (std::string fileName,
+	                                  bool repeater,
+	                                  device_eof_callback_t eofHandler,
+	                                  void *userData):
+	                                     sampleConverter (IQ_U8,
+	                                                      1.0 / 128) {
+struct stat st;
+
+	this	-> fileName	= fileName;
+	this	-> repeater	= repeater;
+	this	-> eofHandler	= eofHandler;
+	this	-> userData	= userData;
+	fd	= open (fileName. c_str (), O_RDONLY);
+	if (fd < 0)
+	   throw OpeningFileFailed (fileName. c_str (), strerror (errno));
+	if ((fstat (fd, &st) < 0) || (st. st_size == 0)) {
+	   int error	= errno;
+	   close (fd);
+	   throw OpeningFileFailed (fileName. c_str (),
+	                            strerror (error == 0 ? EINVAL : error));
+	}
+	mappedSize	= st. st_size;
+	void *p		= mmap (nullptr, mappedSize,
+	                        PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED) {
+	   int error	= errno;
+	   close (fd);
+	   throw OpeningFileFailed (fileName. c_str (), strerror (error));
+	}
+	mapping		= (uint8_t *)p;
+	madvise (mapping, mappedSize, MADV_SEQUENTIAL);
+//
+//	by default the file is raw u8 IQ, as written by rawFiles
+	data		= mapping;
+	bytesPerSample	= 2;
+	totalSamples	= mappedSize / 2;
+	swapIQ		= false;
+	if (endsWith (fileName, ".xml") || endsWith (fileName, ".uff")) {
+	   FILE *f	= fopen (fileName. c_str (), "rb");
+	   bool ok	= (f != nullptr) && openXml (f);
+	   if (f != nullptr)
+	      fclose (f);
+	   if (!ok) {
+	      static char unsupported [] =
+	                  "not an xml file with 8 or 16 bit IQ at 2048000";
+	      munmap (mapping, mappedSize);
+	      close (fd);
+	      throw OpeningFileFailed (fileName. c_str (), unsupported);
+	   }
+	}
+//	(0, 0) in the element format, 128 for unsigned bytes
+	silence. resize (MMAP_SILENCE * bytesPerSample,
+	                 sampleConverter. format () == IQ_U8 ? 128 : 0);
+	currPos. store (0);
+	peekPos		= 0;
+	paced		= 0;
+	eofSignalled. store (false);
+	running. store (false);
+}
+
+	mmapFileHandler::~mmapFileHandler	() {
+	stopReader ();
+	munmap (mapping, mappedSize);
+	close (fd);
+}
+//
+//	The xml files read here are the ones that need no rate
+//	conversion and have an element format the iqConverter knows,
+//	the others are left to the xml_fileReader
+bool	mmapFileHandler::openXml	(FILE *f) {
+bool	ok	= false;
+xmlDescriptor	theDescriptor (f, &ok);
+int	format;
+float	scale;
+
+	if (!ok || (theDescriptor. nrBlocks < 1) ||
+	    (theDescriptor. sampleRate != MMAP_SAMPLE_RATE))
+	   return false;
+	if ((theDescriptor. iqOrder != "IQ") &&
+	    (theDescriptor. iqOrder != "QI"))
+	   return false;
+	if (theDescriptor. container == "int8") {
+	   format	= IQ_S8;
+	   scale	= 1.0 / 127;
+	}
+	else
+	if (theDescriptor. container == "uint8") {
+	   format	= IQ_U8;
+	   scale	= 1.0 / 128;
+	}
+	else
+	if (theDescriptor. container == "int16") {
+	   format	= theDescriptor. byteOrder == "MSB" ?
+	                                       IQ_S16_BE : IQ_S16;
+	   scale	= 1.0 / (1 << (theDescriptor. bitsperChannel - 1));
+	}
+	else
+	   return false;
+
+	if (mappedSize <= XML_HEADER_SIZE)
+	   return false;
+	sampleConverter	= iqConverter (format, scale);
+	bytesPerSample	= sampleConverter. bytesPerSample ();
+	swapIQ		= theDescriptor. iqOrder == "QI";
+	data		= mapping + XML_HEADER_SIZE;
+//
+//	the blocks follow each other, a recording that was cut short
+//	is read as far as it goes
+	int64_t	samples	= 0;
+	for (auto &b : theDescriptor. blockList)
+	   samples += b. typeofUnit == "Channel" ?
+	                           b. nrElements / 2 : b. nrElements;
+	totalSamples	= (mappedSize - XML_HEADER_SIZE) / bytesPerSample;
+	if ((samples > 0) && (samples < totalSamples))
+	   totalSamples	= samples;
+	return true;
+}
+
+bool	mmapFileHandler::restartReader	(int32_t frequency) {
+	(void)frequency;
+	if (running. load ())
+	   return true;
+	restartClock ();
+	running. store (true);
+	return true;
+}
+
+void	mmapFileHandler::stopReader	() {
+	if (!running. load ())
+	   return;
+	running. store (false);
+	wakeUp ();
+}
+
+bool	mmapFileHandler::setUnthrottled	(bool b) {
+	unthrottled. store (b);
+	return true;
+}
+
+void	mmapFileHandler::restartClock	() {
+	startTime	= std::chrono::steady_clock::now ();
+	paced		= 0;
+}
+//
+//	When looping there is always data, otherwise up to the end
+//	of the file and a block of silence beyond it. Throttled, no more
+//	samples are released than the time since the start of the replay
+//	allows
+int32_t	mmapFileHandler::available	() {
+	if (!running. load ())
+	   return 0;
+int64_t	left	= repeater ? totalSamples : totalSamples - currPos. load ();
+	if (left < MMAP_SILENCE)
+	   left	= MMAP_SILENCE;
+	if (!unthrottled. load ()) {
+	   int64_t usecs = std::chrono::duration_cast<std::chrono::microseconds>
+	                      (std::chrono::steady_clock::now () - startTime).
+	                                                          count ();
+	   int64_t due	= usecs * MMAP_SAMPLE_RATE / 1000000 - paced;
+	   if (due < left)
+	      left	= due;
+	}
+	if (left < 0)
+	   return 0;
+	return left > (1 << 24) ? (1 << 24) : (int32_t)left;
+}
+
+int32_t	mmapFileHandler::Samples	() {
+	return available ();
+}
+//
+//	the samples are taken in place, as far as the end of the file,
+//	beyond it from the silence
+const void	*mmapFileHandler::peekNative	(int32_t *amount) {
+int64_t	pos	= currPos. load ();
+int64_t	n	= available ();
+bool	beyond	= pos >= totalSamples;
+
+	if (!beyond && (n > totalSamples - pos))
+	   n	= totalSamples - pos;
+	if (n > *amount)
+	   n	= *amount;
+	if (n <= 0) {
+	   *amount	= 0;
+	   return nullptr;
+	}
+	*amount	= n;
+	peekPos	= pos;
+	return beyond ? silence. data () : data + pos * bytesPerSample;
+}
+
+void	mmapFileHandler::convertNative	(const void *in, int32_t n,
+	                                 std::complex<float> *out) {
+	sampleConverter. convert (in, n, out);
+	if (swapIQ)
+	   for (int32_t i = 0; i < n; i ++)
+	      out [i] = std::complex<float> (imag (out [i]), real (out [i]));
+}
+//
+//	Not looping, the end of the input is signalled when the last
+//	sample of the file is taken, the decoder then has all of them
+void	mmapFileHandler::commitSamples	(int32_t amount) {
+int64_t	expected	= peekPos;
+int64_t	pos		= peekPos + amount;
+
+	paced	+= amount;
+//	a seek in between wins
+	if (!currPos. compare_exchange_strong (expected, pos))
+	   return;
+	if (pos < totalSamples)
+	   return;
+	if (repeater) {
+	   currPos. compare_exchange_strong (pos, 0);
+	   return;
+	}
+	if (!eofSignalled. exchange (true) && (eofHandler != nullptr))
+	   eofHandler (userData);
+}
+
+int32_t	mmapFileHandler::getSamples	(std::complex<float> *v,
+	                                 int32_t size) {
+int32_t	done	= 0;
+
+	while (waitForSamples (size, 100) < size)
+	   if (!running. load ())
+	      break;
+
+	while (done < size) {
+	   int32_t amount	= size - done;
+	   const void *p	= peekNative (&amount);
+	   if (p == nullptr)
+	      break;
+	   convertNative (p, amount, &v [done]);
+	   commitSamples (amount);
+	   done	+= amount;
+	}
+	return done;
+}
+//
+//	A seek moves the replay, the clock of the throttling keeps
+//	running. A seek while the decoder is reading takes effect with
+//	its next read, the samples it has in hand are not counted
+bool	mmapFileHandler::seekTime	(double seconds) {
+	return seekSample ((int64_t)(seconds * MMAP_SAMPLE_RATE));
+}
+
+bool	mmapFileHandler::seekFrame	(int64_t frame) {
+	return seekSample (frame * MMAP_FRAME_SIZE);
+}
+
+bool	mmapFileHandler::seekSample	(int64_t pos) {
+	if ((pos < 0) || (pos >= totalSamples))
+	   return false;
+	currPos. store (pos);
+	eofSignalled. store (false);
+	return true;
+}
+
+int64_t	mmapFileHandler::position	() {
+	return currPos. load ();
+}
+
+int64_t	mmapFileHandler::nrSamples	() {
+	return totalSamples;
+}
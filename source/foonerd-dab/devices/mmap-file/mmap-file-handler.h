@@ -0,0 +1,102 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	mmapFileHandler replays a recording, raw u8 IQ or an xml file
+//	with 8 or 16 bit IQ elements at 2048000 samples/s, from a read
+//	only memory mapping of the file. There is no reader thread and
+//	no ring buffer, the samples are given in place (peekNative) and
+//	converted into the buffer of the sample reader.
+//	The replay can start at any time or frame (seekTime, seekFrame),
+//	and can loop. Unthrottled it runs as fast as the decoder, otherwise
+//	the samples are released at the sample rate.
+//	Without looping - as with the rawFiles handler - silence follows
+//	the end of the file, the eof handler is called when the last
+//	sample of the file is taken
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+#include	<atomic>
+#include	<chrono>
+#include	"device-handler.h"
+#include	"iq-converter.h"
+
+//	a Mode I frame, 96 msec
+#define	MMAP_FRAME_SIZE		196608
+#define	MMAP_SAMPLE_RATE	2048000
+//	the silence after the end of the file is given in blocks of
+#define	MMAP_SILENCE		32768
+
+typedef	void (*device_eof_callback_t)(void * userData);
+
+class	mmapFileHandler: public deviceHandler {
+public:
+			mmapFileHandler	(std::string, bool repeater = true,
+	                                 device_eof_callback_t eofHandler =
+	                                                          nullptr,
+	                                 void *userData = nullptr);
+			~mmapFileHandler	();
+	bool		restartReader	(int32_t);
+	void		stopReader	();
+	int32_t		getSamples	(std::complex<float> *, int32_t);
+	int32_t		Samples		();
+	const void	*peekNative	(int32_t *);
+	void		convertNative	(const void *, int32_t,
+	                                 std::complex<float> *);
+	void		commitSamples	(int32_t);
+	bool		setUnthrottled	(bool);
+//
+//	the position is in samples from the start of the data, a seek
+//	beyond the end is refused
+	bool		seekTime	(double seconds);
+	bool		seekFrame	(int64_t frame);
+	int64_t		position	();
+	int64_t		nrSamples	();
+private:
+	std::string	fileName;
+	bool		repeater;
+	device_eof_callback_t	eofHandler;
+	void		*userData;
+	int		fd;
+	uint8_t		*mapping;
+	size_t		mappedSize;
+	const uint8_t	*data;
+	int64_t		totalSamples;
+	int32_t		bytesPerSample;
+	bool		swapIQ;
+	iqConverter	sampleConverter;
+	std::vector<uint8_t>	silence;
+	std::atomic<int64_t>	currPos;
+	int64_t		peekPos;
+	std::atomic<bool>	running;
+	std::atomic<bool>	eofSignalled;
+//	throttling: the samples taken since the clock was (re)started
+	std::chrono::steady_clock::time_point	startTime;
+	int64_t		paced;
+
+	int32_t		available	();
+	bool		seekSample	(int64_t);
+	void		restartClock	();
+	bool		openXml		(FILE *);
+};
+
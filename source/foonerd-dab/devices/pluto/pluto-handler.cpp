@@ -49,11 +49,6 @@ bool get_ad9361_stream_ch (__notused struct iio_context *ctx,
         return *chn != nullptr;
 }
 
-static inline
-std::complex<float> cmul (std::complex<float> x, float y) {
-	return std::complex<float> (real (x) * y, imag (x) * y);
-}
-
 int	ad9361_set_trx_fir_enable(struct iio_device *dev, int enable) {
 int ret = iio_device_attr_write_bool (dev,
 	                              "in_out_voltage_filter_fir_en",
@@ -86,7 +81,9 @@ bool value;
 	plutoHandler::plutoHandler  (int32_t	frequency,
 	                             int	gainValue,
 	                             bool	agcMode):
-	                               _I_Buffer (4 * 1024 * 1024) {
+	                               _I_Buffer (4 * 1024 * 1024),
+	                               theConverter (PLUTO_RATE, DAB_RATE),
+	                               sampleConverter (IQ_S16, 1.0 / 2048) {
 struct iio_channel *chn = nullptr;
 
 	this	-> ctx			= nullptr;
@@ -233,17 +230,6 @@ struct iio_channel *chn = nullptr;
 	   if (ret < 0)
 	      DEBUG_PRINT ("error in initial gain setting");
 	}
-//
-//	and set up interpolation table
-	float	divider		= (float)DIVIDER;
-	float	denominator	= DAB_RATE / divider;
-	for (int i = 0; i < DAB_RATE / DIVIDER; i ++) {
-           float inVal  = float (PLUTO_RATE / divider);
-           mapTable_int [i]     =  int (floor (i * (inVal / denominator)));
-           mapTable_float [i]   = i * (inVal / denominator) - mapTable_int [i];
-        }
-        convIndex       = 0;
-
 	int enabled;
 //	go for the filter
 	ad9361_get_trx_fir_enable (phys_dev, &enabled);
@@ -301,7 +287,6 @@ void	plutoHandler::run	() {
 char	*p_end, *p_dat;
 int	p_inc;
 int	nbytes_rx;
-std::complex<float> localBuf [DAB_RATE / DIVIDER];
 
 	running. store (true);
 	while (running. load ()) {
@@ -309,27 +294,24 @@ std::complex<float> localBuf [DAB_RATE / DIVIDER];
 	   p_inc	= iio_buffer_step	(rxbuf);
 	   p_end	= (char *)(iio_buffer_end  (rxbuf));
 
-	   for (p_dat = (char *)iio_buffer_first (rxbuf, rx0_i);
-	        p_dat < p_end; p_dat += p_inc) {
-	      const int16_t i_p = ((int16_t *)p_dat) [0];
-	      const int16_t q_p = ((int16_t *)p_dat) [1];
-	      std::complex<float>sample = std::complex<float> (i_p / 2048.0,
-	                                                       q_p / 2048.0);
-	      convBuffer [convIndex ++] = sample;
-	      if (convIndex > CONV_SIZE) {
-	         for (int j = 0; j < DAB_RATE / DIVIDER; j ++) {
-	            int16_t inpBase	= mapTable_int [j];
-	            float   inpRatio	= mapTable_float [j];
-	            localBuf [j]	= cmul (convBuffer [inpBase + 1],
-	                                                          inpRatio) +
-                                     cmul (convBuffer [inpBase], 1 - inpRatio);
-                 }
-	         _I_Buffer. putDataIntoBuffer (localBuf,
-	                                          DAB_RATE / DIVIDER);
-	         convBuffer [0] = convBuffer [CONV_SIZE];
-	         convIndex = 1;
-	      }
-	   }
+	   p_dat	= (char *)iio_buffer_first (rxbuf, rx0_i);
+	   int nSamples	= p_dat < p_end ? (p_end - p_dat + p_inc - 1) / p_inc : 0;
+	   convBuffer. resize (nSamples);
+//
+//	with just the I and Q channel enabled the samples are adjacent
+	   if (p_inc == 2 * sizeof (int16_t))
+	      sampleConverter. convert (p_dat, nSamples, convBuffer. data ());
+	   else
+	      for (int i = 0; i < nSamples; i ++, p_dat += p_inc)
+	         sampleConverter. convert (p_dat, 1, &convBuffer [i]);
+//
+//	the samples of the buffer are converted to DAB_RATE in one go
+	   if ((int)outBuffer. size () < theConverter. outSize (nSamples))
+	      outBuffer. resize (theConverter. outSize (nSamples));
+	   int n	= theConverter. convert (convBuffer. data (), nSamples,
+	                                         outBuffer. data ());
+	   _I_Buffer. putDataIntoBuffer (outBuffer. data (), n);
+	   samplesArrived ();
 	}
 }
 
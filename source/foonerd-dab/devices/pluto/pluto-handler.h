@@ -27,12 +27,13 @@
 #include	<iio.h>
 #include	"ringbuffer.h"
 #include	"device-handler.h"
+#include	"rate-converter.h"
+#include	"iq-converter.h"
 #include	<thread>
+#include	<vector>
 
 #define	PLUTO_RATE	2100000
 #define	DAB_RATE	2048000
-#define	DIVIDER		1000
-#define	CONV_SIZE	(PLUTO_RATE / DIVIDER)
 class	plutoHandler: public deviceHandler {
 public:
 			plutoHandler		(int	frequency,
@@ -68,10 +69,10 @@ private:
 	struct	iio_channel	*rx0_q;
 	struct	iio_buffer	*rxbuf;
 //	struct	stream_cfg	rxcfg;
-	std::complex<float>	convBuffer	[CONV_SIZE + 1];
-	int			convIndex;
-	int16_t			mapTable_int	[DAB_RATE / DIVIDER];
-	float			mapTable_float	[DAB_RATE / DIVIDER];
+	rateConverter		theConverter;
+	iqConverter		sampleConverter;
+	std::vector<std::complex<float>>	convBuffer;
+	std::vector<std::complex<float>>	outBuffer;
 };
 
 
@@ -0,0 +1,294 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"rate-converter.h"
+#include	<math.h>
+#include	<string.h>
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define	X86_KERNELS
+#include	<immintrin.h>
+#endif
+#if defined (__aarch64__)
+#define	NEON_KERNELS
+#include	<arm_neon.h>
+#endif
+
+static
+int32_t	gcd		(int32_t a, int32_t b) {
+	while (b != 0) {
+	   int32_t t = a % b;
+	   a	= b;
+	   b	= t;
+	}
+	return a;
+}
+
+//	the modified Bessel function of order 0, for the Kaiser window
+static
+double	besselI0	(double x) {
+double	sum	= 1;
+double	term	= 1;
+
+	for (int k = 1; k < 50; k ++) {
+	   term	*= (x / (2 * k)) * (x / (2 * k));
+	   sum	+= term;
+	   if (term < sum * 1e-12)
+	      break;
+	}
+	return sum;
+}
+
+//	the inner product of taps (interleaved) complex samples with the
+//	(duplicated) coefficients
+static
+void	dot_scalar	(const float *samples, const float *coeffs,
+	                 int taps, float *out) {
+float	re	= 0;
+float	im	= 0;
+
+	for (int i = 0; i < 2 * taps; i += 2) {
+	   re	+= samples [i] * coeffs [i];
+	   im	+= samples [i + 1] * coeffs [i + 1];
+	}
+	out [0]	= re;
+	out [1]	= im;
+}
+
+#ifdef	X86_KERNELS
+__attribute__ ((target ("sse2")))
+static
+void	dot_sse2	(const float *samples, const float *coeffs,
+	                 int taps, float *out) {
+__m128	acc0	= _mm_setzero_ps ();
+__m128	acc1	= _mm_setzero_ps ();
+
+	for (int i = 0; i < 2 * taps; i += 8) {
+	   acc0	= _mm_add_ps (acc0, _mm_mul_ps (_mm_loadu_ps (&samples [i]),
+	                                        _mm_loadu_ps (&coeffs [i])));
+	   acc1	= _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (&samples [i + 4]),
+	                                        _mm_loadu_ps (&coeffs [i + 4])));
+	}
+//	lanes 0 and 2 are I, lanes 1 and 3 are Q
+	acc0	= _mm_add_ps (acc0, acc1);
+	acc0	= _mm_add_ps (acc0, _mm_movehl_ps (acc0, acc0));
+	_mm_storel_pi ((__m64 *)out, acc0);
+}
+
+__attribute__ ((target ("avx2,fma")))
+static
+void	dot_avx2	(const float *samples, const float *coeffs,
+	                 int taps, float *out) {
+__m256	acc0	= _mm256_setzero_ps ();
+__m256	acc1	= _mm256_setzero_ps ();
+int	i;
+
+//	two accumulators, to hide the latency of the fma's
+	for (i = 0; i + 16 <= 2 * taps; i += 16) {
+	   acc0	= _mm256_fmadd_ps (_mm256_loadu_ps (&samples [i]),
+	                           _mm256_loadu_ps (&coeffs [i]), acc0);
+	   acc1	= _mm256_fmadd_ps (_mm256_loadu_ps (&samples [i + 8]),
+	                           _mm256_loadu_ps (&coeffs [i + 8]), acc1);
+	}
+	if (i < 2 * taps)
+	   acc0	= _mm256_fmadd_ps (_mm256_loadu_ps (&samples [i]),
+	                           _mm256_loadu_ps (&coeffs [i]), acc0);
+	acc0	= _mm256_add_ps (acc0, acc1);
+	__m128 s	= _mm_add_ps (_mm256_castps256_ps128 (acc0),
+	                              _mm256_extractf128_ps (acc0, 1));
+	s	= _mm_add_ps (s, _mm_movehl_ps (s, s));
+	_mm_storel_pi ((__m64 *)out, s);
+}
+#endif
+
+#ifdef	NEON_KERNELS
+static
+void	dot_neon	(const float *samples, const float *coeffs,
+	                 int taps, float *out) {
+float32x4_t	acc0	= vdupq_n_f32 (0);
+float32x4_t	acc1	= vdupq_n_f32 (0);
+
+	for (int i = 0; i < 2 * taps; i += 8) {
+	   acc0	= vmlaq_f32 (acc0, vld1q_f32 (&samples [i]),
+	                           vld1q_f32 (&coeffs [i]));
+	   acc1	= vmlaq_f32 (acc1, vld1q_f32 (&samples [i + 4]),
+	                           vld1q_f32 (&coeffs [i + 4]));
+	}
+	acc0	= vaddq_f32 (acc0, acc1);
+	vst1_f32 (out, vadd_f32 (vget_low_f32 (acc0), vget_high_f32 (acc0)));
+}
+#endif
+
+	rateConverter::rateConverter	(int32_t inRate, int32_t outRate,
+	                                 int taps, float attenuation) {
+	if ((inRate <= 0) || (outRate <= 0) || (taps <= 0))
+	   throw (21);
+	int32_t	g	= gcd (inRate, outRate);
+	interpolation	= outRate / g;
+	decimation	= inRate / g;
+//
+//	the filter spans taps samples at the lower rate, i.e.
+//	taps * inRate / lower input samples
+	int32_t lower	= inRate < outRate ? inRate : outRate;
+	nTaps		= (int)ceil ((double)taps * inRate / lower);
+	nTaps		= (nTaps + 3) & ~03;
+	setKernel (RC_AUTO);
+	reset ();
+	if (interpolation == decimation)
+	   return;
+
+	int	L	= interpolation;
+	int	N	= L * nTaps;
+//	the cutoff, relative to the rate of the interpolated signal
+	double	fc	= 0.5 * lower / ((double)L * inRate);
+	double	beta	= attenuation > 50 ?
+	                       0.1102 * (attenuation - 8.7) :
+	                  attenuation > 21 ?
+	                       0.5842 * pow (attenuation - 21, 0.4) +
+	                       0.07886 * (attenuation - 21) : 0;
+	std::vector<double> h (N);
+	double	sum	= 0;
+	for (int i = 0; i < N; i ++) {
+	   double t	= i - (N - 1) / 2.0;
+	   double x	= 2 * i / (double)(N - 1) - 1;
+	   double sinc	= t == 0 ? 1 : sin (2 * M_PI * fc * t) /
+	                                     (2 * M_PI * fc * t);
+	   h [i]	= 2 * fc * sinc *
+	                  besselI0 (beta * sqrt (1 - x * x)) / besselI0 (beta);
+	   sum	+= h [i];
+	}
+//
+//	output sample n is at time n * M (at the interpolated rate),
+//	written as b * L + p, it is the sum over h [p + j * L] *
+//	in [b - j]. The phases are stored with the oldest sample first
+	coeffs. resize (2 * N);
+	for (int p = 0; p < L; p ++)
+	   for (int m = 0; m < nTaps; m ++) {
+	      float c	= h [p + (nTaps - 1 - m) * L] * L / sum;
+	      coeffs [2 * (p * nTaps + m)]	= c;
+	      coeffs [2 * (p * nTaps + m) + 1]	= c;
+	   }
+}
+
+	rateConverter::~rateConverter	() {}
+
+void	rateConverter::reset	() {
+	history. assign (nTaps - 1, std::complex<float> (0, 0));
+	position	= nTaps - 1;
+	phase		= 0;
+}
+
+int32_t	rateConverter::convert	(const std::complex<float> *in,
+	                         int32_t n, std::complex<float> *out) {
+int32_t	count	= 0;
+
+	if (interpolation == decimation) {
+	   memcpy (out, in, n * sizeof (std::complex<float>));
+	   return n;
+	}
+
+	history. insert (history. end (), in, in + n);
+	int32_t	available	= history. size ();
+	const float *samples	= (const float *)history. data ();
+	while (position < available) {
+	   kernel (&samples [2 * (position - nTaps + 1)],
+	           &coeffs [2 * phase * nTaps], nTaps,
+	           (float *)&out [count ++]);
+	   phase	+= decimation;
+	   position	+= phase / interpolation;
+	   phase	%= interpolation;
+	}
+//
+//	keep the nTaps - 1 samples preceding the next one to be used
+	int32_t	used	= position - (nTaps - 1);
+	history. erase (history. begin (), history. begin () + used);
+	position	-= used;
+	return count;
+}
+
+int32_t	rateConverter::outSize	(int32_t n) {
+	return (int32_t)((int64_t)n * interpolation / decimation) + 2;
+}
+
+int	rateConverter::L	() {
+	return interpolation;
+}
+
+int	rateConverter::M	() {
+	return decimation;
+}
+
+int	rateConverter::taps	() {
+	return nTaps;
+}
+
+bool	rateConverter::setKernel	(int type) {
+	switch (type) {
+	   case RC_AUTO:
+#ifdef	X86_KERNELS
+	      if (__builtin_cpu_supports ("avx2") &&
+	          __builtin_cpu_supports ("fma"))
+	         return setKernel (RC_AVX2);
+	      if (__builtin_cpu_supports ("sse2"))
+	         return setKernel (RC_SSE2);
+#endif
+#ifdef	NEON_KERNELS
+	      return setKernel (RC_NEON);
+#endif
+	      return setKernel (RC_SCALAR);
+
+	   case RC_SCALAR:
+	      kernel	= dot_scalar;
+	      break;
+#ifdef	X86_KERNELS
+	   case RC_SSE2:
+	      if (!__builtin_cpu_supports ("sse2"))
+	         return false;
+	      kernel	= dot_sse2;
+	      break;
+
+	   case RC_AVX2:
+	      if (!__builtin_cpu_supports ("avx2") ||
+	          !__builtin_cpu_supports ("fma"))
+	         return false;
+	      kernel	= dot_avx2;
+	      break;
+#endif
+#ifdef	NEON_KERNELS
+	   case RC_NEON:
+	      kernel	= dot_neon;
+	      break;
+#endif
+	   default:
+	      return false;
+	}
+	kernelType	= type;
+	return true;
+}
+
+const char	*rateConverter::kernelName	() {
+	switch (kernelType) {
+	   case RC_SSE2:	return "sse2";
+	   case RC_AVX2:	return "avx2";
+	   case RC_NEON:	return "neon";
+	   default:		return "scalar";
+	}
+}
@@ -0,0 +1,80 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	rateConverter converts a stream of samples from the rate of
+//	the device to the 2048000 samples/second of DAB, with a rational
+//	polyphase filter: the output rate is L / M times the input rate,
+//	for each output sample the inner product of one of the L phases
+//	of the (Kaiser windowed sinc) lowpass filter with the last input
+//	samples is computed.
+//	taps is the length of the filter, expressed in samples at the
+//	lower of the two rates, attenuation the stopband attenuation
+//	(in dB) the filter is designed for. The transition band is
+//	centered on half the lower rate.
+//	convert takes any number of input samples and returns the number
+//	of output samples, at most outSize (n) of them. With equal rates
+//	the samples are just copied
+#include	<stdint.h>
+#include	<complex>
+#include	<vector>
+
+#define	RC_AUTO		0
+#define	RC_SCALAR	1
+#define	RC_SSE2		2
+#define	RC_AVX2		3
+#define	RC_NEON		4
+
+typedef void (*rcKernel_t)(const float *samples, const float *coeffs,
+	                   int taps, float *out);
+
+class	rateConverter {
+public:
+			rateConverter	(int32_t inRate,
+	                                 int32_t outRate	= 2048000,
+	                                 int taps		= 32,
+	                                 float attenuation	= 90);
+			~rateConverter	();
+	int32_t		convert		(const std::complex<float> *in,
+	                                 int32_t n,
+	                                 std::complex<float> *out);
+	int32_t		outSize		(int32_t n);
+	void		reset		();
+	int		L		();
+	int		M		();
+	int		taps		();
+	bool		setKernel	(int);
+	const char	*kernelName	();
+private:
+	int		interpolation;	// L
+	int		decimation;	// M
+	int		nTaps;		// taps per phase, a multiple of 4
+//	per phase the coefficients in time order, each one twice, so
+//	they can be multiplied with the interleaved I and Q values
+	std::vector<float>	coeffs;
+	std::vector<std::complex<float>>	history;
+	int		position;	// of the newest input sample used
+	int		phase;
+	rcKernel_t	kernel;
+	int		kernelType;
+};
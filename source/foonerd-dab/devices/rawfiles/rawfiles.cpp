@@ -46,10 +46,11 @@ struct timeval  tv;
 #define	__BUFFERSIZE	16 * 32768
 //
 //
-	rawFiles::rawFiles (std::string f, bool repeater) {
+	rawFiles::rawFiles (std::string f, bool repeater):
+	                        sampleConverter (IQ_U8, 1.0 / 128) {
 	fileName	= f;
 	this	-> repeater	= repeater;
-	_I_Buffer	= new RingBuffer<std::complex<float>>(__BUFFERSIZE);
+	_I_Buffer	= new RingBuffer<uint8_t>(2 * __BUFFERSIZE);
 	filePointer	= fopen (f. c_str (), "rb");
 	if (filePointer == NULL) {
 	   delete _I_Buffer;
@@ -64,10 +65,11 @@ struct timeval  tv;
 	rawFiles::rawFiles (std::string f,
 	                    double fileOffsetInSeconds,
 	                    device_eof_callback_t eofHandler,
-	                    void * userData) {
+	                    void * userData):
+	                        sampleConverter (IQ_U8, 1.0 / 128) {
 	fileName	= f;
 	this	-> repeater = false;
-	_I_Buffer	= new RingBuffer<std::complex<float>>(__BUFFERSIZE);
+	_I_Buffer	= new RingBuffer<uint8_t>(2 * __BUFFERSIZE);
 	filePointer	= fopen (f. c_str (), "rb");
 	if (filePointer == NULL) {
 	   delete _I_Buffer;
@@ -83,6 +85,7 @@ struct timeval  tv;
 	rawFiles::~rawFiles () {
 	if (running. load ()) {
 	   running. store (false);
+	   wakeUp ();
 	   workerHandle. join ();
 	   fclose (filePointer);
 	}
@@ -99,32 +102,61 @@ bool	rawFiles::restartReader	(int32_t frequency) {
 void	rawFiles::stopReader	() {
        if (running. load ()) {
 	   running. store (false);
+	   wakeUp ();
            workerHandle. join ();
 	}
 }
 
 int32_t	rawFiles::getSamples	(std::complex<float> *V, int32_t size) {
 int32_t	amount;
+uint8_t	tempBuffer [2 * size];
 
 	if (filePointer == NULL)
 	   return 0;
 
-	while ((_I_Buffer -> GetRingBufferReadAvailable ()) < size)
-	   usleep (100);
+	while (waitForSamples (size, 100) < size)
+	   if (!running. load ())
+	      return 0;
 
-	amount	= _I_Buffer -> getDataFromBuffer (V, size);
+	amount	= _I_Buffer -> getDataFromBuffer (tempBuffer, 2 * size) / 2;
+	roomAvailable ();
+	sampleConverter. convert (tempBuffer, amount, V);
 	return amount;
 }
 
 int32_t	rawFiles::Samples (void) {
-	return _I_Buffer -> GetRingBufferReadAvailable ();
+	return _I_Buffer -> GetRingBufferReadAvailable () / 2;
+}
+//
+//	the buffer keeps the samples as they are in the file, they are
+//	converted when taken
+const void	*rawFiles::peekNative	(int32_t *amount) {
+int32_t	n	= 2 * *amount;
+const uint8_t *p	= _I_Buffer -> peek (&n);
+
+	*amount	= n / 2;
+	return p;
+}
+
+void	rawFiles::convertNative	(const void *in, int32_t n,
+	                         std::complex<float> *out) {
+	sampleConverter. convert (in, n, out);
+}
+
+void	rawFiles::commitSamples	(int32_t amount) {
+	_I_Buffer -> commit (2 * amount);
+	roomAvailable ();
+}
+
+bool	rawFiles::setUnthrottled	(bool b) {
+	unthrottled. store (b);
+	return true;
 }
 //
 //	The actual interface to the filereader is in a separate thread
 //
 void	rawFiles::run () {
-int32_t	t, i;
-std::complex<float>	*bi;
+int32_t	t;
 int32_t	bufferSize	= 32768;
 int64_t	period;
 int64_t	nextStop;
@@ -133,25 +165,21 @@ bool	eofReached	= false;
 	running. store (true);
 	period		= (32768 * 1000) / (2 * 2048);	// full IQś read
 	DEBUG_PRINT ("Period = %ld\n", period);
-	bi		= new std::complex<float> [bufferSize];
 	nextStop	= getMyTime ();
 	while (running. load ()) {
-	   while (_I_Buffer -> WriteSpace () < bufferSize + 10) {
-	      if (!running. load ())
-	         break;
-	      usleep (100);
-	   }
+	   while (running. load () &&
+	          !waitForRoom ([&] () {
+	               return _I_Buffer -> WriteSpace () >= 2 * bufferSize + 10;
+	          }, 100))
+	      ;
 
 	   nextStop += period;
-	   t = readBuffer (bi, bufferSize);
+	   t = readIntoBuffer (bufferSize);
 	   if (t < bufferSize) {
-	      for (i = 0; i < bufferSize; i ++)
-	          bi [i] = 0;
-	      t = bufferSize;
+	      putSilence (bufferSize - t);
 	      eofReached	= true;
 	   }
-
-	   _I_Buffer -> putDataIntoBuffer (bi, t);
+	   samplesArrived ();
 	   if (eofReached && repeater) {
 	      fseek (filePointer, currPos, SEEK_SET);
 	      eofReached = false;
@@ -165,6 +193,8 @@ bool	eofReached	= false;
 	   if (eofReached)
 	      break;
 
+	   if (unthrottled. load ())
+	      continue;
 	   if (nextStop - getMyTime () > 0)
 	      usleep (nextStop - getMyTime ());
 	}
@@ -173,14 +203,9 @@ bool	eofReached	= false;
 /*
  *	length is number of uints that we read.
  */
-int32_t	rawFiles::readBuffer (std::complex<float> *data, int32_t length) {
+int32_t	rawFiles::readBuffer (uint8_t *data, int32_t length) {
 int32_t	n;
-int	i;
-uint8_t temp [2 * length];
-	n = fread (temp,  sizeof (uint8_t), 2 * length, filePointer);
-	for (i = 0; i < n / 2; i ++)
-	   data [i] = std::complex <float> ((float)(temp [2 * i] - 128) / 128,
-	                                    (float)(temp [2 * i + 1] - 128) / 128);
+	n = fread (data,  sizeof (uint8_t), 2 * length, filePointer);
 	currPos		+= n;
 	if (n < length) {
 	   fseek (filePointer, 0, SEEK_SET);
@@ -188,3 +213,32 @@ uint8_t temp [2 * length];
 	}
 	return	n / 2;
 }
+//
+//	The samples are read in place, into the ring buffer. When the
+//	buffer is not mirrored a block may be split at its end, so it
+//	is read in (at most) two parts
+int32_t	rawFiles::readIntoBuffer	(int32_t length) {
+int32_t	done	= 0;
+
+	while (done < length) {
+	   int32_t amount	= 2 * (length - done);
+	   uint8_t *p		= _I_Buffer -> reserve (&amount);
+	   int32_t n		= readBuffer (p, amount / 2);
+	   _I_Buffer -> publish (2 * n);
+	   done	+= n;
+	   if (n < amount / 2)
+	      break;
+	}
+	return done;
+}
+//
+//	at the end of the file the block is completed with (0, 0)
+void	rawFiles::putSilence	(int32_t length) {
+	while (length > 0) {
+	   int32_t amount	= 2 * length;
+	   uint8_t *p		= _I_Buffer -> reserve (&amount);
+	   memset (p, 128, amount);
+	   _I_Buffer -> publish (amount);
+	   length	-= amount / 2;
+	}
+}
@@ -24,6 +24,7 @@
 
 #include        "ringbuffer.h"
 #include        "device-handler.h"
+#include        "iq-converter.h"
 #include        <thread>
 #include        <atomic>
 
@@ -41,6 +42,11 @@ public:
 	int32_t		getSamples	(std::complex<float> *, int32_t);
 	uint8_t		myIdentity	(void);
 	int32_t		Samples		(void);
+	const void	*peekNative	(int32_t *);
+	void		convertNative	(const void *, int32_t,
+	                                 std::complex<float> *);
+	void		commitSamples	(int32_t);
+	bool		setUnthrottled	(bool);
 	bool		restartReader	(int32_t);
 	void		stopReader	(void);
 private:
@@ -50,12 +56,15 @@ private:
 	bool		repeater;
 	void		*userData;
 virtual	void		run		(void);
-	RingBuffer<std::complex<float>>	*_I_Buffer;
-	int32_t		readBuffer	(std::complex<float> *, int32_t);
+	RingBuffer<uint8_t>	*_I_Buffer;
+	int32_t		readBuffer	(uint8_t *, int32_t);
+	int32_t		readIntoBuffer	(int32_t);
+	void		putSilence	(int32_t);
 
 	std::thread	workerHandle;
 	int32_t		bufferSize;
 	FILE		*filePointer;
+	iqConverter	sampleConverter;
 	std::atomic<bool> running;
 	int64_t		currPos;
 };
@@ -31,7 +31,8 @@
 	                                 int32_t	frequency,
 	                                 int16_t	gain,
 	                                 bool		autogain,
-	                                 int16_t	ppm) {
+	                                 int16_t	ppm):
+	                                    sampleConverter (IQ_U8, 1.0 / 128) {
 	this	-> hostname	= hostname;
 	this	-> basePort	= port;
 	this	-> vfoFrequency	= frequency;
@@ -114,6 +115,7 @@ void	rtl_tcp_client:: run () {
            }
 
            theBuffer -> putDataIntoBuffer (buffer, res);
+	   samplesArrived ();
         }
 }
 
@@ -123,19 +125,35 @@ void	rtl_tcp_client:: run () {
 //	uint8_t to std::complex<float>
 int32_t	rtl_tcp_client::getSamples (std::complex<float> *V, int32_t size) {
 int32_t	amount;
-uint8_t	tempBuffer = [2 * size];
+uint8_t	tempBuffer [2 * size];
 //
 	amount = theBuffer	-> getDataFromBuffer (tempBuffer, 2 * size);
-	for (int i = 0; i < amount / 2; i ++)
-	    V [i] = std::complex<float> (
-	                        (float (tempBuffer [2 * i] - 128)) / 128.0,
-	                        (float (tempBuffer [2 * i + 1] - 128)) / 128.0);
+	sampleConverter. convert (tempBuffer, amount / 2, V);
 	return amount / 2;
 }
 
 int32_t	rtl_tcp_client::Samples	() {
 	return  theBuffer	-> GetRingBufferReadAvailable () / 2;
 }
+//
+//	the samples stay uint8_t in the buffer until the sample reader
+//	takes them
+const void	*rtl_tcp_client::peekNative	(int32_t *amount) {
+int32_t	n	= 2 * *amount;
+const uint8_t *p	= theBuffer -> peek (&n);
+
+	*amount	= n / 2;
+	return p;
+}
+
+void	rtl_tcp_client::convertNative	(const void *in, int32_t n,
+	                                 std::complex<float> *out) {
+	sampleConverter. convert (in, n, out);
+}
+
+void	rtl_tcp_client::commitSamples	(int32_t amount) {
+	theBuffer	-> commit (2 * amount);
+}
 
 //	bitDepth is is used to set the scale for the spectrum
 //	not really something you would expect here
@@ -40,6 +40,7 @@
 #include	"dab-constants.h"
 #include	"device-handler.h"
 #include	"ringbuffer.h"
+#include	"iq-converter.h"
 
 //	commands are packed in 5 bytes, one "command byte" 
 //	and an integer parameter
@@ -61,6 +62,10 @@ public:
 	void		stopReader	();
 	int32_t		getSamples	(std::complex<float> *V, int32_t size);
 	int32_t		Samples		();
+	const void	*peekNative	(int32_t *);
+	void		convertNative	(const void *, int32_t,
+	                                 std::complex<float> *);
+	void		commitSamples	(int32_t);
 	int16_t		bitDepth	();
 private:
 virtual	void		run		();
@@ -73,6 +78,7 @@ virtual	void		run		();
 
 	int32_t		theRate;
 	RingBuffer<uint8_t>	*theBuffer;
+	iqConverter	sampleConverter;
 	int		theSocket;
         struct sockaddr_in server;
 	std::thread     threadHandle;
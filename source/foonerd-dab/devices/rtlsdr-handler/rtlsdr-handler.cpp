@@ -34,6 +34,7 @@
 #include	<chrono>
 #include	<ctime>
 #include	<unistd.h>
+#include	<string.h>
 
 #ifdef	__MINGW32__
 #define	GETPROCADDRESS	GetProcAddress
@@ -56,6 +57,7 @@ rtlsdrHandler	*theStick	= (rtlsdrHandler *)ctx;
 	   return;
 
 	(void) theStick -> _I_Buffer -> putDataIntoBuffer (buf, len);
+	theStick -> samplesArrived ();
 }
 //
 //	for handling the events in libusb, we need a controlthread
@@ -90,7 +92,8 @@ static const char* getTunerName(int tunerType) {
 	                              bool	autogain,
 	                              uint16_t	deviceIndex,
 	                              const char *	deviceSerial,
-	                              const char *	deviceOpts ) {
+	                              const char *	deviceOpts ):
+	                                 sampleConverter (IQ_U8, 1.0 / 128) {
 int16_t	deviceCount;
 int32_t	r;
 int16_t	i;
@@ -299,46 +302,26 @@ void	rtlsdrHandler::stopReader	(void) {
 	workerHandle. join ();
 	running	= false;
 }
-//
-//	we only have 8 bits, so rather than doing a float division to get
-//	the float value we want, we precompute the possibilities
-static
-float convTable [] = {
- -128 / 128.0 , -127 / 128.0 , -126 / 128.0 , -125 / 128.0 , -124 / 128.0 , -123 / 128.0 , -122 / 128.0 , -121 / 128.0 , -120 / 128.0 , -119 / 128.0 , -118 / 128.0 , -117 / 128.0 , -116 / 128.0 , -115 / 128.0 , -114 / 128.0 , -113 / 128.0
-, -112 / 128.0 , -111 / 128.0 , -110 / 128.0 , -109 / 128.0 , -108 / 128.0 , -107 / 128.0 , -106 / 128.0 , -105 / 128.0 , -104 / 128.0 , -103 / 128.0 , -102 / 128.0 , -101 / 128.0 , -100 / 128.0 , -99 / 128.0 , -98 / 128.0 , -97 / 128.0
-, -96 / 128.0 , -95 / 128.0 , -94 / 128.0 , -93 / 128.0 , -92 / 128.0 , -91 / 128.0 , -90 / 128.0 , -89 / 128.0 , -88 / 128.0 , -87 / 128.0 , -86 / 128.0 , -85 / 128.0 , -84 / 128.0 , -83 / 128.0 , -82 / 128.0 , -81 / 128.0
-, -80 / 128.0 , -79 / 128.0 , -78 / 128.0 , -77 / 128.0 , -76 / 128.0 , -75 / 128.0 , -74 / 128.0 , -73 / 128.0 , -72 / 128.0 , -71 / 128.0 , -70 / 128.0 , -69 / 128.0 , -68 / 128.0 , -67 / 128.0 , -66 / 128.0 , -65 / 128.0
-, -64 / 128.0 , -63 / 128.0 , -62 / 128.0 , -61 / 128.0 , -60 / 128.0 , -59 / 128.0 , -58 / 128.0 , -57 / 128.0 , -56 / 128.0 , -55 / 128.0 , -54 / 128.0 , -53 / 128.0 , -52 / 128.0 , -51 / 128.0 , -50 / 128.0 , -49 / 128.0
-, -48 / 128.0 , -47 / 128.0 , -46 / 128.0 , -45 / 128.0 , -44 / 128.0 , -43 / 128.0 , -42 / 128.0 , -41 / 128.0 , -40 / 128.0 , -39 / 128.0 , -38 / 128.0 , -37 / 128.0 , -36 / 128.0 , -35 / 128.0 , -34 / 128.0 , -33 / 128.0
-, -32 / 128.0 , -31 / 128.0 , -30 / 128.0 , -29 / 128.0 , -28 / 128.0 , -27 / 128.0 , -26 / 128.0 , -25 / 128.0 , -24 / 128.0 , -23 / 128.0 , -22 / 128.0 , -21 / 128.0 , -20 / 128.0 , -19 / 128.0 , -18 / 128.0 , -17 / 128.0
-, -16 / 128.0 , -15 / 128.0 , -14 / 128.0 , -13 / 128.0 , -12 / 128.0 , -11 / 128.0 , -10 / 128.0 , -9 / 128.0 , -8 / 128.0 , -7 / 128.0 , -6 / 128.0 , -5 / 128.0 , -4 / 128.0 , -3 / 128.0 , -2 / 128.0 , -1 / 128.0
-, 0 / 128.0 , 1 / 128.0 , 2 / 128.0 , 3 / 128.0 , 4 / 128.0 , 5 / 128.0 , 6 / 128.0 , 7 / 128.0 , 8 / 128.0 , 9 / 128.0 , 10 / 128.0 , 11 / 128.0 , 12 / 128.0 , 13 / 128.0 , 14 / 128.0 , 15 / 128.0
-, 16 / 128.0 , 17 / 128.0 , 18 / 128.0 , 19 / 128.0 , 20 / 128.0 , 21 / 128.0 , 22 / 128.0 , 23 / 128.0 , 24 / 128.0 , 25 / 128.0 , 26 / 128.0 , 27 / 128.0 , 28 / 128.0 , 29 / 128.0 , 30 / 128.0 , 31 / 128.0
-, 32 / 128.0 , 33 / 128.0 , 34 / 128.0 , 35 / 128.0 , 36 / 128.0 , 37 / 128.0 , 38 / 128.0 , 39 / 128.0 , 40 / 128.0 , 41 / 128.0 , 42 / 128.0 , 43 / 128.0 , 44 / 128.0 , 45 / 128.0 , 46 / 128.0 , 47 / 128.0
-, 48 / 128.0 , 49 / 128.0 , 50 / 128.0 , 51 / 128.0 , 52 / 128.0 , 53 / 128.0 , 54 / 128.0 , 55 / 128.0 , 56 / 128.0 , 57 / 128.0 , 58 / 128.0 , 59 / 128.0 , 60 / 128.0 , 61 / 128.0 , 62 / 128.0 , 63 / 128.0
-, 64 / 128.0 , 65 / 128.0 , 66 / 128.0 , 67 / 128.0 , 68 / 128.0 , 69 / 128.0 , 70 / 128.0 , 71 / 128.0 , 72 / 128.0 , 73 / 128.0 , 74 / 128.0 , 75 / 128.0 , 76 / 128.0 , 77 / 128.0 , 78 / 128.0 , 79 / 128.0
-, 80 / 128.0 , 81 / 128.0 , 82 / 128.0 , 83 / 128.0 , 84 / 128.0 , 85 / 128.0 , 86 / 128.0 , 87 / 128.0 , 88 / 128.0 , 89 / 128.0 , 90 / 128.0 , 91 / 128.0 , 92 / 128.0 , 93 / 128.0 , 94 / 128.0 , 95 / 128.0
-, 96 / 128.0 , 97 / 128.0 , 98 / 128.0 , 99 / 128.0 , 100 / 128.0 , 101 / 128.0 , 102 / 128.0 , 103 / 128.0 , 104 / 128.0 , 105 / 128.0 , 106 / 128.0 , 107 / 128.0 , 108 / 128.0 , 109 / 128.0 , 110 / 128.0 , 111 / 128.0
-, 112 / 128.0 , 113 / 128.0 , 114 / 128.0 , 115 / 128.0 , 116 / 128.0 , 117 / 128.0 , 118 / 128.0 , 119 / 128.0 , 120 / 128.0 , 121 / 128.0 , 122 / 128.0 , 123 / 128.0 , 124 / 128.0 , 125 / 128.0 , 126 / 128.0 , 127 / 128.0 };
-
 //
 //	The brave old getSamples. For the dab stick, we get
 //	size samples: still in I/Q pairs, but we have to convert the data from
 //	uint8_t to std::complex<float>
 
 int32_t	rtlsdrHandler::getSamples (std::complex<float> *V, int32_t size) {
-int32_t	amount, i;
+int32_t	amount;
 uint8_t	*tempBuffer = (uint8_t *)alloca (2 * size * sizeof (uint8_t));
 //
 	amount = _I_Buffer	-> getDataFromBuffer (tempBuffer, 2 * size);
-	for (i = 0; i < amount / 2; i ++) {
-	   V [i] = std::complex<float>
-	                   (convTable [tempBuffer [2 * i]],
-	                    convTable [tempBuffer [2 * i + 1]]);;
-	   dumpBuffer [2 * dumpIndex    ]	= tempBuffer [2 * i];
-	   dumpBuffer [2 * dumpIndex + 1]	= tempBuffer [2 * i + 1];
-	   if (outFile != nullptr) {
-	      if (++ dumpIndex >= DUMP_SIZE / 2) {
+	sampleConverter. convert (tempBuffer, amount / 2, V);
+	if (outFile != nullptr) {
+	   for (int i = 0; i < amount / 2; ) {
+	      int n	= DUMP_SIZE / 2 - dumpIndex;
+	      if (n > amount / 2 - i)
+	         n = amount / 2 - i;
+	      memcpy (&dumpBuffer [2 * dumpIndex], &tempBuffer [2 * i], 2 * n);
+	      i		+= n;
+	      dumpIndex	+= n;
+	      if (dumpIndex >= DUMP_SIZE / 2) {
 	         fwrite (dumpBuffer, 1, DUMP_SIZE, outFile);
 	         dumpIndex = 0;
 	      }
@@ -351,6 +334,27 @@ int32_t	rtlsdrHandler::Samples	(void) {
 	return _I_Buffer	-> GetRingBufferReadAvailable () / 2;
 }
 //
+//	the samples stay uint8_t in the buffer until the sample reader
+//	takes them; while dumping getSamples is used
+const void	*rtlsdrHandler::peekNative	(int32_t *amount) {
+int32_t	n	= 2 * *amount;
+
+	if (outFile != nullptr)
+	   return nullptr;
+	const uint8_t *p	= _I_Buffer -> peek (&n);
+	*amount	= n / 2;
+	return p;
+}
+
+void	rtlsdrHandler::convertNative	(const void *in, int32_t n,
+	                                 std::complex<float> *out) {
+	sampleConverter. convert (in, n, out);
+}
+
+void	rtlsdrHandler::commitSamples	(int32_t amount) {
+	_I_Buffer	-> commit (2 * amount);
+}
+//
 bool	rtlsdrHandler::load_rtlFunctions (void) {
 //
 //	link the required procedures
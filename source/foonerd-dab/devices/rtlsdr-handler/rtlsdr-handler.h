@@ -26,6 +26,7 @@
 #include	<dlfcn.h>
 #include	"ringbuffer.h"
 #include	"device-handler.h"
+#include	"iq-converter.h"
 #include	<thread>
 
 #define	DUMP_SIZE	8192
@@ -91,6 +92,10 @@ public:
 	void		stopReader	();
 	int32_t		getSamples	(std::complex<float> *, int32_t);
 	int32_t		Samples		();
+	const void	*peekNative	(int32_t *);
+	void		convertNative	(const void *, int32_t,
+	                                 std::complex<float> *);
+	void		commitSamples	(int32_t);
 	void		resetBuffer	();
 	int16_t		maxGain		();
 	int16_t		bitDepth	();
@@ -117,6 +122,7 @@ private:
 	FILE		*outFile;
 	int		frequency;
 	char		* deviceOptions;
+	iqConverter	sampleConverter;
 	uint8_t		dumpBuffer [DUMP_SIZE];
 	int		dumpIndex;
 	int		tunerType;	// Detected tuner type for diagnostics
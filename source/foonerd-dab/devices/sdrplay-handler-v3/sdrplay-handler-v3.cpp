@@ -32,7 +32,9 @@
 	                                       uint16_t	deviceIndex,
 	                                       int16_t	antenna,
 	                                       bool	X_dump):
-	                                          _I_Buffer (4 * 1024 * 1024) {
+	                                          _I_Buffer (4 * 1024 * 1024),
+	                                          sampleConverter (IQ_S16_SPLIT,
+	                                                           1.0 / 2048) {
 	this	-> vfoFrequency	= frequency;
 	this	-> ppmCorrection	= ppmCorrection;
 	this	-> GRdB		= GRdB;
@@ -98,7 +100,6 @@ void    StreamACallback (short *xi, short *xq,
                          unsigned int numSamples, unsigned int reset,
                          void *cbContext) {
 sdrplayHandler_v3 *p	= static_cast<sdrplayHandler_v3 *> (cbContext);
-float	denominator	= (float)(p -> denominator);
 std::complex<float> localBuf [numSamples];
 
 	(void)params;
@@ -107,12 +108,12 @@ std::complex<float> localBuf [numSamples];
 	if (!p -> running. load ())
 	   return;
 
-	for (int i = 0; i < (int)numSamples; i ++)
-	   localBuf [i] = std::complex<float> (((float)xi [i]) / denominator,
-	                                         ((float)xq [i]) / denominator);
+	p -> sampleConverter. convert (xi, xq, numSamples, localBuf);
 	int n = (int)(p -> _I_Buffer. GetRingBufferWriteAvailable ());
-	if (n >= (int)numSamples)
+	if (n >= (int)numSamples) {
 	   p -> _I_Buffer. putDataIntoBuffer (localBuf, numSamples);
+	   p -> samplesArrived ();
+	}
 }
 
 static
@@ -302,6 +303,7 @@ int			lna_upperBound = 4;
 	      nrBits		= 14;
 	      break;
 	}
+	sampleConverter. setScale (1 / denominator);
 
 	if (lnaState >= lna_upperBound)
 	   this -> lnaState	= lna_upperBound;
@@ -30,6 +30,7 @@
 #include	"dab-constants.h"
 #include	"ringbuffer.h"
 #include	"device-handler.h"
+#include	"iq-converter.h"
 #include	<sdrplay_api.h>
 
 
@@ -55,6 +56,7 @@ public:
 //	the callback functions refer to them
         RingBuffer<std::complex<float>> _I_Buffer;
         float   denominator;
+        iqConverter     sampleConverter;
         void    update_PowerOverload (sdrplay_api_EventParamsT *params);
         std::atomic<bool>       running;
 private:
@@ -31,7 +31,9 @@
 	                                 bool		autoGain,
 	                                 uint16_t	deviceIndex,
 	                                 int16_t	antenna,
-	                                 bool		X_dump) {
+	                                 bool		X_dump):
+	                                    sampleConverter (IQ_S16_SPLIT,
+	                                                     1.0 / 2048) {
 int	err;
 float	ver;
 mir_sdr_DeviceT devDesc [4];
@@ -100,6 +102,7 @@ int	maxlna;
 	   denominator	= 2048.0;
 	   maxlna	= 9;
 	}
+	sampleConverter. setScale (1 / denominator);
 
 	if (lnaState < 0)
 	   lnaState = 0;
@@ -140,17 +143,14 @@ void myStreamCallback (int16_t		*xi,
 	               uint32_t		reset,
 	               uint32_t		hwRemoved,
 	               void		*cbContext) {
-int16_t	i;
 sdrplayHandler	*p	= static_cast<sdrplayHandler *> (cbContext);
 std::complex<float> localBuf [numSamples];
-float	denominator		= p -> denominator;
 
 	if (reset || hwRemoved)
 	   return;
-	for (i = 0; i <  (int)numSamples; i ++)
-	   localBuf [i] = std::complex<float> (float (xi [i]) / denominator,
-	                                       float (xq [i]) / denominator);
+	p -> sampleConverter. convert (xi, xq, numSamples, localBuf);
 	p -> _I_Buffer -> putDataIntoBuffer (localBuf, numSamples);
+	p -> samplesArrived ();
 	(void)	firstSampleNum;
 	(void)	grChanged;
 	(void)	rfChanged;
@@ -27,6 +27,7 @@
 #include	<atomic>
 #include	"ringbuffer.h"
 #include	"device-handler.h"
+#include	"iq-converter.h"
 #include	"mirsdrapi-rsp.h"
 
 typedef void (*mir_sdr_StreamCallback_t)(int16_t	*xi,
@@ -68,6 +69,7 @@ public:
 //	within the callback
 	RingBuffer<std::complex<float>>	*_I_Buffer;
 	float		denominator;
+	iqConverter	sampleConverter;
 private:
 
 	int16_t		hwVersion;
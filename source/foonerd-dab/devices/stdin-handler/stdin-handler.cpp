@@ -43,8 +43,9 @@ struct timeval  tv;
 #define	__BUFFERSIZE	16 * 32768
 //
 //
-	stdinHandler::stdinHandler (void) {
-	_I_Buffer	= new RingBuffer<std::complex<float>>(__BUFFERSIZE);
+	stdinHandler::stdinHandler (void):
+	                        sampleConverter (IQ_U8, 1.0 / 128) {
+	_I_Buffer	= new RingBuffer<uint8_t>(2 * __BUFFERSIZE);
 
 	filePointer	= stdin;
 	if (filePointer == NULL) {
@@ -52,12 +53,14 @@ struct timeval  tv;
 	   delete _I_Buffer;
 	   throw OpeningFileFailed("stdin","idk shouldn't fail");
 	}
+	period		= 2000;		// usec, for the 4096 samples of a read
 	running. store (false);
 }
 
 	stdinHandler::~stdinHandler (void) {
 	if (running. load ()) {
 	   running. store (false);
+	   wakeUp ();
 	   workerHandle. join ();
 	}
 	fclose (filePointer);
@@ -80,55 +83,78 @@ void	stdinHandler::stopReader	(void) {
 
 int32_t	stdinHandler::getSamples	(std::complex<float> *V, int32_t size) {
 int32_t	amount;
+uint8_t	tempBuffer [2 * size];
 
 	if (filePointer == NULL)
 	   return 0;
 
-	while ((_I_Buffer -> GetRingBufferReadAvailable ()) < size)
-	   usleep (100);
+	while (waitForSamples (size, 100) < size)
+	   if (!running. load ())
+	      return 0;
 
-	amount	= _I_Buffer -> getDataFromBuffer (V, size);
+	amount	= _I_Buffer -> getDataFromBuffer (tempBuffer, 2 * size) / 2;
+	roomAvailable ();
+	sampleConverter. convert (tempBuffer, amount, V);
 	return amount;
 }
 
 int32_t	stdinHandler::Samples (void) {
-	return _I_Buffer -> GetRingBufferReadAvailable ();
+	return _I_Buffer -> GetRingBufferReadAvailable () / 2;
+}
+//
+//	the buffer keeps the uint8_t samples as read, they are
+//	converted when taken
+const void	*stdinHandler::peekNative	(int32_t *amount) {
+int32_t	n	= 2 * *amount;
+const uint8_t *p	= _I_Buffer -> peek (&n);
+
+	*amount	= n / 2;
+	return p;
+}
+
+void	stdinHandler::convertNative	(const void *in, int32_t n,
+	                                 std::complex<float> *out) {
+	sampleConverter. convert (in, n, out);
+}
+
+void	stdinHandler::commitSamples	(int32_t amount) {
+	_I_Buffer -> commit (2 * amount);
+	roomAvailable ();
 }
 //
 //	The actual interface to the filereader is in a separate thread
 //	we read in fragments of 2 msec
 void	stdinHandler::run (void) {
-int32_t	t, i;
-std::complex<float>	*bi;
-uint8_t	*b2;
+int32_t	t;
 int32_t	bufferSize	= 2048 * 2;
 int64_t	nextStop;
 
 	running. store (true);
-	bi		= new std::complex<float> [bufferSize];
-	b2		= new uint8_t [bufferSize * 2];
 	nextStop	= getMyTime ();
 	while (running. load ()) {
-	   while (_I_Buffer -> WriteSpace () < bufferSize + 10) {
-	      if (!running. load ())
-	         break;
-	      usleep (100);
-	   }
+	   while (running. load () &&
+	          !waitForRoom ([&] () {
+	               return _I_Buffer -> WriteSpace () >= 2 * bufferSize + 10;
+	          }, 100))
+	      ;
 
 	   nextStop += period;
-	   t = fread (b2, 1, 2 * bufferSize, filePointer);
-	   for (i = 0; i < bufferSize; i ++) {
-	      bi [i] = std::complex <float> (
-	                            (b2 [2 * i    ] - 128) / 128.0,
-	                            (b2 [2 * i + 1] - 128) / 128.0);
+//	the bytes are read in place, into the ring buffer, in (at most)
+//	two parts when the buffer is not mirrored
+	   int32_t done	= 0;
+	   while (done < 2 * bufferSize) {
+	      int32_t amount	= 2 * bufferSize - done;
+	      uint8_t *p	= _I_Buffer -> reserve (&amount);
+	      t = fread (p, 1, amount, filePointer);
+	      _I_Buffer -> publish (t);
+	      done	+= t;
+	      if (t < amount)
+	         break;
 	   }
-
-	   _I_Buffer -> putDataIntoBuffer (bi, t);
+	   samplesArrived ();
 	   if (nextStop - getMyTime () > 0)
 	      usleep (nextStop - getMyTime ());
 	}
 
-	delete [] b2;
-	delete [] bi;
 	DEBUG_PRINT ("taak voor replay eindigt hier\n");
 }
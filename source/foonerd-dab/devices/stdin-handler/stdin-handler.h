@@ -24,6 +24,7 @@
 
 #include        "ringbuffer.h"
 #include        "device-handler.h"
+#include        "iq-converter.h"
 #include        <thread>
 #include        <atomic>
 /*
@@ -34,13 +35,18 @@ public:
 	       		~stdinHandler	(void);
 	int32_t		getSamples	(std::complex<float> *, int32_t);
 	int32_t		Samples		(void);
+	const void	*peekNative	(int32_t *);
+	void		convertNative	(const void *, int32_t,
+	                                 std::complex<float> *);
+	void		commitSamples	(int32_t);
 	bool		restartReader	(int32_t frequency);
 	void		stopReader	(void);
 private:
 virtual	void		run		(void);
 	FILE		*filePointer;
 	int		period;
-	RingBuffer<std::complex<float>>	*_I_Buffer;
+	RingBuffer<uint8_t>	*_I_Buffer;
+	iqConverter	sampleConverter;
 	std::thread	workerHandle;
 	std::atomic<bool> running;
 };
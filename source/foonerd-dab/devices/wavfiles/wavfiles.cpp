@@ -119,6 +119,7 @@ bool	wavFiles::restartReader	(int32_t frequency) {
 void	wavFiles::stopReader	(void) {
 	if (running. load ()) {
 	   running. store (false);
+	   wakeUp ();
            workerHandle. join ();
 	}
 	running. store (false);
@@ -132,16 +133,32 @@ int32_t	amount;
 	if (!running. load ())
 	   return 0;
 
-	while (_I_Buffer -> GetRingBufferReadAvailable () < (uint32_t)size)
-	   usleep (100);
+	while (waitForSamples (size, 100) < size)
+	   if (!running. load ())
+	      return 0;
 
 	amount = _I_Buffer	-> getDataFromBuffer (V, size);
+	roomAvailable ();
 	return amount;
 }
 
 int32_t	wavFiles::Samples (void) {
 	return _I_Buffer -> GetRingBufferReadAvailable ();
 }
+
+const std::complex<float> *wavFiles::peekSamples	(int32_t *amount) {
+	return _I_Buffer -> peek (amount);
+}
+
+void	wavFiles::commitSamples	(int32_t amount) {
+	_I_Buffer -> commit (amount);
+	roomAvailable ();
+}
+
+bool	wavFiles::setUnthrottled	(bool b) {
+	unthrottled. store (b);
+	return true;
+}
 //
 //	The actual interface to the filereader is in a separate thread
 
@@ -159,11 +176,11 @@ bool	eofReached	= false;
 	bi		= new std::complex<float> [bufferSize];
 	nextStop	= getMyTime ();
 	while (running. load ()) {
-	   while (_I_Buffer -> WriteSpace () < bufferSize) {
-	      if (!running. load ())
-	         break;
-	      usleep (100);
-	   }
+	   while (running. load () &&
+	          !waitForRoom ([&] () {
+	               return _I_Buffer -> WriteSpace () >= bufferSize;
+	          }, 100))
+	      ;
 
 	   nextStop += period;
 	   t = readBuffer (bi, bufferSize);
@@ -174,6 +191,7 @@ bool	eofReached	= false;
 	      t = bufferSize;
 	   }
 	   _I_Buffer -> putDataIntoBuffer (bi, bufferSize);
+	   samplesArrived ();
 	   if (eofReached && this -> repeater) {
 	      sf_seek (filePointer, (sf_count_t)0, SEEK_SET);
 	      eofReached = false;
@@ -186,6 +204,8 @@ bool	eofReached	= false;
 	   else
 	   if (eofReached)
 	      break;
+	   if (unthrottled. load ())
+	      continue;
 	   if (nextStop - getMyTime () > 0)
 	      usleep (nextStop - getMyTime ());
 	}
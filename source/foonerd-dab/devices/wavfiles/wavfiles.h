@@ -40,6 +40,9 @@ public:
 	int32_t		getSamples	(std::complex<float> *, int32_t);
 	uint8_t		myIdentity	(void);
 	int32_t		Samples		(void);
+	const std::complex<float> *peekSamples	(int32_t *);
+	void		commitSamples	(int32_t);
+	bool		setUnthrottled	(bool);
 	bool		restartReader	(int32_t);
 	void		stopReader	();
 	
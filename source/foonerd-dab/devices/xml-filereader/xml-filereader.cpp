@@ -35,8 +35,12 @@
 //
 //
 	xml_fileReader::xml_fileReader (std::string fileName,
-	                                bool	continue_on_eof) {
+	                                bool	continue_on_eof,
+	                                device_eof_callback_t eofHandler,
+	                                void	*userData) {
 	this -> fileName	= fileName;
+	this -> eofHandler	= eofHandler;
+	this -> userData	= userData;
 	_I_Buffer	= new RingBuffer<std::complex<float>>(INPUT_FRAMEBUFFERSIZE);
 	theFile	= fopen (fileName.c_str (), "rb");
 	if (theFile == nullptr) {
@@ -79,7 +83,11 @@ bool	xml_fileReader::restartReader (int32_t freq) {
 	                                  theDescriptor,
 	                                  5000,
 	                                  _I_Buffer,
-	                                  continue_on_eof);
+	                                  continue_on_eof,
+	                                  this,
+	                                  eofHandler,
+	                                  userData);
+	theReader	-> setUnthrottled (unthrottled. load ());
 	return true;
 }
 
@@ -96,10 +104,13 @@ int32_t	xml_fileReader::getSamples	(std::complex<float> *V,
 	if (theFile == nullptr)		// should not happen
 	   return 0;
 
-	while ((int32_t)(_I_Buffer -> GetRingBufferReadAvailable()) < size)
-	   usleep (1000);
+	while (waitForSamples (size, 100) < size)
+	   if (theReader == nullptr)
+	      return 0;
 
-	return _I_Buffer	-> getDataFromBuffer (V, size);
+	int32_t amount	= _I_Buffer	-> getDataFromBuffer (V, size);
+	roomAvailable ();
+	return amount;
 }
 
 int32_t	xml_fileReader::Samples	() {
@@ -107,3 +118,19 @@ int32_t	xml_fileReader::Samples	() {
 	   return 0;
 	return _I_Buffer -> GetRingBufferReadAvailable();
 }
+
+const std::complex<float> *xml_fileReader::peekSamples	(int32_t *amount) {
+	return _I_Buffer -> peek (amount);
+}
+
+void	xml_fileReader::commitSamples	(int32_t amount) {
+	_I_Buffer -> commit (amount);
+	roomAvailable ();
+}
+
+bool	xml_fileReader::setUnthrottled	(bool b) {
+	unthrottled. store (b);
+	if (theReader != nullptr)
+	   theReader -> setUnthrottled (b);
+	return true;
+}
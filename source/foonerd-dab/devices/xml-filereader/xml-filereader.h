@@ -31,15 +31,23 @@
 
 class	xmlDescriptor;
 class	xml_Reader;
+
+typedef void (*device_eof_callback_t)(void * userData);
 /*
  */
 class	xml_fileReader: public deviceHandler {
 public:
-				xml_fileReader	(std::string, bool);
+				xml_fileReader	(std::string, bool,
+	                                 device_eof_callback_t eofHandler =
+	                                                          nullptr,
+	                                 void *userData = nullptr);
                 		~xml_fileReader	();
 	int32_t			getSamples	(std::complex<float> *,
 	                                                         int32_t);
 	int32_t			Samples		();
+	const std::complex<float> *peekSamples	(int32_t *);
+	void			commitSamples	(int32_t);
+	bool			setUnthrottled	(bool);
 	bool			restartReader	(int32_t);
 	void			stopReader	(void);
 private:
@@ -51,6 +59,8 @@ private:
 	uint64_t		filePointer;
 	xmlDescriptor		*theDescriptor;
 	xml_Reader		*theReader;
+	device_eof_callback_t	eofHandler;
+	void			*userData;
 };
 
 
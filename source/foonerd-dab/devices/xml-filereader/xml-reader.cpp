@@ -34,9 +34,27 @@ int r	= 1;
 	return r;
 }
 
-static inline
-std::complex<float> compmul (std::complex<float> a, float b) {
-	return std::complex<float> (real (a) * b, imag (a) * b);
+//
+//	the containers with 8 and 16 bit elements are converted by
+//	an iqConverter, the format is looked up once (-1 for the others)
+static
+int	elementFormat	(xmlDescriptor *fd) {
+	if (fd -> container == "int8")
+	   return IQ_S8;
+	if (fd -> container == "uint8")
+	   return IQ_U8;
+	if (fd -> container == "int16")
+	   return fd -> byteOrder == "MSB" ? IQ_S16_BE : IQ_S16;
+	return -1;
+}
+
+static
+float	elementScale	(xmlDescriptor *fd) {
+	if (fd -> container == "int8")
+	   return 1.0 / 127;
+	if (fd -> container == "uint8")
+	   return 1.0 / 128;
+	return 1.0 / shift (fd -> bitsperChannel);
 }
 
 static inline
@@ -52,26 +70,30 @@ struct timeval tv;
 	                        xmlDescriptor	*fd,
 	                        uint64_t	filePointer,
 	                        RingBuffer<std::complex<float>> *b,
-	                        bool	continue_on_eof) {
+	                        bool	continue_on_eof,
+	                        deviceHandler	*owner,
+	                        void	(*eofHandler)(void *),
+	                        void	*userData):
+	                           theConverter (fd -> sampleRate, 2048000),
+	                           sampleConverter (elementFormat (fd) < 0 ?
+	                                               IQ_U8 : elementFormat (fd),
+	                                            elementScale (fd)) {
 	this	-> file		= f;
 	this	-> fd		= fd;
 	this	-> filePointer	= filePointer;
 	sampleBuffer		= b;
+	this	-> owner	= owner;
+	this	-> eofHandler	= eofHandler;
+	this	-> userData	= userData;
+	unthrottled. store (false);
 	this	-> continue_on_eof	= continue_on_eof;
 //
-//	convBufferSize is a little confusing since the actual 
-//	buffer is one larger
+//	the samples are read per msec, and converted to 2048000
 	convBufferSize		= fd -> sampleRate / 1000;
-
-	for (int i = 0; i < 2048; i ++) {
-	   float inVal = float (fd -> sampleRate / 1000);
-	   mapTable_int [i] = (int)(floor (i * (inVal / 2048.0)));
-	   mapTable_float [i] = i * (inVal / 2048.0) - mapTable_int [i];
-	}
-
-	convIndex	= 0;
-	convBuffer. resize (convBufferSize + 1);
+	convBuffer. resize (convBufferSize);
+	outBuffer. resize (theConverter. outSize (convBufferSize));
 	nrElements	= fd -> blockList [0]. nrElements;
+	directFormat	= elementFormat (fd) >= 0;
 
 	running. store (false);
 	threadHandle	= std::thread (&xml_Reader::run, this);
@@ -80,6 +102,8 @@ struct timeval tv;
 	xml_Reader::~xml_Reader () {
 	if (running. load ()) {
 	   running. store (false);
+	   if (owner != nullptr)
+	      owner -> wakeUp ();
 	   threadHandle. join ();
 	}
 }
@@ -87,10 +111,16 @@ struct timeval tv;
 void	xml_Reader::stopReader	() {
 	if (running. load ()) {
 	   running. store (false);
+	   if (owner != nullptr)
+	      owner -> wakeUp ();
 	   threadHandle. join ();
 	}
 }
 
+void	xml_Reader::setUnthrottled	(bool b) {
+	unthrottled. store (b);
+}
+
 static	int cycleCount = 0;
 void	xml_Reader::run () {
 uint64_t	samplesRead	= 0;
@@ -106,6 +136,15 @@ int	startPoint	= filePointer;
 	   samplesRead		= 0;
 	   do {
 	      while ((samplesRead <= samplesToRead) && running. load ()) {
+//	readSamples puts (about) 2048 samples in the buffer, when running
+//	unthrottled the buffer has to provide the back pressure
+	         if (unthrottled. load () && (owner != nullptr)) {
+	            while (running. load () &&
+	                   !owner -> waitForRoom ([&] () {
+	                       return sampleBuffer -> WriteSpace () >= 2048;
+	                   }, 100))
+	               ;
+	         }
 
 	         if (fd -> iqOrder == "IQ") 
 	            samplesRead += readSamples (file,
@@ -127,6 +166,8 @@ int	startPoint	= filePointer;
 //	we assume taking this data does not take time
 //	         nextStop = nextStop + ((uint64_t)blockSize * 1000) / 2048;
 	         nextStop = nextStop + (uint64_t)1000;
+	         if (unthrottled. load ())
+	            continue;
 	         if (nextStop > currentTime ())
 	            usleep ( nextStop - currentTime ());
 	      }
@@ -135,6 +176,8 @@ int	startPoint	= filePointer;
 	      samplesRead		= 0;
 	   } while (running.load () && continue_on_eof);
 	}
+	if (running. load () && (eofHandler != nullptr))
+	   eofHandler (userData);
 }
 
 uint64_t	xml_Reader::compute_nrSamples (FILE *f, int blockNumber) {
@@ -157,22 +200,18 @@ uint64_t	samplesToRead	= 0;
 	return samplesToRead;
 }
 
+//
+//	reads 1 msec of samples, returns the number of samples read
 uint64_t	xml_Reader::readSamples (FILE *theFile, 
 	                         void(xml_Reader::*r)(FILE *theFile,
 	                                    std::complex<float> *, int)) {
-std::complex<float> temp [2048];
-
-	(*this.*r) (theFile, &convBuffer [1], convBufferSize);
-	for (int i = 0; i < 2048; i ++) {
-	   int16_t inpBase	= mapTable_int [i];
-	   float   inpRatio	= mapTable_float [i];
-	   temp [i] = compmul (convBuffer [inpBase + 1], inpRatio) +
-	                       compmul (convBuffer [inpBase], 1 - inpRatio);
-	}
-	convBuffer [0] = convBuffer [convBufferSize];
-	convIndex = 1;
-	sampleBuffer -> putDataIntoBuffer (temp, 2048);
-	return 2048;
+	(*this.*r) (theFile, convBuffer. data (), convBufferSize);
+	int n	= theConverter. convert (convBuffer. data (), convBufferSize,
+	                                 outBuffer. data ());
+	sampleBuffer -> putDataIntoBuffer (outBuffer. data (), n);
+	if (owner != nullptr)
+	   owner -> samplesArrived ();
+	return convBufferSize;
 }
 	
 static 
@@ -203,43 +242,10 @@ void	xml_Reader::readElements_IQ (FILE *theFile,
 int	nrBits	= fd -> bitsperChannel;
 float	scaler	= float (shift (nrBits));
 
-	if (fd -> container == "int8") {
-	   uint8_t lbuf [2 * amount];
-	   fread (lbuf, 1, 2 * amount, theFile);
-	   for (int i = 0; i < amount; i ++)
-	      buffer [i] = std::complex<float> (((int8_t)lbuf [2 * i]) / 127.0,
-	                                        ((int8_t)lbuf [2 * i + 1]) / 127.0);
-	   return;
-	}
-	
-	if (fd -> container == "uint8") {
-	   uint8_t lbuf [2 * amount];
-	   fread (lbuf, 1, 2 * amount, theFile);
-	   for (int i = 0; i < amount; i ++)
-	      buffer [i] = std::complex<float> (mapTable [lbuf [2 * i]],
-	                                        mapTable [lbuf [2 * i + 1]]);
-	   return;
-	}
-
-	if (fd -> container == "int16") {
-	   uint8_t lbuf [4 * amount];
-	   fread (lbuf, 2, 2 * amount, theFile);
-	   if (fd -> byteOrder == "MSB") {
-	      for (int i = 0; i < amount; i ++) {
-	         int16_t temp_16_1 = (lbuf [4 * i] << 8) | lbuf [4 * i + 1];
-	         int16_t temp_16_2 = (lbuf [4 * i + 2] << 8) | lbuf [4 * i + 3];
-	         buffer [i] = std::complex<float> ((float)temp_16_1 / scaler,
-	                                           (float)temp_16_2 / scaler);
-	      }
-	   }
-	   else {
-	      for (int i = 0; i < amount; i ++) {
-	         int16_t temp_16_1 = (lbuf [4 * i + 1] << 8) | lbuf [4 * i];
-	         int16_t temp_16_2 = (lbuf [4 * i + 3] << 8) | lbuf [4 * i + 2];
-	         buffer [i] = std::complex<float> ((float)temp_16_1 / scaler,
-	                                           (float)temp_16_2 / scaler);
-	      }
-	   }
+	if (directFormat) {
+	   uint8_t lbuf [amount * sampleConverter. bytesPerSample ()];
+	   fread (lbuf, sampleConverter. bytesPerSample (), amount, theFile);
+	   sampleConverter. convert (lbuf, amount, buffer);
 	   return;
 	}
 
@@ -347,43 +353,13 @@ void	xml_Reader::readElements_QI (FILE *theFile,
 int	nrBits	= fd -> bitsperChannel;
 float	scaler	= float (shift (nrBits));
 
-	if (fd -> container == "int8") {
-	   uint8_t lbuf [2 * amount];
-	   fread (lbuf, 1, 2 * amount, theFile);
-	   for (int i = 0; i < amount; i ++)
-	      buffer [i] = std::complex<float> (((int8_t)lbuf [2 * i + 1]) / 127.0,
-	                                        ((int8_t)lbuf [2 * i]) / 127.0);
-	   return;
-	}
-	
-	if (fd -> container == "uint8") {
-	   uint8_t lbuf [2 * amount];
-	   fread (lbuf, 1, 2 * amount, theFile);
+	if (directFormat) {
+	   uint8_t lbuf [amount * sampleConverter. bytesPerSample ()];
+	   fread (lbuf, sampleConverter. bytesPerSample (), amount, theFile);
+	   sampleConverter. convert (lbuf, amount, buffer);
 	   for (int i = 0; i < amount; i ++)
-	      buffer [i] = std::complex<float> (mapTable [2 * i + 1],
-	                                        mapTable [2 * i]);
-	   return;
-	}
-
-	if (fd -> container == "int16") {
-	   uint8_t lbuf [4 * amount];
-	   fread (lbuf, 2, 2 * amount, theFile);
-	   if (fd -> byteOrder == "MSB") {
-	      for (int i = 0; i < amount; i ++) {
-	         int16_t temp_16_1 = (lbuf [4 * i] << 8) | lbuf [4 * i + 1];
-	         int16_t temp_16_2 = (lbuf [4 * i + 2] << 8) | lbuf [4 * i + 3];
-	         buffer [i] = std::complex<float> ((float)temp_16_2 / scaler,
-	                                           (float)temp_16_1 / scaler);
-	      }
-	   }
-	   else {
-	      for (int i = 0; i < amount; i ++) {
-	         int16_t temp_16_1 = (lbuf [4 * i + 1] << 8) | lbuf [4 * i];
-	         int16_t temp_16_2 = (lbuf [4 * i + 3] << 8) | lbuf [4 * i + 2];
-	         buffer [i] = std::complex<float> ((float)temp_16_2 / scaler,
-	                                           (float)temp_16_1 / scaler);
-	      }
-	   }
+	      buffer [i] = std::complex<float> (imag (buffer [i]),
+	                                        real (buffer [i]));
 	   return;
 	}
 
@@ -29,8 +29,11 @@
 #include	<complex>
 #include	<vector>
 #include	<atomic>
+#include	"rate-converter.h"
+#include	"iq-converter.h"
 
 class	xml_fileReader;
+class	deviceHandler;
 class	xmlDescriptor;
 
 class	xml_Reader {
@@ -39,15 +42,23 @@ public:
 	                            xmlDescriptor	*fd,
 	                            uint64_t		filePointer,
 	                            RingBuffer<std::complex<float>> *b,
-	                            bool		continue_on_eof);
+	                            bool		continue_on_eof,
+	                            deviceHandler	*owner = nullptr,
+	                            void (*eofHandler)(void *) = nullptr,
+	                            void		*userData = nullptr);
 			~xml_Reader	();
 	void		stopReader	();
+	void		setUnthrottled	(bool);
 private:
 	bool		continue_on_eof;
 	FILE		*file;
 	xmlDescriptor	*fd;
 	uint64_t	filePointer;
 	RingBuffer<std::complex<float>> *sampleBuffer;
+	deviceHandler	*owner;
+	void		(*eofHandler)(void *);
+	void		*userData;
+	std::atomic<bool> unthrottled;
 	uint64_t	nrElements;
 	uint64_t	samplesToRead;
 	std::atomic<bool> running;
@@ -67,10 +78,12 @@ private:
 	                                         std::complex<float> *, int amount);
 //
 //	for the conversion - if any
-	int16_t         convBufferSize;
-        int16_t         convIndex;
-        std::vector <std::complex<float> >   convBuffer;
-        int16_t         mapTable_int   [2048];
-        float           mapTable_float [2048];
+	int32_t		convBufferSize;
+	std::vector <std::complex<float> >   convBuffer;
+	std::vector <std::complex<float> >   outBuffer;
+	rateConverter	theConverter;
+//	for the int8, uint8 and int16 containers
+	iqConverter	sampleConverter;
+	bool		directFormat;
 };
 
@@ -24,6 +24,8 @@
 #include	"dab-api.h"
 #include	"ringbuffer.h"
 #include	"dab-processor.h"
+#include	"fft-handler.h"
+#include	"stage-timer.h"
 
 void	*dabInit   (deviceHandler       *theDevice,
 	            API_struct		*theParameters,
@@ -46,6 +48,35 @@ void	dabStartProcessing (void *Handle) {
 	((dabProcessor *)Handle) -> start ();
 }
 
+void	dabSetPipeline	(void *Handle, int nrWorkers) {
+	((dabProcessor *)Handle) -> set_pipeline (nrWorkers);
+}
+
+void	dabSetBatchFFT	(void *Handle, bool b) {
+	((dabProcessor *)Handle) -> set_batchFFT (b);
+}
+
+void	dabFFTPlanning	(const char *wisdomFile, int effort) {
+	fft_handler::setPlanning (wisdomFile == nullptr ? "" :
+	                                std::string (wisdomFile), effort);
+}
+
+bool	dabGetPipelineStats	(void *Handle, pipelineStats *st) {
+	return ((dabProcessor *)Handle) -> get_pipelineStats (st);
+}
+
+void	dabGetProcessingStats	(void *Handle, processingStats *st) {
+	((dabProcessor *)Handle) -> get_processingStats (st);
+}
+
+void	dabStageTimings		(bool b) {
+	stageTimingSwitch (b);
+}
+
+void	dabGetStageTimings	(stageTimings *st) {
+	stageTimingGet (st);
+}
+
 void	dabReset	(void *Handle) {
 	((dabProcessor *)Handle) -> reset ();
 }
@@ -86,6 +117,16 @@ void    set_dataChannel         (void *Handle, packetdata &pd) {
 	((dabProcessor *)Handle) -> set_dataChannel (pd);
 }
 
+int	dabDecodeEnsemble	(void *Handle, int nrWorkers,
+	                         serviceContext_t serviceContext) {
+	return ((dabProcessor *)Handle) -> decodeEnsemble (nrWorkers,
+	                                                   serviceContext);
+}
+
+int	dabGetServiceStats	(void *Handle, serviceStats *st, int max) {
+	return ((dabProcessor *)Handle) -> get_serviceStats (st, max);
+}
+
 int32_t dab_getSId      (void *Handle, const std::string &c_s) {
 	return ((dabProcessor *)Handle) -> get_SId (c_s);
 }
@@ -99,6 +140,10 @@ std::string	get_ensembleName	(void *Handle) {
 	return ((dabProcessor *)Handle) -> get_ensembleName	();
 }
 
+std::shared_ptr<const ensembleSnapshot> dabGetEnsemble	(void *Handle) {
+	return ((dabProcessor *)Handle) -> get_ensemble ();
+}
+
 #ifdef _MSC_VER
 #include <windows.h>
 extern "C" {
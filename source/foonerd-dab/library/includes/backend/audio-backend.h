@@ -32,6 +32,9 @@
 #include	"virtual-backend.h"
 #include	"ringbuffer.h"
 #include	"dab-semaphore.h"
+#include	"energy-dispersal.h"
+#include	"time-deinterleaver.h"
+#include	"cif-pool.h"
 
 class	backendBase;
 class	protection;
@@ -39,34 +42,34 @@ class	audioSink;
 
 class	audioBackend:public virtualBackend {
 public:
-	audioBackend	(audiodata *, API_struct *, void	*);
+	audioBackend	(audiodata *, API_struct *, void	*,
+	                 servicePool *pool = nullptr);
 	~audioBackend	(void);
-int32_t	process		(int16_t *, int16_t);
+int32_t	process		(cifBuffer *);
 void	stopRunning	(void);
 void	start		(void);
 private:
 	void		run		(void);
-	void		processSegment	(int16_t *);
+	void		processSegment	(cifBuffer *);
+	bool		processNext	();
 
 	std::atomic<bool>	running;
 	std::thread	threadHandle;
 	uint8_t		dabModus;
-	int16_t		fragmentSize;
+	int32_t		fragmentSize;
 	int16_t		bitRate;
 	bool		shortForm;
 	int16_t		protLevel;
 	std::vector<uint8_t> outV;
-	std::vector<uint8_t> disperseVector;
-	int16_t		**interleaveData;
-	int16_t		interleaverIndex;
-	int16_t		countforInterleaver;
+	energyDispersal	dispersal;
+	timeDeinterleaver	deinterleaver;
 	std::vector<int16_t> tempX;
 
 	Semaphore	freeSlots;
 	Semaphore	usedSlots;
 	int16_t		nextIn;
 	int16_t		nextOut;
-	int16_t		*theData [20];
+	cifBuffer	*theData [20];
 
 	protection	*protectionHandler;
 	backendBase	*our_backendBase;
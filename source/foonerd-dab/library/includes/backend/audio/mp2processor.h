@@ -40,6 +40,25 @@
 #define KJMP2_MAX_FRAME_SIZE    1440  // the maximum size of a frame
 #define KJMP2_SAMPLES_PER_FRAME 1152  // the number of samples per frame
 
+//	the synthesis filter kernels. The reference kernel is the
+//	original kjmp2 code (direct 64 x 32 matrixing and a bit by bit
+//	header search), the others use the symmetries of the matrix
+//	and produce the same samples
+#define	MP2_AUTO	0
+#define	MP2_REFERENCE	1
+#define	MP2_SCALAR	2
+#define	MP2_SSE41	3
+#define	MP2_AVX2	4
+#define	MP2_NEON	5
+
+//	matrix: the 32 independent rows of the matrix, in 4 groups of
+//	8 rows and 16 columns; samples: the 32 subband samples;
+//	V: the synthesis buffer of the channel; offset: the current
+//	offset in V; out: the 32 output samples
+typedef void (*mp2Synthesis_t)(const int32_t *matrix,
+	                       const int32_t *samples,
+	                       int16_t *V, int32_t offset, int16_t *out);
+
 // quantizer specification structure
 struct quantizer_spec {
 	int32_t nlevels;
@@ -53,7 +72,9 @@ public:
 	                                 API_struct *,
 	                                 void	*);
 			~mp2Processor	(void);
-	void		addtoFrame	(uint8_t *);
+	void		addtoFramePacked	(uint8_t *);
+	bool		setKernel		(int);
+	const char	*kernelName		();
 	
 private:
 	audioOut_t	soundOut;
@@ -78,16 +99,24 @@ private:
 	int32_t		scalefactor[2][32][3];
 	int32_t		sample[2][32][3];
 	int32_t		U[512];
+	int32_t		matrix [4][16][8];
+	mp2Synthesis_t	synthesisKernel;
+	int		kernelType;
+	void		synthesisReference	(int, int, int32_t, int16_t *);
+	void		huntHeader		(uint8_t *, int16_t &, int16_t);
+	void		huntHeaderBits		(uint8_t *, int16_t &, int16_t);
 
 	int32_t		bit_window;
 	int32_t		bits_in_window;
 	uint8_t		*frame_pos;
+	uint8_t		*frame_end;
 	uint8_t		*MP2frame;
 	int16_t		MP2framesize;
 	int16_t		MP2Header_OK;
 	int16_t		MP2headerCount;
 	int16_t		MP2bitCount;
 	void		addbittoMP2	(uint8_t *, uint8_t, int16_t);
+	void		addbitstoMP2	(uint8_t *, int32_t, int16_t);
 	int16_t		numberofFrames;
 	int16_t		errorFrames;
 };
@@ -44,7 +44,7 @@ public:
 	                                 API_struct *,
 	                                 void	*);
 			~mp4Processor	(void);
-	void		addtoFrame	(uint8_t *);
+	void		addtoFramePacked	(uint8_t *);
 private:
 	bool		processSuperframe (uint8_t [], int16_t);
 	audioOut_t	soundOut;
@@ -64,6 +64,7 @@ private:
 	int16_t		blocksInBuffer;
 	int16_t		bitRate;
 	std::vector<uint8_t> frameBytes;
+	std::vector<uint8_t> rsIn;
 	std::vector<uint8_t> outVector;
 	int16_t		RSDims;
 	int16_t		au_start	[10];
@@ -25,15 +25,23 @@
 
 #include	<stdint.h>
 #include	<stdio.h>
+#include	<vector>
 
 //
 //	virtual class, just for providing a common base
-//	for the real decoder classes
+//	for the real decoder classes.
+//	The decoders get the (24 * bitRate) bits of a logical frame
+//	packed, 8 bits per byte, MSB first, through addtoFramePacked.
+//	addtoFrame, with one bit per byte, is kept for compatibility,
+//	it packs the bits and passes them on to addtoFramePacked
 
 class	backendBase {
 public:
-		backendBase	();
+		backendBase	(int32_t frameBits = 0);
 virtual		~backendBase	();
 virtual	void	addtoFrame	(uint8_t *);
+virtual	void	addtoFramePacked	(uint8_t *);
+private:
+	std::vector<uint8_t>	packedFrame;
 };
 
@@ -0,0 +1,58 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	A completed CIF is published once to all backends: the
+//	mscHandler fills a cifBuffer from the pool, each backend
+//	retains it while it is queued, reads its own subchannel
+//	(startAddr, Length) from it and releases it after the
+//	deinterleaving. A buffer with a reference count of zero is
+//	free, so the pool - the only allocation - is bounded
+#include	<stdint.h>
+#include	<vector>
+#include	<atomic>
+
+class	cifBuffer {
+public:
+		cifBuffer	(int32_t size);
+		~cifBuffer	();
+	int16_t	*data		();
+	void	retain		();
+	void	release		();
+	bool	tryClaim	();
+private:
+	std::vector<int16_t>	buffer;
+	std::atomic<int32_t>	refCount;
+};
+
+class	cifPool {
+public:
+		cifPool		(int16_t nrBuffers, int32_t cifSize);
+		~cifPool	();
+//	get returns a free buffer, owned (i.e. with a reference count
+//	of one) by the caller, nullptr if all buffers are in use
+	cifBuffer	*get	();
+private:
+	std::vector<cifBuffer *>	buffers;
+	int16_t		next;
+};
@@ -28,6 +28,9 @@
 #include	<atomic>
 #include	<vector>
 #include	"dab-semaphore.h"
+#include	"energy-dispersal.h"
+#include	"time-deinterleaver.h"
+#include	"cif-pool.h"
 #include	"dab-api.h"
 #include	"virtual-backend.h"
 #include	"data-processor.h"
@@ -38,28 +41,30 @@ class	protection;
 
 class	dataBackend: public virtualBackend {
 public:
-		dataBackend	(packetdata *, API_struct *, void *);
+		dataBackend	(packetdata *, API_struct *, void *,
+	                         servicePool *pool = nullptr);
 		~dataBackend	();
-	int32_t	process		(int16_t *, int16_t);
+	int32_t	process		(cifBuffer *);
 	void	stopRunning	();
 	void	start		();
 private:
-	int16_t		fragmentSize;
+	int32_t		fragmentSize;
 	int16_t		bitRate;
 	bool		shortForm;
 	int16_t		protLevel;
 void	run		(void);
+	void		processSegment	(cifBuffer *);
+	bool		processNext	();
 	std::atomic<bool>	running;
 	std::thread	threadHandle;
-	int16_t		countforInterleaver;
 	std::vector<uint8_t> outV;
 	std::vector<int16_t>	tempX;
-	std::vector<uint8_t>	disperseVector;
-	int16_t		**interleaveData;
+	energyDispersal	dispersal;
+	timeDeinterleaver	deinterleaver;
 	Semaphore	freeSlots;
 	Semaphore	usedSlots;
 
-	int16_t		*theData [20];
+	cifBuffer	*theData [20];
 	int16_t		nextIn;
 	int16_t		nextOut;
 
@@ -41,7 +41,7 @@ public:
 	                 API_struct	*p,
 	                 void		*ctx);
 	~dataProcessor	();
-void	addtoFrame	(uint8_t *);
+void	addtoFramePacked	(uint8_t *);
 private:
 	int16_t		bitRate;
 	uint8_t		DSCTy;
@@ -50,12 +50,15 @@ private:
 	uint8_t		DGflag;
 	int16_t		FEC_scheme;
 	int16_t		expectedIndex;
+	int		expected_cntidx;
 	std::vector<uint8_t>	series;
+	std::vector<uint8_t>	frameBits;
 	int16_t		fillPointer;
 	bool		assembling;
 	std::vector<uint8_t> AppVector;
 	std::vector<uint8_t> FECVector;
 	bool		FEC_table [9];
+	uint8_t		table [12 * (188 + 16)];	// RSDIMS * (FRAMESIZE + 16)
 	reedSolomon my_rsDecoder;
 	bytesOut_t	bytesOut;
 	int32_t		streamAddress;		// int since we init with -1
@@ -63,10 +66,10 @@ private:
 //
 //	result handlers
 	void		handleTDCAsyncstream 	(uint8_t *, int32_t);
-	void		handlePackets		(uint8_t *, int16_t);
+	void		handlePackets		(uint8_t *, uint8_t *, int16_t);
 	void		handlePacket		(uint8_t *vec);
 
-	void		handleRSPacket		(uint8_t *);
+	void		handleRSPacket		(uint8_t *, uint8_t *);
 	void		registerFEC		(uint8_t *, int);
 	void		clear_FECtable		();
 	bool		FEC_complete		();
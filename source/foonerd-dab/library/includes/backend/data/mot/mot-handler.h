@@ -42,6 +42,13 @@ private:
 	motObject	*getHandle	(uint16_t);
 	int		orderNumber;
 	motDirectory	*theDirectory;
+//
+//	the most recent single motSlides (not those in a directory)
+	struct {
+	   uint16_t	transportId;
+	   int32_t	orderNumber;
+	   motObject	*motSlide;
+	} motTable [15];
 };
 #endif
 
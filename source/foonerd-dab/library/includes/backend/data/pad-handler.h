@@ -60,6 +60,11 @@ private:
 	bool		firstSegment;
 	bool		lastSegment;
 	int16_t		segmentNumber;
+//	dynamic label assembly, kept per instance
+	int16_t		segmentno;
+	int16_t		remainDataLength;
+	bool		isLastSegment;
+	bool		moreXPad;
 //      dataGroupLength is set when having processed an appType 1
         int dataGroupLength;
 //
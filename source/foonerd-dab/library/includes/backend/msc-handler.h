@@ -39,6 +39,8 @@
 #include	"dab-api.h"
 #include	"dab-params.h"
 #include	"freq-interleaver.h"
+#include	"cif-pool.h"
+#include	"service-pool.h"
 
 class	virtualBackend;
 
@@ -51,6 +53,13 @@ public:
 	void	process_mscBlock	(std::vector<int16_t> &, int16_t);
 	void	set_audioChannel	(audiodata	&);
 	void	set_dataChannel		(packetdata     &);
+//	with a specific context for the output of the service
+	void	set_audioChannel	(audiodata	&, void *);
+	void	set_dataChannel		(packetdata     &, void *);
+//	the backends set after set_servicePool run on a pool of
+//	workers, the pool ends with stop or reset
+	void	set_servicePool		(int nrWorkers);
+	int	get_serviceStats	(serviceStats *, int);
 	void	reset			();
 	void	stop			();
 	void	start			();
@@ -67,6 +76,9 @@ private:
 	std::mutex	locker;
 	std::vector<complex<float> > phaseReference;
 	std::vector<virtualBackend *>theBackends;
+	cifPool		thePool;
+	cifBuffer	*currentCIF;
+	servicePool	*workerPool;
 	int16_t		cifCount;
 	std::atomic<bool> work_to_do;
 	int16_t		BitsperBlock;
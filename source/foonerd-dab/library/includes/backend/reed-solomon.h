@@ -7,8 +7,20 @@
 #pragma once
 
 #include	<stdint.h>
+#include	<vector>
 #include	"galois.h"
 
+#define	RS_AUTO		0
+#define	RS_SCALAR	1
+#define	RS_SSSE3	2
+#define	RS_AVX2		3
+#define	RS_NEON		4
+
+//	the syndrome kernels, see reed-solomon.cpp
+typedef void (*rsSyndromes_t)(const uint8_t *work, int stride, int length,
+	                      int nroots, const uint8_t *mulTables,
+	                      uint8_t *syndromes);
+
 class	reedSolomon {
 private:
 	galois	myGalois;
@@ -28,6 +40,15 @@ private:
 	void	encode_rs		(const uint8_t *data_in,
 	                                      uint8_t *roots);
 	int16_t	decode_rs		(uint8_t *data);
+	int16_t	correct			(uint8_t *data, uint8_t *syndromes);
+//	for the batch decoder: per root the 2 * 16 entry nibble tables
+//	for multiplying with the root, the (padded) codewords and
+//	their syndromes
+	std::vector<uint8_t>	mulTables;
+	std::vector<uint8_t>	work;
+	std::vector<uint8_t>	batchSyndromes;
+	rsSyndromes_t		syndromeKernel;
+	int		kernelType;
 public:
 		reedSolomon (uint16_t symsize	= 8,
 	                     uint16_t gfpoly	= 0435,
@@ -37,5 +58,17 @@ public:
 		~reedSolomon (void);
 int16_t		dec	  (const uint8_t *data_in, uint8_t *data_out, int16_t cutlen);
 void		enc	  (const uint8_t *data_in, uint8_t *data_out, int16_t cutlen);
+//
+//	decBatch decodes count codewords, stored interleaved, as in
+//	a DAB+ superframe: symbol k of codeword j is in [j + k * count].
+//	The data symbols are written to out in the same order.
+//	The syndromes of all codewords are computed together, codewords
+//	with all syndromes zero are just copied.
+//	Returns -1 if one of the codewords could not be corrected,
+//	the number of corrected symbols otherwise
+int16_t		decBatch  (const uint8_t *in, uint8_t *out,
+	                   int16_t count, int16_t cutlen);
+bool		setKernel	(int);
+const char	*kernelName	();
 };
 
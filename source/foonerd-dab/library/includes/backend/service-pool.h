@@ -0,0 +1,62 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	When the whole ensemble is decoded, the backends do not run
+//	a thread each, they are run - as task - by a fixed pool of
+//	workers. A backend with queued CIF's is scheduled (once, see
+//	virtualBackend::wakeUp) on the queue of one of the workers,
+//	a worker without work takes - steals - tasks from the queues
+//	of the others. A task handles all CIF's queued for its backend,
+//	so a backend is never run by two workers at the same time
+#include	<stdint.h>
+#include	<vector>
+#include	<deque>
+#include	<thread>
+#include	<mutex>
+#include	<condition_variable>
+#include	<atomic>
+
+class	virtualBackend;
+
+class	servicePool {
+public:
+		servicePool	(int nrWorkers);
+		~servicePool	();
+	void	schedule	(virtualBackend *);
+	int	nrWorkers	();
+private:
+	struct taskQueue {
+	   std::mutex			lock;
+	   std::deque<virtualBackend *>	tasks;
+	};
+	std::vector<taskQueue *>	queues;
+	std::vector<std::thread>	workers;
+	std::mutex		sleepLock;
+	std::condition_variable	wakeUp;
+	std::atomic<int>	queued;
+	std::atomic<uint32_t>	nextQueue;
+	std::atomic<bool>	running;
+	void		run		(int);
+	virtualBackend	*getTask	(int);
+};
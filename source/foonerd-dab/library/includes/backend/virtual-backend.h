@@ -24,20 +24,59 @@
 
 #include	<stdint.h>
 #include	<stdio.h>
+#include	<atomic>
+#include	"dab-api.h"
 
 #define	CUSize	(4 * 16)
 
+class	cifBuffer;
+class	servicePool;
+//
+//	process gets the complete CIF, the backend takes its
+//	subchannel - Length CU's from startAddr - from it. A backend
+//	that keeps the buffer beyond the call should retain it
+//
+//	A backend with a servicePool has no thread of its own, after
+//	queueing a CIF it calls wakeUp, and runTask - executed by a
+//	worker of the pool - handles the queued CIF's with processNext
 class	virtualBackend {
 public:
-		virtualBackend	(int16_t, int16_t);
+		virtualBackend	(int16_t, int16_t,
+	                         servicePool *pool = nullptr);
 virtual		~virtualBackend	();
-virtual int32_t	process		(int16_t *, int16_t);
+virtual int32_t	process		(cifBuffer *);
 virtual void	stopRunning	();
 virtual	void	stop		();
 	int16_t	startAddr	();
 	int16_t	Length		();
+	void	runTask		();
+	void	getStats	(serviceStats *);
 protected:
 	int16_t startAddress;
 	int16_t	segmentLength;
+	uint32_t	SId;
+	int16_t		subchId;
+	bool		isAudio;
+	servicePool	*thePool;
+	void		wakeUp		();
+//	processNext handles one queued CIF, false if there is none
+virtual	bool		processNext	();
+private:
+	std::atomic<bool>	scheduled;
+	std::atomic<int32_t>	pending;
+	std::atomic<uint64_t>	segments;
+	std::atomic<uint64_t>	cpuNs;
+	friend class	serviceTimer;
+};
+//
+//	a serviceTimer, as local variable in the code handling a CIF,
+//	adds the cpu time of the thread to the load of the service
+class	serviceTimer {
+public:
+		serviceTimer	(virtualBackend *);
+		~serviceTimer	();
+private:
+	virtualBackend	*theBackend;
+	uint64_t	startTime;
 };
 
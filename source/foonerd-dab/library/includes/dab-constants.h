@@ -92,6 +92,27 @@ typedef	std::complex<float> Complex;
 #define		DIFF_LENGTH	42
 #define		THRESHOLD	3
 
+//	effort spent in planning the FFT's
+#define		FFT_ESTIMATE	0
+#define		FFT_MEASURE	1
+#define		FFT_PATIENT	2
+
+//	the stages of the decoder that can be timed (dabGetStageTimings)
+#define		STAGE_SAMPLE_READER	0
+#define		STAGE_INPUT_WAIT	1
+#define		STAGE_TIME_SYNC		2
+#define		STAGE_FFT		3
+#define		STAGE_DEMAP		4
+#define		STAGE_FIC_VITERBI	5
+#define		STAGE_MSC_DEINTERLEAVE	6
+#define		STAGE_MSC_VITERBI	7
+#define		STAGE_REED_SOLOMON	8
+#define		STAGE_AAC		9
+#define		STAGE_MP2		10
+#define		NR_STAGES		11
+//	histogram bucket i counts the durations in [2^i, 2^(i+1)) nsec
+#define		STAGE_BUCKETS		32
+
 typedef struct  {
 	uint8_t		ecc;
 	uint32_t	EId;
@@ -339,27 +360,37 @@ int16_t	Sum	= 0;
 	return Sum == 0;
 }
 
+//
+//	CRC-16-CCITT (x^16 + x^12 + x^5 + 1), register preset to 0xFFFF,
+//	computed a byte at a time with a table. The CRC of FIB's, AU's
+//	etc is transmitted inverted
 static inline
-bool	check_crc_bytes (uint8_t *msg, int32_t len) {
-int i, j;
-uint16_t	accumulator	= 0xFFFF;
-uint16_t	crc;
-uint16_t	genpoly		= 0x1021;
-
-	for (i = 0; i < len; i ++) {
-	   int16_t data = msg [i] << 8;
-	   for (j = 8; j > 0; j--) {
-	      if ((data ^ accumulator) & 0x8000)
-	         accumulator = ((accumulator << 1) ^ genpoly) & 0xFFFF;
-	      else
-	         accumulator = (accumulator << 1) & 0xFFFF;
-	      data = (data << 1) & 0xFFFF;
+uint16_t	crc16_ccitt	(const uint8_t *msg, int32_t len) {
+static const struct crcTable {
+	uint16_t	entry [256];
+	crcTable	() {
+	   for (int i = 0; i < 256; i ++) {
+	      uint16_t r	= i << 8;
+	      for (int j = 0; j < 8; j ++)
+	         r = (r & 0x8000) ? (r << 1) ^ 0x1021 : r << 1;
+	      entry [i] = r;
 	   }
 	}
+} table;
+uint16_t	accumulator	= 0xFFFF;
+
+	for (int32_t i = 0; i < len; i ++)
+	   accumulator = (accumulator << 8) ^
+	                 table. entry [(accumulator >> 8) ^ msg [i]];
+	return accumulator;
+}
+
+static inline
+bool	check_crc_bytes (const uint8_t *msg, int32_t len) {
+uint16_t	crc	= ~((msg [len] << 8) | msg [len + 1]) & 0xFFFF;
 //
 //	ok, now check with the crc that is contained
 //	in the au
-	crc	= ~((msg [len] << 8) | msg [len + 1]) & 0xFFFF;
-	return (crc ^ accumulator) == 0;
+	return crc16_ccitt (msg, len) == crc;
 }
 
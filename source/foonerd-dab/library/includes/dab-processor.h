@@ -39,6 +39,7 @@
 #include	"dab-api.h"
 #include	"sample-reader.h"
 #include	"tii-detector.h"
+#include	"ofdm-pipeline.h"
 //
 class	deviceHandler;
 
@@ -70,9 +71,16 @@ public:
 	std::string	get_serviceName		(int32_t);
 	void		set_audioChannel        (audiodata &);
 	void		set_dataChannel         (packetdata &);
+	int		decodeEnsemble		(int, serviceContext_t);
+	int		get_serviceStats	(serviceStats *, int);
 	void		reset_msc		();
 	std::string	get_ensembleName	();
+	std::shared_ptr<const ensembleSnapshot> get_ensemble	();
 	void		clearEnsemble		();
+	void		set_pipeline		(int);
+	void		set_batchFFT		(bool);
+	bool		get_pipelineStats	(pipelineStats *);
+	void		get_processingStats	(processingStats *);
 private:
 	deviceHandler	*inputDevice;
 	dabParams	params;
@@ -82,6 +90,8 @@ private:
 	ofdmDecoder	my_ofdmDecoder;
 	ficHandler	my_ficHandler;
 	mscHandler	my_mscHandler;
+	ofdmPipeline	*my_pipeline;
+	bool		batchFFT;
 	syncsignal_t	syncsignalHandler;
 	systemdata_t	systemdataHandler;
 	programdata_t	programdataHandler;
@@ -90,6 +100,7 @@ private:
 	std::thread	threadHandle;
 	void		*userData;
 	std::atomic<bool>	running;
+	std::atomic<uint64_t>	framesDecoded;
 	bool		isSynced;
 	int		threshold;
 	int		snr;
@@ -25,6 +25,7 @@
 #include	<stdint.h>
 #include	<vector>
 #include	<string>
+#include	<unordered_map>
 
 //	ensemble information relates to FIG1, basically some
 //	general, i.e. ensemble wide, data and mapping tables for
@@ -57,10 +58,22 @@ public:
 	std::vector<service> secondaries;
 
 	void	reset		();
+//	the services are added through addPrimary/addSecondary, which
+//	maintain the SId and name indexes
+	void	addPrimary	(const service &);
+	void	addSecondary	(const service &);
+	int	findPrimary	(uint32_t SId);
+	int	findSecondary	(uint32_t SId);
+	int	findPrimary	(const std::string &name);
 	uint32_t serviceToSId	(const std::string &s);
 	std::string	SIdToserv	(uint32_t SId);
 	int	programType	(uint32_t);
 	std::vector<int>	fmFrequencies	(uint32_t);
+private:
+	std::unordered_map<uint32_t, int>	primaryIndex;
+	std::unordered_map<uint32_t, int>	secondaryIndex;
+	std::unordered_map<std::string, uint32_t>	primaryNames;
+	std::unordered_map<std::string, uint32_t>	secondaryNames;
 };
 
 
@@ -26,6 +26,7 @@
 //	Implementation of the FIG database
 #include	<stdint.h>
 #include	<vector>
+#include	<unordered_map>
 
 class	fibConfig {
 public:
@@ -131,6 +132,18 @@ public:
 	std::vector<FIG18_cluster> announcement_table; // FIG0/18
 
 	int32_t dateTime [8];
+//
+//	The tables only grow (until a reset), the elements are
+//	added through the add_xxx functions, that maintain hashed
+//	indexes on the keys used on querying the tables
+	void	add_SId			(const SId_struct &);
+	void	add_subChannel		(const subChannel &);
+	void	add_SC_C		(SId_struct &, const serviceComp_C &);
+	void	add_SC_P		(const serviceComp_P &);
+	void	add_SC_G		(const serviceComp_G &);
+	void	add_language		(const SC_language &);
+	void	add_AppType		(const AppType &);
+
 	void	reset			();
 	int	serviceIdOf		(int index);
 	int	SCIdsOf			(int index);
@@ -147,12 +160,40 @@ public:
 	int	packetAddressOf		(int index);
 	int	DSCTy			(int index);
 	int	DG_flag			(int index);
+	int	findIndex_SId		(uint32_t SId);
+	int	findIndex_SC_G_table	(uint32_t SId, uint8_t SCIds);
 	int	findIndex_SC_P_Table	(uint16_t SCId);
 	int	findIndex_subChannel_table (uint8_t subChId);
 	int	findIndex_languageTable	(uint8_t key_1, uint16_t key_2);
 	int	findIndexApptype_table	(uint32_t SId, uint8_t SCIds);
+	int	findIndex_comp		(uint32_t SId, int compNr);
 	bool	compIsKnown		(serviceComp_C &newComp);
 
 	int	freeSpace		();
+private:
+	std::unordered_map<uint32_t, int>	SId_index;
+	std::unordered_map<uint8_t, int>	subChannel_index;
+	std::unordered_map<uint16_t, int>	SC_P_index;
+//	(SId, compNr) -> SC_C_table
+	std::unordered_map<uint64_t, int>	SC_C_index;
+//	(SId, SCIds) -> SC_G_table, and
+//	(SId, LS_flag, subChId or SCId) -> SCIds
+	std::unordered_map<uint64_t, int>	SC_G_index;
+	std::unordered_map<uint64_t, int>	SCIds_index;
+//	(LS_flag, subChId or SCId) -> language_table
+	std::unordered_map<uint32_t, int>	language_index;
+//	(SId, SCIds) -> AppType_table
+	std::unordered_map<uint64_t, int>	AppType_index;
+	static	uint64_t	key	(uint32_t SId, uint32_t sub) {
+	   return ((uint64_t)SId << 32) | sub;
+	}
+	static	uint32_t	LSKey	(uint8_t LS_flag, uint16_t id) {
+	   return ((uint32_t)LS_flag << 16) | id;
+	}
+	template <typename M, typename K>
+	static	int	lookup		(const M &m, K k) {
+	   auto it = m. find (k);
+	   return it == m. end () ? -1 : it -> second;
+	}
 };
 
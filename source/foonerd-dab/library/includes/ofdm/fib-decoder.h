@@ -30,10 +30,13 @@
 #include        <stdint.h>
 #include        <stdio.h>
 #include        <string>
+#include        <vector>
 #include        <mutex>
 #include        <atomic>
+#include        <memory>
 #include        "dab-api.h"
 #include        "dab-constants.h"
+#include        "fib-snapshot.h"
 
 class	fibConfig;
 class	ensemble;
@@ -61,6 +64,7 @@ public:
 	void		audioData		(int, audiodata &);
 	void		packetData		(int, packetdata &);
 	int		get_nrComps		(uint32_t);
+	void		get_primaryComps	(std::vector<int> &);
 	int		nrChannels		();
         uint8_t		get_ecc			();
         uint32_t	get_EId			();
@@ -70,16 +74,33 @@ public:
 	uint32_t	julianDate		();
 	int		freeSpace		();
 	void		process_FIB		(uint8_t *, uint16_t);
+//	the current snapshot of the database, may be called
+//	without holding the lock of the caller of process_FIB
+	std::shared_ptr<const fibSnapshot> get_snapshot	();
+//	the transmitters found by the TII detector
+	void		set_transmitters	(const std::vector<tiiData> &);
 private:
         API_struct      *theParameters;
         name_of_ensemble_t  name_of_ensemble; 
         serviceName_t   serviceName;
+	ensembleChanged_t	ensembleChanged;
         void            *userData;
 
 	fibConfig	*currentConfig;
 	fibConfig	*nextConfig;
 	ensemble	*theEnsemble;
 	void		adjustTime		(int32_t *dateTime);
+//
+//	changed is set by the FIG handlers when they add or modify
+//	something the snapshot contains, after the FIB a new snapshot
+//	is published
+	bool		changed;
+	uint64_t	snapshotVersion;
+	std::shared_ptr<const fibSnapshot>	snapshot;
+	std::vector<tiiData>	transmitters;
+	void		publish_snapshot	();
+	void		fill_audioData		(int, audiodata &);
+	void		fill_packetData		(int, packetdata &);
 
 	void		process_FIG0		(uint8_t *);
 	void		process_FIG1		(uint8_t *);
@@ -0,0 +1,74 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	fibSnapshot is an immutable copy of the part of the FIG database
+//	the API queries: the ensembleSnapshot as handed out by
+//	dabGetEnsemble, extended with the indexes used for the queries.
+//	The fibDecoder builds a new one - with a higher version number -
+//	after a FIB that changed the database and publishes it through
+//	an atomically swapped shared pointer, so queries do not have
+//	to wait for the lock of the decoder
+#include	<stdint.h>
+#include	<string>
+#include	<vector>
+#include	<unordered_map>
+#include	"dab-api.h"
+#include	"dab-constants.h"
+
+class	fibSnapshot: public ensembleSnapshot {
+public:
+//	the primary component of each primary service, in the order
+//	in which the services were found
+	std::vector<int>	primaryComps;
+	std::unordered_map<uint32_t, std::string>	serviceNames;
+//	from the name of a primary service (padded to 16 characters),
+//	resp. a secondary service to the component index
+	std::unordered_map<std::string, int>	primaryNames;
+	std::unordered_map<std::string, int>	secondaryNames;
+
+		fibSnapshot	() {
+	   version	= 0;
+	   EId		= 0;
+	   ecc		= 0;
+	   for (int i = 0; i < 5; i ++)
+	      localTime [i] = 0;
+	}
+
+	bool	validComp	(int index) const {
+	   return (index >= 0) && (index < (int)components. size ());
+	}
+
+	int	serviceComp	(const std::string &service) const {
+	   std::string ss = service;
+	   for (int i = service. size (); i < 16; i ++)
+	      ss. push_back (' ');
+	   auto it = primaryNames. find (ss);
+	   if (it != primaryNames. end ())
+	      return it -> second;
+	   it = secondaryNames. find (service);
+	   if (it != secondaryNames. end ())
+	      return it -> second;
+	   return -1;
+	}
+};
@@ -29,6 +29,9 @@
 #include	<stdio.h>
 #include	<stdint.h>
 #include	<vector>
+#include	<array>
+#include	<atomic>
+#include	<unordered_map>
 #include	"viterbi-spiral.h"
 #include	"fib-decoder.h"
 #include	<mutex>
@@ -52,11 +55,16 @@ public:
 	void	audioData		(int, audiodata &);
 	void	packetData		(int, packetdata &);
 	int	getServiceComp		(const std::string &);
+	void	get_primaryComps	(std::vector<int> &);
         int32_t get_CIFcount		();
         void    reset			();
 	uint8_t	get_ecc			();
 	uint32_t	get_EId			();
 	std::string get_ensembleName	();
+	void	get_fibStats		(uint64_t &parsed,
+	                                 uint64_t &skipped, uint64_t &failed);
+	std::shared_ptr<const ensembleSnapshot> get_ensemble	();
+	void	set_transmitters	(const std::vector<tiiData> &);
 
 private:
 	fibDecoder	fibHandler;
@@ -64,18 +72,36 @@ private:
 	dabParams	params;
 	void		*userData;
 	void		process_ficInput	(int16_t);
-	uint8_t		bitBuffer_out	[768];
+	void		handle_FIB		(uint8_t *, int16_t);
+	uint8_t		fibBytes	[768 / 8];
+	uint8_t		fibBits		[256];
         int16_t		ofdm_input	[2304];
         bool		punctureTable	[4 * 768 + 24];
+	int16_t		depunctureList	[2304];
 
 	int16_t		index;
 	int16_t		BitsperBlock;
 	int16_t		ficno;
 	int16_t		ficBlocks;
+	int16_t		ficSuccess;
 	int16_t		ficMissed;
 	int16_t		ficRatio;
 	mutex		fibProtector;
 	uint8_t		PRBS [768];
+	uint8_t		PRBSBytes [768 / 8];
+//
+//	In steady state - the FIB's (apart from the ones carrying
+//	FIGs that change all the time) have all been seen before for a
+//	while - FIB's identical to one seen before are not parsed again.
+//	FIB's are looked up by their CRC
+	typedef std::array<uint8_t, 30>	fibContent;
+	std::unordered_multimap<uint16_t, fibContent>	knownFIBs;
+	int		repeatedFIBs;
+	bool		steadyState;
+	std::atomic<uint64_t>	fibsParsed;
+	std::atomic<uint64_t>	fibsSkipped;
+	std::atomic<uint64_t>	fibsFailed;
+	void		clear_knownFIBs		();
 	uint8_t		shiftRegister [9];
 	void		show_ficCRC	(bool);
 };
@@ -28,7 +28,7 @@
 #include	"dab-constants.h"
 #include	"ringbuffer.h"
 #include	"phasetable.h"
-#include	"freq-interleaver.h"
+#include	"ofdm-demapper.h"
 #include	"fft-handler.h"
 
 class	dabParams;
@@ -41,10 +41,19 @@ public:
 	void	processBlock_0		(std::complex<float> *);
 	void	decode			(std::complex<float> *,
 	                                       int32_t n, int16_t *);
+//	batched handling of the MSC blocks of a frame
+	void	set_batchMode		(bool);
+	std::complex<float>	*getFrameBuffer	();
+	void	transformFrame		();
+	void	decodeFrameSymbol	(int16_t, int32_t n, int16_t *);
 private:
 	dabParams	params;
 	fft_handler	my_fftHandler;
-	interLeaver	myMapper;
+	fft_handler	*frameHandler;
+	void	demap			(std::complex<float> *,
+	                                 std::complex<float> *,
+	                                 int32_t, int16_t *);
+	ofdmDemapper	myDemapper;
         RingBuffer<std::complex<float>> *iqBuffer;
 	int		cnt;
 	int32_t		T_s;
@@ -0,0 +1,71 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The differential demodulation and soft bit mapping of a
+//	complete ofdm symbol. The frequency de-interleaving is
+//	applied through a precomputed table of FFT bin indices.
+//	The kernel is chosen at runtime: AVX2 or SSE2 on x86, NEON on
+//	ARM, a scalar version elsewhere. All kernels compute
+//	    r = spectrum [k] * conj (reference [k])
+//	    bits = - (real (r) * 128) / |r|,  - (imag (r) * 128) / |r|
+//	with the same IEEE operations, so their output is identical
+//	(for 32 bit ARM, lacking a vector sqrt, within 1). That needs
+//	a build without -ffast-math, which turns the vector division
+//	and sqrt into estimates (rcpps, rsqrtps and a Newton step)
+#include	<stdint.h>
+#include	<vector>
+#include	<complex>
+#include	"dab-params.h"
+
+#define	DEMAP_AUTO	0
+#define	DEMAP_SCALAR	1
+#define	DEMAP_SSE2	2
+#define	DEMAP_AVX2	3
+#define	DEMAP_NEON	4
+
+typedef void (*demapKernel) (const std::complex<float> *,
+	                     const std::complex<float> *,
+	                     const int32_t *, int, int16_t *);
+
+class	ofdmDemapper {
+public:
+		ofdmDemapper		(uint8_t dabMode);
+		~ofdmDemapper		();
+//	products, if not null, receives (indexed by FFT bin) the
+//	differential products, used to show the constellation
+	void	demap			(const std::complex<float> *spectrum,
+	                                 const std::complex<float> *reference,
+	                                 int16_t *ibits,
+	                                 std::complex<float> *products =
+	                                                          nullptr);
+	bool	setKernel		(int);
+	const char	*kernelName	();
+private:
+	dabParams	params;
+	int32_t		carriers;
+	std::vector<int32_t>	binTable;
+	demapKernel	theKernel;
+	int		kernelType;
+};
+
@@ -0,0 +1,99 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The ofdmPipeline takes the MSC symbols of a frame off the
+//	sync thread. The sync thread reads the samples of a symbol
+//	directly into a preallocated slot and publishes it, a small pool
+//	of workers does the FFT, the differential demodulation and
+//	the frequency de-interleaving, and the results are handed - in
+//	order - to the mscHandler.
+//	Block 3 (the last FIC block) is passed as "reference" only,
+//	its FFT is the phase reference for block 4.
+#include	<stdint.h>
+#include	<vector>
+#include	<thread>
+#include	<atomic>
+#include	<mutex>
+#include	"dab-constants.h"
+#include	"dab-params.h"
+#include	"dab-api.h"
+#include	"dab-semaphore.h"
+#include	"ofdm-demapper.h"
+#include	"fft-handler.h"
+
+class	mscHandler;
+
+class	ofdmPipeline {
+public:
+		ofdmPipeline		(uint8_t	dabMode,
+	                                 int		nrWorkers,
+	                                 mscHandler	*);
+		~ofdmPipeline		();
+	void	start			();
+	void	stop			();
+//	getBuffer returns the slot to be filled with the next T_s
+//	samples, nullptr if the pipeline is stopped
+	std::complex<float>	*getBuffer	();
+	void	putBuffer		(int16_t blkno, bool isReference);
+	void	getStats		(pipelineStats *);
+private:
+	struct symbolSlot {
+	   std::vector<std::complex<float>>	timeData;
+	   std::vector<std::complex<float>>	freqData;
+	   std::vector<int16_t>			ibits;
+	   int16_t			blkno;
+	   bool				isReference;
+	   std::atomic<int64_t>		transformed;
+	   std::atomic<int64_t>		demapped;
+	};
+	dabParams	params;
+	mscHandler	*theMscHandler;
+	ofdmDemapper	myDemapper;
+	int		nrWorkers;
+	int		nrSlots;
+	int32_t		T_s;
+	int32_t		T_u;
+	int32_t		T_g;
+	int32_t		carriers;
+	std::vector<symbolSlot *>	slots;
+	std::vector<fft_handler *>	fftHandlers;
+	std::vector<std::thread>	workers;
+	Semaphore	freeSlots;
+	Semaphore	usedSlots;
+	std::mutex	deliverLock;
+	std::atomic<bool>	running;
+	std::atomic<int64_t>	published;
+	std::atomic<int64_t>	claimed;
+	std::atomic<int64_t>	demappedCount;
+	std::atomic<int64_t>	delivered;
+	std::atomic<int64_t>	producerStalls;
+	std::atomic<int>	peakWaiting;
+	int64_t		filling;
+	bool		bufferTaken;
+	void		run			(int);
+	void		demap			(symbolSlot *, symbolSlot *);
+	void		deliver			();
+	void		reset			();
+};
+
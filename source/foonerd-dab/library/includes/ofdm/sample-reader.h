@@ -33,8 +33,13 @@
 #include	"ringbuffer.h"
 //
 
+//
+//	the maximum amount of samples getSample fetches at once
+#define	PENDING_SIZE	4096
+
 class	deviceHandler;
 class	dabProcessor;
+struct	oscillatorTables;
 
 class	sampleReader {
 public:
@@ -45,6 +50,7 @@ public:
 			~sampleReader		();
 		void	setRunning	(bool b);
 		float	get_sLevel	(void);
+		uint64_t get_samplesRead	(void);
 	        void	reset		(void);
 		std::complex<float> getSample	(int32_t);
 	        void	getSamples	(std::complex<float> *v,
@@ -60,6 +66,17 @@ private:
 		std::atomic<bool>	running;
 		float		sLevel;
 		int32_t		sampleCount;
+		std::atomic<uint64_t>	samplesRead;
 	        int32_t		corrector;
+	const oscillatorTables	*oscillatorTable;
+		float		mixBlock	(const std::complex<float> *,
+	                                 std::complex<float> *,
+	                                 int32_t, int32_t);
+		std::vector<std::complex<float>> pending;
+		int32_t		pendingIndex;
+		int32_t		pendingCount;
+		int32_t		waitFor		(int32_t);
+		uint64_t	waitedNs;
+		void		fillPending	();
 };
 
@@ -0,0 +1,41 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	Energy dispersal for the packed output of the deconvolution:
+//	the PRBS (x^9 + x^5 + 1, all ones at the start) is computed
+//	once, packed MSB first, and applied as 64 bit XOR's
+#include	<stdint.h>
+#include	<vector>
+
+class	energyDispersal {
+public:
+		energyDispersal	(int32_t nBits);
+		~energyDispersal	();
+//	apply XOR's the PRBS on nBits / 8 packed bytes
+	void	apply		(uint8_t *);
+private:
+	std::vector<uint64_t>	prbsWords;
+	std::vector<uint8_t>	prbsTail;
+};
+
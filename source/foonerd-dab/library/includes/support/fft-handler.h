@@ -24,24 +24,44 @@
 #pragma once
 //
 //	Simple wrapper around fftwf
+//	Next to the single vector FFT, the handler can be created
+//	for a batch of "nrSymbols" contiguous ofdm symbols (T_s samples
+//	each), the batch is transformed with a single plan, skipping the
+//	cyclic prefix of each symbol
 #include	"dab-constants.h"
 #include	"dab-params.h"
 #include	<fftw3.h>
-
+#include	<string>
 
 class	fft_handler {
 public:
 			fft_handler	(uint8_t);
+			fft_handler	(uint8_t, int16_t nrSymbols);
 			~fft_handler	();
 	complex<float>	*getVector	();
 	void		fft		(Complex *);
 	void		do_FFT		();
 	void		do_iFFT		();
+//	for the batched version
+	complex<float>	*getFrameBuffer	();
+	complex<float>	*getSpectrum	(int16_t);
+	void		do_frameFFT	();
+//
+//	planning is process wide, the settings apply to handlers
+//	created afterwards
+static	void		setPlanning	(const std::string &wisdomFile,
+	                                 int effort);
 private:
 	dabParams	p;
 	int32_t		fftSize;
+	int32_t		T_s;
+	int32_t		T_g;
+	int16_t		nrSymbols;
 	complex<float>	*vector;
+	complex<float>	*frameBuffer;
+	complex<float>	*frameSpectrum;
 	fftwf_plan	plan;
+	fftwf_plan	framePlan;
 };
 
 
@@ -35,10 +35,22 @@ public:
 		protection  	(int16_t, int16_t);
 virtual		~protection	();
 virtual	bool	deconvolve	(int16_t *, int32_t, uint8_t *);
+//	as deconvolve, the output packed, (24 * bitRate) / 8 bytes
+virtual	bool	deconvolvePacked	(int16_t *, int32_t, uint8_t *);
+//	depuncture fills the viterbiBlock with the (punctured) input
+	void	depuncture	(int16_t *);
+//	the number of soft bits taken by depuncture
+	int32_t	inputSize	();
 protected:
+//	to be called by the eep and uep constructors, once
+//	the indexTable is filled
+	void	buildDepunctureList	();
         int16_t         bitRate;
         int32_t         outSize;
         std::vector<uint8_t> indexTable;
         std::vector<int16_t> viterbiBlock;
+//	the positions in the viterbiBlock of the non punctured bits,
+//	up to outSize * 4 + 24, i.e. 221208 for EEP-A at 2304 kbit/s
+	std::vector<int32_t> depunctureList;
 };
 
@@ -0,0 +1,67 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	Timing of the stages of the decoder (STAGE_xxx, see
+//	dab-constants.h). The timings are collected for the whole
+//	process, in a histogram per stage with power of two buckets.
+//	Timing is off by default, a stageTimer then costs no more than
+//	the load of a flag.
+//	Typical use is a stageTimer as local variable in the scope to
+//	be timed, where a scope does not fit, stageClock and
+//	stageRecord can be used directly
+#include	<stdint.h>
+#include	<atomic>
+#include	<chrono>
+#include	"dab-constants.h"
+#include	"dab-api.h"
+
+extern	std::atomic<bool>	stageTimingOn;
+
+void	stageTimingSwitch	(bool);
+void	stageTimingGet		(stageTimings *);
+void	stageRecord		(int stage, uint64_t ns);
+
+static inline
+uint64_t	stageClock	() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>
+	         (std::chrono::steady_clock::now (). time_since_epoch ()).
+	                                                          count ();
+}
+
+class	stageTimer {
+public:
+		stageTimer	(int stage) {
+	   this	-> stage	= stage;
+	   this	-> startTime	= stageTimingOn. load (std::memory_order_relaxed) ?
+	                                            stageClock () : 0;
+	}
+		~stageTimer	() {
+	   if (startTime != 0)
+	      stageRecord (stage, stageClock () - startTime);
+	}
+private:
+	int		stage;
+	uint64_t	startTime;
+};
+
@@ -0,0 +1,48 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#pragma once
+//
+//	The time deinterleaver of a subchannel, shared by the audio
+//	and the data backend. Soft bit i of a CIF is delayed by
+//	16 - interleaveMap [i % 16] CIF's. The values are stored - in
+//	one aligned buffer - by the time they are needed, and grouped
+//	by i % 16, so a CIF reads and writes only an eighth of the
+//	buffer, sequentially (see time-deinterleaver.cpp)
+#include	<stdint.h>
+
+class	timeDeinterleaver {
+public:
+		timeDeinterleaver	(int32_t fragmentSize);
+		~timeDeinterleaver	();
+//	process takes the fragmentSize soft bits of the subchannel of a
+//	CIF. It returns false as long as the deinterleaver is being
+//	filled (the first 16 CIF's), otherwise "out" is filled with the
+//	deinterleaved soft bits
+	bool	process		(const int16_t *in, int16_t *out);
+private:
+	int32_t		fragmentSize;
+	int32_t		n;
+	int16_t		*history;
+	int16_t		index;
+	int16_t		count;
+};
@@ -31,6 +31,12 @@ public:
 		uep_protection	(int16_t, int16_t);
 		~uep_protection	();
 bool		deconvolve	(int16_t *, int32_t, uint8_t *);
+//	the entries of the UEP table (EN 300 401, table 15):
+//	L [4] and PI [4] (PI [3] == -1 if absent), false if index
+//	is beyond the table
+static	bool	getProfile	(int16_t index, int16_t *bitRate,
+	                         int16_t *protLevel,
+	                         int16_t *L, int16_t *PI);
 };
 
 
@@ -46,11 +46,26 @@ struct v {
 	decision_t *decisions;   /* decisions */
 };
 
+//	The butterflies are done by one of the spiral kernels. With SSE
+//	(X64_DEFINED) the AVX2 and AVX-512 versions are compiled as
+//	well, the best one the CPU supports is selected at runtime.
+//	The kernel functions allow a specific kernel to be chosen, e.g.
+//	to compare them
+typedef void (*spiralKernel)(int, COMPUTETYPE *, COMPUTETYPE *,
+	                     COMPUTETYPE *, DECISIONTYPE *, COMPUTETYPE *);
+
 class	viterbiSpiral {
 public:
 		viterbiSpiral	(int16_t);
 		~viterbiSpiral	(void);
 	void	deconvolve	(int16_t *, uint8_t *);
+	void	deconvolvePacked	(int16_t *, uint8_t *);
+
+static	int		nrKernels	();
+static	const char	*kernelName	(int);
+static	bool		kernelSupported	(int);
+static	int		currentKernel	();
+static	bool		setKernel	(int);
 private:
 
 	struct v	vp;
@@ -63,6 +78,7 @@ _MM_ALIGN16	COMPUTETYPE Branchtab	[NUMSTATES / 2 * RATE];
 	int	parity		(int);
 	void	partab_init	(void);
 //	uint8_t	Partab	[256];
+	void	decode		(int16_t *, uint8_t *);
 	void	init_viterbi	(struct v *, int16_t);
 	void	update_viterbi_blk_GENERIC	(struct v *, COMPUTETYPE *,
 	                                         int16_t);
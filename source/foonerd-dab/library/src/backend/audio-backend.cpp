@@ -27,6 +27,7 @@
 #include	"mp4processor.h"
 #include	"eep-protection.h"
 #include	"uep-protection.h"
+#include	"stage-timer.h"
 #include	<chrono>
 //
 //	As an experiment a version of the backend is created
@@ -39,27 +40,24 @@
 //	fragmentsize == Length * CUSize
 	audioBackend::audioBackend	(audiodata	*d,
 	                                 API_struct	*p,
-	                                 void		*ctx):
+	                                 void		*ctx,
+	                                 servicePool	*pool):
 	                                     virtualBackend (d -> startAddr,
-	                                                     d -> length),
-	                                     outV (24 * d -> bitRate),
+	                                                     d -> length,
+	                                                     pool),
+	                                     outV (24 * d -> bitRate / 8),
+	                                     dispersal (24 * d -> bitRate),
+	                                     deinterleaver (d -> length * CUSize),
 	                                     freeSlots (20) {
-int32_t i, j;
 
 	this    -> dabModus             = d -> ASCTy == 077 ? DAB_PLUS : DAB;
 	this    -> fragmentSize         = d -> length * CUSize;
 	this	-> bitRate		= d -> bitRate;
 	this	-> shortForm		= d -> shortForm;
 	this	-> protLevel		= d -> protLevel;
-
-	interleaveData		= new int16_t *[16]; // max size
-	for (i = 0; i < 16; i ++) {
-	   interleaveData [i] = new int16_t [fragmentSize];
-	   memset (interleaveData [i], 0, fragmentSize * sizeof (int16_t));
-	}
-
-	interleaverIndex	= 0;
-	countforInterleaver	= 0;
+	this	-> SId			= d -> SId;
+	this	-> subchId		= d -> subchId;
+	this	-> isAudio		= true;
 
 	if (shortForm)
 	   protectionHandler	= new uep_protection (bitRate,
@@ -82,38 +80,25 @@ int32_t i, j;
 	tempX . resize (fragmentSize);
 	nextIn			= 0;
 	nextOut			= 0;
-	for (i = 0; i < 20; i ++)
-	   theData [i] = new int16_t [fragmentSize];
-
-	uint8_t	shiftRegister [9];
-	disperseVector. resize (bitRate * 24);
-        memset (shiftRegister, 1, 9);
-        for (i = 0; i < bitRate * 24; i ++) {
-           uint8_t b = shiftRegister [8] ^ shiftRegister [4];
-           for (j = 8; j > 0; j--)
-              shiftRegister [j] = shiftRegister [j - 1];
-           shiftRegister [0] = b;
-           disperseVector [i] = b;
-	}
-
-	start ();
+//	with a pool, the backend is run by the workers of the pool
+	if (thePool == nullptr)
+	   start ();
+	else
+	   running. store (true);
 }
 
 	audioBackend::~audioBackend	() {
-int16_t	i;
-	if (running. load ()) {
-	   running. store (false);
+	running. store (false);
+	if (threadHandle. joinable ())
 	   threadHandle. join ();
-	}
 //	delete our_backendBase;
 	delete protectionHandler;
-	for (i = 0; i < 16; i ++) 
-	   delete[]  interleaveData [i];
-	delete [] interleaveData;
-
-	for (i = 0; i < 20; i ++)
-	   delete [] theData [i];
-
+//
+//	give back the CIF's still queued
+	while (usedSlots. tryAcquire (0)) {
+	   theData [nextOut] -> release ();
+	   nextOut = (nextOut + 1) % 20;
+	}
 }
 
 void	audioBackend::start		(void) {
@@ -121,47 +106,62 @@ void	audioBackend::start		(void) {
 	threadHandle = std::thread (&audioBackend::run, this);
 }
 
-int32_t	audioBackend::process	(int16_t *v, int16_t cnt) {
+//
+//	the CIF is queued as is, the subchannel is taken from it
+//	while deinterleaving
+int32_t	audioBackend::process	(cifBuffer *v) {
 	if (!running. load ())
 	   return 0;
 	while (!freeSlots. tryAcquire (200))
 	   if (!running. load ())
 	      return 0;
-	memcpy (theData [nextIn], v, fragmentSize * sizeof (int16_t));
+	v -> retain ();
+	theData [nextIn] = v;
 	nextIn = (nextIn + 1) % 20;
 	usedSlots. Release ();
+	if (thePool != nullptr)
+	   wakeUp ();
 	return 1;
 }
 
-const	int16_t interleaveMap [] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
-void    audioBackend::processSegment (int16_t *Data) {
-int16_t i;
+void    audioBackend::processSegment (cifBuffer *cif) {
+const int16_t *Data	= &(cif -> data ()) [startAddress * CUSize];
+serviceTimer	load (this);
+bool	filled;
 
-        for (i = 0; i < fragmentSize; i ++) {
-           tempX [i] = interleaveData [(interleaverIndex +
-                                        interleaveMap [i & 017]) & 017][i];
-           interleaveData [interleaverIndex][i] = Data [i];
-        }
+	{
+	   stageTimer	timer (STAGE_MSC_DEINTERLEAVE);
+	   filled	= deinterleaver. process (Data, tempX. data ());
+	}
 
-        interleaverIndex = (interleaverIndex + 1) & 0x0F;
+	cif -> release ();
         nextOut = (nextOut + 1) % 20;
         freeSlots. Release ();
 
 //      only continue when de-interleaver is filled
-        if (countforInterleaver <= 15) {
-           countforInterleaver ++;
-           return;
-        }
-
-	protectionHandler -> deconvolve (tempX. data (),
-	                                 fragmentSize,
-	                                  outV. data ());
+	if (!filled)
+	   return;
+
+	{
+	   stageTimer	timer (STAGE_MSC_VITERBI);
+	   protectionHandler -> deconvolvePacked (tempX. data (),
+	                                          fragmentSize,
+	                                          outV. data ());
+	}
 //
-//      and the energy dispersal
-	for (i = 0; i < bitRate * 24; i ++)
-	   outV [i] ^= disperseVector [i];
+//      and the energy dispersal, outV is packed
+	dispersal. apply (outV. data ());
 
-	our_backendBase -> addtoFrame (outV. data ());
+	our_backendBase -> addtoFramePacked (outV. data ());
+}
+
+//
+//	in the pool, handle a queued CIF, if any
+bool	audioBackend::processNext	() {
+	if (!usedSlots. tryAcquire (0))
+	   return false;
+	processSegment (theData [nextOut]);
+	return true;
 }
 
 void    audioBackend::run       (void) {
@@ -177,9 +177,8 @@ void    audioBackend::run       (void) {
 //
 //	It might take a msec for the task to stop
 void	audioBackend::stopRunning (void) {
-	if (running. load ()) {
-	   running. store (false);
+	running. store (false);
+	if (threadHandle. joinable ())
 	   threadHandle. join ();
-	}
 }
 
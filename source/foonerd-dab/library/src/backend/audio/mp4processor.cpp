@@ -50,6 +50,7 @@
 //
 #include	"charsets.h"
 #include	"pad-handler.h"
+#include	"stage-timer.h"
 
 #include	<stdlib.h>
 #include	<stdint.h>
@@ -110,6 +111,7 @@ void	WriteAudioMuxLengthBytes () {
 	mp4Processor::mp4Processor (int16_t		bitRate,
 	                            API_struct		*p,
 	                            void		*ctx):
+	                                  backendBase (24 * bitRate),
 	                                  my_padHandler (p,
 	                                                 ctx),
 	                                  my_rsDecoder (8, 0435, 0, 1, 10),
@@ -122,6 +124,7 @@ void	WriteAudioMuxLengthBytes () {
 	superFramesize		= 110 * (bitRate / 8);
 	RSDims			= bitRate / 8;
 	frameBytes. resize (RSDims * 120);	// input
+	rsIn.       resize (RSDims * 120);
 	outVector.  resize (RSDims * 110);
 	blockFillIndex	= 0;
 	blocksInBuffer	= 0;
@@ -145,19 +148,11 @@ void	WriteAudioMuxLengthBytes () {
 //
 //	we add vector for vector to the superframe. Once we have
 //	5 lengths of "old" frames, we check
-void	mp4Processor::addtoFrame (uint8_t *V) {
-int16_t	i, j;
-uint8_t	temp	= 0;
+void	mp4Processor::addtoFramePacked (uint8_t *V) {
 int16_t	nbits	= 24 * bitRate;
 //
-//	Note that the packing in the entry vector is still one bit
-//	per Byte, nbits is the number of Bits (i.e. containing bytes)
-	for (i = 0; i < nbits / 8; i ++) {	// in bytes
-	   temp = 0;
-	   for (j = 0; j < 8; j ++)
-	      temp = (temp << 1) | (V [i * 8 + j] & 01);
-	   frameBytes [blockFillIndex * nbits / 8 + i] = temp;
-	}
+//	The entry vector is packed, nbits / 8 bytes
+	memcpy (&frameBytes [blockFillIndex * nbits / 8], V, nbits / 8);
 //
 	blocksInBuffer ++;
 	blockFillIndex = (blockFillIndex + 1) % 5;
@@ -195,25 +190,24 @@ int16_t	nbits	= 24 * bitRate;
 bool	mp4Processor::processSuperframe (uint8_t frameBytes [],
 	                                 int16_t base) {
 uint8_t		num_aus;
-int16_t		i, j, k;
-uint8_t		rsIn	[120];
-uint8_t		rsOut	[110];
+int16_t		i;
+int32_t		superframeSize	= RSDims * 120;
 stream_parms	streamParameters;
 
 /**	apply reed-solomon error repar
   *	OK, what we now have is a vector with RSDims * 120 uint8_t's
   *	Output is a vector with RSDims * 110 uint8_t's
   */
-	for (j = 0; j < RSDims; j ++) {
-	   int16_t ler	= 0;
-	   for (k = 0; k < 120; k ++) 
-	      rsIn [k] = frameBytes [(base + j + k * RSDims) % (RSDims * 120)];
-//
-	   ler = my_rsDecoder. dec (rsIn, rsOut, 135);
-	   if (ler < 0)
+//	The superframe starts at base in the (circular) frameBytes,
+//	unrolled it has the layout expected by decBatch, byte k of
+//	codeword j at j + k * RSDims
+	{
+	   stageTimer	timer (STAGE_REED_SOLOMON);
+	   memcpy (rsIn. data (), &frameBytes [base], superframeSize - base);
+	   memcpy (&rsIn [superframeSize - base], frameBytes, base);
+	   if (my_rsDecoder. decBatch (rsIn. data (),
+	                               outVector. data (), RSDims, 135) < 0)
 	      return false;
-	   for (k = 0; k < 110; k ++) 
-	      outVector [j + k * RSDims] = rsOut [k];
 	}
 //
 //	OK, the result is N * 110 * 8 bits 
@@ -330,9 +324,13 @@ stream_parms	streamParameters;
 	                       &outVector [au_start [i]], aac_frame_length);
 	      memset (&theAudioUnit [aac_frame_length], 0, 10);
 
-	      int tmp = aacDecoder. MP42PCM (&streamParameters,
-	                                     theAudioUnit,
-	                                     aac_frame_length);
+	      int tmp;
+	      {
+	         stageTimer	timer (STAGE_AAC);
+	         tmp = aacDecoder. MP42PCM (&streamParameters,
+	                                    theAudioUnit,
+	                                    aac_frame_length);
+	      }
 	      err = tmp == 0;
 //	      handle_aacFrame (&outVector [au_start [i]],
 //	                       aac_frame_length,
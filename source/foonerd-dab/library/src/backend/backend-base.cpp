@@ -23,13 +23,24 @@
  */
 #include	"backend-base.h"
 
-	backendBase::backendBase (void) {
+	backendBase::backendBase (int32_t frameBits):
+	                                   packedFrame (frameBits / 8) {
 }
 
 	backendBase::~backendBase	(void) {
 }
 
 void	backendBase::addtoFrame	(uint8_t *v) {
+	for (uint32_t i = 0; i < packedFrame. size (); i ++) {
+	   uint8_t temp = 0;
+	   for (int j = 0; j < 8; j ++)
+	      temp = (temp << 1) | (v [8 * i + j] & 01);
+	   packedFrame [i] = temp;
+	}
+	addtoFramePacked (packedFrame. data ());
+}
+
+void	backendBase::addtoFramePacked	(uint8_t *v) {
 	(void)v;
 }
 
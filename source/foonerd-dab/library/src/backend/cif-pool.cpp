@@ -0,0 +1,73 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"cif-pool.h"
+
+	cifBuffer::cifBuffer	(int32_t size):
+	                                   buffer (size) {
+	refCount. store (0);
+}
+
+	cifBuffer::~cifBuffer	() {}
+
+int16_t	*cifBuffer::data	() {
+	return buffer. data ();
+}
+
+void	cifBuffer::retain	() {
+	refCount. fetch_add (1, std::memory_order_relaxed);
+}
+//
+//	the release ordering makes the reads of the consumer happen
+//	before the buffer is claimed and overwritten again
+void	cifBuffer::release	() {
+	refCount. fetch_sub (1, std::memory_order_release);
+}
+
+bool	cifBuffer::tryClaim	() {
+int32_t	expected	= 0;
+	return refCount. compare_exchange_strong (expected, 1,
+	                                          std::memory_order_acquire);
+}
+
+	cifPool::cifPool	(int16_t nrBuffers, int32_t cifSize) {
+	for (int i = 0; i < nrBuffers; i ++)
+	   buffers. push_back (new cifBuffer (cifSize));
+	next	= 0;
+}
+
+	cifPool::~cifPool	() {
+	for (auto b : buffers)
+	   delete b;
+}
+//
+//	round robin, the buffer after the one handed out last is
+//	almost always free
+cifBuffer	*cifPool::get	() {
+	for (uint32_t i = 0; i < buffers. size (); i ++) {
+	   cifBuffer *b = buffers [next];
+	   next	= (next + 1) % buffers. size ();
+	   if (b -> tryClaim ())
+	      return b;
+	}
+	return nullptr;
+}
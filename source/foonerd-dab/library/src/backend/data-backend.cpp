@@ -25,16 +25,21 @@
 #include	"data-backend.h"
 #include	"eep-protection.h"
 #include	"uep-protection.h"
+#include	"stage-timer.h"
 #include	<chrono>
 
 //
 //	fragmentsize == Length * CUSize
 	dataBackend::dataBackend	(packetdata	*d,
 	                                 API_struct	*p,
-	                                 void		*ctx):
+	                                 void		*ctx,
+	                                 servicePool	*pool):
                                          virtualBackend (d -> startAddr,
-                                                         d -> length),
-	                                 outV (24 * d -> bitRate),
+                                                         d -> length,
+	                                                 pool),
+	                                 outV (24 * d -> bitRate / 8),
+	                                 dispersal (24 * d -> bitRate),
+	                                 deinterleaver (d -> length * CUSize),
 	                                 freeSlots (20),
 	                                 our_backendBase (d -> bitRate,
 	                                                  d,
@@ -44,18 +49,11 @@
         this    -> bitRate              = d -> bitRate;
         this    -> shortForm            = d -> shortForm;
         this    -> protLevel            = d -> protLevel;
+	this	-> SId			= d -> SId;
+	this	-> subchId		= d -> subchId;
 	nextIn		= 0;
 	nextOut		= 0;
-	for (int i = 0; i < 20; i ++)
-	   theData [i] = new int16_t [fragmentSize];
-
 	tempX. resize (fragmentSize);
-	interleaveData		= new int16_t *[16]; // the size
-	for (int i = 0; i < 16; i ++) {
-	   interleaveData [i] = new int16_t [fragmentSize];
-	   memset (interleaveData [i], 0, fragmentSize * sizeof (int16_t));
-	}
-	countforInterleaver	= 0;
 //
 //	The handling of the depuncturing and deconvolution is
 //	shared with that of the audio
@@ -65,35 +63,26 @@
 	else
 	   protectionHandler	= new eep_protection (bitRate,
 	                                              protLevel);
-//
-//	any reasonable (i.e. large) size will do here,
-//	as long as the parameter is a power of 2
-	uint8_t shiftRegister [9];
-	disperseVector. resize (24 * bitRate);
-	memset (shiftRegister, 1, 9);
-	for (int i = 0; i < bitRate * 24; i ++) {
-	   uint8_t b = shiftRegister [8] ^ shiftRegister [4];
-	   for (int j = 8; j > 0; j--)
-	      shiftRegister [j] = shiftRegister [j - 1];
-	   shiftRegister [0] = b;
-	   disperseVector [i] = b;
-	}
 	running. store (false);
-	start ();
+//	with a pool, the backend is run by the workers of the pool
+	if (thePool == nullptr)
+	   start ();
+	else
+	   running. store (true);
 }
 
 	dataBackend::~dataBackend () {
-	if (running. load ()) {
-	   running. store (false);
+	running. store (false);
+	if (threadHandle. joinable ())
 	   threadHandle. join ();
-	}
 
 	delete protectionHandler;
-	for (int i = 0; i < 16; i ++)
-	   delete[] interleaveData [i];
-	delete[]	interleaveData;
-	for (int i = 0; i < 20; i ++)
-	   delete [] theData [i];
+//
+//	give back the CIF's still queued
+	while (usedSlots. tryAcquire (0)) {
+	   theData [nextOut] -> release ();
+	   nextOut = (nextOut + 1) % 20;
+	}
 }
 
 void    dataBackend::start         () {
@@ -101,62 +90,76 @@ void    dataBackend::start         () {
         threadHandle = std::thread (&dataBackend::run, this);
 }
 
-int32_t	dataBackend::process	(int16_t *v, int16_t cnt) {
-	(void)cnt;
+//
+//	the CIF is queued as is, the subchannel is taken from it
+//	while deinterleaving
+int32_t	dataBackend::process	(cifBuffer *v) {
 	while (!freeSlots. tryAcquire (200))
 	   if (!running)
 	      return 0;
-	memcpy (theData [nextIn], v, fragmentSize * sizeof (int16_t));
+	v -> retain ();
+	theData [nextIn] = v;
 	nextIn = (nextIn + 1) % 20;
 	usedSlots. Release ();
+	if (thePool != nullptr)
+	   wakeUp ();
 	return 1;
 }
 
-const   int16_t interleaveMap[] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
-
 void	dataBackend::run	() {
-int16_t	i;
-int16_t	countforInterleaver	= 0;
-int16_t interleaverIndex	= 0;
-
 	running. store (true);
 	while (running. load ()) {
 	   while (!usedSlots. tryAcquire (200))
 	      if (!running. load ())
 	         return;
+	   processSegment (theData [nextOut]);
+	}
+}
+//
+//	in the pool, handle a queued CIF, if any
+bool	dataBackend::processNext	() {
+	if (!usedSlots. tryAcquire (0))
+	   return false;
+	processSegment (theData [nextOut]);
+	return true;
+}
 
-	   for (i = 0; i < fragmentSize; i ++) {
-	      tempX [i] = interleaveData [(interleaverIndex +
-	                          interleaveMap [i & 017]) & 017][i];
-	      interleaveData [interleaverIndex][i] = theData [nextOut] [i];
-	   }
-	   nextOut = (nextOut + 1) % 20;
-	   freeSlots. Release ();
+void	dataBackend::processSegment	(cifBuffer *cif) {
+const int16_t *Data	= &(cif -> data ()) [startAddress * CUSize];
+serviceTimer	load (this);
+bool	filled;
 
-	   interleaverIndex = (interleaverIndex + 1) & 0x0F;
+	{
+	   stageTimer	timer (STAGE_MSC_DEINTERLEAVE);
+	   filled	= deinterleaver. process (Data, tempX. data ());
+	}
+	cif -> release ();
+	nextOut = (nextOut + 1) % 20;
+	freeSlots. Release ();
 
 //	only continue when de-interleaver is filled
-	   if (countforInterleaver <= 15) {
-	      countforInterleaver ++;
-	      continue;
-	   }
+	if (!filled)
+	   return;
 //
-	   protectionHandler -> deconvolve (tempX. data (),
-	                                       fragmentSize, outV. data ());
+	{
+	   stageTimer	timer (STAGE_MSC_VITERBI);
+	   protectionHandler -> deconvolvePacked (tempX. data (),
+	                                          fragmentSize,
+	                                          outV. data ());
+	}
 //
 //	and the energy dispersal
-	   for (i = 0; i < bitRate * 24; i ++)
-	      outV [i] ^= disperseVector [i];
-//	What we get here is a long sequence (24 * bitrate) of bits, not packed
-//	but forming a DAB packet
+	dispersal. apply (outV. data ());
+//	What we get here is a sequence of (24 * bitrate) bits, packed,
+//	forming a DAB packet
 //	we hand it over to make an MSC data group
-	   our_backendBase. addtoFrame (outV. data ());
-	}
+	our_backendBase. addtoFramePacked (outV. data ());
 }
 
 //	It might take a msec for the task to stop
 void	dataBackend::stopRunning () {
 	running. store (false);
-	threadHandle. join ();
+	if (threadHandle. joinable ())
+	   threadHandle. join ();
 }
 
@@ -28,6 +28,7 @@
 #include	"virtual-datahandler.h"
 #include	"mot-handler.h"
 #include	"tdc-datahandler.h"
+#include	"stage-timer.h"
 #include	"mot-handler.h"
 //#include	"adv-datahandler.h"
 //	\class dataProcessor
@@ -41,6 +42,7 @@
 	                                 packetdata	*pd,
 	                                 API_struct	*p,
 	                                 void		*ctx):
+	                                     backendBase (24 * bitRate),
 	                                     my_rsDecoder (8, 0435, 0, 1, 16) {
 	this	-> bitRate		= pd -> bitRate;
 	this	-> DSCTy		= pd -> DSCTy;
@@ -50,12 +52,14 @@
 	this	-> FEC_scheme		= pd -> FEC_scheme;
 	this	-> bytesOut		= p -> bytesOut_Handler;
 
+	frameBits. resize (24 * this -> bitRate);
 	AppVector. resize (RSDIMS * FRAMESIZE + 48);
 	FECVector. resize (9 * 22);
 	for (int i = 0; i < 9; i ++)
 	   FEC_table [i] = false;
 
 	fillPointer	= 0;
+	expected_cntidx	= 0;
 	fprintf (stderr, "** DBG: dataProcessor: appType=%d FEC=%d DSCTy=%d (", pd -> appType, FEC_scheme, pd -> DSCTy);
 	switch (DSCTy) {
 	   default:
@@ -91,20 +95,28 @@
 	delete		my_dataHandler;
 }
 
-void	dataProcessor::addtoFrame (uint8_t  *outV) {
+//
+//	The input is packed. The packet and datagroup handling is
+//	on bits, so the frame is unpacked, the RS protected packets
+//	are taken from the packed input
+void	dataProcessor::addtoFramePacked (uint8_t  *V) {
+uint8_t	*outV	= frameBits. data ();
 //	There is - obviously - some exception, that is
 //	when the DG flag is on and there are no datagroups for DSCTy5
 	if (!running. load ()) {
 	   return;
 	}
+	for (int i = 0; i < 24 * bitRate; i ++)
+	   outV [i] = (V [i >> 3] >> (7 - (i & 07))) & 01;
 	if ((this -> DSCTy == 5) &&
 	    (this -> DGflag))	// no datagroups
 	      handleTDCAsyncstream (outV, 24 * bitRate);
 	   else
-	      handlePackets (outV, 24 * bitRate);
+	      handlePackets (outV, V, 24 * bitRate);
 }
 //
-void	dataProcessor::handlePackets (uint8_t *dataL, int16_t length) {
+void	dataProcessor::handlePackets (uint8_t *dataL,
+	                              uint8_t *packed, int16_t length) {
 uint8_t *data = dataL;
 	while (running. load ()) {
 //	pLength is in bits
@@ -115,7 +127,7 @@ uint8_t *data = dataL;
 	   if (!FEC_scheme) 
 	      handlePacket (data);
 	   else
-	      handleRSPacket (data);
+	      handleRSPacket (data, packed);
 //
 //	prepare for the next round
 	   length -= pLength;
@@ -123,11 +135,11 @@ uint8_t *data = dataL;
 	      return;
 	   }
 	   data = &(data [pLength]);
+	   packed = &(packed [pLength / 8]);
 	}
 }
 
 void	dataProcessor::handlePacket (uint8_t *vec) {
-static int expected_cntidx = 0;
 	uint8_t Length	= (getBits (vec, 0, 2) + 1) * 24;
 	if (!check_CRC_bits (vec, Length * 8)) {
 //	   fprintf (stderr, "crc fails %d\n", Length);
@@ -214,7 +226,7 @@ static int expected_cntidx = 0;
 //
 //	we try to ensure that when the RS packages are read in, we
 //	have exactly RSDIMS * FRAMESIZE uint's read
-void	dataProcessor::handleRSPacket (uint8_t  *vec) {
+void	dataProcessor::handleRSPacket (uint8_t  *vec, uint8_t *packed) {
 int32_t pLength		= (getBits_2 (vec, 0) + 1) * 24;
 uint16_t address	= getBits (vec, 6, 10);
 
@@ -225,7 +237,7 @@ uint16_t address	= getBits (vec, 6, 10);
 //	with data, next 9 * 22 bytes RS data
 	if ((pLength == 24) && (address == 1022)) {	// RS packet
 	   uint8_t counter = getBits (vec, 2, 4);
-	   registerFEC (vec, counter);
+	   registerFEC (packed, counter);
 	   if ((counter == 8) && FEC_complete ()) {
 	      processRS (AppVector, FECVector);
 	      handle_RSpackets (AppVector);
@@ -235,7 +247,7 @@ uint16_t address	= getBits (vec, 6, 10);
 	}
 	else {
 //	addPacket checks the size and sets fillPointer to 0 if erroneous
-	   fillPointer = addPacket (vec, AppVector, fillPointer);
+	   fillPointer = addPacket (packed, AppVector, fillPointer);
 	}
 }
 
@@ -244,28 +256,20 @@ void	dataProcessor::clear_FECtable () {
 	   FEC_table [i] = false;
 }
 //
-//	addPacket basically packs the sequence of bits into a sequence
-//	of bytes, for processing by the RS decoder
+//	addPacket appends the (packed) packet to the sequence
+//	of bytes for processing by the RS decoder
 //	Of course, we check for overflow
 int	dataProcessor::addPacket (uint8_t *vec,
 	                          std::vector<uint8_t> &theBuffer,
 	                          int fillPointer) {
-	int16_t	packetLength	= (getBits_2 (vec, 0) + 1) * 24;
+	int16_t	packetLength	= ((vec [0] >> 6) + 1) * 24;
 //	Assert theBuffer. size () == RDIMS * FRAMESIZE + 48
 	if ((uint32_t)fillPointer + packetLength > theBuffer. size ()) {
 	   clear_FECtable ();
 	   return 0;
 	}
 
-	for (int i = 0; i < packetLength; i ++) {
-	   uint8_t temp = 0;
-	   for (int j = 0; j < 8; j ++)
-	      temp = (temp << 1) | (vec [i * 8 + j] == 0 ? 0 : 1);
-	   if ((uint32_t)fillPointer + i >= theBuffer. size ())
-	      fprintf (stderr, "%d is too large\n", fillPointer + i);
-	   else
-	   theBuffer [fillPointer + i] = temp;
-	}
+	memcpy (&theBuffer [fillPointer], vec, packetLength);
 	return fillPointer + packetLength;
 }
 //
@@ -304,15 +308,11 @@ std::vector<uint8_t> bitData (packetLength * 8);
 //	as it tuns out, the FEC data packages are arriving in order,
 //	so it would have been sufficient just to wait until the
 //	package with counter '8' was seen
+//	vec is the packed packet, the RS data follows the 2 byte header
 void	dataProcessor::registerFEC (uint8_t *vec, int cnt) {
 	if (cnt < 0 || cnt > 8)
 	   return;		// garbage data
-	for (int i = 0; i < 22; i ++) {
-	   uint8_t temp = 0;
-	   for (int j = 0; j < 8; j ++)
-	      temp = (temp << 1) | vec [16 + 8 * i + j];
-	   FECVector [cnt * 22 + i] = temp;
-	}
+	memcpy (&FECVector [cnt * 22], &vec [2], 22);
 	FEC_table [cnt] = true;
 }
 
@@ -352,29 +352,17 @@ int16_t	usefulLength	= getBits_7 (data, 17);
 //
 void	dataProcessor::processRS (std::vector<uint8_t> &appData,
 	                          const std::vector<uint8_t> &RSdata) {
-static
-uint8_t table [RSDIMS][FRAMESIZE + 16];
-uint8_t rsOut	[FRAMESIZE];
 	if (!running. load ())
 	   return;
+stageTimer	timer (STAGE_REED_SOLOMON);
 //	Assert appdata . size () == RSDIMS * FRAMESIZE + 48
 //	Assert RSdata. size () == 9 * 22;
-	for (int i = 0; i < RSDIMS * FRAMESIZE; i ++)
-	   table [i % RSDIMS][i / RSDIMS] = appData [i];
-	for (int i = 0; i <  (int)(RSdata. size ()); i ++)
-	   table [i % RSDIMS] [FRAMESIZE + i / RSDIMS] = RSdata [i];
-
-	for (int i = 0; i < RSDIMS; i ++) {
-	   int xx = my_rsDecoder. dec (table [i], rsOut, 51);
-	   (void)xx;
-//	   fprintf (stderr, "rs decoder says %d\n", xx);
-	   for (int j = 0; j < FRAMESIZE; j ++)
-	      table [i][j] = rsOut [j];
-	}
-//
-//	copy the table back to the vector
-	for (int i = 0; i < RSDIMS * FRAMESIZE; i ++)
-	   appData [i] = table [i % RSDIMS][i / RSDIMS];
+//	the app data followed by the RS data is the layout decBatch
+//	expects, byte k of codeword i at i + k * RSDIMS. Of the 9 * 22
+//	RS data bytes only RSDIMS * 16 are parity, the rest is padding
+	memcpy (table, appData. data (), RSDIMS * FRAMESIZE);
+	memcpy (&table [RSDIMS * FRAMESIZE], RSdata. data (), RSDIMS * 16);
+	my_rsDecoder. decBatch (table, appData. data (), RSDIMS, 51);
 }
 
 
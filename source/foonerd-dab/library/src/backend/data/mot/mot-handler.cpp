@@ -26,12 +26,7 @@
 #include	"mot-dir.h"
 //
 //	we "cache" the most recent single motSlides (not those in a directory)
-//
-struct {
-	uint16_t	transportId;
-	int32_t		orderNumber;
-	motObject	*motSlide;
-} motTable [15];
+//	in the motTable, which is part of the handler instance
 
 	motHandler::motHandler (motdata_t motdataHandler,
 	                        void	*ctx) {
@@ -48,7 +43,7 @@ struct {
 int	i;
 
 	for (i = 0; i < 15; i ++)
-	   if (motTable [i]. orderNumber > 0)
+	   if (motTable [i]. orderNumber >= 0)
 	      delete motTable [i]. motSlide;
 	if (theDirectory != nullptr)
 	   delete theDirectory;
@@ -48,6 +48,12 @@
 	currentSlide	= nullptr;
 	dynamicLabelText. clear ();
 //
+//	state of the dynamic label assembler
+	segmentno	= 0;
+	remainDataLength	= 0;
+	isLastSegment	= false;
+	moreXPad	= false;
+//
 //	DL Plus state initialization
 	dlPlusNumTags	= 0;
 	dlPlusItemToggle = false;
@@ -373,10 +379,6 @@ void	padHandler::handleDLPlusCommand (uint8_t *data, int16_t length) {
 //	A dynamic label is created from a sequence of (dynamic) xpad
 //	fields, starting with CI = 2, continuing with CI = 3
 void	padHandler::dynamicLabel (uint8_t *data, int16_t length, uint8_t CI) {
-static int16_t segmentno           = 0;
-static int16_t remainDataLength    = 0;
-static bool    isLastSegment       = false;
-static bool moreXPad	= false;
 int16_t  dataLength	= 0;
 
 	(void)segmentno;
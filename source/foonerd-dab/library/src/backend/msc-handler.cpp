@@ -36,15 +36,21 @@
 
 #define	CUSize	(4 * 16)
 //	Note CIF counts from 0 .. 3
-
-static
-int16_t	cifVector [55296];
+//
+//	The CIF's are collected in buffers from a pool, part of the
+//	handler, several dabProcessor instances may run in a single
+//	process. A completed CIF is passed - without copying - to all
+//	backends. A backend queues at most 20 CIF's, and all backends
+//	get the same CIF's, so 20 buffers are in use by the backends,
+//	one is being filled, one extra for safety
+#define	CIF_BUFFERS	(20 + 2)
 
 static int blocksperCIF [] = {18, 72, 0, 36};
 
 		mscHandler::mscHandler	(API_struct	*p,
 	                                 void		*userData):
-	                                    params (p -> dabMode) {
+	                                    params (p -> dabMode),
+	                                    thePool (CIF_BUFFERS, 55296) {
 	this	-> p			= p;
 	this	-> soundOut		= p -> audioOut_Handler;
 	this	-> dataOut		= p -> dataOut_Handler;
@@ -52,7 +58,8 @@ static int blocksperCIF [] = {18, 72, 0, 36};
 	this	-> programQuality	= p -> program_quality_Handler;
 	this	-> motdata_Handler	= p -> motdata_Handler;
 	this	-> userData		= userData;
-//	cifVector. resize (55296);
+	currentCIF		= nullptr;
+	workerPool		= nullptr;
 	cifCount		= 0;	// msc blocks in CIF
 	theBackends. push_back (new virtualBackend (0, 0));
 	BitsperBlock		= 2 * params. get_carriers ();
@@ -64,10 +71,21 @@ static int blocksperCIF [] = {18, 72, 0, 36};
 }
 
 	mscHandler::~mscHandler	() {
+//	the backends may still hold CIF's from the pool
+	stop ();
+	if (currentCIF != nullptr)
+	   currentCIF -> release ();
 }
 
+//
+//	the workers of the pool may be running a backend, so the pool
+//	is stopped before the backends are deleted
 void	mscHandler::stop () {
 	locker. lock ();
+	if (workerPool != nullptr) {
+	   delete workerPool;
+	   workerPool	= nullptr;
+	}
 	for (auto const &b : theBackends) {
 	   b -> stopRunning ();
 	   delete b;
@@ -96,52 +114,76 @@ void	mscHandler::reset	() {
 //	the actual changing of the settings is done in the
 //	thread executing process_mscBlock
 void	mscHandler::set_audioChannel (audiodata &d) {
+	set_audioChannel (d, userData);
+}
+
+void	mscHandler::set_dataChannel (packetdata &d) {
+	set_dataChannel (d, userData);
+}
+
+void	mscHandler::set_audioChannel (audiodata &d, void *ctx) {
 	locker. lock ();
-//
-//	we could assert here that theBackend == nullptr
-	theBackends. push_back (new audioBackend (&d, p, userData));
+	theBackends. push_back (new audioBackend (&d, p, ctx, workerPool));
 	work_to_do. store (true);
 	locker. unlock ();
 }
 
-void	mscHandler::set_dataChannel (packetdata &d) {
+void	mscHandler::set_dataChannel (packetdata &d, void *ctx) {
 	locker. lock ();
-	theBackends. push_back (new dataBackend (&d, p, userData));
+	theBackends. push_back (new dataBackend (&d, p, ctx, workerPool));
 	work_to_do. store (true);
 	locker. unlock ();
 }
 
+void	mscHandler::set_servicePool	(int nrWorkers) {
+	locker. lock ();
+	if (workerPool == nullptr)
+	   workerPool	= new servicePool (nrWorkers);
+	locker. unlock ();
+}
+
+int	mscHandler::get_serviceStats	(serviceStats *st, int max) {
+int	n	= 0;
+	locker. lock ();
+	for (auto const &b : theBackends) {
+	   if (n >= max)
+	      break;
+	   if (b -> Length () > 0)
+	      b -> getStats (&st [n ++]);
+	}
+	locker. unlock ();
+	return n;
+}
+
 void	mscHandler::process_mscBlock	(std::vector<int16_t> &fbits,
 	                                 int16_t blkno) { 
 int16_t	currentblk;
 
 //	we accept the incoming data
 	currentblk	= (blkno - 4) % numberofblocksperCIF;
-	memcpy (&cifVector [currentblk * BitsperBlock],
+	if (currentCIF == nullptr) {
+	   currentCIF	= thePool. get ();
+	   if (currentCIF == nullptr) {		// should not happen
+	      fprintf (stderr, "no free CIF buffer\n");
+	      return;
+	   }
+	}
+	memcpy (&(currentCIF -> data ()) [currentblk * BitsperBlock],
 	                    fbits. data (), BitsperBlock * sizeof (int16_t));
 	if (currentblk < numberofblocksperCIF - 1) 
 	   return;
 
 	if (!work_to_do. load ())
 	   return;
-//	OK, now we have a full CIF
+//	OK, now we have a full CIF, the backends that queue it
+//	retain it, we give up our reference
 	locker. lock ();
 	cifCount	= (cifCount + 1) & 03;
-	for (auto const& b: theBackends) {
-	   int startAddr	= b -> startAddr ();
-	   int Length		= b -> Length    ();
-
-	   if (Length > 0) {
-#ifdef _MSC_VER
-	      int16_t *myBegin = (int16_t *)_alloca((Length * CUSize) * sizeof(int16_t));
-#else
-	      int16_t myBegin [Length * CUSize];
-#endif
-	      memcpy (myBegin, &cifVector [startAddr * CUSize],
-	                               Length * CUSize * sizeof (int16_t));
-	      (void) b -> process (myBegin, Length * CUSize);
-	   }
-	}
+	for (auto const& b: theBackends)
+	   if (b -> Length () > 0)
+	      (void) b -> process (currentCIF);
 	locker. unlock ();
+	currentCIF -> release ();
+	currentCIF	= nullptr;
 }
 
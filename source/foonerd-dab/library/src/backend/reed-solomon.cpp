@@ -10,6 +10,14 @@
 #ifdef _MSC_VER
 #include	<malloc.h>
 #endif
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define	X86_KERNELS
+#include	<immintrin.h>
+#endif
+#if defined (__aarch64__)
+#define	NEON_KERNELS
+#include	<arm_neon.h>
+#endif
 
 /*
  *	Reed-Solomon decoder
@@ -76,6 +84,22 @@ int i, j, root, iprim;
 	}
 	for (i = 0; i <= nroots; i ++)
 	   generator [i] = myGalois. poly2power (generator [i]);
+//
+//	for the batch decoder: the syndromes are evaluated with Horner,
+//	multiplying with the root (as in getSyndrome) in each step.
+//	c * x is computed as c * (x & 0xF) ^ c * (x & 0xF0), i.e. with
+//	two tables of 16 entries, small enough for a vector shuffle
+	mulTables. resize (32 * nroots);
+	for (i = 0; i < nroots; i ++) {
+	   uint16_t root = myGalois. power2poly (
+	                      myGalois. pow_power (
+	                         myGalois. multiply_power (fcr, i), prim));
+	   for (j = 0; j < 16; j ++) {
+	      mulTables [32 * i + j]	  = myGalois. multiply_poly (root, j);
+	      mulTables [32 * i + 16 + j] = myGalois. multiply_poly (root, j << 4);
+	   }
+	}
+	setKernel (RS_AUTO);
 }
 
 	reedSolomon::~reedSolomon	() {
@@ -157,12 +181,24 @@ int16_t	ret;
 int16_t	reedSolomon::decode_rs (uint8_t *data) {
 #ifdef _MSC_VER
 uint8_t *syndromes = (uint8_t *)_alloca(nroots);
+#else
+uint8_t syndromes [nroots];
+#endif
+//
+//	returning syndromes in poly
+	if (computeSyndromes (data, syndromes))
+	   return 0;
+	return correct (data, syndromes);
+}
+//
+//	the error correction, given the (non zero) syndromes
+int16_t	reedSolomon::correct (uint8_t *data, uint8_t *syndromes) {
+#ifdef _MSC_VER
 uint8_t *Lambda	   = (uint8_t *)_alloca(nroots + 1);
 uint8_t	*rootTable = (uint8_t *)_alloca(nroots);
 uint8_t	*locTable  = (uint8_t *)_alloca(nroots);
 uint8_t	*omega     = (uint8_t *)_alloca(nroots + 1);
 #else
-uint8_t syndromes [nroots];
 uint8_t Lambda	  [nroots + 1];
 uint8_t	rootTable [nroots];
 uint8_t	locTable  [nroots];
@@ -171,10 +207,6 @@ uint8_t	omega	  [nroots + 1];
 uint16_t lambda_degree, omega_degree;
 int16_t	rootCount;
 int16_t	i;
-//
-//	returning syndromes in poly
-	if (computeSyndromes (data, syndromes))
-	   return 0;
 //	Step 2: Berlekamp-Massey
 //	Lambda in power notation
 	lambda_degree = computeLambda (syndromes, Lambda);
@@ -306,7 +338,9 @@ int16_t	deg_lambda	= 0;
 	Lambda	[0]	= 1;
 	Corrector [1]	= 1;
 //
-	while (K < nroots) {
+//	nroots steps, one per syndrome, the last one was skipped before,
+//	limiting the correction to (nroots - 1) / 2 errors
+	while (K <= nroots) {
 #ifdef _MSC_VER
 	   uint8_t *oldLambda = (uint8_t *)_alloca(nroots);
 #else
@@ -331,11 +365,13 @@ int16_t	deg_lambda	= 0;
 	   Corrector [0] = 0;
 
 //	and compute a new error
-	   error	= syndromes [K];	
-	   for (i = 1; i <= K; i ++)  {
-	      error = myGalois. add_poly (error,
+	   if (K < nroots) {
+	      error	= syndromes [K];
+	      for (i = 1; i <= K; i ++)  {
+	         error = myGalois. add_poly (error,
 	                           myGalois. multiply_poly (syndromes [K - i],
 	                                                     Lambda [i]));
+	      }
 	   }
 	   K += 1;
  	} // end of Berlekamp loop
@@ -428,3 +464,244 @@ int16_t	deg_omega = 0;
 	return deg_omega;
 }
 
+//
+//	The syndrome kernels for the batch decoder. The codewords are
+//	in work, symbol k of codeword j at work [k * stride + j], stride
+//	being a multiple of 32, the syndromes are written to
+//	syndromes [i * stride + j]. The vector versions take 16 (32)
+//	codewords at a time, and update up to 16 syndromes per symbol,
+//	all independent
+static
+void	syndromes_scalar	(const uint8_t *work, int stride, int length,
+	                         int nroots, const uint8_t *mulTables,
+	                         uint8_t *syndromes) {
+	for (int i = 0; i < nroots; i ++) {
+	   const uint8_t *lo	= &mulTables [32 * i];
+	   const uint8_t *hi	= lo + 16;
+	   uint8_t *syn		= &syndromes [i * stride];
+	   memcpy (syn, work, stride);
+	   for (int k = 1; k < length; k ++) {
+	      const uint8_t *row	= &work [k * stride];
+	      for (int j = 0; j < stride; j ++)
+	         syn [j] = lo [syn [j] & 0x0F] ^ hi [syn [j] >> 4] ^ row [j];
+	   }
+	}
+}
+
+#ifdef	X86_KERNELS
+__attribute__ ((target ("ssse3")))
+static
+void	syndromes_ssse3		(const uint8_t *work, int stride, int length,
+	                         int nroots, const uint8_t *mulTables,
+	                         uint8_t *syndromes) {
+const __m128i	mask	= _mm_set1_epi8 (0x0F);
+__m128i	syn [16];
+
+	for (int i0 = 0; i0 < nroots; i0 += 16) {
+	   int n	= nroots - i0 < 16 ? nroots - i0 : 16;
+	   const uint8_t *tables	= &mulTables [32 * i0];
+	   for (int j = 0; j < stride; j += 16) {
+	      __m128i first	= _mm_loadu_si128 ((const __m128i *)&work [j]);
+	      for (int i = 0; i < n; i ++)
+	         syn [i] = first;
+	      for (int k = 1; k < length; k ++) {
+	         __m128i row	=
+	               _mm_loadu_si128 ((const __m128i *)&work [k * stride + j]);
+	         for (int i = 0; i < n; i ++) {
+	            __m128i lo	=
+	               _mm_loadu_si128 ((const __m128i *)&tables [32 * i]);
+	            __m128i hi	=
+	               _mm_loadu_si128 ((const __m128i *)&tables [32 * i + 16]);
+	            __m128i x	= syn [i];
+	            syn [i] = _mm_xor_si128 (
+	                         _mm_xor_si128 (
+	                            _mm_shuffle_epi8 (lo, _mm_and_si128 (x, mask)),
+	                            _mm_shuffle_epi8 (hi, _mm_and_si128 (
+	                                        _mm_srli_epi16 (x, 4), mask))),
+	                         row);
+	         }
+	      }
+	      for (int i = 0; i < n; i ++)
+	         _mm_storeu_si128 ((__m128i *)&syndromes [(i0 + i) * stride + j],
+	                           syn [i]);
+	   }
+	}
+}
+
+__attribute__ ((target ("avx2")))
+static
+void	syndromes_avx2		(const uint8_t *work, int stride, int length,
+	                         int nroots, const uint8_t *mulTables,
+	                         uint8_t *syndromes) {
+const __m256i	mask	= _mm256_set1_epi8 (0x0F);
+__m256i	syn [16];
+
+	for (int i0 = 0; i0 < nroots; i0 += 16) {
+	   int n	= nroots - i0 < 16 ? nroots - i0 : 16;
+	   const uint8_t *tables	= &mulTables [32 * i0];
+	   for (int j = 0; j < stride; j += 32) {
+	      __m256i first	= _mm256_loadu_si256 ((const __m256i *)&work [j]);
+	      for (int i = 0; i < n; i ++)
+	         syn [i] = first;
+	      for (int k = 1; k < length; k ++) {
+	         __m256i row	= _mm256_loadu_si256 (
+	                              (const __m256i *)&work [k * stride + j]);
+	         for (int i = 0; i < n; i ++) {
+//	the shuffles work per 128 bit lane, both lanes get the tables
+	            __m256i lo	= _mm256_broadcastsi128_si256 (
+	                _mm_loadu_si128 ((const __m128i *)&tables [32 * i]));
+	            __m256i hi	= _mm256_broadcastsi128_si256 (
+	                _mm_loadu_si128 ((const __m128i *)&tables [32 * i + 16]));
+	            __m256i x	= syn [i];
+	            syn [i] = _mm256_xor_si256 (
+	                         _mm256_xor_si256 (
+	                            _mm256_shuffle_epi8 (lo,
+	                                        _mm256_and_si256 (x, mask)),
+	                            _mm256_shuffle_epi8 (hi,
+	                                        _mm256_and_si256 (
+	                                        _mm256_srli_epi16 (x, 4), mask))),
+	                         row);
+	         }
+	      }
+	      for (int i = 0; i < n; i ++)
+	         _mm256_storeu_si256 (
+	                  (__m256i *)&syndromes [(i0 + i) * stride + j], syn [i]);
+	   }
+	}
+}
+#endif
+
+#ifdef	NEON_KERNELS
+static
+void	syndromes_neon		(const uint8_t *work, int stride, int length,
+	                         int nroots, const uint8_t *mulTables,
+	                         uint8_t *syndromes) {
+const uint8x16_t	mask	= vdupq_n_u8 (0x0F);
+uint8x16_t	syn [16];
+
+	for (int i0 = 0; i0 < nroots; i0 += 16) {
+	   int n	= nroots - i0 < 16 ? nroots - i0 : 16;
+	   const uint8_t *tables	= &mulTables [32 * i0];
+	   for (int j = 0; j < stride; j += 16) {
+	      uint8x16_t first	= vld1q_u8 (&work [j]);
+	      for (int i = 0; i < n; i ++)
+	         syn [i] = first;
+	      for (int k = 1; k < length; k ++) {
+	         uint8x16_t row	= vld1q_u8 (&work [k * stride + j]);
+	         for (int i = 0; i < n; i ++) {
+	            uint8x16_t lo	= vld1q_u8 (&tables [32 * i]);
+	            uint8x16_t hi	= vld1q_u8 (&tables [32 * i + 16]);
+	            uint8x16_t x	= syn [i];
+	            syn [i] = veorq_u8 (
+	                         veorq_u8 (vqtbl1q_u8 (lo, vandq_u8 (x, mask)),
+	                                   vqtbl1q_u8 (hi, vshrq_n_u8 (x, 4))),
+	                         row);
+	         }
+	      }
+	      for (int i = 0; i < n; i ++)
+	         vst1q_u8 (&syndromes [(i0 + i) * stride + j], syn [i]);
+	   }
+	}
+}
+#endif
+
+int16_t	reedSolomon::decBatch	(const uint8_t *in, uint8_t *out,
+	                         int16_t count, int16_t cutlen) {
+int	length		= codeLength - cutlen;	// symbols per codeword
+int	dataLength	= length - nroots;
+int	stride		= (count + 31) & ~31;
+int16_t	corrected	= 0;
+bool	failed		= false;
+#ifdef _MSC_VER
+uint8_t *rf	= (uint8_t *)_alloca(codeLength);
+uint8_t *syn	= (uint8_t *)_alloca(nroots);
+#else
+uint8_t rf	[codeLength];
+uint8_t	syn	[nroots];
+#endif
+
+	if (work. size () < (size_t)(length * stride)) {
+	   work. resize (length * stride);
+	   batchSyndromes. resize (nroots * stride);
+	}
+	for (int k = 0; k < length; k ++)
+	   memcpy (&work [k * stride], &in [k * count], count);
+	syndromeKernel (work. data (), stride, length, nroots,
+	                mulTables. data (), batchSyndromes. data ());
+//
+//	only codewords with errors are handed to the
+//	(Berlekamp-Massey, Chien, Forney) corrector
+	memset (rf, 0, cutlen * sizeof (rf [0]));
+	for (int j = 0; j < count; j ++) {
+	   uint8_t synError	= 0;
+	   for (int i = 0; i < nroots; i ++) {
+	      syn [i]	= batchSyndromes [i * stride + j];
+	      synError	|= syn [i];
+	   }
+	   if (synError == 0)
+	      continue;
+	   for (int k = 0; k < length; k ++)
+	      rf [cutlen + k] = work [k * stride + j];
+	   int16_t res	= correct (rf, syn);
+	   if (res < 0)
+	      failed = true;
+	   else
+	      corrected += res;
+	   for (int k = 0; k < dataLength; k ++)
+	      work [k * stride + j] = rf [cutlen + k];
+	}
+	for (int k = 0; k < dataLength; k ++)
+	   memcpy (&out [k * count], &work [k * stride], count);
+	return failed ? -1 : corrected;
+}
+
+bool	reedSolomon::setKernel	(int kernel) {
+	switch (kernel) {
+	   case RS_AUTO:
+#ifdef	X86_KERNELS
+	      if (__builtin_cpu_supports ("avx2"))
+	         return setKernel (RS_AVX2);
+	      if (__builtin_cpu_supports ("ssse3"))
+	         return setKernel (RS_SSSE3);
+#endif
+#ifdef	NEON_KERNELS
+	      return setKernel (RS_NEON);
+#endif
+	      return setKernel (RS_SCALAR);
+
+	   case RS_SCALAR:
+	      syndromeKernel	= syndromes_scalar;
+	      break;
+#ifdef	X86_KERNELS
+	   case RS_SSSE3:
+	      if (!__builtin_cpu_supports ("ssse3"))
+	         return false;
+	      syndromeKernel	= syndromes_ssse3;
+	      break;
+
+	   case RS_AVX2:
+	      if (!__builtin_cpu_supports ("avx2"))
+	         return false;
+	      syndromeKernel	= syndromes_avx2;
+	      break;
+#endif
+#ifdef	NEON_KERNELS
+	   case RS_NEON:
+	      syndromeKernel	= syndromes_neon;
+	      break;
+#endif
+	   default:
+	      return false;
+	}
+	kernelType	= kernel;
+	return true;
+}
+
+const char	*reedSolomon::kernelName	() {
+	switch (kernelType) {
+	   case RS_SSSE3:	return "ssse3";
+	   case RS_AVX2:	return "avx2";
+	   case RS_NEON:	return "neon";
+	   default:		return "scalar";
+	}
+}
@@ -0,0 +1,112 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"service-pool.h"
+#include	"virtual-backend.h"
+#include	<chrono>
+
+	servicePool::servicePool	(int nrWorkers) {
+	if (nrWorkers <= 0)
+	   nrWorkers	= std::thread::hardware_concurrency ();
+	if (nrWorkers <= 0)
+	   nrWorkers	= 1;
+	queued. store (0);
+	nextQueue. store (0);
+	running. store (true);
+	for (int i = 0; i < nrWorkers; i ++)
+	   queues. push_back (new taskQueue);
+	for (int i = 0; i < nrWorkers; i ++)
+	   workers. push_back (std::thread (&servicePool::run, this, i));
+}
+
+//
+//	tasks still queued are dropped, the backends are deleted
+//	by the mscHandler after the pool
+	servicePool::~servicePool	() {
+	running. store (false);
+	{  std::unique_lock<std::mutex> lck (sleepLock);
+	   wakeUp. notify_all ();
+	}
+	for (auto &w : workers)
+	   w. join ();
+	for (auto q : queues)
+	   delete q;
+}
+
+int	servicePool::nrWorkers	() {
+	return workers. size ();
+}
+//
+//	schedule is called from the thread executing process_mscBlock,
+//	the tasks are spread round robin over the queues
+void	servicePool::schedule	(virtualBackend *b) {
+taskQueue *q	= queues [nextQueue. fetch_add (1) % queues. size ()];
+
+	q -> lock. lock ();
+	q -> tasks. push_back (b);
+	q -> lock. unlock ();
+	queued. fetch_add (1);
+	std::unique_lock<std::mutex> lck (sleepLock);
+	wakeUp. notify_one ();
+}
+//
+//	a worker takes the oldest task from its own queue, if that is
+//	empty it steals the newest task from one of the other queues
+virtualBackend	*servicePool::getTask	(int self) {
+int	n	= queues. size ();
+
+	for (int i = 0; i < n; i ++) {
+	   taskQueue *q	= queues [(self + i) % n];
+	   virtualBackend *b	= nullptr;
+	   q -> lock. lock ();
+	   if (!q -> tasks. empty ()) {
+	      if (i == 0) {
+	         b = q -> tasks. front ();
+	         q -> tasks. pop_front ();
+	      }
+	      else {
+	         b = q -> tasks. back ();
+	         q -> tasks. pop_back ();
+	      }
+	   }
+	   q -> lock. unlock ();
+	   if (b != nullptr) {
+	      queued. fetch_sub (1);
+	      return b;
+	   }
+	}
+	return nullptr;
+}
+
+void	servicePool::run	(int self) {
+	while (running. load ()) {
+	   virtualBackend *b	= getTask (self);
+	   if (b != nullptr) {
+	      b -> runTask ();
+	      continue;
+	   }
+	   std::unique_lock<std::mutex> lck (sleepLock);
+	   wakeUp. wait_for (lck, std::chrono::milliseconds (100),
+	                     [this] { return (queued. load () > 0) ||
+	                                     !running. load (); });
+	}
+}
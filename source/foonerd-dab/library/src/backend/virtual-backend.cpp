@@ -25,18 +25,32 @@
 //
 #include	"dab-constants.h"
 #include	"virtual-backend.h"
+#include	"service-pool.h"
+#ifdef	_MSC_VER
+#include	<windows.h>
+#else
+#include	<time.h>
+#endif
 
-        virtualBackend::virtualBackend  (int16_t a, int16_t l) {
+        virtualBackend::virtualBackend  (int16_t a, int16_t l,
+	                                 servicePool *pool) {
         startAddress    = a;
         segmentLength   = l;
+	SId		= 0;
+	subchId		= -1;
+	isAudio		= false;
+	thePool		= pool;
+	scheduled. store (false);
+	pending. store (0);
+	segments. store (0);
+	cpuNs. store (0);
 }
 
         virtualBackend::~virtualBackend (void) {
 }
 
-int32_t virtualBackend::process (int16_t *v, int16_t c) {
+int32_t virtualBackend::process (cifBuffer *v) {
         (void)v;
-        (void)c;
         return 32768;
 }
 
@@ -55,4 +69,60 @@ void    virtualBackend::stopRunning     (void) {
 void    virtualBackend::stop    (void) {
 }
 
+bool	virtualBackend::processNext	() {
+	return false;
+}
+//
+//	wakeUp is called after a CIF is queued. The backend is
+//	scheduled only if it is not scheduled (or running) already,
+//	runTask - after handling all CIF's - checks again, so no CIF
+//	is left behind
+void	virtualBackend::wakeUp	() {
+	pending. fetch_add (1);
+	if (!scheduled. exchange (true))
+	   thePool -> schedule (this);
+}
+
+void	virtualBackend::runTask	() {
+	do {
+	   while (processNext ())
+	      pending. fetch_sub (1);
+	   scheduled. store (false);
+	} while ((pending. load () > 0) && !scheduled. exchange (true));
+}
+
+void	virtualBackend::getStats	(serviceStats *st) {
+	st -> SId	= SId;
+	st -> subchId	= subchId;
+	st -> isAudio	= isAudio;
+	st -> segments	= segments. load ();
+	st -> cpuNs	= cpuNs. load ();
+}
+
+static
+uint64_t	threadCpuNs	() {
+#ifdef	_MSC_VER
+FILETIME	creation, exit, kernel, user;
+	GetThreadTimes (GetCurrentThread (), &creation, &exit, &kernel, &user);
+	return ((((uint64_t)kernel. dwHighDateTime << 32) |
+	                                      kernel. dwLowDateTime) +
+	        (((uint64_t)user. dwHighDateTime << 32) |
+	                                      user. dwLowDateTime)) * 100;
+#else
+struct timespec	ts;
+	clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts. tv_sec * 1000000000 + ts. tv_nsec;
+#endif
+}
+
+	serviceTimer::serviceTimer	(virtualBackend *b) {
+	theBackend	= b;
+	startTime	= threadCpuNs ();
+}
+
+	serviceTimer::~serviceTimer	() {
+	theBackend -> cpuNs. fetch_add (threadCpuNs () - startTime);
+	theBackend -> segments. fetch_add (1);
+}
+
 
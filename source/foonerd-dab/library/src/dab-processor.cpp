@@ -24,6 +24,7 @@
 #include	"device-handler.h"
 #include	"timesyncer.h"
 #include	"dab-api.h"
+#include	"stage-timer.h"
 
 /**
   *	\brief dabProcessor
@@ -67,6 +68,9 @@
 	this	-> carrierDiff		= params. get_carrierDiff ();
 	this	-> tii_counter		= 0;
 	this	-> threshold		= p -> thresholdValue;
+	this	-> my_pipeline		= nullptr;
+	this	-> batchFFT		= false;
+	framesDecoded. store (0);
 	isSynced			= false;
 	snr				= 0;
 	running. store (false);
@@ -74,11 +78,15 @@
 
 	dabProcessor::~dabProcessor	() {
 	stop ();
+	if (my_pipeline != nullptr)
+	   delete my_pipeline;
 }
 
 void	dabProcessor::start		() {
 	if (running. load ())
 	   return;
+	if (my_pipeline != nullptr)
+	   my_pipeline -> start ();
 	threadHandle	= std::thread (&dabProcessor::run, this);
 }
 
@@ -101,6 +109,7 @@ std::vector<complex<float>>	ofdmBuffer (T_null);
 int		dip_attempts		= 0;
 int		index_attempts		= 0;
 int		startIndex		= -1;
+int		syncResult;
 
 	isSynced	= false;
 	snr		= 0;
@@ -110,14 +119,19 @@ int		startIndex		= -1;
 
 	try {
 	   myReader. reset ();
-	   for (i = 0; i < T_F / 2; i ++) {
-	     (void)jan_abs (myReader. getSample (0));
+	   for (i = 0; i < T_F / 2; i += T_null) {
+	      int amount = T_F / 2 - i < T_null ? T_F / 2 - i : T_null;
+	      myReader. getSamples (ofdmBuffer. data (), amount, 0);
 	   }
 
 notSynced:
 //Initing:
 	   my_TII_Detector. reset ();
-	   switch (myTimeSyncer. sync (T_null, T_F)) {
+	   {
+	      stageTimer timer (STAGE_TIME_SYNC);
+	      syncResult	= myTimeSyncer. sync (T_null, T_F);
+	   }
+	   switch (syncResult) {
 	      case TIMESYNC_ESTABLISHED:
 	         break;                 // yes, we are ready
 
@@ -136,8 +150,11 @@ notSynced:
 	   myReader. getSamples (ofdmBuffer. data (),
 	                         T_u, coarseOffset + fineOffset);
 
-	   startIndex = phaseSynchronizer.
+	   {
+	      stageTimer timer (STAGE_TIME_SYNC);
+	      startIndex = phaseSynchronizer.
 	                        findIndex (ofdmBuffer. data (), THRESHOLD);
+	   }
 	   if (startIndex < 0) { // no sync, try again
 	      isSynced	= false;
 	      if (++index_attempts > 25) {
@@ -156,9 +173,11 @@ Check_endofNull:
 
 	   myReader. getSamples (ofdmBuffer. data (),
 	                      T_u, coarseOffset + fineOffset);
-	   startIndex =
-			phaseSynchronizer.
+	   {
+	      stageTimer timer (STAGE_TIME_SYNC);
+	      startIndex = phaseSynchronizer.
 	                         findIndex (ofdmBuffer. data (), 4 * THRESHOLD);
+	   }
 	   if (startIndex < 0) { // no sync, try again
 	      isSynced	= false;
 	      if (++index_attempts > 5) {
@@ -215,10 +234,49 @@ SyncOnPhase:
 	   std::vector<int16_t> ibits (2 * params. get_carriers ());
 	   for (int ofdmSymbolCount = 1;
 	        ofdmSymbolCount < (uint16_t)nrBlocks; ofdmSymbolCount ++) {	
-	      myReader. getSamples (ofdmBuffer. data (),
+	      std::complex<float> *symbol	= ofdmBuffer. data ();
+	      bool inPipeline	= (my_pipeline != nullptr) &&
+	                                         (ofdmSymbolCount >= 3);
+	      bool inFrame	= !inPipeline && batchFFT &&
+	                                         (ofdmSymbolCount >= 4);
+//
+//	With a pipeline, the MSC blocks (and block 3, being their
+//	phase reference) are read straight into a pipeline slot,
+//	in batch mode the MSC blocks are collected in the frame buffer
+	      if (inPipeline) {
+	         symbol	= my_pipeline -> getBuffer ();
+	         if (symbol == nullptr)
+	            throw (21);
+	      }
+	      else
+	      if (inFrame)
+	         symbol	= &(my_ofdmDecoder. getFrameBuffer ())
+	                                   [(ofdmSymbolCount - 4) * T_s];
+	      myReader. getSamples (symbol,
 	                               T_s, coarseOffset + fineOffset);
 	      for (i = (int)T_u; i < (int)T_s; i ++) 
-	         FreqCorr += ofdmBuffer [i] * conj (ofdmBuffer [i - T_u]);
+	         FreqCorr += symbol [i] * conj (symbol [i - T_u]);
+	      if (inFrame) {
+	         if (ofdmSymbolCount < nrBlocks - 1)
+	            continue;
+	         my_ofdmDecoder. transformFrame ();
+	         for (int blkno = 4; blkno < nrBlocks; blkno ++) {
+	            my_ofdmDecoder. decodeFrameSymbol (blkno - 4,
+	                                               blkno, ibits. data ());
+	            my_mscHandler. process_mscBlock (ibits, blkno);
+	         }
+	         continue;
+	      }
+	      if (inPipeline) {
+	         if (ofdmSymbolCount == 3) {
+	            my_ofdmDecoder. decode (symbol,
+	                                 ofdmSymbolCount, ibits. data ());
+	            my_ficHandler. process_ficBlock (ibits, ofdmSymbolCount);
+	         }
+	         my_pipeline -> putBuffer (ofdmSymbolCount,
+	                                   ofdmSymbolCount < 4);
+	         continue;
+	      }
 //
 //	Note that only the first few blocks are handled locally
 //	The FIC/FIB handling is in this thread, so that there is
@@ -260,15 +318,16 @@ SyncOnPhase:
 	         if (++tii_counter >= 4) {
 	            std::vector<tiiData> res =
 	                  my_TII_Detector. processNULL (threshold);
-	            if ((res. size () > 0) && (show_tii != nullptr)) {
-	               uint8_t the_ecc	= my_ficHandler. get_ecc ();
-	               uint16_t the_EId	= my_ficHandler. get_EId ();
-	               for (auto &d : res) {
-	                  d. ecc	= the_ecc;
-	                  d. EId	= the_EId;
-	                  show_tii (&d, userData);
-	               }
+	            uint8_t the_ecc	= my_ficHandler. get_ecc ();
+	            uint16_t the_EId	= my_ficHandler. get_EId ();
+	            for (auto &d : res) {
+	               d. ecc	= the_ecc;
+	               d. EId	= the_EId;
 	            }
+	            my_ficHandler. set_transmitters (res);
+	            if (show_tii != nullptr)
+	               for (auto &d : res)
+	                  show_tii (&d, userData);
 	            tii_counter = 0;
 	            my_TII_Detector. reset ();
 	         }
@@ -284,16 +343,57 @@ SyncOnPhase:
 	      coarseOffset -= carrierDiff;
 	      fineOffset += carrierDiff;
 	   }
+	   framesDecoded. store (framesDecoded. load () + 1);
 	   goto Check_endofNull;
 	}
 
 	catch (int e) {
 //	   fprintf (stderr, "dab processor will stop\n");
 	}
+	if (my_pipeline != nullptr)
+	   my_pipeline -> stop ();
 	my_mscHandler.  stop ();
 //	fprintf (stderr, "dabProcessor is shutting down\n");
 }
 
+//
+//	The pipeline can only be set up (or removed) while not running
+void	dabProcessor::set_pipeline	(int nrWorkers) {
+	if (running. load ()) {
+	   fprintf (stderr, "cannot change the pipeline while running\n");
+	   return;
+	}
+	if (my_pipeline != nullptr)
+	   delete my_pipeline;
+	my_pipeline	= nullptr;
+	if (nrWorkers > 0)
+	   my_pipeline	= new ofdmPipeline (params. get_dabMode (),
+	                                    nrWorkers, &my_mscHandler);
+}
+
+void	dabProcessor::set_batchFFT	(bool b) {
+	if (running. load ()) {
+	   fprintf (stderr, "cannot change the fft mode while running\n");
+	   return;
+	}
+	my_ofdmDecoder. set_batchMode (b);
+	batchFFT	= b;
+}
+
+bool	dabProcessor::get_pipelineStats	(pipelineStats *st) {
+	if (my_pipeline == nullptr)
+	   return false;
+	my_pipeline -> getStats (st);
+	return true;
+}
+
+void	dabProcessor::get_processingStats	(processingStats *st) {
+	st -> samplesRead	= myReader. get_samplesRead ();
+	st -> framesDecoded	= framesDecoded. load ();
+	my_ficHandler. get_fibStats (st -> fibsParsed,
+	                             st -> fibsSkipped, st -> fibsFailed);
+}
+
 void	dabProcessor:: reset		() {
 	stop  ();
 	start ();
@@ -303,7 +403,6 @@ void	dabProcessor::stop		() {
 	if (running. load ()) {
 	   running. store (false);
 	   myReader. setRunning (false);
-	   sleep (1);
 	   threadHandle. join ();
 	}
 }
@@ -380,6 +479,57 @@ void    dabProcessor::set_dataChannel (packetdata &d) {
 	my_mscHandler. set_dataChannel (d);
 }
 
+//
+//	all services of the ensemble, the handlers of the services are
+//	run by a pool of workers
+int	dabProcessor::decodeEnsemble	(int nrWorkers,
+	                                 serviceContext_t serviceContext) {
+std::vector<int> comps;
+int	attached	= 0;
+
+	my_mscHandler. reset ();
+	my_mscHandler. set_servicePool (nrWorkers);
+	my_ficHandler. get_primaryComps (comps);
+	for (auto index : comps) {
+	   switch (my_ficHandler. serviceType (index)) {
+	      case AUDIO_SERVICE: {
+	         audiodata ad;
+	         ad. defined	= false;
+	         my_ficHandler. audioData (index, ad);
+	         if (!ad. defined)
+	            break;
+	         void *ctx = serviceContext == nullptr ? userData :
+	                        serviceContext (ad. SId, ad. serviceName,
+	                                        true, userData);
+	         my_mscHandler. set_audioChannel (ad, ctx);
+	         programdataHandler (&ad, ctx);
+	         attached ++;
+	         break;
+	      }
+	      case PACKET_SERVICE: {
+	         packetdata pd;
+	         pd. defined	= false;
+	         my_ficHandler. packetData (index, pd);
+	         if (!pd. defined)
+	            break;
+	         void *ctx = serviceContext == nullptr ? userData :
+	                        serviceContext (pd. SId, pd. serviceName,
+	                                        false, userData);
+	         my_mscHandler. set_dataChannel (pd, ctx);
+	         attached ++;
+	         break;
+	      }
+	      default:
+	         break;
+	   }
+	}
+	return attached;
+}
+
+int	dabProcessor::get_serviceStats	(serviceStats *st, int max) {
+	return my_mscHandler. get_serviceStats (st, max);
+}
+
 void    dabProcessor::clearEnsemble	() {
 	my_ficHandler. reset ();
 }
@@ -388,6 +538,10 @@ std::string dabProcessor::get_ensembleName	() {
 	return my_ficHandler. get_ensembleName ();
 }
 
+std::shared_ptr<const ensembleSnapshot> dabProcessor::get_ensemble () {
+	return my_ficHandler. get_ensemble ();
+}
+
 bool    dabProcessor::wasSecond (int16_t cf, dabParams *p) {
 	switch (p -> get_dabMode ()) {
 	   default:
@@ -27,41 +27,70 @@ void	ensemble::reset	() {
 //	isSynced	= false;
 	primaries. resize (0);
 	secondaries. resize (0);
+	primaryIndex.	clear ();
+	secondaryIndex.	clear ();
+	primaryNames.	clear ();
+	secondaryNames.	clear ();
 	namePresent = false;
+	eccByte		= 0;		// until FIG0/9 is seen
+	lto		= 0;
+}
+//
+//	for equal names (or SId's) the first one added is found,
+//	as with the original linear searches
+void	ensemble::addPrimary	(const service &serv) {
+	primaryIndex. emplace (serv. SId, primaries. size ());
+	primaryNames. emplace (serv. name, serv. SId);
+	primaries. push_back (serv);
+}
+
+void	ensemble::addSecondary	(const service &serv) {
+	secondaryIndex. emplace (serv. SId, secondaries. size ());
+	secondaryNames. emplace (serv. name, serv. SId);
+	secondaries. push_back (serv);
+}
+
+int	ensemble::findPrimary	(uint32_t SId) {
+	auto it = primaryIndex. find (SId);
+	return it == primaryIndex. end () ? -1 : it -> second;
+}
+
+int	ensemble::findSecondary	(uint32_t SId) {
+	auto it = secondaryIndex. find (SId);
+	return it == secondaryIndex. end () ? -1 : it -> second;
+}
+
+int	ensemble::findPrimary	(const std::string &name) {
+	auto it = primaryNames. find (name);
+	if (it == primaryNames. end ())
+	   return -1;
+	return findPrimary (it -> second);
 }
 
 uint32_t  ensemble::serviceToSId	(const std::string &s) {
-	for (auto &serv: primaries)
-	   if (serv. name == s)	
-	      return serv. SId;
-	for (auto &serv: secondaries)
-	   if (serv. name == s)
-	      return serv. SId;
+	auto it = primaryNames. find (s);
+	if (it != primaryNames. end ())
+	   return it -> second;
+	it = secondaryNames. find (s);
+	if (it != secondaryNames. end ())
+	   return it -> second;
 	return 0;
 }
 
 std::string	ensemble::SIdToserv	(uint32_t SId) {
-	for (auto &serv: primaries)
-	   if (serv. SId == SId)
-	      return serv. name;
-	return " ";
+int	index	= findPrimary (SId);
+	return index < 0 ? " " : primaries [index]. name;
 }
 
 int	ensemble::programType (uint32_t SId) {
-	for (auto &serv: primaries)
-	   if (serv. SId == SId)
-	      return serv. programType;
-	return -1;
+int	index	= findPrimary (SId);
+	return index < 0 ? -1 : primaries [index]. programType;
 }
 
 std::vector<int>	ensemble::fmFrequencies	(uint32_t SId) {
-std::vector<int> res;
-	for (auto &serv: primaries)
-	   if (serv. SId == SId) {
-	      for (auto freq: serv. fmFrequencies)
-	         res. push_back (freq);
-	      return res;
-	   }
-	return res;
+int	index	= findPrimary (SId);
+	if (index < 0)
+	   return std::vector<int> ();
+	return primaries [index]. fmFrequencies;
 }
 
@@ -36,6 +36,8 @@
 //	Of course, on querying the FIG database, it needs more
 //	cycles, but at least the code now is (in my opinion)
 //	reasonable clear.
+//	Since the API is polled at a high rate, the lookups on the
+//	tables use hashed indexes, maintained as the elements are added
 
 	fibConfig::fibConfig	() {}
 	fibConfig::~fibConfig	() {}
@@ -50,8 +52,62 @@ void	fibConfig::reset	() {
 	programType_table.	resize (0);
 	AppType_table.		resize (0);
 	announcement_table. 	resize (0);
+	SId_index.		clear ();
+	subChannel_index.	clear ();
+	SC_P_index.		clear ();
+	SC_C_index.		clear ();
+	SC_G_index.		clear ();
+	SCIds_index.		clear ();
+	language_index.		clear ();
+	AppType_index.		clear ();
 	memset (dateTime, 0, sizeof (dateTime));
 }
+//
+//	the callers check that the key is new, the emplace calls
+//	would not overwrite an existing entry anyway
+void	fibConfig::add_SId		(const SId_struct &element) {
+	SId_index. emplace (element. SId, SId_table. size ());
+	SId_table. push_back (element);
+}
+
+void	fibConfig::add_subChannel	(const subChannel &channel) {
+	subChannel_index. emplace (channel. subChId, subChannel_table. size ());
+	subChannel_table. push_back (channel);
+}
+
+void	fibConfig::add_SC_C		(SId_struct &SId_element,
+	                                 const serviceComp_C &comp) {
+	SC_C_index. emplace (key (comp. SId, comp. compNr), SC_C_table. size ());
+	SId_element. comps. push_back (SC_C_table. size ());
+	SC_C_table. push_back (comp);
+}
+
+void	fibConfig::add_SC_P		(const serviceComp_P &comp) {
+	SC_P_index. emplace (comp. SCId, SC_P_table. size ());
+	SC_P_table. push_back (comp);
+}
+
+void	fibConfig::add_SC_G		(const serviceComp_G &comp) {
+	SC_G_index. emplace (key (comp. SId, comp. SCIds), SC_G_table. size ());
+	uint16_t id	= comp. LS_flag == 0 ? comp. subChId : comp. SCId;
+	SCIds_index. emplace (key (comp. SId, LSKey (comp. LS_flag, id)),
+	                      comp. SCIds);
+	SC_G_table. push_back (comp);
+}
+
+void	fibConfig::add_language		(const SC_language &element) {
+	uint16_t id	= element. LS_flag == 0 ? element. subChId :
+	                                          element. SCId;
+	language_index. emplace (LSKey (element. LS_flag, id),
+	                         language_table. size ());
+	language_table. push_back (element);
+}
+
+void	fibConfig::add_AppType		(const AppType &element) {
+	AppType_index. emplace (key (element. SId, element. SCIds),
+	                        AppType_table. size ());
+	AppType_table. push_back (element);
+}
 
 int	fibConfig::serviceIdOf		(int index) {
 	return SC_C_table [index]. SId;
@@ -59,27 +115,16 @@ int	fibConfig::serviceIdOf		(int index) {
 
 int	fibConfig::SCIdsOf		(int index) {
 serviceComp_C &comp = SC_C_table [index];
+int	SCIds;
 	if (comp. TMid == 0) {
-	   for (int i = 0; i < (int)SC_G_table. size (); i ++) {
-	      if (SC_G_table [i]. LS_flag != 0)
-	         continue;
-	      if (SC_G_table [i]. SId != comp. SId)
-	         continue;
-	      if (SC_G_table [i]. subChId == comp. subChId)
-	         return SC_G_table [i]. SCIds;
-	   }
-	   return 0;		//  primary component
+	   SCIds = lookup (SCIds_index, key (comp. SId,
+	                                     LSKey (0, comp. subChId)));
+	   return SCIds < 0 ? 0 : SCIds;	// 0: primary component
 	}
 	if (comp. TMid == 3) {	// should be it
-	   for (int i = 0; i < (int) SC_G_table. size (); i ++) {
-	      if (SC_G_table [i]. LS_flag == 0)
-	         continue;
-	      if (SC_G_table [i]. SId != comp. SId)
-	         continue;
-	      if (SC_G_table [i]. SCId == comp. SCId)
-	         return SC_G_table [i]. SCIds;
-	   }
-	   return 0;
+	   SCIds = lookup (SCIds_index, key (comp. SId,
+	                                     LSKey (1, comp. SCId)));
+	   return SCIds < 0 ? 0 : SCIds;
 	}
 	return -1;
 }
@@ -95,10 +140,7 @@ serviceComp_C &comp = SC_C_table [index];
 }
 
 int	fibConfig::findIndex_subChannel_table (uint8_t subChId) {
-	for (int i = 0; i < (int)subChannel_table. size (); i ++)
-	   if (subChannel_table [i]. subChId == subChId)
-	      return i;
-	return -1;
+	return lookup (subChannel_index, subChId);
 }
 
 int	fibConfig::startAddressOf	(int index) {
@@ -148,19 +190,14 @@ int	fibConfig::dabTypeOf		(int index) {
 }
 
 int	fibConfig::languageOf 		(int index) {
-	if (SC_C_table [index]. TMid == 0) {
-	   int subChId = SC_C_table [index]. subChId;
-	   for (auto &lt : language_table)
-	      if ((lt. LS_flag == 0) && (lt. subChId == subChId))
-	         return lt. language;
-	}
-	if (SC_C_table [index]. TMid == 3) {  // it should be
-	   int SCId	= SC_C_table [index]. SCId;
-	   for (auto &lt : language_table)
-	      if ((lt. LS_flag == 0) && (lt. SCId == SCId))
-	         return lt. language;
-	}
-	return -1;
+int	langIndex	= -1;
+	if (SC_C_table [index]. TMid == 0)
+	   langIndex = findIndex_languageTable (0, SC_C_table [index]. subChId);
+	if (SC_C_table [index]. TMid == 3)	// it should be
+	   langIndex = findIndex_languageTable (1, SC_C_table [index]. SCId);
+	if (langIndex < 0)
+	   return -1;
+	return language_table [langIndex]. language;
 }
 	
 int	fibConfig::appTypeOf		(int index) {
@@ -212,42 +249,32 @@ serviceComp_C &comp = SC_C_table [index];
 	return SC_P_table [SCId_index]. DG_flag;
 }
 
+int	fibConfig::findIndex_SId	(uint32_t SId) {
+	return lookup (SId_index, SId);
+}
+
+int	fibConfig::findIndex_SC_G_table	(uint32_t SId, uint8_t SCIds) {
+	return lookup (SC_G_index, key (SId, SCIds));
+}
+
 int	fibConfig::findIndex_SC_P_Table (uint16_t SCId) {
-	for (int i = 0; i < (int)SC_P_table. size (); i ++)
-	   if (SC_P_table [i]. SCId == SCId)
-	      return i;
-	return -1;
+	return lookup (SC_P_index, SCId);
 }
 
 int	fibConfig::findIndex_languageTable (uint8_t key_1, uint16_t key_2) {
-	for (int i = 0; i < (int) language_table. size (); i ++) {
-	   if (language_table [i]. LS_flag != key_1)
-	      continue;
-	   if ((key_1 == 0) && (language_table [i]. subChId == key_2))
-	      return i;
-	   if ((key_1 == 1) && (language_table [i]. SCId == key_2))
-	      return i;
-	}
-	return -1;
+	return lookup (language_index, LSKey (key_1, key_2));
 }
 
 int	fibConfig::findIndexApptype_table (uint32_t SId, uint8_t SCIds) {
-	for (int i = 0; i < (int)AppType_table. size (); i ++)
-	   if ((AppType_table [i]. SId == SId) &&
-	       (AppType_table [i]. SCIds == SCIds))
-	   return i;
-	return -1;
+	return lookup (AppType_index, key (SId, SCIds));
+}
+
+int	fibConfig::findIndex_comp	(uint32_t SId, int compNr) {
+	return lookup (SC_C_index, key (SId, compNr));
 }
 
 bool	fibConfig::compIsKnown	(serviceComp_C &newComp) {
-	for (auto &comp : SC_C_table) {
-	   if (comp. SId != newComp. SId)
-	      continue;
-	   if (comp. compNr != newComp. compNr)
-	      continue;
-	   return true;
-	}
-	return false;
+	return findIndex_comp (newComp. SId, newComp. compNr) >= 0;
 }
 
 int	fibConfig::freeSpace	() {
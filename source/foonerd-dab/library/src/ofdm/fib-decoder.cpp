@@ -36,8 +36,6 @@
 //#include	"dab-tables.h"
 #include	"time-converter.h"
 //
-
-	static uint32_t dateTime [8];
 //	The fibDecoder was rewritten since the "old" one
 //	contained (a) errors and (b) was incomplete on
 //	some issues.
@@ -50,15 +48,21 @@
         if (p -> serviceName == nullptr)
            fprintf (stderr, "programname handler nullptr detected\n");
         this    -> serviceName   = p ->  serviceName;
+	this	-> ensembleChanged	= p -> ensembleChanged_Handler;
         this    -> userData             = userData;
-        memset (dateTime, 0, 8 * sizeof (uint32_t));
 
 //
 //	Note that they may change "roles", 
 	currentConfig	= new fibConfig();
 	nextConfig	= new fibConfig();
 	theEnsemble	= new ensemble ();
-        reset   ();
+	currentConfig	-> reset ();
+	nextConfig	-> reset ();
+//	version 0 is the empty ensemble, the first
+//	change is reported as version 1
+	snapshotVersion	= 0;
+	snapshot	= std::make_shared<fibSnapshot> ();
+	changed		= false;
 	CIFcount	= 0;
 	mjd		= 0;
 }
@@ -114,6 +118,8 @@ uint8_t	*d		= p;
 //	      processedBytes += getBits (p, 3, 5) + 1;
 	      d = p + processedBytes * 8;
 	}
+	if (changed)
+	   publish_snapshot ();
 	fibLocker. unlock();
 }
 //
@@ -240,7 +246,6 @@ uint16_t        highpart, lowpart;
 int16_t         occurrenceChange;
 uint8_t CN_bit	= getBits_1 (d, 8 + 0);
 uint8_t		alarmFlag;
-static	uint8_t prevChangeFlag	= 0;
 
 	(void)CN_bit;
 	EId                     = getBits   (d, 16, 16);
@@ -252,7 +257,6 @@ static	uint8_t prevChangeFlag	= 0;
 	(void)alarmFlag;
 	occurrenceChange        = getBits_8 (d, 16 + 32);
 	(void)changeFlag;
-	(void)prevChangeFlag;
 
 	(void)occurrenceChange;
 	CIFcount_hi		= highpart;
@@ -333,7 +337,8 @@ static	int table_2 [] = {27, 21, 18, 15};
 	if (localBase -> findIndex_subChannel_table (subChId) >= 0)
 	   return bitOffset / 8;
 //
-	localBase -> subChannel_table. push_back (channel);
+	localBase -> add_subChannel (channel);
+	changed	= true;
 	return bitOffset / 8;	// we return bytes
 }
 //
@@ -385,11 +390,9 @@ fibConfig	*localBase = CN_bit == 0 ? currentConfig : nextConfig;
 	fibConfig::SId_struct SId_element;
 	SId_element. announcing = 0;
 	SId_element. SId = SId;
-	for (auto &ss: localBase -> SId_table) {
-	   if (ss. SId == SId) {
-	      bitOffset += numberofComponents * 16 + 8;
-	      return bitOffset / 8;
-	   }
+	if (localBase -> findIndex_SId (SId) >= 0) {
+	   bitOffset += numberofComponents * 16 + 8;
+	   return bitOffset / 8;
 	}
 	bitOffset	+= 8;
 	for (i = 0; i < numberofComponents; i ++) {
@@ -413,12 +416,11 @@ fibConfig	*localBase = CN_bit == 0 ? currentConfig : nextConfig;
 	   else 
 	      {;}
 	   bitOffset += 16;
-	   if (!localBase -> compIsKnown (comp)) {	
-	      SId_element. comps. push_back (localBase -> SC_C_table. size ());
-	      localBase -> SC_C_table. push_back (comp);
-	   }
+	   if (!localBase -> compIsKnown (comp))
+	      localBase -> add_SC_C (SId_element, comp);
 	}
-	localBase -> SId_table. push_back (SId_element);
+	localBase -> add_SId (SId_element);
+	changed	= true;
 	return bitOffset / 8;		// in Bytes
 }
 
@@ -459,16 +461,16 @@ fibConfig	*localBase = CN_bit == 0 ? currentConfig : nextConfig;
 	(void)CAOrg;
 	used += 40 / 8;
 
-	for (auto &comp : localBase ->  SC_P_table)
-	   if (comp. SCId == SCId)
-	      return used;
+	if (localBase -> findIndex_SC_P_Table (SCId) >= 0)
+	   return used;
 	fibConfig::serviceComp_P element;
 	element. SCId  		= SCId;
 	element. subChId  	= SubChId;
 	element. DSCTy		= DSCTy;
 	element. DG_flag	= DGflag;
 	element.  packetAddress	= packetAddress;
-	localBase -> SC_P_table. push_back (element);
+	localBase -> add_SC_P (element);
+	changed	= true;
 	return used;
 }
 
@@ -498,27 +500,24 @@ fibConfig::SC_language comp;
 	comp. LS_flag = LS_flag;
 	if (LS_flag == 0) {
 	   comp. subChId = getBits (d, bitOffset + 2, 6);
-	   for (int i = 0; i < (int) localBase -> language_table. size (); i ++)
-	      if ((localBase -> language_table [i]. LS_flag == 0) &&
-	          (localBase -> language_table [i]. subChId == comp. subChId)) {
-	         bitOffset += 16;
-	         return bitOffset / 8;
-	      }
+	   if (localBase -> findIndex_languageTable (0, comp. subChId) >= 0) {
+	      bitOffset += 16;
+	      return bitOffset / 8;
+	   }
 	   comp. language = getBits (d, bitOffset + 8, 8);
 	   bitOffset += 16;
 	}
 	else {
 	   comp. SCId = getBits (d, bitOffset + 4, 12);
-	   for (int i = 0; i < (int)localBase ->  language_table. size (); i ++)
-	      if ((localBase -> language_table [i]. LS_flag == 0) &&
-	          (localBase -> language_table [i]. SCId == comp. SCId)) {
-	         bitOffset += 24;
-	         return bitOffset / 8;
-	      }
+	   if (localBase -> findIndex_languageTable (1, comp. SCId) >= 0) {
+	      bitOffset += 24;
+	      return bitOffset / 8;
+	   }
 	   comp. language = getBits (d, bitOffset + 16, 8);
 	   bitOffset += 24;
 	}
-	localBase -> language_table. push_back (comp);
+	localBase -> add_language (comp);
+	changed	= true;
 	return bitOffset / 8;
 }
 //
@@ -589,10 +588,10 @@ fibConfig::serviceComp_G comp;
 	}
 	if (extensionFlag)
 	   bitOffset += 8;	// skip Rfa
-	for (auto &el : localBase -> SC_G_table)
-	   if ((el. SId == SId) && (el. SCIds == SCIds))
-	      return bitOffset / 8;
-	localBase -> SC_G_table. push_back (comp);
+	if (localBase -> findIndex_SC_G_table (SId, SCIds) >= 0)
+	   return bitOffset / 8;
+	localBase -> add_SC_G (comp);
+	changed	= true;
 	return bitOffset / 8;
 }
 
@@ -616,6 +615,8 @@ int16_t	used	= 2;		// offset in bytes
 
 	uint8_t	LTO	= currentConfig -> dateTime [6];
 	uint8_t ecc	= getBits (d, used * 8 + 8, 8);
+	if (theEnsemble -> eccByte != ecc)
+	   changed	= true;
 	theEnsemble	-> eccByte	= ecc;
 	theEnsemble	-> lto		= LTO;
 //	lto_ecc (LTO, ecc);
@@ -692,6 +693,9 @@ uint16_t	theTime	[6];
 //	theTime [2] = D;	// Day
 	theTime [3] = getBits_5 (dd, offset + 21); // Hours
 	theTime [4] = getBits_6 (dd, offset + 26); // Minutes
+	int32_t	previous [5];
+	for (int i = 0; i < 5; i ++)
+	   previous [i] = currentConfig -> dateTime [i];
 
 	if (getBits_6 (dd, offset + 26) != currentConfig -> dateTime [4]) 
 	   theTime [5] =  0;	// Seconds
@@ -712,6 +716,10 @@ uint16_t	theTime	[6];
 //	   int utc_minute 	= currentConfig -> dateTime [4];
 //	   int utc_seconds	= currentConfig -> dateTime [5];
 	adjustTime (currentConfig -> dateTime);
+//	the snapshot has the local time in minutes
+	for (int i = 0; i < 5; i ++)
+	   if (previous [i] != currentConfig -> dateTime [i])
+	      changed = true;
 	if (theParameters -> timeHandler != nullptr)
 	   theParameters -> timeHandler (
 	                    currentConfig -> dateTime [3],
@@ -759,10 +767,10 @@ fibConfig::AppType element;
 	   element. Apptype	= appType;
 	   bitOffset 		+= (11 + 5 + 8 * length);
 	}
-	for (auto &comp : localBase -> AppType_table)
-	   if ((comp. SId == SId) && (comp. SCIds == SCIds))
-	      return bitOffset / 8;
-	localBase -> AppType_table. push_back (element);
+	if (localBase -> findIndexApptype_table (SId, SCIds) >= 0)
+	   return bitOffset / 8;
+	localBase -> add_AppType (element);
+	changed	= true;
 	return bitOffset / 8;
 }
 
@@ -781,9 +789,12 @@ fibConfig	*localBase	= CN_bit == 0 ? currentConfig : nextConfig;
 	   int16_t subChId	= getBits_6 (d, used * 8);
 	   uint8_t FEC_scheme	= getBits_2 (d, used * 8 + 6);
 	   used = used + 1;
-	   for (auto &subC: localBase -> subChannel_table)
-	      if (subC. subChId == subChId)
-	         subC. FEC_scheme = FEC_scheme;
+	   int index = localBase -> findIndex_subChannel_table (subChId);
+	   if ((index >= 0) &&
+	       (localBase -> subChannel_table [index]. FEC_scheme != FEC_scheme)) {
+	      localBase -> subChannel_table [index]. FEC_scheme = FEC_scheme;
+	      changed	= true;
+	   }
 	}
 }
 //
@@ -795,11 +806,11 @@ int16_t	offset	= 16;
 	while (offset < length * 8) {
 	   uint16_t	SId	= getBits (d, offset, 16);
 	   uint8_t typeCode	= getBits_5 (d, offset + 27);
-	   for (uint16_t i = 0; i < theEnsemble -> primaries. size (); i ++) {
-	      if (theEnsemble -> primaries [i]. SId == SId) {
-	         theEnsemble -> primaries [i]. programType = typeCode;
-	         break;
-	      }
+	   int index	= theEnsemble -> findPrimary (SId);
+	   if ((index >= 0) &&
+	       (theEnsemble -> primaries [index]. programType != typeCode)) {
+	      theEnsemble -> primaries [index]. programType = typeCode;
+	      changed	= true;
 	   }
 	   offset += 32;
 	}
@@ -917,27 +928,26 @@ int16_t		base		= l_offset + 16;
 	   if (RandM == 0x08) {
 	      uint16_t fmFrequency_key	= getBits (d, base + 24, 8);
 	      int32_t  fmFrequency	= 87500 + fmFrequency_key * 100;
-	      for (auto &serv : theEnsemble -> primaries) {
-	         if ((serv. SId == idField)) {
-	            bool alreadyIn = false;
-	            for (auto freq : serv. fmFrequencies) {
-	               if (fmFrequency == freq) {
-	                  alreadyIn = true;
-	                  break;
-	               }
-	            }
-	            if (!alreadyIn) {
-	               serv. fmFrequencies. push_back (fmFrequency);
-	               newData = true;
+	      int index	= theEnsemble -> findPrimary (idField);
+	      if (index >= 0) {
+	         ensemble::service &serv = theEnsemble -> primaries [index];
+	         bool alreadyIn = false;
+	         for (auto freq : serv. fmFrequencies) {
+	            if (fmFrequency == freq) {
+	               alreadyIn = true;
+	               break;
 	            }
 	         }
+	         if (!alreadyIn) {
+	            serv. fmFrequencies. push_back (fmFrequency);
+	            newData = true;
+	         }
 	      }
 	   }
 	   base += 24 + length * 8;
 	}
-	(void)newData;
-//	if (newData)
-//	   emit setFreqList ();
+	if (newData)
+	   changed	= true;
 	         
 	return upperLimit / 8;
 }
@@ -1009,6 +1019,7 @@ char		label [17];
 	      theEnsemble ->  ensembleName	= realName;
 	      theEnsemble ->  EId	= EId;
 	      theEnsemble ->  namePresent	= true;
+	      changed	= true;
 	      if (theParameters -> name_of_ensemble != nullptr)
 	         theParameters -> name_of_ensemble (name, EId, userData);
 	   }
@@ -1031,10 +1042,8 @@ char		label [17];
 	if (charSet >= 16) 	// does not seem right
 	   return;
 	
-	for (auto &serv : theEnsemble -> primaries) {
-	   if (SId == serv. SId) 
-	      return;
-	}
+	if (theEnsemble -> findPrimary (SId) >= 0)
+	   return;
 
 	for (int i = 0; i < 16; i ++) 
 	   label [i] = getBits_8 (d, offset + 8 * i);
@@ -1054,13 +1063,12 @@ char		label [17];
 	prim. shortName		= shortName;
 	prim. SId		= SId;
 	prim. fmFrequencies. resize (0);
-	theEnsemble -> primaries. push_back (prim);
+	theEnsemble -> addPrimary (prim);
+	changed	= true;
 	int subChId = -1;
-	for (int i = 0; i < (int)(currentConfig -> SC_C_table. size ()); i ++) {
-	   fibConfig::serviceComp_C  comp  = currentConfig -> SC_C_table [i];
-	   if ((comp. compNr == 0) && (comp. SId == SId))
-	      subChId	= currentConfig -> subChannelOf (i);
-	}
+	int compIndex	= currentConfig -> findIndex_comp (SId, 0);
+	if (compIndex >= 0)
+	   subChId	= currentConfig -> subChannelOf (compIndex);
 	if (theParameters -> serviceName != nullptr)
 	   theParameters -> serviceName (dataName, SId, subChId, userData);
 	if (theEnsemble -> primaries. size () >= 2)
@@ -1089,12 +1097,9 @@ uint32_t	SId;
 	}
 //
 //	just a check if we already have the servicename
-	for (auto &serv : theEnsemble -> secondaries)
-	   if (serv. SId == SId)
-	      return;
-	for (auto &serv :theEnsemble -> primaries)
-	   if (serv. SId == SId)
-	     return;
+	if ((theEnsemble -> findSecondary (SId) >= 0) ||
+	    (theEnsemble -> findPrimary (SId) >= 0))
+	   return;
 
 	label [16]      = 0x00;
 	(void)Rfu;
@@ -1117,7 +1122,9 @@ uint32_t	SId;
 	prim. shortName	= shortName;
 	prim. SId	= SId;
 	prim. SCIds	= SCIds;
-	theEnsemble -> secondaries. push_back (prim);
+	prim. programType	= 0;
+	theEnsemble -> addSecondary (prim);
+	changed	= true;
 	if (theParameters -> serviceName != nullptr)
 	   theParameters -> serviceName (dataName, SId, -1, userData);
 }
@@ -1136,10 +1143,8 @@ int16_t		bitOffset	= 48;
 	label [16]      = 0x00;
 	(void)Rfu; (void)extension;
 
-	for (auto &serv : theEnsemble -> primaries) {
-	   if (SId == serv. SId) 
-	      return;
-	}
+	if (theEnsemble -> findPrimary (SId) >= 0)
+	   return;
 
 	if (charSet > 16) 
 	   return;	// something wrong
@@ -1161,24 +1166,21 @@ int16_t		bitOffset	= 48;
 	prim. name 	= dataName;
 	prim. shortName = shortName;
 	prim. SId	= SId;
-	theEnsemble -> primaries. push_back (prim);
+	theEnsemble -> addPrimary (prim);
+	changed	= true;
 	if (theParameters -> serviceName != nullptr)
 	   theParameters -> serviceName (dataName, SId, -1, userData);
 }
 
 void	fibDecoder::connect_channel () {
 	fibLocker. lock();
-	currentConfig	-> reset ();
-	nextConfig	-> reset ();
-	theEnsemble	-> reset ();
+	reset ();
 	fibLocker. unlock();
 }
 
 void	fibDecoder::disconnect_channel () {
 	fibLocker. lock ();
-	currentConfig	-> reset ();
-	nextConfig	-> reset ();
-	theEnsemble	-> reset ();
+	reset ();
 	fibLocker. unlock();
 }
 
@@ -1186,42 +1188,174 @@ void	fibDecoder::reset	() {
 	theEnsemble	-> reset ();
 	currentConfig	-> reset ();
 	nextConfig	-> reset ();
+	transmitters. resize (0);
+	publish_snapshot ();
+}
+//
+//	The snapshot is built from the current configuration and the
+//	ensemble, using the same (indexed) lookups as before.
+//	It is only built when something changed, so in steady state
+//	- where the FIBs only repeat what is known - it costs nothing
+void	fibDecoder::publish_snapshot	() {
+std::shared_ptr<fibSnapshot> next = std::make_shared<fibSnapshot> ();
+
+	next -> version		= ++snapshotVersion;
+	next -> ensembleName	= theEnsemble -> ensembleName;
+	next -> EId		= theEnsemble -> EId;
+	next -> ecc		= theEnsemble -> eccByte;
+	next -> components. resize (currentConfig -> SC_C_table. size ());
+	for (int i = 0; i < (int)(currentConfig -> SC_C_table. size ()); i ++) {
+	   ensembleComponent &comp = next -> components [i];
+	   comp. SId	= currentConfig -> SC_C_table [i]. SId;
+	   comp. SCIds	= currentConfig -> SCIdsOf (i);
+	   comp. compNr	= currentConfig -> SC_C_table [i]. compNr;
+	   comp. ad. defined	= false;
+	   comp. pd. defined	= false;
+	   if (currentConfig -> SC_C_table [i]. TMid == 00) {
+	      comp. serviceType	= AUDIO_SERVICE;
+	      fill_audioData (i, comp. ad);
+	   }
+	   else {
+	      comp. serviceType	= PACKET_SERVICE;
+	      fill_packetData (i, comp. pd);
+	   }
+	}
+
+	for (auto &serv : theEnsemble -> primaries) {
+	   ensembleService service;
+	   service. SId		= serv. SId;
+	   service. name	= serv. name;
+	   service. shortName	= serv. shortName;
+	   service. isPrimary	= true;
+	   service. SCIds	= 0;
+	   service. programType	= serv. programType;
+	   service. announcing	= 0;
+	   service. fmFrequencies	= serv. fmFrequencies;
+	   next -> serviceNames. emplace (serv. SId, serv. name);
+	   int index	= currentConfig -> findIndex_SId (serv. SId);
+	   if (index >= 0) {
+	      fibConfig::SId_struct &element = currentConfig -> SId_table [index];
+	      service. components	= element. comps;
+	      service. announcing	= element. announcing;
+	      if (element. comps. size () > 0) {
+	         next -> primaryComps. push_back (element. comps [0]);
+	         next -> primaryNames. emplace (serv. name, element. comps [0]);
+	      }
+	   }
+	   next -> services. push_back (service);
+	}
+	for (auto &serv : theEnsemble -> secondaries) {
+	   ensembleService service;
+	   service. SId		= serv. SId;
+	   service. name	= serv. name;
+	   service. shortName	= serv. shortName;
+	   service. isPrimary	= false;
+	   service. SCIds	= serv. SCIds;
+	   service. programType	= serv. programType;
+	   service. announcing	= 0;
+	   int compIndex	= get_serviceComp_SCIds (serv. SId, serv. SCIds);
+	   if (compIndex >= 0)
+	      service. components. push_back (compIndex);
+	   next -> secondaryNames. emplace (serv. name, compIndex);
+	   next -> services. push_back (service);
+	}
+
+	for (auto &channel : currentConfig -> subChannel_table) {
+	   ensembleSubchannel sub;
+	   sub. subChId		= channel. subChId;
+	   sub. startAddr	= channel. startAddr;
+	   sub. length		= channel. Length;
+	   sub. shortForm	= channel. shortForm;
+	   sub. protLevel	= channel. protLevel;
+	   sub. bitRate		= channel. bitRate;
+	   sub. FEC_scheme	= channel. FEC_scheme;
+	   next -> subchannels. push_back (sub);
+	}
+	for (int i = 0; i < 5; i ++)
+	   next -> localTime [i] = currentConfig -> dateTime [i];
+	next -> transmitters	= transmitters;
+
+	std::atomic_store (&snapshot,
+	                   std::shared_ptr<const fibSnapshot> (next));
+	changed	= false;
+	if (ensembleChanged != nullptr)
+	   ensembleChanged (next -> version, userData);
+}
+
+std::shared_ptr<const fibSnapshot> fibDecoder::get_snapshot	() {
+	return std::atomic_load (&snapshot);
+}
+//
+//	the TII detector reports every few frames, a new snapshot is
+//	only made when the set of transmitters changes
+void	fibDecoder::set_transmitters	(const std::vector<tiiData> &list) {
+	fibLocker. lock ();
+	bool same	= list. size () == transmitters. size ();
+	for (int i = 0; same && (i < (int)list. size ()); i ++) {
+	   same	= false;
+	   for (auto &t : transmitters)
+	      if ((t. mainId == list [i]. mainId) &&
+	          (t. subId  == list [i]. subId))
+	         same	= true;
+	}
+	if (!same) {
+	   transmitters	= list;
+	   publish_snapshot ();
+	}
+	fibLocker. unlock ();
 }
 
 bool	fibDecoder::syncReached() {
 	return  theEnsemble -> isSynced;
 }
 
+//
+//	The queries from the API are answered from the snapshot,
+//	they do not need the fibLocker
 uint32_t fibDecoder::get_SId	(int index) {
-	return currentConfig -> SC_C_table [index]. SId;
+std::shared_ptr<const fibSnapshot> current = get_snapshot ();
+	if (!current -> validComp (index))
+	   return 0;
+	return current -> components [index]. SId;
 }
 
 std::string fibDecoder::get_serviceName	(uint32_t SId) {
-	for (auto &prim: theEnsemble -> primaries)
-	   if (prim. SId == SId)
-	      return prim. name;
-	return "";
+std::shared_ptr<const fibSnapshot> current = get_snapshot ();
+	auto it = current -> serviceNames. find (SId);
+	return it == current -> serviceNames. end () ? "" : it -> second;
 }
 
 uint8_t	fibDecoder::serviceType (int index) {
-	if ((index < 0) || ((uint16_t)index >= currentConfig -> SC_C_table. size ()))
+std::shared_ptr<const fibSnapshot> current = get_snapshot ();
+	if (!current -> validComp (index))
 	   return UNKNOWN_SERVICE;
-	return currentConfig -> SC_C_table [index]. TMid == 00 ?
-	                                            AUDIO_SERVICE :
-	                                            PACKET_SERVICE;
+	return current -> components [index]. serviceType;
 }
 
 void	fibDecoder::audioData	(int index, audiodata &ad) {
+std::shared_ptr<const fibSnapshot> current = get_snapshot ();
+	if (current -> validComp (index) &&
+	    (current -> components [index]. serviceType == AUDIO_SERVICE))
+	   ad = current -> components [index]. ad;
+}
+
+void	fibDecoder::packetData		(int index, packetdata &pd) {
+std::shared_ptr<const fibSnapshot> current = get_snapshot ();
+	if (current -> validComp (index) &&
+	    (current -> components [index]. serviceType == PACKET_SERVICE))
+	   pd = current -> components [index]. pd;
+}
+
+void	fibDecoder::fill_audioData	(int index, audiodata &ad) {
 fibConfig::serviceComp_C &comp = currentConfig -> SC_C_table [index];
-	for (auto &serv : theEnsemble -> primaries) {
-	   if (serv. SId == comp. SId) {
-	      ad. serviceName	= serv. name;
-	      ad. shortName	= serv. shortName;
-	      ad. SId		= serv. SId;
-	      ad. programType	= serv. programType;
-//	      ad. fmFrequencies	= serv. fmFrequencies;
-	      break;
-	   }
+int	servIndex	= theEnsemble -> findPrimary (comp. SId);
+	if (servIndex >= 0) {
+	   ensemble::service &serv = theEnsemble -> primaries [servIndex];
+	   ad. serviceName	= serv. name;
+	   ad. shortName	= serv. shortName;
+	   ad. SId		= serv. SId;
+	   ad. programType	= serv. programType;
+//	   ad. fmFrequencies	= serv. fmFrequencies;
 	}
 	int subChId	= currentConfig -> subChannelOf (index);
 	ad. subchId	= subChId;
@@ -1241,15 +1375,14 @@ fibConfig::serviceComp_C &comp = currentConfig -> SC_C_table [index];
 	ad. defined	= true;
 }
 
-void	fibDecoder::packetData		(int index, packetdata &pd) {
+void	fibDecoder::fill_packetData	(int index, packetdata &pd) {
 fibConfig::serviceComp_C &comp = currentConfig -> SC_C_table [index];
-	for (auto &serv : theEnsemble -> primaries) {
-	   if (serv. SId == comp. SId) {
-	      pd. serviceName	= serv. name;
-	      pd. shortName	= serv. shortName;
-	      pd. SId		= serv. SId;
-	      break;
-	   }
+int	servIndex	= theEnsemble -> findPrimary (comp. SId);
+	if (servIndex >= 0) {
+	   ensemble::service &serv = theEnsemble -> primaries [servIndex];
+	   pd. serviceName	= serv. name;
+	   pd. shortName	= serv. shortName;
+	   pd. SId		= serv. SId;
 	}
 	int subChId	= currentConfig -> subChannelOf (index);
 	pd. subchId	= subChId;
@@ -1273,10 +1406,14 @@ fibConfig::serviceComp_C &comp = currentConfig -> SC_C_table [index];
 }
 
 int	fibDecoder::get_nrComps			(uint32_t SId) {
-	for (auto &SId_element : currentConfig -> SId_table)
-	   if (SId_element. SId == SId)
-	      return SId_element. comps. size ();
-	return 0;
+int	index	= currentConfig -> findIndex_SId (SId);
+	return index < 0 ? 0 : currentConfig -> SId_table [index]. comps. size ();
+}
+//
+//	for each (primary) service in the ensemble the index of its
+//	primary component, in the order in which the services were found
+void	fibDecoder::get_primaryComps		(std::vector<int> &v) {
+	v	= get_snapshot () -> primaryComps;
 }
 //
 //	for primary services we return the index of the first
@@ -1284,72 +1421,43 @@ int	fibDecoder::get_nrComps			(uint32_t SId) {
 //	component with the matching SCIds
 //	
 int	fibDecoder::getServiceComp		(const std::string &service) {
-//	first we check to see if the service is a primary one
-	std::string ss = service;
-	for (int i = service. size (); i < 16; i ++)
-	   ss. push_back (' ');
-	for (auto &serv : theEnsemble -> primaries) {
-	   if (serv. name != ss)
-	      continue;
-	   for (auto & SId_element: currentConfig -> SId_table) {
-	      if (SId_element. SId == serv. SId)
-	         return SId_element. comps [0];
-	   }
-	}
-	
-	for (auto &serv : theEnsemble -> secondaries) {
-	   if (serv. name != service)
-	      continue;
-	   return get_serviceComp_SCIds (serv. SId, serv. SCIds);
-	}
-	return -1;
+	return get_snapshot () -> serviceComp (service);
 }
 
 int	fibDecoder::get_serviceComp		(uint32_t SId, int compnr) {
-	for (auto &SId_element : currentConfig -> SId_table) {
-	   if (SId_element. SId == SId) {
-	      return SId_element. comps [compnr];
-	   }
-	}
-	return -1;
+int	index	= currentConfig -> findIndex_SId (SId);
+	if (index < 0)
+	   return -1;
+	return currentConfig -> SId_table [index]. comps [compnr];
 }
 
 int	fibDecoder::get_serviceComp_SCIds	(uint32_t SId, int SCIds) {
-	for (auto &SId_element : currentConfig -> SId_table) {
-	   if (SId_element. SId != SId)
-	      continue;
-	   for (int i = 0; i < (int) SId_element. comps. size (); i ++) {
-	      int index = SId_element. comps [i];
-	      if (currentConfig -> SCIdsOf   (index) == SCIds)
-	         return index;
-	   }
-	}
+int	SId_index	= currentConfig -> findIndex_SId (SId);
+	if (SId_index < 0)
+	   return -1;
+	for (auto index : currentConfig -> SId_table [SId_index]. comps)
+	   if (currentConfig -> SCIdsOf (index) == SCIds)
+	      return index;
 	return -1;
 }
 
 bool	fibDecoder::isPrimary	(const std::string &s) {
-	for (auto &serv : theEnsemble -> primaries) {
-	   if (s == serv. name)
-	      return true;
-	}
-	return false;
+	return theEnsemble -> findPrimary (s) >= 0;
 }
 	
 uint8_t	 fibDecoder::get_ecc			() {
-	return theEnsemble -> eccByte;
+	return get_snapshot () -> ecc;
 }
 
 uint32_t fibDecoder::get_EId		() {
-	return theEnsemble -> EId;
+	return get_snapshot () -> EId;
 }
 
 std::vector<int> fibDecoder::getFrequency	(const std::string &s) {
-std::vector<int> res;
-	for (auto &serv : theEnsemble -> primaries) {
-	   if (serv. name == s)
-	      return serv. fmFrequencies;
-	}
-	return  res;
+int	index	= theEnsemble -> findPrimary (s);
+	if (index < 0)
+	   return std::vector<int> ();
+	return theEnsemble -> primaries [index]. fmFrequencies;
 }
 	   
 //	required for ETI generation
@@ -1374,19 +1482,17 @@ uint32_t fibDecoder::julianDate		() {
 void	fibDecoder::handle_announcement (uint16_t SId, uint16_t flags,
 	                                                uint8_t subChId) {
 	(void)subChId;
-	for (auto &serv : currentConfig -> SId_table)
-	   if (serv. SId == SId) {
-//	      if (serv. announcing != flags)
-//	         emit announcement (SId, flags);
-	      serv. announcing = flags;
-	   }
+	int index	= currentConfig -> findIndex_SId (SId);
+	if ((index >= 0) &&
+	    (currentConfig -> SId_table [index]. announcing != flags)) {
+	   currentConfig -> SId_table [index]. announcing = flags;
+	   changed	= true;
+	}
 }
 
 uint16_t fibDecoder::get_announcing	(uint16_t SId) {
-	for (auto &serv : currentConfig -> SId_table)
-	   if (serv. SId == SId)
-	      return serv. announcing;
-	return 0;
+int	index	= currentConfig -> findIndex_SId (SId);
+	return index < 0 ? 0 : currentConfig -> SId_table [index]. announcing;
 }
 
 int	fibDecoder::freeSpace		() {
@@ -1394,6 +1500,6 @@ int	fibDecoder::freeSpace		() {
 }
 
 std::string fibDecoder::get_ensembleName	() {
-	return theEnsemble -> ensembleName;
+	return get_snapshot () -> ensembleName;
 }
 
@@ -22,6 +22,13 @@
 #include	"fic-handler.h"
 #include	"msc-handler.h"
 #include	"protTables.h"
+#include	"stage-timer.h"
+//
+//	steady state is reached after this many repeated FIB's in
+//	a row, about 4 seconds in Mode I. The number of different FIB's
+//	kept is limited, if exceeded, the table is cleared
+#define	STEADY_FIBS	500
+#define	MAX_KNOWN_FIBS	2048
 //
 //	The 3072 bits of the serial motherword shall be split into
 //	24 blocks of 128 bits each.
@@ -54,6 +61,7 @@ int16_t	local	= 0;
 	BitsperBlock	= 2 * params. get_carriers ();
 	ficno		= 0;
 	ficBlocks	= 0;
+	ficSuccess	= 0;
 	ficMissed	= 0;
 	ficRatio	= 0;
 	memset (shiftRegister, 1, 9);
@@ -65,6 +73,13 @@ int16_t	local	= 0;
 
 	   shiftRegister [0] = PRBS [i];
 	}
+	memset (PRBSBytes, 0, sizeof (PRBSBytes));
+	for (i = 0; i < 768; i ++)
+	   PRBSBytes [i / 8] |= PRBS [i] << (7 - i % 8);
+	fibsParsed	= 0;
+	fibsSkipped	= 0;
+	fibsFailed	= 0;
+	clear_knownFIBs ();
 
 /**
   *	a block of 2304 bits is considered to be a codeword
@@ -104,6 +119,13 @@ int16_t	local	= 0;
 	      punctureTable [local] = true;
 	   local ++;
 	}
+//
+//	the 2304 non punctured positions, the depuncturing is then
+//	just a scatter without tests
+	local	= 0;
+	for (i = 0; i < 4 * 768 + 24; i ++)
+	   if (punctureTable [i])
+	      depunctureList [local ++] = i;
 }
 
 		ficHandler::~ficHandler (void) {
@@ -160,18 +182,20 @@ int32_t	i;
 void	ficHandler::process_ficInput (int16_t ficno) {
 int16_t	i;
 int16_t	viterbiBlock [3072 + 24];
-int16_t	inputCount	= 0;
 
 	memset (viterbiBlock, 0, (3072 + 24) * sizeof (int16_t));
 
-	for (i = 0; i < 4 * 768 + 24; i ++)
-	   if (punctureTable [i])
-	      viterbiBlock [i] = ofdm_input [inputCount ++];
+	for (i = 0; i < 2304; i ++)
+	   viterbiBlock [depunctureList [i]] = ofdm_input [i];
 /**
   *	Now we have the full word ready for deconvolution
   *	deconvolution is according to DAB standard section 11.2
+  *	The 768 bits are delivered packed
   */
-	deconvolve (viterbiBlock, bitBuffer_out);
+	{
+	   stageTimer	timer (STAGE_FIC_VITERBI);
+	   deconvolvePacked (viterbiBlock, fibBytes);
+	}
 /**
   *	if everything worked as planned, we now have a
   *	768 bit vector containing three FIB's
@@ -179,51 +203,114 @@ int16_t	inputCount	= 0;
   *	first step: energy dispersal according to the DAB standard
   *	We use a predefined vector PRBS
   */
-	for (i = 0; i < 768; i ++)
-	   bitBuffer_out [i] ^= PRBS [i];
+	for (i = 0; i < 768 / 8; i ++)
+	   fibBytes [i] ^= PRBSBytes [i];
 /**
   *	each of the fib blocks is protected by a crc
   *	(we know that there are three fib blocks each time we are here
   *	we keep track of the successrate
   *	and show that per 100 fic blocks
   */
-	for (i = ficno * 3; i < ficno * 3 + 3; i ++) {
-	   uint8_t *p = &bitBuffer_out [(i % 3) * 256];
-	   if (!check_CRC_bits (p, 256)) {
+	for (i = 0; i < 3; i ++) {
+	   uint8_t *p = &fibBytes [i * 32];
+	   if (!check_crc_bytes (p, 30)) {
+	      fibsFailed ++;
 	      show_ficCRC (false);
 	      continue;
 	   }
 	   show_ficCRC (true);
-	   fibProtector. lock ();
-	   fibHandler. process_FIB (p, ficno);
-	   fibProtector. unlock ();
+	   handle_FIB (p, ficno);
 	}
 }
+//
+//	FIB's carrying FIG 0/0 (the CIF count, in each frame), 0/10 (date
+//	and time) or 0/19 (announcement switching) are always parsed,
+//	they are found by just following the FIG headers
+static
+bool	isVolatile	(const uint8_t *fib) {
+int	processed	= 0;
+
+	while (processed < 30) {
+	   uint8_t FIGtype	= fib [processed] >> 5;
+	   uint8_t FIGlength	= fib [processed] & 0x1F;
+	   if (fib [processed] == 0xFF)		// end marker
+	      break;
+	   if ((FIGtype == 0) && (FIGlength > 0) && (processed + 1 < 30)) {
+	      uint8_t extension	= fib [processed + 1] & 0x1F;
+	      if ((extension == 0) || (extension == 10) || (extension == 19))
+	         return true;
+	   }
+	   processed += FIGlength + 1;
+	}
+	return false;
+}
+//
+//	fib points to the 32 (packed) bytes of a FIB with a valid CRC,
+//	the table of known FIB's is protected by the same lock as
+//	the FIB decoder
+void	ficHandler::handle_FIB	(uint8_t *fib, int16_t ficno) {
+	fibProtector. lock ();
+	if (!isVolatile (fib)) {
+	   uint16_t crc	= (fib [30] << 8) | fib [31];
+	   bool known	= false;
+	   auto range	= knownFIBs. equal_range (crc);
+	   for (auto it = range. first; it != range. second; it ++)
+	      if (memcmp (it -> second. data (), fib, 30) == 0) {
+	         known = true;
+	         break;
+	      }
+	   if (known && steadyState) {
+	      fibsSkipped ++;
+	      fibProtector. unlock ();
+	      return;
+	   }
+	   if (!known) {
+	      if (knownFIBs. size () >= MAX_KNOWN_FIBS)
+	         clear_knownFIBs ();
+	      fibContent content;
+	      memcpy (content. data (), fib, 30);
+	      knownFIBs. insert (std::make_pair (crc, content));
+	      repeatedFIBs	= 0;
+	      steadyState	= false;
+	   }
+	   else
+	   if (++repeatedFIBs >= STEADY_FIBS)
+	      steadyState	= true;
+	}
+
+	for (int i = 0; i < 256; i ++)
+	   fibBits [i] = (fib [i / 8] >> (7 - i % 8)) & 01;
+	fibsParsed ++;
+	fibHandler. process_FIB (fibBits, ficno);
+	fibProtector. unlock ();
+}
+
+void	ficHandler::clear_knownFIBs	() {
+	knownFIBs. clear ();
+	repeatedFIBs	= 0;
+	steadyState	= false;
+}
 
 void	ficHandler::clearEnsemble (void) {
 	fibProtector. lock ();
 	fibHandler. clear_ensemble ();
+	clear_knownFIBs ();
 	fibProtector. unlock ();
 }
 
+//
+//	the queries are answered by the fibDecoder from its snapshot
+//	of the database, no need to lock
 uint8_t	ficHandler::serviceType	(int index) {
-uint8_t	result;
-	fibProtector. lock ();
-	result	= fibHandler. serviceType (index);
-	fibProtector. unlock ();
-	return result;
+	return fibHandler. serviceType (index);
 }
 
 void	ficHandler::audioData	(int index, audiodata &ad) {
-	fibProtector. lock ();
 	fibHandler. audioData (index, ad);
-	fibProtector. unlock ();
 }
 
 void	ficHandler::packetData	(int index, packetdata &pd) {
-	fibProtector. lock ();
 	fibHandler. packetData (index, pd );
-	fibProtector. unlock ();
 }
 
 int32_t ficHandler::get_CIFcount        () {
@@ -239,27 +326,39 @@ bool	ficHandler::syncReached		() {
 	return fibHandler. syncReached ();
 }
 
-static	int 	pos	= 0;
-static	int	amount = 0;
 void	ficHandler::show_ficCRC (bool b) {
 	if (b) 
-	   pos ++;
-	if (++amount >= 100) {
+	   ficSuccess ++;
+	if (++ficBlocks >= 100) {
 	   if (fib_qualityHandler != nullptr)
-	      fib_qualityHandler (pos, userData);
-	   pos	= 0;
-	   amount	= 0;
+	      fib_qualityHandler (ficSuccess, userData);
+	   ficSuccess	= 0;
+	   ficBlocks	= 0;
 	}
 }
 
 void	ficHandler::reset		() {
+	fibProtector. lock ();
 	fibHandler. reset ();
+	clear_knownFIBs ();
+	fibProtector. unlock ();
+}
+
+void	ficHandler::get_fibStats	(uint64_t &parsed,
+	                                 uint64_t &skipped, uint64_t &failed) {
+	parsed	= fibsParsed. load ();
+	skipped	= fibsSkipped. load ();
+	failed	= fibsFailed. load ();
 }
 
 int	ficHandler::getServiceComp	(const std::string &s) {
 	return fibHandler. getServiceComp (s);
 }
 
+void	ficHandler::get_primaryComps	(std::vector<int> &v) {
+	fibHandler. get_primaryComps (v);
+}
+
 int	ficHandler::get_SId		(int index) {
 	return fibHandler. get_SId (index);
 }
@@ -280,3 +379,13 @@ std::string ficHandler::get_ensembleName () {
 	return fibHandler. get_ensembleName ();
 }
 
+std::shared_ptr<const ensembleSnapshot> ficHandler::get_ensemble () {
+	return fibHandler. get_snapshot ();
+}
+
+void	ficHandler::set_transmitters	(const std::vector<tiiData> &list) {
+	fibProtector. lock ();
+	fibHandler. set_transmitters (list);
+	fibProtector. unlock ();
+}
+
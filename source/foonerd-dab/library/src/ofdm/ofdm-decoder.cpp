@@ -29,6 +29,7 @@
 #include	"phasetable.h"
 #include	"freq-interleaver.h"
 #include	"dab-params.h"
+#include	"stage-timer.h"
 
 /**
   */
@@ -36,7 +37,7 @@
                                          RingBuffer<std::complex<float>> *iqBuffer):
 	                                     params (dabMode),
 	                                     my_fftHandler (dabMode),
-	                                     myMapper    (dabMode) {
+	                                     myDemapper  (dabMode) {
 
         this    -> iqBuffer             = iqBuffer;
 	this	-> T_s			= params. get_T_s ();
@@ -47,16 +48,60 @@
 	fft_buffer			= my_fftHandler. getVector ();
 	phaseReference. resize (T_u);
 	cnt				= 0;
+	frameHandler			= nullptr;
 }
 
 	ofdmDecoder::~ofdmDecoder	() {
+	if (frameHandler != nullptr)
+	   delete frameHandler;
+}
+//
+//	In batch mode the MSC blocks (4 .. L - 1) of a frame are read
+//	into a single frame buffer and transformed with a single plan
+void	ofdmDecoder::set_batchMode	(bool b) {
+	if (b && (frameHandler == nullptr))
+	   frameHandler	= new fft_handler (params. get_dabMode (),
+	                                   nrBlocks - 4);
+	else
+	if (!b && (frameHandler != nullptr)) {
+	   delete frameHandler;
+	   frameHandler = nullptr;
+	}
+}
+
+std::complex<float> *ofdmDecoder::getFrameBuffer	() {
+	return frameHandler == nullptr ? nullptr :
+	                                 frameHandler -> getFrameBuffer ();
+}
+
+void	ofdmDecoder::transformFrame	() {
+stageTimer	timer (STAGE_FFT);
+	frameHandler	-> do_frameFFT ();
+}
+//
+//	symbol is the index in the frame buffer, the phase reference
+//	for symbol 0 is the last block handled by decode, i.e. block 3
+void	ofdmDecoder::decodeFrameSymbol	(int16_t symbol,
+	                                 int32_t blkno, int16_t *ibits) {
+std::complex<float> *spectrum	= frameHandler -> getSpectrum (symbol);
+
+	demap (spectrum,
+	       symbol == 0 ? phaseReference. data () :
+	                     frameHandler -> getSpectrum (symbol - 1),
+	       blkno, ibits);
+	if (symbol == nrBlocks - 5)
+	   memcpy (phaseReference. data (),
+	                 spectrum, T_u * sizeof (std::complex<float>));
 }
 
 void	ofdmDecoder::processBlock_0 (std::complex<float> *buffer) {
 	memcpy (fft_buffer, buffer,
 	                      T_u * sizeof (std::complex<float>));
 
-	my_fftHandler. do_FFT ();
+	{
+	   stageTimer	timer (STAGE_FFT);
+	   my_fftHandler. do_FFT ();
+	}
 /**
   *	we are now in the frequency domain, and we keep the carriers
   *	as coming from the FFT as phase reference.
@@ -67,13 +112,6 @@ void	ofdmDecoder::processBlock_0 (std::complex<float> *buffer) {
 
 void	ofdmDecoder::decode (std::complex<float> *buffer,
 	                             int32_t blkno, int16_t *ibits) {
-int16_t	i;
-#ifdef _MSC_VER
-std::complex<float> *conjVector = (std::complex<float> *)_alloca(T_u*sizeof(std::complex<float>));
-#else
-std::complex<float> conjVector [T_u];
-#endif
-
       memcpy (fft_buffer, &(buffer[T_g]),
                                        T_u * sizeof (std::complex<float>));
 
@@ -81,50 +119,45 @@ std::complex<float> conjVector [T_u];
 /**
   *	first step: do the FFT
   */
-	my_fftHandler. do_FFT ();
-/**
-  *	a little optimization: we do not interchange the
-  *	positive/negative frequencies to their right positions.
-  *	The de-interleaving understands this
-  */
-//toBitsLabel:
-/**
-  *	Note that from here on, we are only interested in the
-  *	"carriers" useful carriers of the FFT output
-  */
-	for (i = 0; i < carriers; i ++) {
-	   int16_t	index	= myMapper. mapIn (i);
-	   if (index < 0) 
-	      index += T_u;
+	{
+	   stageTimer	timer (STAGE_FFT);
+	   my_fftHandler. do_FFT ();
+	}
+	demap (fft_buffer, phaseReference. data (), blkno, ibits);
+	memcpy (phaseReference. data (),
+	          fft_buffer, T_u * sizeof (std::complex<float>));
+}
+
+void	ofdmDecoder::demap	(std::complex<float> *spectrum,
+	                         std::complex<float> *reference,
+	                         int32_t blkno, int16_t *ibits) {
 /**
   *	decoding is computing the phase difference between
   *	carriers with the same index in subsequent blocks.
   *	The carrier of a block is the reference for the carrier
-  *	on the same position in the next block
+  *	on the same position in the next block.
+  *	The de-interleaving is folded into the demapper, note that
+  *	we do not interchange the positive/negative frequencies
+  *	to their right positions, the demapper understands this
   */
-	   std::complex<float>	r1 = fft_buffer [index] * conj (phaseReference [index]);
-           conjVector [index] = r1;
-//	The viterbi decoder expects values in the range 0 .. 255,
-//	we present values -127 .. 127 (easy with depuncturing)
-	   float ab1		= abs (r1);
-	   ibits [i]		= - (real (r1) * 128) / ab1;
-	   ibits [carriers + i] = - (imag (r1) * 128) / ab1;
+	if ((blkno != 2) || (iqBuffer == nullptr) || (++cnt <= 7)) {
+	   myDemapper. demap (spectrum, reference, ibits);
+	   return;
 	}
-
-	memcpy (phaseReference. data (),
-	          fft_buffer, T_u * sizeof (std::complex<float>));
+#ifdef _MSC_VER
+std::complex<float> *conjVector = (std::complex<float> *)_alloca(T_u*sizeof(std::complex<float>));
+#else
+std::complex<float> conjVector [T_u];
+#endif
+	myDemapper. demap (spectrum, reference, ibits, conjVector);
 //	From time to time we show the constellation of block 2.
 //	Note that we do it in two steps since the
 //	fftbuffer contained low and high at the ends
 //	and we maintain that format
-	if ((blkno == 2) && (iqBuffer != nullptr)) {
-	   if (++cnt > 7) {
-	      iqBuffer	-> putDataIntoBuffer (&conjVector [0],
+	iqBuffer	-> putDataIntoBuffer (&conjVector [0],
 	                                      carriers / 2);
-	      iqBuffer	-> putDataIntoBuffer (&conjVector [T_u - 1 - carriers / 2],
+	iqBuffer	-> putDataIntoBuffer (&conjVector [T_u - 1 - carriers / 2],
 	                                      carriers / 2);
-	      cnt = 0;
-	   }
-	}
+	cnt = 0;
 }
 
@@ -0,0 +1,326 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"ofdm-demapper.h"
+#include	"freq-interleaver.h"
+#include	"stage-timer.h"
+#include	<math.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define	X86_KERNELS
+#include	<immintrin.h>
+#endif
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define	NEON_KERNELS
+#include	<arm_neon.h>
+#endif
+
+//	CMakeLists.txt builds this file with -fno-fast-math, see
+//	ofdm-demapper.h
+//
+//	|r| is bounded from below, so a zero product gives zero bits
+//	rather than a NaN converted to an integer
+#define	MIN_MAGNITUDE	1.0e-30f
+
+static inline
+void	demapOne	(const std::complex<float> *spectrum,
+	                 const std::complex<float> *reference,
+	                 int32_t bin, int i, int carriers, int16_t *ibits) {
+const float *s	= reinterpret_cast<const float *>(&spectrum [bin]);
+const float *r	= reinterpret_cast<const float *>(&reference [bin]);
+float	re	= s [0] * r [0] + s [1] * r [1];
+float	im	= s [1] * r [0] - s [0] * r [1];
+float	ab	= sqrtf (re * re + im * im);
+
+	if (ab < MIN_MAGNITUDE)
+	   ab = MIN_MAGNITUDE;
+	ibits [i]		= (int16_t)(- (re * 128) / ab);
+	ibits [carriers + i]	= (int16_t)(- (im * 128) / ab);
+}
+
+static
+void	demap_scalar	(const std::complex<float> *spectrum,
+	                 const std::complex<float> *reference,
+	                 const int32_t *binTable, int carriers,
+	                 int16_t *ibits) {
+	for (int i = 0; i < carriers; i ++)
+	   demapOne (spectrum, reference, binTable [i], i, carriers, ibits);
+}
+
+#ifdef	X86_KERNELS
+//
+//	SSE2, 4 carriers per step. Two complex values are loaded per
+//	register, and the real and imaginary parts are separated
+//	with a shuffle
+__attribute__ ((target ("sse2")))
+static
+void	demap_sse2	(const std::complex<float> *spectrum,
+	                 const std::complex<float> *reference,
+	                 const int32_t *binTable, int carriers,
+	                 int16_t *ibits) {
+const __m128	scale	= _mm_set1_ps (-128.0f);
+const __m128	minMag	= _mm_set1_ps (MIN_MAGNITUDE);
+const __m64	*s	= reinterpret_cast<const __m64 *>(spectrum);
+const __m64	*r	= reinterpret_cast<const __m64 *>(reference);
+int	i;
+
+	for (i = 0; i + 4 <= carriers; i += 4) {
+	   const int32_t *b	= &binTable [i];
+	   __m128 s01	= _mm_loadh_pi (_mm_loadl_pi (_mm_setzero_ps (),
+	                                                  &s [b [0]]),
+	                                                  &s [b [1]]);
+	   __m128 s23	= _mm_loadh_pi (_mm_loadl_pi (_mm_setzero_ps (),
+	                                                  &s [b [2]]),
+	                                                  &s [b [3]]);
+	   __m128 r01	= _mm_loadh_pi (_mm_loadl_pi (_mm_setzero_ps (),
+	                                                  &r [b [0]]),
+	                                                  &r [b [1]]);
+	   __m128 r23	= _mm_loadh_pi (_mm_loadl_pi (_mm_setzero_ps (),
+	                                                  &r [b [2]]),
+	                                                  &r [b [3]]);
+	   __m128 sRe	= _mm_shuffle_ps (s01, s23, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m128 sIm	= _mm_shuffle_ps (s01, s23, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m128 rRe	= _mm_shuffle_ps (r01, r23, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m128 rIm	= _mm_shuffle_ps (r01, r23, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m128 re	= _mm_add_ps (_mm_mul_ps (sRe, rRe),
+	                              _mm_mul_ps (sIm, rIm));
+	   __m128 im	= _mm_sub_ps (_mm_mul_ps (sIm, rRe),
+	                              _mm_mul_ps (sRe, rIm));
+	   __m128 ab	= _mm_sqrt_ps (_mm_add_ps (_mm_mul_ps (re, re),
+	                                           _mm_mul_ps (im, im)));
+	   ab		= _mm_max_ps (ab, minMag);
+	   __m128i bRe	= _mm_cvttps_epi32 (_mm_div_ps (_mm_mul_ps (re, scale), ab));
+	   __m128i bIm	= _mm_cvttps_epi32 (_mm_div_ps (_mm_mul_ps (im, scale), ab));
+	   __m128i packed	= _mm_packs_epi32 (bRe, bIm);
+	   _mm_storel_epi64 ((__m128i *)&ibits [i], packed);
+	   _mm_storel_epi64 ((__m128i *)&ibits [carriers + i],
+	                               _mm_unpackhi_epi64 (packed, packed));
+	}
+	for (; i < carriers; i ++)
+	   demapOne (spectrum, reference, binTable [i], i, carriers, ibits);
+}
+//
+//	AVX2, 8 carriers per step. The hardware gathers turn out to be
+//	slower than pairs of 64 bit loads, so the complex values are
+//	loaded as in the SSE2 version, lane 0 taking carriers 0 .. 3 and
+//	lane 1 carriers 4 .. 7. Note that fma is deliberately not enabled,
+//	contracting the multiply-adds would make the result differ from
+//	the other kernels
+__attribute__ ((target ("avx2")))
+static inline
+__m256	load4Pairs	(const __m64 *v, const int32_t *b,
+	                 int i0, int i1, int i2, int i3) {
+__m128	lo	= _mm_loadh_pi (_mm_loadl_pi (_mm_setzero_ps (),
+	                                      &v [b [i0]]), &v [b [i1]]);
+__m128	hi	= _mm_loadh_pi (_mm_loadl_pi (_mm_setzero_ps (),
+	                                      &v [b [i2]]), &v [b [i3]]);
+	return _mm256_insertf128_ps (_mm256_castps128_ps256 (lo), hi, 1);
+}
+
+__attribute__ ((target ("avx2")))
+static
+void	demap_avx2	(const std::complex<float> *spectrum,
+	                 const std::complex<float> *reference,
+	                 const int32_t *binTable, int carriers,
+	                 int16_t *ibits) {
+const __m256	scale	= _mm256_set1_ps (-128.0f);
+const __m256	minMag	= _mm256_set1_ps (MIN_MAGNITUDE);
+const __m64	*s	= reinterpret_cast<const __m64 *>(spectrum);
+const __m64	*r	= reinterpret_cast<const __m64 *>(reference);
+int	i;
+
+	for (i = 0; i + 8 <= carriers; i += 8) {
+	   const int32_t *b	= &binTable [i];
+	   __m256 sA	= load4Pairs (s, b, 0, 1, 4, 5);
+	   __m256 sB	= load4Pairs (s, b, 2, 3, 6, 7);
+	   __m256 rA	= load4Pairs (r, b, 0, 1, 4, 5);
+	   __m256 rB	= load4Pairs (r, b, 2, 3, 6, 7);
+	   __m256 sRe	= _mm256_shuffle_ps (sA, sB, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m256 sIm	= _mm256_shuffle_ps (sA, sB, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m256 rRe	= _mm256_shuffle_ps (rA, rB, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m256 rIm	= _mm256_shuffle_ps (rA, rB, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m256 re	= _mm256_add_ps (_mm256_mul_ps (sRe, rRe),
+	                                 _mm256_mul_ps (sIm, rIm));
+	   __m256 im	= _mm256_sub_ps (_mm256_mul_ps (sIm, rRe),
+	                                 _mm256_mul_ps (sRe, rIm));
+	   __m256 ab	= _mm256_sqrt_ps (_mm256_add_ps (_mm256_mul_ps (re, re),
+	                                                 _mm256_mul_ps (im, im)));
+	   ab		= _mm256_max_ps (ab, minMag);
+	   __m256i bRe	= _mm256_cvttps_epi32 (_mm256_div_ps (
+	                                   _mm256_mul_ps (re, scale), ab));
+	   __m256i bIm	= _mm256_cvttps_epi32 (_mm256_div_ps (
+	                                   _mm256_mul_ps (im, scale), ab));
+	   _mm_storeu_si128 ((__m128i *)&ibits [i],
+	                     _mm_packs_epi32 (_mm256_castsi256_si128 (bRe),
+	                                      _mm256_extracti128_si256 (bRe, 1)));
+	   _mm_storeu_si128 ((__m128i *)&ibits [carriers + i],
+	                     _mm_packs_epi32 (_mm256_castsi256_si128 (bIm),
+	                                      _mm256_extracti128_si256 (bIm, 1)));
+	}
+	for (; i < carriers; i ++)
+	   demapOne (spectrum, reference, binTable [i], i, carriers, ibits);
+}
+#endif
+
+#ifdef	NEON_KERNELS
+//
+//	NEON, 4 carriers per step. 32 bit ARM has no vector sqrt and
+//	division, there the reciprocal square root estimate is refined
+//	with two Newton Raphson steps, and the bits may differ by 1
+static
+void	demap_neon	(const std::complex<float> *spectrum,
+	                 const std::complex<float> *reference,
+	                 const int32_t *binTable, int carriers,
+	                 int16_t *ibits) {
+const float	*s	= reinterpret_cast<const float *>(spectrum);
+const float	*r	= reinterpret_cast<const float *>(reference);
+const float32x4_t scale	= vdupq_n_f32 (-128.0f);
+const float32x4_t minMag	= vdupq_n_f32 (MIN_MAGNITUDE);
+int	i;
+
+	for (i = 0; i + 4 <= carriers; i += 4) {
+	   const int32_t *b	= &binTable [i];
+	   float32x4x2_t sv	= vuzpq_f32 (
+	                           vcombine_f32 (vld1_f32 (&s [2 * b [0]]),
+	                                         vld1_f32 (&s [2 * b [1]])),
+	                           vcombine_f32 (vld1_f32 (&s [2 * b [2]]),
+	                                         vld1_f32 (&s [2 * b [3]])));
+	   float32x4x2_t rv	= vuzpq_f32 (
+	                           vcombine_f32 (vld1_f32 (&r [2 * b [0]]),
+	                                         vld1_f32 (&r [2 * b [1]])),
+	                           vcombine_f32 (vld1_f32 (&r [2 * b [2]]),
+	                                         vld1_f32 (&r [2 * b [3]])));
+	   float32x4_t re	= vaddq_f32 (vmulq_f32 (sv. val [0], rv. val [0]),
+	                                     vmulq_f32 (sv. val [1], rv. val [1]));
+	   float32x4_t im	= vsubq_f32 (vmulq_f32 (sv. val [1], rv. val [0]),
+	                                     vmulq_f32 (sv. val [0], rv. val [1]));
+	   float32x4_t sq	= vaddq_f32 (vmulq_f32 (re, re),
+	                                     vmulq_f32 (im, im));
+#ifdef	__aarch64__
+	   float32x4_t ab	= vmaxq_f32 (vsqrtq_f32 (sq), minMag);
+	   int32x4_t bRe	= vcvtq_s32_f32 (vdivq_f32 (vmulq_f32 (re, scale), ab));
+	   int32x4_t bIm	= vcvtq_s32_f32 (vdivq_f32 (vmulq_f32 (im, scale), ab));
+#else
+	   sq			= vmaxq_f32 (sq, vmulq_f32 (minMag, minMag));
+	   float32x4_t rs	= vrsqrteq_f32 (sq);
+	   rs	= vmulq_f32 (rs, vrsqrtsq_f32 (vmulq_f32 (sq, rs), rs));
+	   rs	= vmulq_f32 (rs, vrsqrtsq_f32 (vmulq_f32 (sq, rs), rs));
+	   int32x4_t bRe	= vcvtq_s32_f32 (vmulq_f32 (vmulq_f32 (re, scale), rs));
+	   int32x4_t bIm	= vcvtq_s32_f32 (vmulq_f32 (vmulq_f32 (im, scale), rs));
+#endif
+	   vst1_s16 (&ibits [i], vqmovn_s32 (bRe));
+	   vst1_s16 (&ibits [carriers + i], vqmovn_s32 (bIm));
+	}
+	for (; i < carriers; i ++)
+	   demapOne (spectrum, reference, binTable [i], i, carriers, ibits);
+}
+#endif
+
+	ofdmDemapper::ofdmDemapper	(uint8_t dabMode):
+	                                    params (dabMode) {
+interLeaver	myMapper (dabMode);
+int32_t	T_u	= params. get_T_u ();
+
+	this	-> carriers	= params. get_carriers ();
+//	a little optimization: we do not interchange the
+//	positive/negative frequencies to their right positions,
+//	the table maps carrier i directly onto its FFT bin
+	binTable. resize (carriers);
+	for (int i = 0; i < carriers; i ++) {
+	   int32_t index	= myMapper. mapIn (i);
+	   if (index < 0)
+	      index += T_u;
+	   binTable [i]	= index;
+	}
+	setKernel (DEMAP_AUTO);
+}
+
+	ofdmDemapper::~ofdmDemapper	() {
+}
+
+bool	ofdmDemapper::setKernel	(int kernel) {
+	switch (kernel) {
+	   case DEMAP_AUTO:
+#ifdef	X86_KERNELS
+	      if (__builtin_cpu_supports ("avx2"))
+	         return setKernel (DEMAP_AVX2);
+	      if (__builtin_cpu_supports ("sse2"))
+	         return setKernel (DEMAP_SSE2);
+#endif
+#ifdef	NEON_KERNELS
+	      return setKernel (DEMAP_NEON);
+#endif
+	      return setKernel (DEMAP_SCALAR);
+
+	   case DEMAP_SCALAR:
+	      theKernel	= demap_scalar;
+	      break;
+#ifdef	X86_KERNELS
+	   case DEMAP_SSE2:
+	      if (!__builtin_cpu_supports ("sse2"))
+	         return false;
+	      theKernel	= demap_sse2;
+	      break;
+
+	   case DEMAP_AVX2:
+	      if (!__builtin_cpu_supports ("avx2"))
+	         return false;
+	      theKernel	= demap_avx2;
+	      break;
+#endif
+#ifdef	NEON_KERNELS
+	   case DEMAP_NEON:
+	      theKernel	= demap_neon;
+	      break;
+#endif
+	   default:
+	      return false;
+	}
+	kernelType	= kernel;
+	return true;
+}
+
+const char	*ofdmDemapper::kernelName	() {
+	switch (kernelType) {
+	   case DEMAP_SSE2:	return "sse2";
+	   case DEMAP_AVX2:	return "avx2";
+	   case DEMAP_NEON:	return "neon";
+	   default:		return "scalar";
+	}
+}
+
+void	ofdmDemapper::demap	(const std::complex<float> *spectrum,
+	                         const std::complex<float> *reference,
+	                         int16_t *ibits,
+	                         std::complex<float> *products) {
+stageTimer	timer (STAGE_DEMAP);
+	if (products != nullptr) {
+	   for (int i = 0; i < carriers; i ++) {
+	      int32_t bin	= binTable [i];
+	      products [bin]	= spectrum [bin] * conj (reference [bin]);
+	      demapOne (spectrum, reference, bin, i, carriers, ibits);
+	   }
+	   return;
+	}
+	theKernel (spectrum, reference, binTable. data (), carriers, ibits);
+}
+
@@ -0,0 +1,236 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"ofdm-pipeline.h"
+#include	"msc-handler.h"
+#include	"stage-timer.h"
+#include	<cstring>
+
+//
+//	Slots are used round robin, each symbol gets a sequence number
+//	and lives in slot "seqno % nrSlots". A slot can only be refilled
+//	after its successor is delivered, since the FFT output of a symbol
+//	is the phase reference for the next one. Therefore one slot
+//	more than the number of free slots is allocated
+static inline
+int	slotsFor	(int nrWorkers) {
+	return nrWorkers * 8 < 16 ? 16 : nrWorkers * 8;
+}
+
+	ofdmPipeline::ofdmPipeline	(uint8_t	dabMode,
+	                                 int		nrWorkers,
+	                                 mscHandler	*theMscHandler):
+	                                    params (dabMode),
+	                                    myDemapper (dabMode),
+	                                    freeSlots (slotsFor (nrWorkers) - 1),
+	                                    usedSlots (0) {
+	this	-> theMscHandler	= theMscHandler;
+	this	-> nrWorkers		= nrWorkers < 1 ? 1 : nrWorkers;
+	this	-> nrSlots		= slotsFor (nrWorkers);
+	this	-> T_s			= params. get_T_s ();
+	this	-> T_u			= params. get_T_u ();
+	this	-> T_g			= params. get_T_g ();
+	this	-> carriers		= params. get_carriers ();
+	for (int i = 0; i < nrSlots; i ++) {
+	   symbolSlot *s	= new symbolSlot;
+	   s -> timeData. resize (T_s);
+	   s -> freqData. resize (T_u);
+	   s -> ibits. resize (2 * carriers);
+	   s -> blkno		= 0;
+	   s -> isReference	= true;
+	   s -> transformed. store (-1);
+	   s -> demapped. store (-1);
+	   slots. push_back (s);
+	}
+//	fftw planning is not thread safe, so all plans are made here,
+//	executing them from the workers is
+	for (int i = 0; i < this -> nrWorkers; i ++)
+	   fftHandlers. push_back (new fft_handler (dabMode));
+	published. store (0);
+	claimed. store (0);
+	demappedCount. store (0);
+	delivered. store (0);
+	producerStalls. store (0);
+	peakWaiting. store (0);
+	filling		= 0;
+	bufferTaken	= false;
+	running. store (false);
+}
+
+	ofdmPipeline::~ofdmPipeline	() {
+	stop ();
+	for (auto s : slots)
+	   delete s;
+	for (auto f : fftHandlers)
+	   delete f;
+}
+
+void	ofdmPipeline::start		() {
+	if (running. load ())
+	   return;
+	reset ();
+	running. store (true);
+	for (int i = 0; i < nrWorkers; i ++)
+	   workers. push_back (std::thread (&ofdmPipeline::run, this, i));
+}
+
+void	ofdmPipeline::stop		() {
+	if (!running. load ())
+	   return;
+	running. store (false);
+	for (auto &w : workers)
+	   w. join ();
+	workers. resize (0);
+	reset ();
+}
+//
+//	Bring the semaphores and the counters back into the
+//	"empty" state, symbols still in the pipeline are discarded.
+//	Only called while no workers are active
+void	ofdmPipeline::reset		() {
+int64_t	inUse	= published. load () - delivered. load ();
+
+	if (bufferTaken)
+	   inUse ++;
+	for (int64_t i = 0; i < inUse; i ++)
+	   freeSlots. Release ();
+	while (usedSlots. tryAcquire (0))
+	   ;
+	for (auto s : slots) {
+	   s -> transformed. store (-1);
+	   s -> demapped. store (-1);
+	}
+	published. store (0);
+	claimed. store (0);
+	demappedCount. store (0);
+	delivered. store (0);
+	filling		= 0;
+	bufferTaken	= false;
+}
+//
+//	called by the sync thread
+std::complex<float> *ofdmPipeline::getBuffer	() {
+	if (!freeSlots. tryAcquire (0)) {
+	   producerStalls ++;
+	   while (!freeSlots. tryAcquire (200))
+	      if (!running. load ())
+	         return nullptr;
+	}
+	bufferTaken	= true;
+	return slots [filling % nrSlots] -> timeData. data ();
+}
+
+void	ofdmPipeline::putBuffer	(int16_t blkno, bool isReference) {
+symbolSlot *s	= slots [filling % nrSlots];
+
+	s -> blkno		= blkno;
+	s -> isReference	= isReference;
+	bufferTaken		= false;
+	published. store (++ filling);
+	int waiting	= (int)(filling - claimed. load ());
+	if (waiting > peakWaiting. load ())
+	   peakWaiting. store (waiting);
+	usedSlots. Release ();
+}
+
+//
+//	The workers. Symbols are claimed in order, so the predecessor
+//	of a symbol is - at worst - being transformed by another worker
+//	when we need it as phase reference
+void	ofdmPipeline::run		(int index) {
+fft_handler	*my_fftHandler	= fftHandlers [index];
+std::complex<float> *fft_buffer	= my_fftHandler -> getVector ();
+
+	while (running. load ()) {
+	   if (!usedSlots. tryAcquire (200))
+	      continue;
+	   int64_t seqNo	= claimed. fetch_add (1);
+	   symbolSlot *s	= slots [seqNo % nrSlots];
+	   memcpy (fft_buffer, &(s -> timeData [T_g]),
+	                           T_u * sizeof (std::complex<float>));
+	   {
+	      stageTimer	timer (STAGE_FFT);
+	      my_fftHandler -> do_FFT ();
+	   }
+	   memcpy (s -> freqData. data (), fft_buffer,
+	                           T_u * sizeof (std::complex<float>));
+	   s -> transformed. store (seqNo);
+
+	   if (!s -> isReference && (seqNo > 0)) {
+	      symbolSlot *prev	= slots [(seqNo - 1) % nrSlots];
+	      while (prev -> transformed. load () != seqNo - 1) {
+	         if (!running. load ())
+	            return;
+	         std::this_thread::yield ();
+	      }
+	      demap (s, prev);
+	   }
+	   s -> demapped. store (seqNo);
+	   demappedCount ++;
+	   deliver ();
+	}
+}
+//
+//	decoding is computing the phase difference between
+//	carriers with the same index in subsequent blocks,
+//	the demapper is shared by the workers, it is read only
+void	ofdmPipeline::demap	(symbolSlot *s, symbolSlot *prev) {
+	myDemapper. demap (s -> freqData. data (),
+	                   prev -> freqData. data (), s -> ibits. data ());
+}
+//
+//	The mscHandler wants the blocks in order. Whoever holds the
+//	lock delivers as many consecutive demapped symbols as there are.
+//	The lock is waited for: try_lock may fail spuriously, and a
+//	symbol left behind that way - the last ones of the input in
+//	particular - would never be delivered. A worker getting the
+//	lock after the holder finds its symbol delivered already
+void	ofdmPipeline::deliver	() {
+	std::lock_guard<std::mutex> guard (deliverLock);
+	int64_t next	= delivered. load ();
+	while (next < published. load ()) {
+	   symbolSlot *s = slots [next % nrSlots];
+	   if (s -> demapped. load () != next)
+	      break;
+	   if (!s -> isReference)
+	      theMscHandler -> process_mscBlock (s -> ibits, s -> blkno);
+	   delivered. store (++ next);
+	   freeSlots. Release ();
+	}
+}
+
+void	ofdmPipeline::getStats	(pipelineStats *st) {
+int64_t	p	= published. load ();
+int64_t	c	= claimed. load ();
+int64_t	m	= demappedCount. load ();
+int64_t	d	= delivered. load ();
+
+	st -> workers			= nrWorkers;
+	st -> slots			= nrSlots;
+	st -> waitingForWorker		= (int)(p - c);
+	st -> inProgress		= (int)(c - m);
+	st -> waitingForDelivery	= (int)(m - d);
+	st -> peakWaitingForWorker	= peakWaiting. load ();
+	st -> producerStalls		= producerStalls. load ();
+	st -> symbolsDelivered		= d;
+}
+
@@ -24,28 +24,65 @@
 #include	"sample-reader.h"
 #include	"device-handler.h"
 #include	"dab-processor.h"
+#include	"stage-timer.h"
+#include	<cstring>
+#include	<cmath>
+
+//
+//	The oscillator is e^(j 2 pi p / INPUT_RATE) for an integer phase p.
+//	Rather than a table with INPUT_RATE entries (16 Mbyte) we use
+//	two small ones, p = hi * FINE_SIZE + lo, and the value is
+//	coarse [hi] * fine [lo] (24 Kbyte in total, i.e. in L1).
+//	The tables are read-only and shared between all sampleReader
+//	instances, the (C++11) initialization of a local static is
+//	thread safe
+#define	FINE_SIZE	2048
+#define	COARSE_SIZE	(INPUT_RATE / FINE_SIZE)
+
+struct oscillatorTables {
+	std::complex<float>	coarse [COARSE_SIZE];
+	std::complex<float>	fine   [FINE_SIZE];
+};
 
 static
-std::complex<float> oscillatorTable [INPUT_RATE];
+const oscillatorTables	&sharedOscillator () {
+static const oscillatorTables *theTables = [] () {
+	   oscillatorTables *t = new oscillatorTables;
+	   for (int i = 0; i < COARSE_SIZE; i ++)
+	      t -> coarse [i] = std::polar (1.0f,
+	                      (float)(2.0 * M_PI * i * FINE_SIZE / INPUT_RATE));
+	   for (int i = 0; i < FINE_SIZE; i ++)
+	      t -> fine [i] = std::polar (1.0f,
+	                      (float)(2.0 * M_PI * i / INPUT_RATE));
+	   return t;
+	} ();
+	return *theTables;
+}
+
+static inline
+std::complex<float> oscillator (const oscillatorTables &t, int32_t phase) {
+	return t. coarse [phase / FINE_SIZE] * t. fine [phase % FINE_SIZE];
+}
 
 	sampleReader::sampleReader (dabProcessor *parent,
 	                            deviceHandler	*theRig,
 	                            RingBuffer<std::complex<float>> *spectrumBuffer
 	                           ) {
-int	i;
 	theParent		= parent;
 	this	-> theRig	= theRig;
 	bufferSize		= 32768;
 	this    -> spectrumBuffer       = spectrumBuffer;
 	localBuffer. resize (bufferSize);
+	pending. resize (PENDING_SIZE);
+	pendingIndex		= 0;
+	pendingCount		= 0;
 	localCounter		= 0;
 	currentPhase		= 0;
 	sLevel			= 0;
 	sampleCount		= 0;
-	for (i = 0; i < INPUT_RATE; i ++)
-	   oscillatorTable [i] = std::complex<float>
-	                            (cos (2.0 * M_PI * i / INPUT_RATE),
-	                             sin (2.0 * M_PI * i / INPUT_RATE));
+	samplesRead. store (0);
+	waitedNs		= 0;
+	oscillatorTable		= &sharedOscillator ();
 
 	corrector	= 0;
 	running. store (true);
@@ -64,26 +101,67 @@ void	sampleReader::reset	(void) {
 
 void	sampleReader::setRunning (bool b) {
 	running. store (b);
+	if (!b)
+	   theRig -> wakeUp ();
+}
+//
+//	Wait - blocking - until the device has (at least) n samples,
+//	the wait is interrupted by setRunning (false)
+//	Only the time actually spent waiting counts as input wait, it
+//	is recorded and subtracted from the time of the sample reader
+int32_t	sampleReader::waitFor	(int32_t n) {
+int32_t	available	= theRig -> Samples ();
+
+	if (running. load () && (available >= n))
+	   return available;
+uint64_t startTime	= stageTimingOn. load (std::memory_order_relaxed) ?
+	                                                   stageClock () : 0;
+	while (running. load () &&
+	          ((available = theRig -> waitForSamples (n, 100)) < n))
+	   ;
+	if (startTime != 0) {
+	   uint64_t waited	= stageClock () - startTime;
+	   stageRecord (STAGE_INPUT_WAIT, waited);
+	   waitedNs	+= waited;
+	}
+	if (!running. load ())
+	   throw 20;
+	return available;
+}
+//
+//	getSample is used (by the timeSyncer) for long runs of samples,
+//	one at the time. Rather than asking the device for each sample,
+//	whatever the device has (up to PENDING_SIZE) is fetched at once,
+//	getSamples takes the remainder first
+void	sampleReader::fillPending	() {
+	pendingIndex	= 0;
+	pendingCount	= 0;
+	while (pendingCount <= 0) {
+	   int32_t available	= waitFor (1);
+	   if (available > PENDING_SIZE)
+	      available = PENDING_SIZE;
+	   pendingCount	= theRig -> getSamples (pending. data (), available);
+	}
+	samplesRead. store (samplesRead. load () + pendingCount);
 }
 
 float	sampleReader::get_sLevel (void) {
 	return sLevel;
 }
 
+uint64_t	sampleReader::get_samplesRead	(void) {
+	return samplesRead. load ();
+}
+
 std::complex<float> sampleReader::getSample (int32_t phaseOffset) {
 std::complex<float> temp;
 
 	if (!running. load ())
 	   throw 21;
 
-	while (running. load () && (theRig -> Samples () < 1))
-	      usleep (100);
-
-	if (!running. load ())	
-	   throw 20;
-//
-//	so here, bufferContent > 0
-	theRig -> getSamples (&temp, 1);
+	if (pendingIndex >= pendingCount)
+	   fillPending ();
+	temp	= pending [pendingIndex ++];
 
 	if (localCounter < bufferSize)
 	   localBuffer [localCounter ++]        = temp;
@@ -93,7 +171,7 @@ std::complex<float> temp;
 	currentPhase	-= phaseOffset;
 	currentPhase	= (currentPhase + INPUT_RATE) % INPUT_RATE;
 
-	temp		*= oscillatorTable [currentPhase];
+	temp		*= oscillator (*oscillatorTable, currentPhase);
 	sLevel		= 0.00001 * jan_abs (temp) + (1 - 0.00001) * sLevel;
 #define	N	5
 	sampleCount	++;
@@ -108,29 +186,164 @@ std::complex<float> temp;
 	return temp;
 }
 
+//
+//	mixBlock applies the frequency correction to a block of samples
+//	and returns the sum of the (approximated) amplitudes.
+//	The phase stays an integer (it is exact and cannot drift), the
+//	oscillator is generated in lanes of 8 samples by recursive
+//	rotation, i.e. multiplication with e^(j 2 pi 8 f / INPUT_RATE).
+//	Every MIX_CHUNK samples the lanes are reseeded from the exact
+//	phase, so the rounding errors of the rotation do not accumulate.
+//	The inner loops are written such that the compiler vectorizes
+//	them
+#define	MIX_LANES	8
+#define	MIX_CHUNK	256
+float	sampleReader::mixBlock	(const std::complex<float> *in,
+	                         std::complex<float> *v,
+	                         int32_t n, int32_t phaseOffset) {
+const oscillatorTables &t	= *oscillatorTable;
+//	the phase decrements by phaseOffset per sample, increment
+int32_t	step	= ((- phaseOffset) % INPUT_RATE + INPUT_RATE) % INPUT_RATE;
+float	seedRe [MIX_LANES], seedIm [MIX_LANES];
+float	rotRe  [MIX_LANES], rotIm  [MIX_LANES];
+float	laneSum [MIX_LANES];
+
+	for (int j = 0; j < MIX_LANES; j ++) {
+	   std::complex<float> s =
+	           oscillator (t, (int32_t)(((int64_t)j * step) % INPUT_RATE));
+	   seedRe [j]	= real (s);
+	   seedIm [j]	= imag (s);
+	   laneSum [j]	= 0;
+	}
+std::complex<float> w	=
+	   oscillator (t, (int32_t)(((int64_t)MIX_LANES * step) % INPUT_RATE));
+const float wRe	= real (w);
+const float wIm	= imag (w);
+
+	for (int32_t i = 0; i < n; i += MIX_CHUNK) {
+	   int32_t m	= n - i < MIX_CHUNK ? n - i : MIX_CHUNK;
+//	phase of the first sample of the chunk
+	   currentPhase	= (currentPhase + step) % INPUT_RATE;
+	   std::complex<float> base	= oscillator (t, currentPhase);
+	   for (int j = 0; j < MIX_LANES; j ++) {
+	      rotRe [j]	= real (base) * seedRe [j] - imag (base) * seedIm [j];
+	      rotIm [j]	= real (base) * seedIm [j] + imag (base) * seedRe [j];
+	   }
+	   const float *y	= reinterpret_cast<const float *>(&in [i]);
+	   float *x	= reinterpret_cast<float *>(&v [i]);
+	   for (int32_t k = 0; k < m; k += MIX_LANES) {
+	      int lanes	= m - k < MIX_LANES ? m - k : MIX_LANES;
+	      if (lanes == MIX_LANES) {
+	         for (int j = 0; j < MIX_LANES; j ++) {
+	            float re	= y [2 * j];
+	            float im	= y [2 * j + 1];
+	            float oRe	= re * rotRe [j] - im * rotIm [j];
+	            float oIm	= re * rotIm [j] + im * rotRe [j];
+	            x [2 * j]		= oRe;
+	            x [2 * j + 1]	= oIm;
+	            float a	= fabsf (oRe);
+	            float b	= fabsf (oIm);
+	            laneSum [j]	+= a > b ? a + 0.5f * b : b + 0.5f * a;
+	         }
+	      }
+	      else {
+	         for (int j = 0; j < lanes; j ++) {
+	            float re	= y [2 * j];
+	            float im	= y [2 * j + 1];
+	            x [2 * j]		= re * rotRe [j] - im * rotIm [j];
+	            x [2 * j + 1]	= re * rotIm [j] + im * rotRe [j];
+	            laneSum [j]	+= jan_abs (std::complex<float> (x [2 * j],
+	                                                       x [2 * j + 1]));
+	         }
+	      }
+	      for (int j = 0; j < MIX_LANES; j ++) {
+	         float re	= rotRe [j] * wRe - rotIm [j] * wIm;
+	         float im	= rotRe [j] * wIm + rotIm [j] * wRe;
+	         rotRe [j]	= re;
+	         rotIm [j]	= im;
+	      }
+	      x	+= 2 * MIX_LANES;
+	      y	+= 2 * MIX_LANES;
+	   }
+//	and the phase of the last sample of the chunk
+	   currentPhase	= (int32_t)((currentPhase +
+	                             (int64_t)(m - 1) * step) % INPUT_RATE);
+	}
+float	sum	= 0;
+	for (int j = 0; j < MIX_LANES; j ++)
+	   sum += laneSum [j];
+	return sum;
+}
+
 void	sampleReader::getSamples (std::complex<float>  *v,
 	                          int32_t n, int32_t phaseOffset) {
-int32_t		i;
 
-	while (running. load () && (theRig -> Samples () < n))
-	   usleep (100);
+int32_t	done	= 0;
+float	levelSum	= 0;
+uint64_t startTime	= stageTimingOn. load (std::memory_order_relaxed) ?
+	                                                   stageClock () : 0;
 
-	if (!running. load ())	
+	if (!running. load ())
 	   throw 20;
+	waitedNs	= 0;
 //
-	n = theRig -> getSamples (v, n);
-
+//	The samples come from what getSample left over, or - if the
+//	device supports it - are mixed straight out of the device's
+//	buffer into v. Devices keeping their native format convert
+//	straight out of their buffer into v, the samples are then mixed
+//	in place (v is small enough to stay in the cache), otherwise
+//	they are copied into v and mixed there
+	while (done < n) {
+	   int32_t amount	= n - done;
+	   const std::complex<float> *src;
+	   bool	peeked		= false;
+	   if (pendingIndex < pendingCount) {
+	      if (amount > pendingCount - pendingIndex)
+	         amount = pendingCount - pendingIndex;
+	      src		= &pending [pendingIndex];
+	      pendingIndex	+= amount;
+	   }
+	   else {
+	      waitFor (amount);
+	      src	= theRig -> peekSamples (&amount);
+	      if (src != nullptr)
+	         peeked	= true;
+	      else {
+	         const void *raw	= theRig -> peekNative (&amount);
+	         if (raw != nullptr) {
+	            theRig -> convertNative (raw, amount, &v [done]);
+	            peeked	= true;
+	         }
+	         else
+	            amount	= theRig -> getSamples (&v [done], amount);
+	         src	= &v [done];
+	      }
+	      if (amount <= 0)
+	         break;
+	      samplesRead. store (samplesRead. load () + amount);
+	   }
 //	OK, we have samples!!
+	   if (localCounter < bufferSize) {
+	      int32_t k = amount < bufferSize - localCounter ?
+	                         amount : bufferSize - localCounter;
+	      memcpy (&localBuffer [localCounter], src,
+	                         k * sizeof (std::complex<float>));
+	      localCounter	+= k;
+	   }
 //	first: adjust frequency. We need Hz accuracy
-	for (i = 0; i < n; i ++) {
-	   currentPhase	-= phaseOffset;
+	   levelSum	+= mixBlock (src, &v [done], amount, phaseOffset);
+	   if (peeked)
+	      theRig -> commitSamples (amount);
+	   done	+= amount;
+	}
+	n	= done;
 //
-//	Note that "phase" itself might be negative
-	   currentPhase	= (currentPhase + INPUT_RATE) % INPUT_RATE;
-	   if (localCounter < bufferSize)
-	      localBuffer [localCounter ++]     = v [i];
-	   v [i]	*= oscillatorTable [currentPhase];
-	   sLevel	= 0.00001 * jan_abs (v [i]) + (1 - 0.00001) * sLevel;
+//	The level is an exponential average with a weight of 0.00001
+//	per sample. Over a block that is (almost exactly) the weight
+//	(1 - 0.00001)^n for the old value and the remainder for the mean
+	if (n > 0) {
+	   float keep	= powf (1 - 0.00001, n);
+	   sLevel	= keep * sLevel + (1 - keep) * levelSum / n;
 	}
 
 	sampleCount	+= n;
@@ -142,5 +355,8 @@ int32_t		i;
 	   localCounter = 0;
 	   sampleCount = 0;
 	}
+	if (startTime != 0)
+	   stageRecord (STAGE_SAMPLE_READER,
+	                        stageClock () - startTime - waitedNs);
 }
 
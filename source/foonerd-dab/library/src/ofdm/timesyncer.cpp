@@ -41,12 +41,15 @@ float	envBuffer       [syncBufferSize];
 #endif
 const
 int	syncBufferMask	= syncBufferSize - 1;
+std::complex<float> levelBuffer [C_LEVEL_SIZE];
 int	i;
 
+//	the first C_LEVEL_SIZE samples are read as a block,
+//	the search itself takes them - from a prefetched block - one by one
+	myReader -> getSamples (levelBuffer, C_LEVEL_SIZE, 0);
 	syncBufferIndex = 0;
 	for (i = 0; i < C_LEVEL_SIZE; i ++) {
-	   std::complex<float> sample        = myReader -> getSample (0);
-	   envBuffer [syncBufferIndex]       = jan_abs (sample);
+	   envBuffer [syncBufferIndex]       = jan_abs (levelBuffer [i]);
 	   cLevel                            += envBuffer [syncBufferIndex];
 	   syncBufferIndex ++;
 	}
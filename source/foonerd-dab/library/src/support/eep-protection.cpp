@@ -34,7 +34,7 @@
 	                                int16_t protLevel):
 	                                     protection (bitRate, protLevel) {
 int16_t i, j;
-int16_t viterbiCounter  = 0;
+int32_t viterbiCounter  = 0;
 int16_t L1	= 0,
 	L2	= 0;
 int8_t  *PI1, *PI2, *PI_X;
@@ -140,6 +140,7 @@ int8_t  *PI1, *PI2, *PI_X;
 	      indexTable [viterbiCounter] = true;
 	   viterbiCounter ++;
 	}
+	buildDepunctureList ();
 }
 
 	eep_protection::~eep_protection (void) {
@@ -148,17 +149,8 @@ int8_t  *PI1, *PI2, *PI_X;
 bool	eep_protection::deconvolve (int16_t *v,
 	                            int32_t size, uint8_t *outBuffer) {
 
-int16_t	i;
-int16_t	inputCounter	= 0;
-
 	(void)size;			// currently unused
-	memset (viterbiBlock. data (), 0,
-	                 (outSize * 4 + 24) * sizeof (int16_t)); 
-
-	for (i = 0; i < outSize * 4 + 24; i ++)
-           if (indexTable [i])
-              viterbiBlock [i] = v [inputCounter ++];
-
+	depuncture (v);
 	viterbiSpiral::deconvolve (viterbiBlock. data (), outBuffer);
 	return true;
 }
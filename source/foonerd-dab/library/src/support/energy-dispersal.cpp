@@ -0,0 +1,60 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"energy-dispersal.h"
+#include	<string.h>
+
+	energyDispersal::energyDispersal	(int32_t nBits) {
+std::vector<uint8_t> bytes (nBits / 8, 0);
+uint8_t	shiftRegister [9];
+
+	memset (shiftRegister, 1, 9);
+	for (int i = 0; i < nBits / 8 * 8; i ++) {
+	   uint8_t b = shiftRegister [8] ^ shiftRegister [4];
+	   for (int j = 8; j > 0; j--)
+	      shiftRegister [j] = shiftRegister [j - 1];
+	   shiftRegister [0] = b;
+	   bytes [i >> 3] |= b << (7 - (i & 07));
+	}
+//
+//	the words are loaded and stored with memcpy, i.e. in the
+//	byte order of the machine, so they are stored the same way
+	prbsWords. resize (bytes. size () / 8);
+	memcpy (prbsWords. data (), bytes. data (), prbsWords. size () * 8);
+	prbsTail. assign (bytes. begin () + prbsWords. size () * 8,
+	                  bytes. end ());
+}
+
+	energyDispersal::~energyDispersal	() {}
+
+void	energyDispersal::apply	(uint8_t *v) {
+uint64_t	w;
+int32_t	nWords	= prbsWords. size ();
+
+	for (int32_t i = 0; i < nWords; i ++) {
+	   memcpy (&w, &v [8 * i], 8);
+	   w ^= prbsWords [i];
+	   memcpy (&v [8 * i], &w, 8);
+	}
+	for (uint32_t i = 0; i < prbsTail. size (); i ++)
+	   v [8 * nWords + i] ^= prbsTail [i];
+}
@@ -22,23 +22,115 @@
  */
 #include	"fft-handler.h"
 #include	<cstring>
+#include	<mutex>
+
+//
+//	The fftw planner is not thread safe and the wisdom is global
+//	to the process, so planning is serialized over all handlers
+//	of all dabProcessor instances
+static	std::mutex	planLock;
+static	std::string	wisdomFile	= "";
+static	unsigned int	planFlags	= FFTW_ESTIMATE;
+static	bool		wisdomLoaded	= false;
+
+void	fft_handler::setPlanning	(const std::string &wisdomFile,
+	                                 int effort) {
+	std::lock_guard<std::mutex> lock (planLock);
+	::wisdomFile	= wisdomFile;
+	wisdomLoaded	= false;
+	switch (effort) {
+	   default:
+	   case FFT_ESTIMATE:
+	      planFlags	= FFTW_ESTIMATE;
+	      break;
+	   case FFT_MEASURE:
+	      planFlags	= FFTW_MEASURE;
+	      break;
+	   case FFT_PATIENT:
+	      planFlags	= FFTW_PATIENT;
+	      break;
+	}
+}
+//
+//	to be called with the planLock held
+static
+void	loadWisdom	() {
+	if (wisdomLoaded || (wisdomFile == ""))
+	   return;
+	if (!fftwf_import_wisdom_from_filename (wisdomFile. c_str ()))
+	   fprintf (stderr, "no (valid) fft wisdom in %s\n",
+	                                        wisdomFile. c_str ());
+	wisdomLoaded	= true;
+}
+
+static
+void	saveWisdom	() {
+	if (wisdomFile != "")
+	   (void)fftwf_export_wisdom_to_filename (wisdomFile. c_str ());
+}
 
 	fft_handler::fft_handler (uint8_t dabMode): p (dabMode) {
 	int i;
 	this	-> fftSize	= p. get_T_u ();
+	this	-> T_s		= p. get_T_s ();
+	this	-> T_g		= p. get_T_g ();
+	this	-> nrSymbols	= 0;
+	frameBuffer		= nullptr;
+	frameSpectrum		= nullptr;
+	framePlan		= nullptr;
 	vector	= (complex<float> *)
 	                fftwf_malloc (sizeof (complex<float>) * fftSize);
-	for (i = 0; i < fftSize; i ++)
-	   vector [i] = std::complex<float> (0, 0);
+	std::lock_guard<std::mutex> lock (planLock);
+	loadWisdom ();
 	plan	= fftwf_plan_dft_1d (fftSize,
 	                            reinterpret_cast <fftwf_complex *>(vector),
 	                            reinterpret_cast <fftwf_complex *>(vector),
-	                            FFTW_FORWARD, FFTW_ESTIMATE);
+	                            FFTW_FORWARD, planFlags);
+	saveWisdom ();
+//	planning with MEASURE/PATIENT overwrites the vector
+	for (i = 0; i < fftSize; i ++)
+	   vector [i] = std::complex<float> (0, 0);
 }
+//
+//	The batched version. The input is the framebuffer, nrSymbols
+//	ofdm symbols of T_s samples, transformed are the T_u samples
+//	following the cyclic prefix of each symbol, the spectra are
+//	stored contiguously in frameSpectrum
+	fft_handler::fft_handler (uint8_t dabMode, int16_t nrSymbols):
+	                                              fft_handler (dabMode) {
+int	n [1];
 
+	this	-> nrSymbols	= nrSymbols;
+	n [0]			= fftSize;
+	frameBuffer	= (complex<float> *)
+	                fftwf_malloc (sizeof (complex<float>) *
+	                                          nrSymbols * T_s);
+	frameSpectrum	= (complex<float> *)
+	                fftwf_malloc (sizeof (complex<float>) *
+	                                          nrSymbols * fftSize);
+	std::lock_guard<std::mutex> lock (planLock);
+	framePlan	= fftwf_plan_many_dft (1, n, nrSymbols,
+	                   reinterpret_cast <fftwf_complex *>(&frameBuffer [T_g]),
+	                   nullptr, 1, T_s,
+	                   reinterpret_cast <fftwf_complex *>(frameSpectrum),
+	                   nullptr, 1, fftSize,
+	                   FFTW_FORWARD, planFlags);
+	saveWisdom ();
+	memset ((void *)frameBuffer, 0,
+	         nrSymbols * T_s * sizeof (complex<float>));
+}
+
+//	destroying a plan is a planner call as well, another instance
+//	may be planning meanwhile
 	fft_handler::~fft_handler (void) {
+	std::lock_guard<std::mutex> lock (planLock);
 	   fftwf_destroy_plan (plan);
 	   fftwf_free (vector);
+	   if (framePlan != nullptr) {
+	      fftwf_destroy_plan (framePlan);
+	      fftwf_free (frameBuffer);
+	      fftwf_free (frameSpectrum);
+	   }
 }
 
 void	fft_handler::fft	(Complex *v) {
@@ -67,4 +159,18 @@ int	i;
 	for (i = 0; i < fftSize; i ++)
 	   vector [i] = conj (vector [i]);
 }
+//
+//	Note that the frame buffer is the input of the plan, data
+//	is to be read into it directly
+complex<float>	*fft_handler::getFrameBuffer	() {
+	return frameBuffer;
+}
+
+complex<float>	*fft_handler::getSpectrum	(int16_t symbol) {
+	return &frameSpectrum [symbol * fftSize];
+}
+
+void	fft_handler::do_frameFFT	() {
+	fftwf_execute (framePlan);
+}
 
@@ -24,6 +24,7 @@
  *	Simple base class for combining uep and eep deconvolvers
  */
 #include	"protection.h"
+#include	<string.h>
 
      protection::protection  (int16_t bitRate, int16_t protLevel):
 	                                viterbiSpiral (24 * bitRate),
@@ -39,3 +40,35 @@ bool    protection::deconvolve  (int16_t *a, int32_t b, uint8_t *c) {
            return false;
 }
 
+bool	protection::deconvolvePacked	(int16_t *v,
+	                                 int32_t size, uint8_t *outBuffer) {
+	(void)size;			// currently unused
+	depuncture (v);
+	viterbiSpiral::deconvolvePacked (viterbiBlock. data (), outBuffer);
+	return true;
+}
+//
+//	the indexTable - filled by the eep or uep constructor - tells
+//	which bits of the viterbi block are not punctured. Rather than
+//	testing all (outSize * 4 + 24) entries for each CIF, the
+//	positions of the non punctured bits are listed once
+void	protection::buildDepunctureList	() {
+	depunctureList. resize (0);
+	for (int32_t i = 0; i < outSize * 4 + 24; i ++)
+	   if (indexTable [i])
+	      depunctureList. push_back (i);
+}
+
+int32_t	protection::inputSize	() {
+	return depunctureList. size ();
+}
+
+void	protection::depuncture	(int16_t *v) {
+const int32_t *list	= depunctureList. data ();
+int16_t	*block	= viterbiBlock. data ();
+int32_t	n	= depunctureList. size ();
+
+	memset (block, 0, (outSize * 4 + 24) * sizeof (int16_t)); 
+	for (int32_t i = 0; i < n; i ++)
+	   block [list [i]] = v [i];
+}
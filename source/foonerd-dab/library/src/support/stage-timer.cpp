@@ -0,0 +1,104 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	"stage-timer.h"
+
+std::atomic<bool>	stageTimingOn (false);
+//
+//	The stages are recorded from different threads (the sync thread,
+//	the pipeline workers, the backends), so all counters are atomic.
+//	Relaxed ordering is sufficient, a snapshot taken while the
+//	decoder runs may be off by a few entries
+struct	stageCounters {
+	std::atomic<uint64_t>	count;
+	std::atomic<uint64_t>	totalNs;
+	std::atomic<uint64_t>	minNs;
+	std::atomic<uint64_t>	maxNs;
+	std::atomic<uint64_t>	histogram [STAGE_BUCKETS];
+};
+
+static
+stageCounters	counters [NR_STAGES];
+
+static
+const char *stageNames [NR_STAGES] = {
+	"sample_reader",
+	"input_wait",
+	"time_sync",
+	"fft",
+	"demap",
+	"fic_viterbi",
+	"msc_deinterleave",
+	"msc_viterbi",
+	"reed_solomon",
+	"aac",
+	"mp2"
+};
+
+void	stageTimingSwitch	(bool b) {
+	if (b) {
+	   for (int i = 0; i < NR_STAGES; i ++) {
+	      counters [i]. count. store (0);
+	      counters [i]. totalNs. store (0);
+	      counters [i]. minNs. store (UINT64_MAX);
+	      counters [i]. maxNs. store (0);
+	      for (int j = 0; j < STAGE_BUCKETS; j ++)
+	         counters [i]. histogram [j]. store (0);
+	   }
+	}
+	stageTimingOn. store (b);
+}
+
+void	stageRecord	(int stage, uint64_t ns) {
+stageCounters &c	= counters [stage];
+int	bucket		= 0;
+
+	while ((bucket < STAGE_BUCKETS - 1) && ((ns >> (bucket + 1)) != 0))
+	   bucket ++;
+	c. count. fetch_add (1, std::memory_order_relaxed);
+	c. totalNs. fetch_add (ns, std::memory_order_relaxed);
+	c. histogram [bucket]. fetch_add (1, std::memory_order_relaxed);
+	uint64_t m	= c. minNs. load (std::memory_order_relaxed);
+	while ((ns < m) &&
+	       !c. minNs. compare_exchange_weak (m, ns,
+	                                         std::memory_order_relaxed))
+	   ;
+	m	= c. maxNs. load (std::memory_order_relaxed);
+	while ((ns > m) &&
+	       !c. maxNs. compare_exchange_weak (m, ns,
+	                                         std::memory_order_relaxed))
+	   ;
+}
+
+void	stageTimingGet		(stageTimings *st) {
+	for (int i = 0; i < NR_STAGES; i ++) {
+	   stageTiming &s	= st -> stage [i];
+	   s. name	= stageNames [i];
+	   s. count	= counters [i]. count. load ();
+	   s. totalNs	= counters [i]. totalNs. load ();
+	   s. minNs	= s. count == 0 ? 0 : counters [i]. minNs. load ();
+	   s. maxNs	= counters [i]. maxNs. load ();
+	   for (int j = 0; j < STAGE_BUCKETS; j ++)
+	      s. histogram [j] = counters [i]. histogram [j]. load ();
+	}
+}
+
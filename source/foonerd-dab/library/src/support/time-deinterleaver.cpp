@@ -0,0 +1,110 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include	<stdlib.h>
+#include	<string.h>
+#include	"time-deinterleaver.h"
+#if defined(__MINGW32__) || defined(_MSC_VER)
+#include	<malloc.h>
+#endif
+
+static const
+int16_t	interleaveMap [] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
+
+//
+//	Soft bit i = 16 * j + k, taken at time t, is needed at time
+//	t + 16 - interleaveMap [k]. The buffer has 16 rows, row r holds
+//	the values needed at a time t with t % 16 == r, in each row the
+//	values with the same k are together: segment k (of n = fragmentSize
+//	/ 16 values) holds the values for j = 0 .. n - 1.
+//	A CIF then reads one row and writes 16 segments, an eighth of
+//	the buffer, all sequential, where storing the history per
+//	position (or per CIF) makes each CIF touch all of it
+	timeDeinterleaver::timeDeinterleaver	(int32_t fragmentSize) {
+size_t	size	= 16 * fragmentSize * sizeof (int16_t);
+
+	this	-> fragmentSize	= fragmentSize;
+	this	-> n		= fragmentSize / 16;
+#if defined(__MINGW32__) || defined(_MSC_VER)
+	history	= (int16_t *)_aligned_malloc (size, 64);
+#else
+	if (posix_memalign ((void **)&history, 64, size) != 0)
+	   history = nullptr;
+#endif
+	if (history == nullptr)
+	   throw (21);
+	memset (history, 0, size);
+	index	= 0;
+	count	= 0;
+}
+
+	timeDeinterleaver::~timeDeinterleaver	() {
+#if defined(__MINGW32__) || defined(_MSC_VER)
+	_aligned_free (history);
+#else
+	free (history);
+#endif
+}
+//
+//	The transpositions are done in tiles of 16 x 16 values, the
+//	values of a tile are in 16 (in, out) resp. 16 (the segments)
+//	sequential runs
+bool	timeDeinterleaver::process	(const int16_t *in, int16_t *out) {
+const int16_t	*row	= &history [index * fragmentSize];
+int16_t	*segment [16];
+bool	filled	= count > 15;
+int32_t	j0	= 0;
+//
+//	the row is read before it is written, values with
+//	interleaveMap [k] == 0 go to the row being read
+	if (filled) {
+	   for (j0 = 0; j0 + 16 <= n; j0 += 16)
+	      for (int k = 0; k < 16; k ++) {
+	         const int16_t *src = &row [k * n + j0];
+	         int16_t *dst	= &out [16 * j0 + k];
+	         for (int j = 0; j < 16; j ++)
+	            dst [16 * j] = src [j];
+	      }
+	   for (int32_t j = j0; j < n; j ++)
+	      for (int k = 0; k < 16; k ++)
+	         out [16 * j + k] = row [k * n + j];
+	}
+
+	for (int k = 0; k < 16; k ++)
+	   segment [k] = &history [((index - interleaveMap [k]) & 017) *
+	                                             fragmentSize + k * n];
+	for (j0 = 0; j0 + 16 <= n; j0 += 16)
+	   for (int k = 0; k < 16; k ++) {
+	      const int16_t *src = &in [16 * j0 + k];
+	      int16_t *dst	= &segment [k][j0];
+	      for (int j = 0; j < 16; j ++)
+	         dst [j] = src [16 * j];
+	   }
+	for (int32_t j = j0; j < n; j ++)
+	   for (int k = 0; k < 16; k ++)
+	      segment [k][j] = in [16 * j + k];
+
+	index	= (index + 1) & 017;
+	if (!filled)
+	   count ++;
+	return filled;
+}
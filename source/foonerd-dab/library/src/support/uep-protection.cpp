@@ -133,6 +133,25 @@ int16_t	i;
 	return -1;
 }
 
+bool	uep_protection::getProfile	(int16_t index, int16_t *bitRate,
+	                                 int16_t *protLevel,
+	                                 int16_t *L, int16_t *PI) {
+	for (int16_t i = 0; i <= index; i ++)
+	   if (profileTable [i]. bitRate == 0)
+	      return false;
+	*bitRate	= profileTable [index]. bitRate;
+	*protLevel	= profileTable [index]. protLevel;
+	L [0]	= profileTable [index]. L1;
+	L [1]	= profileTable [index]. L2;
+	L [2]	= profileTable [index]. L3;
+	L [3]	= profileTable [index]. L4;
+	PI [0]	= profileTable [index]. PI1;
+	PI [1]	= profileTable [index]. PI2;
+	PI [2]	= profileTable [index]. PI3;
+	PI [3]	= profileTable [index]. PI4;
+	return true;
+}
+
 /**
   *	the table is based on chapter 11 of the DAB standard.
   *
@@ -145,7 +164,7 @@ int16_t	i;
 	                                int16_t protLevel):
 	                                   protection (bitRate, protLevel) {
 int16_t index, i, j;
-int16_t viterbiCounter  = 0;
+int32_t viterbiCounter  = 0;
 int16_t         L1;
 int16_t         L2;
 int16_t         L3;
@@ -222,6 +241,7 @@ int8_t          *PI_X;
 	      indexTable [viterbiCounter] = true;
 	   viterbiCounter ++;
 	}
+	buildDepunctureList ();
 }
 
 	uep_protection::~uep_protection (void) {
@@ -229,18 +249,8 @@ int8_t          *PI_X;
 
 bool	uep_protection::deconvolve (int16_t *v,
 	                            int32_t size, uint8_t *outBuffer) {
-int16_t	i;
-int16_t	inputCounter	= 0;
-
 	(void)size;			// currently unused
-	memset (viterbiBlock. data (), 0,
-	                        (outSize * 4 + 24) * sizeof (int16_t)); 
-
-
-        for (i = 0; i < outSize * 4 + 24; i ++)
-           if (indexTable [i])
-              viterbiBlock [i] = v [inputCounter ++];
-
+	depuncture (v);
 ///     The actual deconvolution is done by the viterbi decoder
 	viterbiSpiral::deconvolve (viterbiBlock. data (), outBuffer);
 	return true;
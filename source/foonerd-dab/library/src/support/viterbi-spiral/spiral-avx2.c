@@ -0,0 +1,100 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+//
+//	AVX2 version of the (spiral generated) butterflies, with the
+//	layout of FULL_SPIRAL_sse: 64 states with 32 bit metrics, the
+//	branch table as 4 rows of 32 entries and per trellis step 8 bytes
+//	of decisions, byte k holding the decisions for the states
+//	8k .. 8k + 7.
+//	Each call of the loop body handles two steps, X -> Y and Y -> X.
+//	The code is compiled with a target attribute, so it is only
+//	executed when the CPU supports AVX2 (see viterbi-spiral.cpp)
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#include	<stdint.h>
+#include	<immintrin.h>
+
+//	one trellis step, old states i and i + 32 (i = 8k .. 8k + 7)
+//	give new states 2i and 2i + 1, i.e. 16k .. 16k + 15
+__attribute__ ((target ("avx2")))
+static inline
+void	step_avx2	(const int32_t *X, int32_t *Y,
+	                 const int32_t *syms, unsigned char *dec,
+	                 const int32_t *Branchtab) {
+const __m256i	s0	= _mm256_set1_epi32 (syms [0]);
+const __m256i	s1	= _mm256_set1_epi32 (syms [1]);
+const __m256i	s2	= _mm256_set1_epi32 (syms [2]);
+const __m256i	s3	= _mm256_set1_epi32 (syms [3]);
+const __m256i	max	= _mm256_set1_epi32 (1020);
+int	k;
+
+	for (k = 0; k < 4; k ++) {
+	   const __m256i *b	= (const __m256i *)(Branchtab + 8 * k);
+	   __m256i metric	=
+	       _mm256_add_epi32 (
+	          _mm256_add_epi32 (
+	             _mm256_xor_si256 (s0, _mm256_loadu_si256 (b)),
+	             _mm256_xor_si256 (s1, _mm256_loadu_si256 (b + 4))),
+	          _mm256_add_epi32 (
+	             _mm256_xor_si256 (s2, _mm256_loadu_si256 (b + 8)),
+	             _mm256_xor_si256 (s3, _mm256_loadu_si256 (b + 12))));
+	   __m256i cmetric	= _mm256_sub_epi32 (max, metric);
+	   __m256i a	= _mm256_loadu_si256 ((const __m256i *)(X + 8 * k));
+	   __m256i c	= _mm256_loadu_si256 ((const __m256i *)(X + 8 * k + 32));
+	   __m256i m0	= _mm256_add_epi32 (a, metric);
+	   __m256i m1	= _mm256_add_epi32 (c, cmetric);
+	   __m256i m2	= _mm256_add_epi32 (a, cmetric);
+	   __m256i m3	= _mm256_add_epi32 (c, metric);
+	   __m256i d0	= _mm256_cmpgt_epi32 (m0, m1);
+	   __m256i d1	= _mm256_cmpgt_epi32 (m2, m3);
+	   __m256i n0	= _mm256_min_epi32 (m0, m1);
+	   __m256i n1	= _mm256_min_epi32 (m2, m3);
+//
+//	interleave the even and odd new states, the unpacks work
+//	per 128 bit lane, the permutes restore the order
+	   __m256i lo	= _mm256_unpacklo_epi32 (n0, n1);
+	   __m256i hi	= _mm256_unpackhi_epi32 (n0, n1);
+	   _mm256_storeu_si256 ((__m256i *)(Y + 16 * k),
+	                        _mm256_permute2x128_si256 (lo, hi, 0x20));
+	   _mm256_storeu_si256 ((__m256i *)(Y + 16 * k + 8),
+	                        _mm256_permute2x128_si256 (lo, hi, 0x31));
+	   lo	= _mm256_unpacklo_epi32 (d0, d1);
+	   hi	= _mm256_unpackhi_epi32 (d0, d1);
+	   dec [2 * k]	  = _mm256_movemask_ps (_mm256_castsi256_ps (
+	                         _mm256_permute2x128_si256 (lo, hi, 0x20)));
+	   dec [2 * k + 1] = _mm256_movemask_ps (_mm256_castsi256_ps (
+	                         _mm256_permute2x128_si256 (lo, hi, 0x31)));
+	}
+}
+
+__attribute__ ((target ("avx2")))
+void	FULL_SPIRAL_avx2 (int amount, int32_t *Y, int32_t *X,
+	                  int32_t *syms, unsigned char *dec,
+	                  int32_t *Branchtab) {
+int	i;
+
+	for (i = 0; i < amount; i ++) {
+	   step_avx2 (X, Y, syms + 8 * i,     dec + 16 * i,     Branchtab);
+	   step_avx2 (Y, X, syms + 8 * i + 4, dec + 16 * i + 8, Branchtab);
+	}
+}
+#endif
@@ -0,0 +1,96 @@
+#
+/*
+ *    Copyright (C) 2016, 2025
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the  DAB-library
+ *
+ *    DAB-library is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    DAB-library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with DAB-library; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+//
+//	AVX-512 version of the butterflies, same layout as spiral-avx2.c,
+//	with 16 states per vector. The comparisons give bit masks,
+//	the decisions for the even and odd states are merged with pdep
+//	(BMI2, present on all CPUs with AVX-512)
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#include	<stdint.h>
+#include	<string.h>
+#include	<immintrin.h>
+
+#define	AVX512_TARGET	__attribute__ ((target ("avx512f,avx512bw,bmi2")))
+
+//	one trellis step, old states i and i + 32 (i = 16k .. 16k + 15)
+//	give new states 2i and 2i + 1, i.e. 32k .. 32k + 31
+AVX512_TARGET
+static inline
+void	step_avx512	(const int32_t *X, int32_t *Y,
+	                 const int32_t *syms, unsigned char *dec,
+	                 const int32_t *Branchtab) {
+const __m512i	s0	= _mm512_set1_epi32 (syms [0]);
+const __m512i	s1	= _mm512_set1_epi32 (syms [1]);
+const __m512i	s2	= _mm512_set1_epi32 (syms [2]);
+const __m512i	s3	= _mm512_set1_epi32 (syms [3]);
+const __m512i	max	= _mm512_set1_epi32 (1020);
+//	qword indices, taking the 128 bit lanes of the unpacks in order
+const __m512i	first	= _mm512_set_epi64 (11, 10, 3, 2, 9, 8, 1, 0);
+const __m512i	second	= _mm512_set_epi64 (15, 14, 7, 6, 13, 12, 5, 4);
+int	k;
+
+	for (k = 0; k < 2; k ++) {
+	   const int32_t *b	= Branchtab + 16 * k;
+	   __m512i metric	=
+	       _mm512_add_epi32 (
+	          _mm512_add_epi32 (
+	             _mm512_xor_si512 (s0, _mm512_loadu_si512 (b)),
+	             _mm512_xor_si512 (s1, _mm512_loadu_si512 (b + 32))),
+	          _mm512_add_epi32 (
+	             _mm512_xor_si512 (s2, _mm512_loadu_si512 (b + 64)),
+	             _mm512_xor_si512 (s3, _mm512_loadu_si512 (b + 96))));
+	   __m512i cmetric	= _mm512_sub_epi32 (max, metric);
+	   __m512i a	= _mm512_loadu_si512 (X + 16 * k);
+	   __m512i c	= _mm512_loadu_si512 (X + 16 * k + 32);
+	   __m512i m0	= _mm512_add_epi32 (a, metric);
+	   __m512i m1	= _mm512_add_epi32 (c, cmetric);
+	   __m512i m2	= _mm512_add_epi32 (a, cmetric);
+	   __m512i m3	= _mm512_add_epi32 (c, metric);
+	   __mmask16 d0	= _mm512_cmpgt_epi32_mask (m0, m1);
+	   __mmask16 d1	= _mm512_cmpgt_epi32_mask (m2, m3);
+	   __m512i n0	= _mm512_min_epi32 (m0, m1);
+	   __m512i n1	= _mm512_min_epi32 (m2, m3);
+	   __m512i lo	= _mm512_unpacklo_epi32 (n0, n1);
+	   __m512i hi	= _mm512_unpackhi_epi32 (n0, n1);
+	   _mm512_storeu_si512 (Y + 32 * k,
+	                        _mm512_permutex2var_epi64 (lo, first, hi));
+	   _mm512_storeu_si512 (Y + 32 * k + 16,
+	                        _mm512_permutex2var_epi64 (lo, second, hi));
+	   uint32_t bits	= _pdep_u32 (d0, 0x55555555) |
+	                          _pdep_u32 (d1, 0xAAAAAAAA);
+	   memcpy (dec + 4 * k, &bits, sizeof (bits));
+	}
+}
+
+AVX512_TARGET
+void	FULL_SPIRAL_avx512 (int amount, int32_t *Y, int32_t *X,
+	                    int32_t *syms, unsigned char *dec,
+	                    int32_t *Branchtab) {
+int	i;
+
+	for (i = 0; i < amount; i ++) {
+	   step_avx512 (X, Y, syms + 8 * i,     dec + 16 * i,     Branchtab);
+	   step_avx512 (Y, X, syms + 8 * i + 4, dec + 16 * i + 8, Branchtab);
+	}
+}
+#endif
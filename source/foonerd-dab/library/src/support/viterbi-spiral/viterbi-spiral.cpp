@@ -25,6 +25,7 @@
 #include	"mm_malloc.h"
 #include	"viterbi-spiral.h"
 #include	<cstring>
+#include	<atomic>
 #ifdef  __MINGW32__
 #include	<intrin.h>
 #include	<malloc.h>
@@ -211,10 +212,24 @@ uint8_t getbit (uint8_t v, int32_t o) {
 //	}
 //}
 
+void	viterbiSpiral::deconvolve	(int16_t *input, uint8_t *output) {
+uint32_t	i;
+
+	decode (input, data);
+	for (i = 0; i < (uint16_t)frameBits; i ++)
+	   output [i] = getbit (data [i >> 3], i & 07);
+}
+//
+//	The chainback delivers the bits packed, MSB first, so
+//	here the (frameBits + 7) / 8 bytes are just passed on
+void	viterbiSpiral::deconvolvePacked	(int16_t *input, uint8_t *output) {
+	decode (input, output);
+}
+
 //	Note that our DAB environment maps the softbits to -127 .. 127
 //	we have to map that onto 0 .. 255
 
-void	viterbiSpiral::deconvolve	(int16_t *input, uint8_t *output) {
+void	viterbiSpiral::decode	(int16_t *input, uint8_t *output) {
 uint32_t	i;
 
 	init_viterbi (&vp, 0);
@@ -229,10 +244,7 @@ uint32_t	i;
 //	else
 	   update_viterbi_blk_SPIRAL (&vp, symbols, frameBits + (K - 1));
 
-	chainback_viterbi (&vp, data, frameBits, 0);
-
-	for (i = 0; i < (uint16_t)frameBits; i ++)
-	   output [i] = getbit (data [i >> 3], i & 07);
+	chainback_viterbi (&vp, output, frameBits, 0);
 }
 
 /* C-language butterfly */
@@ -303,6 +315,88 @@ void FULL_SPIRAL_no_sse (int,
 	                 COMPUTETYPE *syms,
 	                 DECISIONTYPE *dec,
 	                 COMPUTETYPE *Branchtab);
+#if defined(SSE_AVAILABLE) && defined(__GNUC__) && \
+	            (defined(__x86_64__) || defined(__i386__))
+#define	AVX_KERNELS
+void FULL_SPIRAL_avx2	(int, COMPUTETYPE *, COMPUTETYPE *,
+	                 COMPUTETYPE *, DECISIONTYPE *, COMPUTETYPE *);
+void FULL_SPIRAL_avx512	(int, COMPUTETYPE *, COMPUTETYPE *,
+	                 COMPUTETYPE *, DECISIONTYPE *, COMPUTETYPE *);
+#endif
+}
+
+static	bool	always	() {
+	return true;
+}
+
+#ifdef	AVX_KERNELS
+static	bool	hasAVX2	() {
+	return __builtin_cpu_supports ("avx2");
+}
+
+static	bool	hasAVX512	() {
+	return __builtin_cpu_supports ("avx512f") &&
+	       __builtin_cpu_supports ("avx512bw") &&
+	       __builtin_cpu_supports ("bmi2");
+}
+#endif
+//
+//	the kernels in order of preference, the last one supported
+//	is the default
+static const struct {
+	const char	*name;
+	spiralKernel	kernel;
+	bool		(*supported)();
+} kernels [] = {
+#if defined(SSE_AVAILABLE)
+	{"sse",		FULL_SPIRAL_sse,	always},
+#ifdef	AVX_KERNELS
+	{"avx2",	FULL_SPIRAL_avx2,	hasAVX2},
+	{"avx512",	FULL_SPIRAL_avx512,	hasAVX512},
+#endif
+#elif defined(NEON_AVAILABLE)
+	{"neon",	FULL_SPIRAL_neon,	always},
+#else
+	{"generic",	FULL_SPIRAL_no_sse,	always},
+#endif
+};
+
+#define	NR_KERNELS	((int)(sizeof (kernels) / sizeof (kernels [0])))
+
+static
+std::atomic<int>	selectedKernel (-1);
+
+int	viterbiSpiral::nrKernels	() {
+	return NR_KERNELS;
+}
+
+const char *viterbiSpiral::kernelName	(int k) {
+	return (k >= 0) && (k < NR_KERNELS) ? kernels [k]. name : nullptr;
+}
+
+bool	viterbiSpiral::kernelSupported	(int k) {
+	return (k >= 0) && (k < NR_KERNELS) && kernels [k]. supported ();
+}
+
+int	viterbiSpiral::currentKernel	() {
+int	k	= selectedKernel. load (std::memory_order_relaxed);
+
+	if (k >= 0)
+	   return k;
+	for (k = NR_KERNELS - 1; k > 0; k --)
+	   if (kernels [k]. supported ())
+	      break;
+	selectedKernel. store (k);
+	return k;
+}
+//
+//	changing the kernel affects all decoders, a deconvolve in
+//	progress completes with the kernel it started with
+bool	viterbiSpiral::setKernel	(int k) {
+	if (!kernelSupported (k))
+	   return false;
+	selectedKernel. store (k);
+	return true;
 }
 
 void	viterbiSpiral::update_viterbi_blk_SPIRAL (struct v *vp,
@@ -314,13 +408,7 @@ int32_t s;
 	for (s = 0; s < nbits; s++)
 	   memset (d + s, 0, sizeof(decision_t));
 
-#if defined(SSE_AVAILABLE)
-	FULL_SPIRAL_sse (nbits / 2,
-#elif defined(NEON_AVAILABLE)
-	FULL_SPIRAL_neon (nbits / 2,
-#else
-	FULL_SPIRAL_no_sse (nbits / 2,
-#endif
+	kernels [currentKernel ()]. kernel (nbits / 2,
 	                 vp -> new_metrics -> t,
 	                 vp -> old_metrics -> t,
 	                 syms,
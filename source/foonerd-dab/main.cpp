@@ -33,6 +33,7 @@
 #include	<complex>
 #include	<vector>
 #include	<atomic>
+#include	<chrono>
 #include	"dab-api.h"
 #include	"includes/support/band-handler.h"
 #ifdef  HAVE_SDRPLAY
@@ -47,6 +48,10 @@
 #include        "wavfiles.h"
 #elif   HAVE_RAWFILES
 #include        "rawfiles.h"
+#elif   HAVE_XMLFILES
+#include        "xml-filereader.h"
+#elif   HAVE_MMAPFILES
+#include        "mmap-file-handler.h"
 #elif   HAVE_RTL_TCP
 #include        "rtl_tcp-client.h"
 #elif   HAVE_HACKRF
@@ -95,6 +100,17 @@ std::atomic<bool>timesyncSet;
 
 static
 std::atomic<bool>ensembleRecognized;
+//
+//	When decoding a file "unthrottled" the counters are taken at the
+//	end of the input, for the throughput report
+static
+std::atomic<bool>endOfInput;
+
+static
+processingStats	eofStats;
+
+static
+std::chrono::steady_clock::time_point	eofTime;
 
 #ifdef	DATA_STREAMER
 tcpServer	tdcServer (8888);
@@ -102,12 +118,88 @@ tcpServer	tdcServer (8888);
 
 std::string	programName		= "Sky Radio";
 int32_t		serviceIdentifier	= -1;
+//
+//	With -m all services of the ensemble are decoded, the output
+//	of each service goes to files of its own, named after the SId,
+//	in the directory given: PCM (16 bit stereo) to <SId>.pcm,
+//	the bytes of data services to <SId>.dat
+struct	serviceSink {
+	uint32_t	SId;
+	std::string	name;
+	bool		isAudio;
+	int		rate;
+	FILE		*out;
+};
+
+static
+std::string	ensembleDir	= "";
+
+static
+std::vector<serviceSink *>	sinks;
+
+static
+void	inputEnded	(void *userData) {
+	(void)userData;
+	if (endOfInput. load ())
+	   return;
+	if (theRadio != nullptr)
+	   dabGetProcessingStats (theRadio, &eofStats);
+	eofTime	= std::chrono::steady_clock::now ();
+	endOfInput. store (true);
+}
 
 static void sighandler (int signum) {
         fprintf (stderr, "Signal caught, terminating!\n");
 	run. store (false);
 }
 
+//
+//	called by the library for each service attached by
+//	dabDecodeEnsemble, the sink is passed as context to the callbacks
+static
+void	*serviceContext	(uint32_t SId, const std::string &name,
+	                 bool isAudio, void *userData) {
+serviceSink	*s	= new serviceSink;
+char	fileName [32];
+	(void)userData;
+	snprintf (fileName, sizeof (fileName), "%X.%s", SId,
+	                                   isAudio ? "pcm" : "dat");
+	s -> SId	= SId;
+	s -> name	= name;
+	s -> isAudio	= isAudio;
+	s -> rate	= 0;
+	s -> out	= fopen ((ensembleDir + fileName). c_str (), "wb");
+	if (s -> out == nullptr)
+	   fprintf (stderr, "cannot open %s%s\n", ensembleDir. c_str (),
+	                                                      fileName);
+	sinks. push_back (s);
+	return s;
+}
+
+static
+void	servicePcmHandler (int16_t *buffer, int size, int rate,
+	                   bool isStereo, void *ctx) {
+serviceSink *s	= (serviceSink *)ctx;
+	(void)isStereo;
+	if (rate != s -> rate) {
+	   fprintf (stderr, "SERVICE_AUDIO: SId=%X rate=%d\n", s -> SId, rate);
+	   s -> rate = rate;
+	}
+	if ((buffer == nullptr) || (size <= 0) || (s -> out == nullptr))
+	   return;
+	fwrite (buffer, sizeof (int16_t), size, s -> out);
+}
+
+static
+void	serviceBytesHandler (uint8_t *data, int16_t amount,
+	                     uint8_t type, void *ctx) {
+serviceSink *s	= (serviceSink *)ctx;
+	(void)type;
+	if ((data == nullptr) || (amount <= 0) || (s -> out == nullptr))
+	   return;
+	fwrite (data, 1, amount, s -> out);
+}
+
 static
 void	syncsignal_Handler (bool b, void *userData) {
 	timeSynced. store (b);
@@ -585,53 +677,71 @@ bool		wantInfo	= false;
 int		lnaGain		= 40;
 int		vgaGain		= 40;
 int		ppmOffset	= 0;
-const char	*optionsString	= "i:T:D:d:M:B:P:O:A:C:G:g:p:";
+const char	*optionsString	= "i:W:m:w:be:E:T:D:d:M:B:P:O:A:C:G:g:p:";
 #elif	HAVE_LIME
 int16_t		gain		= 70;
 std::string	antenna		= "Auto";
-const char	*optionsString	= "i:T:D:d:M:B:P:O:A:C:G:g:X:";
+const char	*optionsString	= "i:W:m:w:be:E:T:D:d:M:B:P:O:A:C:G:g:X:";
 #elif	HAVE_SDRPLAY
 int16_t		GRdB		= 30;
 int16_t		lnaState	= 2;
 bool		autogain	= false;
 int16_t		ppmOffset	= 0;
-const char	*optionsString	= "i:T:D:d:M:B:P:O:A:C:G:L:Qp:";
+const char	*optionsString	= "i:W:m:w:be:E:T:D:d:M:B:P:O:A:C:G:L:Qp:";
 #elif	HAVE_SDRPLAY_V3
 int16_t		GRdB		= 30;
 int16_t		lnaState	= 2;
 bool		autogain	= false;
 int16_t		ppmOffset	= 0;
-const char	*optionsString	= "i:T:D:d:M:B:P:O:A:C:G:L:Qp:";
+const char	*optionsString	= "i:W:m:w:be:E:T:D:d:M:B:P:O:A:C:G:L:Qp:";
 #elif	HAVE_AIRSPY
 int16_t		gain		= 20;
 bool		autogain	= false;
 int		ppmOffset	= 0;
-const char	*optionsString	= "i:T:D:d:M:B:P:O:A:C:G:p:S:";
+const char	*optionsString	= "i:W:m:w:be:E:T:D:d:M:B:P:O:A:C:G:p:S:";
 #elif	HAVE_RTLSDR
 int16_t		gain		= 50;
 bool		autogain	= false;
 int16_t		ppmOffset	= 0;
-const char	*optionsString	= "i:T:D:d:M:B:P:O:A:C:G:p:QS:v";
+const char	*optionsString	= "i:W:m:w:be:E:T:D:d:M:B:P:O:A:C:G:p:QS:v";
 #elif	HAVE_WAVFILES
 std::string	fileName;
 bool		repeater	= true;
-const char	*optionsString	= "i:D:d:M:B:P:O:A:F:R:";
+bool		unthrottled	= false;
+const char	*optionsString	= "i:W:m:w:be:E:D:d:M:B:P:O:A:F:R:u";
 #elif	HAVE_RAWFILES
 std::string	fileName;
 bool	repeater		= true;
-const char	*optionsString	= "i:D:d:M:B:P:O:A:F:R:";
+bool		unthrottled	= false;
+const char	*optionsString	= "i:W:m:w:be:E:D:d:M:B:P:O:A:F:R:u";
+#elif	HAVE_XMLFILES
+std::string	fileName;
+bool		repeater	= true;
+bool		unthrottled	= false;
+const char	*optionsString	= "i:W:m:w:be:E:D:d:M:B:P:O:A:F:Ru";
+#elif	HAVE_MMAPFILES
+std::string	fileName;
+bool		repeater	= true;
+bool		unthrottled	= false;
+double		startSeconds	= 0;
+const char	*optionsString	= "i:W:m:w:be:E:D:d:M:B:P:O:A:F:Rus:";
 #elif	HAVE_RTL_TCP
 int		gain		= 50;
 bool		autogain	= false;
 int		ppmOffset	= 0;
 std::string	hostname = "127.0.0.1";		// default
 int32_t		basePort = 1234;		// default
-const char	*optionsString	= "i:T:D:d:M:B:P:O:A:C:G:Qp:H:I";
+const char	*optionsString	= "i:W:m:w:be:E:T:D:d:M:B:P:O:A:C:G:Qp:H:I";
 #endif
 std::string	soundChannel	= "default";
 int16_t		timeSyncTime	= 5;
 int16_t		freqSyncTime	= 5;
 int		theDuration	= -1;	// default, infinite
+int		pipelineWorkers	= 0;	// default, no pipeline
+int		serviceWorkers	= 0;	// default, one per core
+bool		batchFFT	= false;
+std::string	wisdomFile	= "";
+int		fftEffort	= FFT_ESTIMATE;
 int		opt;
 struct sigaction sigact;
 bandHandler	dabBand;
@@ -641,6 +751,7 @@ deviceHandler	*theDevice;
 	timeSynced.	store (false);
 	timesyncSet.	store (false);
 	run.		store (false);
+	endOfInput.	store (false);
 
 	std::setlocale (LC_ALL, "");
 	if (argc == 1) {
@@ -683,6 +794,31 @@ deviceHandler	*theDevice;
 	         programName	= optarg;
 	         break;
 
+	      case 'W':
+	         pipelineWorkers	= atoi (optarg);
+	         break;
+
+	      case 'm':
+	         ensembleDir	= std::string (optarg);
+	         ensembleDir	+= "/";
+	         break;
+
+	      case 'w':
+	         serviceWorkers	= atoi (optarg);
+	         break;
+
+	      case 'b':
+	         batchFFT	= true;
+	         break;
+
+	      case 'e':
+	         wisdomFile	= std::string (optarg);
+	         break;
+
+	      case 'E':
+	         fftEffort	= atoi (optarg);
+	         break;
+
 #ifdef	HAVE_WAVFILES
 	      case 'F':
 	         fileName	= std::string (optarg);
@@ -690,6 +826,10 @@ deviceHandler	*theDevice;
 	      case 'R':
 	         repeater	= false;
 	         break;
+
+	      case 'u':
+	         unthrottled	= true;
+	         break;
 #elif	HAVE_RAWFILES
 	      case 'F':
 	         fileName	= std::string (optarg);
@@ -698,6 +838,39 @@ deviceHandler	*theDevice;
 	      case 'R':	         repeater	= false;
 	         break;
 
+	      case 'u':
+	         unthrottled	= true;
+	         break;
+#elif	HAVE_XMLFILES
+	      case 'F':
+	         fileName	= std::string (optarg);
+	         break;
+
+	      case 'R':
+	         repeater	= false;
+	         break;
+
+	      case 'u':
+	         unthrottled	= true;
+	         break;
+
+#elif	HAVE_MMAPFILES
+	      case 'F':
+	         fileName	= std::string (optarg);
+	         break;
+
+	      case 'R':
+	         repeater	= false;
+	         break;
+
+	      case 'u':
+	         unthrottled	= true;
+	         break;
+
+	      case 's':
+	         startSeconds	= atof (optarg);
+	         break;
+
 #elif	HAVE_HACKRF
 	      case 'G':
 	         lnaGain	= atoi (optarg);
@@ -868,9 +1041,27 @@ deviceHandler	*theDevice;
 #elif   HAVE_LIME
            theDevice    = new limeHandler       (frequency, gain, antenna);
 #elif	HAVE_WAVFILES
-	   theDevice	= new wavFiles (fileName, repeater);
+	   if (unthrottled)
+	      theDevice	= new wavFiles (fileName, 0.0, inputEnded, nullptr);
+	   else
+	      theDevice	= new wavFiles (fileName, repeater);
 #elif	HAVE_RAWFILES
-	   theDevice	= new rawFiles (fileName, repeater);
+	   if (unthrottled)
+	      theDevice	= new rawFiles (fileName, 0.0, inputEnded, nullptr);
+	   else
+	      theDevice	= new rawFiles (fileName, repeater);
+#elif	HAVE_XMLFILES
+	   theDevice	= new xml_fileReader (fileName,
+	                                      repeater && !unthrottled,
+	                                      inputEnded, nullptr);
+#elif	HAVE_MMAPFILES
+	   mmapFileHandler *theFile = new mmapFileHandler (fileName,
+	                                      repeater && !unthrottled,
+	                                      inputEnded, nullptr);
+	   if ((startSeconds > 0) && !theFile -> seekTime (startSeconds))
+	      fprintf (stderr, "%s is shorter than %.1f seconds\n",
+	                        fileName. c_str (), startSeconds);
+	   theDevice	= theFile;
 #elif	HAVE_RTL_TCP
 	   theDevice	= new rtl_tcp_client (hostname,
 	                                      basePort,
@@ -906,7 +1097,22 @@ deviceHandler	*theDevice;
 	interface. motdata_Handler	= wantInfo == true ? motdata_Handler : nullptr;
 	interface. tii_data_Handler	= tii_data_Handler;
 	interface. timeHandler		= timeHandler;
+	interface. ensembleChanged_Handler	= nullptr;
+//
+//	for the whole ensemble the output is per service, the
+//	dynamic label and slides of all services would end up in
+//	the same files
+	if (ensembleDir != "") {
+	   interface. audioOut_Handler	= servicePcmHandler;
+	   interface. bytesOut_Handler	= serviceBytesHandler;
+	   interface. dataOut_Handler	= nullptr;
+	   interface. dlPlusOut_Handler	= nullptr;
+	   interface. motdata_Handler	= nullptr;
+	}
 
+//	FFT planning applies to all FFT's made in dabInit
+	dabFFTPlanning (wisdomFile == "" ? nullptr : wisdomFile. c_str (),
+	                fftEffort);
 //	and with a sound device we can create a "backend"
 	theRadio	= (void *)dabInit (theDevice,
 	                                   &interface,
@@ -919,6 +1125,16 @@ deviceHandler	*theDevice;
 	   exit (4);
 	}
 
+	if (pipelineWorkers > 0)
+	   dabSetPipeline (theRadio, pipelineWorkers);
+	if (batchFFT)
+	   dabSetBatchFFT (theRadio, true);
+#if	defined (HAVE_WAVFILES) || defined (HAVE_RAWFILES) || defined (HAVE_XMLFILES) || defined (HAVE_MMAPFILES)
+	if (unthrottled)
+	   theDevice -> setUnthrottled (true);
+#endif
+	std::chrono::steady_clock::time_point startTime =
+	                                 std::chrono::steady_clock::now ();
 	theDevice	-> restartReader (frequency);
 //
 //	The device should be working right now
@@ -968,33 +1184,95 @@ deviceHandler	*theDevice;
 	   programName = dab_getserviceName (theRadio, serviceIdentifier);
 	}
 
-	fprintf (stderr,"we try to start program %s\n", programName.c_str());
-	if (!is_audioService (theRadio, programName)) {
-	   std::cerr << "sorry  we cannot handle service " <<
-                                                 programName << "\n";
-	   run. store (false);
+	if (ensembleDir != "") {
+	   int n = dabDecodeEnsemble (theRadio, serviceWorkers,
+	                                                serviceContext);
+	   fprintf (stderr, "decoding %d services\n", n);
+	   if (n == 0)
+	      run. store (false);
 	}
 	else {
-	   audiodata ad;
-	   dataforAudioService (theRadio, programName, ad, 0);
-	   if (ad. defined) {
-	      dabReset_msc (theRadio);
-	      set_audioChannel (theRadio, ad);
-	   }
-	   else {
+	   fprintf (stderr,"we try to start program %s\n", programName.c_str());
+	   if (!is_audioService (theRadio, programName)) {
 	      std::cerr << "sorry  we cannot handle service " <<
-                                                 programName << "\n";
+                                                    programName << "\n";
 	      run. store (false);
 	   }
+	   else {
+	      audiodata ad;
+	      dataforAudioService (theRadio, programName, ad, 0);
+	      if (ad. defined) {
+	         dabReset_msc (theRadio);
+	         set_audioChannel (theRadio, ad);
+	      }
+	      else {
+	         std::cerr << "sorry  we cannot handle service " <<
+                                                    programName << "\n";
+	         run. store (false);
+	      }
+	   }
 	}
 
-	while (run. load () && (theDuration != 0)) {
-	   if (theDuration > 0)
+//	the loop ticks at 100 msec, so the end of an unthrottled
+//	input is acted upon quickly
+	int ticks	= 0;
+	while (run. load () && !endOfInput. load () && (theDuration != 0)) {
+	   usleep (100000);
+	   if ((++ticks % 10 == 0) && (theDuration > 0))
 	      theDuration --;
-	   sleep (1);
+	}
+//
+//	the cpu time per service, taken before the handlers are stopped
+	if (sinks. size () > 0) {
+	   serviceStats	load [64];
+	   int n = dabGetServiceStats (theRadio, load, 64);
+	   for (int i = 0; i < n; i ++) {
+	      std::string name	= dab_getserviceName (theRadio, load [i]. SId);
+	      fprintf (stderr, "SERVICE_CPU: SId=%X subch=%d %s \"%s\" segments=%llu cpu=%.3f sec\n",
+	                       load [i]. SId, load [i]. subchId,
+	                       load [i]. isAudio ? "audio" : "data",
+	                       name. c_str (),
+	                       (unsigned long long)load [i]. segments,
+	                       load [i]. cpuNs / 1e9);
+	   }
 	}
 	theDevice	-> stopReader ();
 	dabStop (theRadio);
+	for (auto s : sinks) {
+	   if (s -> out != nullptr)
+	      fclose (s -> out);
+	   delete s;
+	}
+	sinks. resize (0);
+#if	defined (HAVE_WAVFILES) || defined (HAVE_RAWFILES) || defined (HAVE_XMLFILES) || defined (HAVE_MMAPFILES)
+	if (unthrottled) {
+	   processingStats ps;
+	   std::chrono::steady_clock::time_point endTime;
+	   if (endOfInput. load ()) {
+	      ps	= eofStats;
+	      endTime	= eofTime;
+	   }
+	   else {
+	      dabGetProcessingStats (theRadio, &ps);
+	      endTime	= std::chrono::steady_clock::now ();
+	   }
+	   double elapsed	=
+	           std::chrono::duration<double> (endTime - startTime). count ();
+	   double signal	= ps. samplesRead / 2048000.0;
+	   fprintf (stderr, "throughput: %.1f sec of signal in %.1f sec, %.2f x realtime, %llu frames, %.1f frames/sec\n",
+	                     signal, elapsed,
+	                     elapsed > 0 ? signal / elapsed : 0,
+	                     (unsigned long long)ps. framesDecoded,
+	                     elapsed > 0 ? ps. framesDecoded / elapsed : 0);
+	}
+#endif
+	pipelineStats st;
+	if (dabGetPipelineStats (theRadio, &st))
+	   fprintf (stderr, "pipeline: %d workers, %llu symbols, %llu stalls, peak queue %d\n",
+	                     st. workers,
+	                     (unsigned long long)st. symbolsDelivered,
+	                     (unsigned long long)st. producerStalls,
+	                     st. peakWaitingForWorker);
 	dabExit	(theRadio);
 	delete theDevice;
 }
@@ -1008,9 +1286,17 @@ void    printOptions (void) {
 "	                  -D number\tamount of time to look for an ensemble\n"
 "	                  -d number\tseconds to reach time sync\n"
 "	                  -P name\tprogram to be selected in the ensemble\n"
+"	                  -m dir\tdecode all services of the ensemble, the output per service (SId) in dir\n"
+"	                  -w number\tnumber of worker threads for the services with -m (default 0, one per core)\n"
+"	                  -W number\tnumber of worker threads for the MSC symbols (default 0, no pipeline)\n"
+"	                  -b\tdo the FFT of the MSC blocks of a frame as one batch\n"
+"	                  -e file\tload (and save) fftw wisdom from/to file\n"
+"	                  -E number\tFFT planning effort, 0 estimate (default), 1 measure, 2 patient\n"
 "	for file input:\n"
 "	                  -F filename\tin case the input is from file\n"
 "	                  -R switch off automatic continuation after eof\n"
+"	                  -u\tunthrottled, decode the file as fast as possible and report the throughput\n"
+"	                  -s seconds\tstart at <seconds> in the file (memory mapped files)\n"
 "	for hackrf:\n"
 "	                  -B Band\tBand is either L_BAND or BAND_III (default)\n"
 "	                  -C Channel\n"